@@ -0,0 +1,16 @@
+#!/bin/bash
+#SBATCH --job-name=chile_1000_mpi
+#SBATCH --output=chile_1000_mpi.out
+#SBATCH --error=chile_1000_mpi.err
+#SBATCH --partition=s_hadoop
+#SBATCH --nodes=4
+#SBATCH --ntasks-per-node=2
+#SBATCH --time=10:00:00
+#SBATCH --cpus-per-task=36
+
+# one process per socket, built with scons mpi=yes omp=gnu
+export OMP_NUM_THREADS=${SLURM_CPUS_PER_TASK}
+export OMP_PLACES=cores
+export OMP_PROC_BIND=close
+
+srun ./build/tsunami_lab configs/chile1000.json
@@ -6,6 +6,9 @@
 
 #include <thread>
 #include <atomic>
+#ifdef USEMPI
+#include <mpi.h>
+#endif
 using json = nlohmann::json;
 
 //! Port for the server
@@ -131,6 +134,20 @@ void updateData()
 int main(int i_argc, char *i_argv[])
 {
     int exitCode = 0;
+#ifdef USEMPI
+    // the simulation runs in another thread than the main one in server mode
+    int l_threadSupport = 0;
+    MPI_Init_thread(&i_argc, &i_argv, MPI_THREAD_SERIALIZED, &l_threadSupport);
+    int l_rank = 0;
+    int l_nRanks = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &l_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &l_nRanks);
+    // the first process reports the progress of all of them
+    if (l_rank > 0)
+    {
+        std::cout.setstate(std::ios_base::badbit);
+    }
+#endif
     simulator = new tsunami_lab::Simulator;
 
     //------------------------------------------//
@@ -138,6 +155,15 @@ int main(int i_argc, char *i_argv[])
     //------------------------------------------//
     if (i_argc >= 2 && (strcmp(i_argv[1], "server") == 0))
     {
+#ifdef USEMPI
+        if (l_nRanks > 1)
+        {
+            std::cerr << "Error: the server mode runs in a single process" << std::endl;
+            delete simulator;
+            MPI_Finalize();
+            return EXIT_FAILURE;
+        }
+#endif
         if (i_argc >= 3)
         {
             m_PORT = atoi(i_argv[2]);
@@ -577,5 +603,8 @@ int main(int i_argc, char *i_argv[])
     }
 
     delete simulator;
+#ifdef USEMPI
+    MPI_Finalize();
+#endif
     return exitCode;
 }
@@ -7,6 +7,8 @@
  **/
 
 #include "Simulator.h"
+#include "systeminfo/Isa.h"
+#include "systeminfo/Affinity.h"
 
 // c libraries
 #include <cstdlib>
@@ -17,6 +19,7 @@
 #include <chrono>
 #include <future>
 #include <thread>
+#include <algorithm>
 
 #ifndef NOFILESYSTEM
 #include <filesystem>
@@ -56,6 +59,9 @@ void tsunami_lab::Simulator::setupFolders()
 void tsunami_lab::Simulator::configureFiles()
 {
   m_outputFileName = m_configData.value("outputFileName", "solution");
+  // every process writes the files of its subdomain
+  if (m_nMpiRanks > 1)
+    m_outputFileName += "_" + std::to_string(m_mpiRank);
   m_netCdfOutputPathString = "solutions/" + m_outputFileName + ".nc";
   m_netcdfOutputPath = m_netCdfOutputPathString.c_str();
 
@@ -86,6 +92,81 @@ void tsunami_lab::Simulator::loadConfiguration()
   std::cout << ">> Loading configuration from local json data" << std::endl;
 
   m_solver = m_configData.value("solver", "fwave");
+  systeminfo::Isa::Level l_isa = systeminfo::Isa::select(m_configData.value("isa", "auto"));
+  std::cout << ">> Using " << systeminfo::Isa::name(l_isa) << " solver kernels" << std::endl;
+  // the placement has to be set before the patch touches its memory
+  if (m_configData.value("threadPinning", false))
+  {
+    if (systeminfo::Affinity::pinThreads())
+      std::cout << ">> Pinned the threads to the cores" << std::endl;
+    else
+      std::cerr << "Warning: could not pin the threads to the cores" << std::endl;
+  }
+  std::string l_memoryPolicyName = m_configData.value("memoryPolicy", "firsttouch");
+  systeminfo::Affinity::MemoryPolicy l_memoryPolicy = systeminfo::Affinity::FIRST_TOUCH;
+  if (!systeminfo::Affinity::parse(l_memoryPolicyName, l_memoryPolicy))
+  {
+    std::cerr << "Warning: unknown memory policy " << l_memoryPolicyName << ", using "
+              << systeminfo::Affinity::name(l_memoryPolicy) << " instead" << std::endl;
+  }
+  if (l_memoryPolicy != systeminfo::Affinity::FIRST_TOUCH)
+  {
+    if (systeminfo::Affinity::setMemoryPolicy(l_memoryPolicy))
+      std::cout << ">> Using the " << systeminfo::Affinity::name(l_memoryPolicy) << " memory policy" << std::endl;
+    else
+      std::cerr << "Warning: could not set the " << systeminfo::Affinity::name(l_memoryPolicy) << " memory policy" << std::endl;
+  }
+  m_inPlaceUpdates = m_configData.value("inPlaceUpdates", false);
+  m_hugePages = m_configData.value("hugePages", false);
+  m_persistentParallelRegion = m_configData.value("persistentParallelRegion", false);
+  m_adaptiveTimeStepFrequency = m_configData.value("adaptiveTimeStepFrequency", 0);
+  m_activityThreshold = m_configData.value("activityThreshold", -1);
+  m_stripWidth = m_configData.value("stripWidth", 0);
+  m_ghostWidth = m_configData.value("ghostWidth", 1);
+  m_taskTileRows = m_configData.value("taskTileRows", 0);
+  m_loadBalanceSteps = m_configData.value("loadBalanceSteps", 0);
+  m_asyncOutputFrames = m_configData.value("asyncOutputFrames", 0);
+  m_shareCellQuantities = m_configData.value("shareCellQuantities", false);
+  m_quantizedBathymetry = m_configData.value("quantizedBathymetry", false);
+  m_linearDepth = m_configData.value("linearDepth", 0.0);
+  m_linearAmplitudeRatio = m_configData.value("linearAmplitudeRatio", 0.01);
+  // the levels are clamped before the conversion, negative ones would wrap around
+  m_localTimeStepLevels = std::clamp(m_configData.value("localTimeStepping", 0), 0, 8);
+  json l_refinement = m_configData.value("refinement", json::object());
+  m_refinementRatio = l_refinement.value("ratio", 0);
+  m_refinementBlockSize = l_refinement.value("blockSize", 16);
+  m_refinementRegridFrequency = l_refinement.value("regridFrequency", 10);
+  m_refinementAmplitude = l_refinement.value("amplitude", 0.0);
+  m_refinementDepthGradient = l_refinement.value("depthGradient", 0.0);
+  m_refinementCoastDepth = l_refinement.value("coastDepth", 0.0);
+  m_refinementStationRadius = l_refinement.value("stationRadius", -1.0);
+  m_refinementNests.clear();
+  json l_nests = l_refinement.value("nests", json::array());
+  for (json &elem : l_nests)
+  {
+    Nest l_nest;
+    l_nest.name = elem.value("name", "nest" + std::to_string(m_refinementNests.size()));
+    l_nest.x0 = elem.at("x0");
+    l_nest.y0 = elem.at("y0");
+    l_nest.x1 = elem.at("x1");
+    l_nest.y1 = elem.at("y1");
+    l_nest.ratio = elem.value("ratio", 2);
+    l_nest.nSteps = elem.value("timeSteps", 0);
+    l_nest.output = elem.value("output", false);
+    m_refinementNests.push_back(l_nest);
+  }
+  // the refined blocks advance with the time steps of the coarse patch
+  if (m_localTimeStepLevels > 0 && (m_refinementRatio >= 2 || !m_refinementNests.empty()))
+  {
+    std::cerr << "Warning: the local time stepping is not supported with refinement and disabled" << std::endl;
+    m_localTimeStepLevels = 0;
+  }
+  // the refluxing recomputes the coarse fluxes with the solver of the patches, which the linearized edges would deviate from
+  if (m_linearDepth > 0 && (m_refinementRatio >= 2 || !m_refinementNests.empty()))
+  {
+    std::cerr << "Warning: the linearization is not supported with refinement and disabled" << std::endl;
+    m_linearDepth = 0;
+  }
   // read size config
   m_nx = m_configData.value("nx", 1);
   m_ny = m_configData.value("ny", 1);
@@ -133,6 +214,27 @@ void tsunami_lab::Simulator::loadConfiguration()
   m_writingFrequency = m_configData.value("writingFrequency", 80);
   m_checkpointFrequency = m_configData.value("checkpointFrequency", -1);
 
+  // the subdomains advance with the time steps of the whole domain and exchange their halo cells between them
+  if (m_nMpiRanks > 1)
+  {
+    if (m_localTimeStepLevels > 0)
+      std::cerr << "Warning: the local time stepping is not supported with several processes and disabled" << std::endl;
+    if (m_refinementRatio >= 2 || !m_refinementNests.empty())
+      std::cerr << "Warning: the refinement is not supported with several processes and disabled" << std::endl;
+    if (m_quantizedBathymetry)
+      std::cerr << "Warning: the quantized bathymetry is not supported with several processes and disabled" << std::endl;
+    if (m_checkpointFrequency > 0)
+      std::cerr << "Warning: checkpoints are not supported with several processes and disabled" << std::endl;
+    if (m_persistentParallelRegion)
+      std::cerr << "Warning: the persistent parallel region is not supported with several processes and disabled" << std::endl;
+    m_localTimeStepLevels = 0;
+    m_refinementRatio = 0;
+    m_refinementNests.clear();
+    m_quantizedBathymetry = false;
+    m_checkpointFrequency = -1;
+    m_persistentParallelRegion = false;
+  }
+
   // read station data
   m_stationFrequency = m_configData.value("stationFrequency", 0);
   if (m_useFileIO)
@@ -279,6 +381,8 @@ void tsunami_lab::Simulator::setUpNetCdf()
     std::cout << "  Current simulation time:  " << m_simTime << std::endl;
     std::cout << "  Current time step:        " << m_timeStep << std::endl;
     std::cout << std::endl;
+    m_nxLocal = m_nx;
+    m_nyLocal = m_ny;
 
     if (m_timeStepMax < m_timeStep)
     {
@@ -287,37 +391,117 @@ void tsunami_lab::Simulator::setUpNetCdf()
   }
   else
   {
-    m_netCdf = new tsunami_lab::io::NetCdf(m_nx,
-                                           m_ny,
+    // every process writes the cells of its subdomain
+    tsunami_lab::t_real l_sizeX = m_nxLocal == m_nx ? m_simulationSizeX : m_nxLocal * m_dx;
+    tsunami_lab::t_real l_sizeY = m_nyLocal == m_ny ? m_simulationSizeY : m_nyLocal * m_dy;
+    m_netCdf = new tsunami_lab::io::NetCdf(m_nxLocal,
+                                           m_nyLocal,
                                            m_nk,
-                                           m_simulationSizeX,
-                                           m_simulationSizeY,
-                                           m_offsetX,
-                                           m_offsetY,
+                                           l_sizeX,
+                                           l_sizeY,
+                                           m_offsetX + m_firstCellX * m_dx,
+                                           m_offsetY + m_firstCellY * m_dy,
                                            m_netcdfOutputPath,
                                            m_checkPointFilePath);
   }
+
+  // a dedicated thread writes the frames of the netcdf files
+  if (m_dataWriter == NETCDF && m_asyncOutputFrames > 0)
+  {
+    std::cout << ">> Writing netcdf asynchronously with " << m_asyncOutputFrames << " pooled frames" << std::endl;
+    m_netCdfWriter = new tsunami_lab::io::NetCdfWriter(m_asyncOutputFrames);
+  }
+}
+
+void tsunami_lab::Simulator::createDecomposition()
+{
+  m_firstCellX = 0;
+  m_firstCellY = 0;
+  m_nxLocal = m_nx;
+  m_nyLocal = m_ny;
+  if (m_nMpiRanks == 1)
+    return;
+  if (m_ny == 1)
+  {
+    std::cerr << "Error: the 1d patch cannot be split into several processes" << std::endl;
+    m_shouldExit = true;
+    return;
+  }
+
+#ifdef USEMPI
+  // the cells averaged by the output stay in one subdomain
+  m_decomposition = new tsunami_lab::patches::Decomposition2d(MPI_COMM_WORLD,
+                                                              m_nx,
+                                                              m_ny,
+                                                              m_nk,
+                                                              m_solver,
+                                                              m_boundaryL,
+                                                              m_boundaryR,
+                                                              m_boundaryT,
+                                                              m_boundaryB);
+  m_decomposition->getSubdomain(m_firstCellX, m_firstCellY, m_nxLocal, m_nyLocal);
+  tsunami_lab::t_idx l_nRanksX, l_nRanksY;
+  m_decomposition->getRanks(l_nRanksX, l_nRanksY);
+  std::cout << ">> Splitting the domain into " << l_nRanksX << " x " << l_nRanksY << " subdomains" << std::endl;
+#endif
 }
 
 void tsunami_lab::Simulator::createWaveProp()
 {
   std::cout << ">> Creating WavePropagation patch" << std::endl;
+  tsunami_lab::patches::Field2d::setHugePages(m_hugePages);
   if (m_ny == 1)
   {
-    m_waveProp = new tsunami_lab::patches::WavePropagation1d(m_nx,
-                                                             m_solver,
-                                                             m_boundaryL,
-                                                             m_boundaryR);
+    m_waveProp = tsunami_lab::patches::createWavePropagation1d(m_nx,
+                                                               m_solver,
+                                                               m_boundaryL,
+                                                               m_boundaryR);
   }
   else
   {
-    m_waveProp = new tsunami_lab::patches::WavePropagation2d(m_nx,
-                                                             m_ny,
-                                                             m_boundaryL,
-                                                             m_boundaryR,
-                                                             m_boundaryT,
-                                                             m_boundaryB);
+    Boundary l_boundaryL = m_boundaryL;
+    Boundary l_boundaryR = m_boundaryR;
+    Boundary l_boundaryT = m_boundaryT;
+    Boundary l_boundaryB = m_boundaryB;
+#ifdef USEMPI
+    if (m_decomposition != nullptr)
+    {
+      l_boundaryL = m_decomposition->getBoundary(tsunami_lab::patches::Decomposition2d::LEFT);
+      l_boundaryR = m_decomposition->getBoundary(tsunami_lab::patches::Decomposition2d::RIGHT);
+      l_boundaryT = m_decomposition->getBoundary(tsunami_lab::patches::Decomposition2d::TOP);
+      l_boundaryB = m_decomposition->getBoundary(tsunami_lab::patches::Decomposition2d::BOTTOM);
+    }
+#endif
+    m_waveProp = tsunami_lab::patches::createWavePropagation2d(m_nxLocal,
+                                                               m_nyLocal,
+                                                               m_solver,
+                                                               l_boundaryL,
+                                                               l_boundaryR,
+                                                               l_boundaryT,
+                                                               l_boundaryB,
+                                                               m_inPlaceUpdates);
+  }
+  m_waveProp->setActivityThreshold(m_activityThreshold);
+  m_waveProp->setStripWidth(m_stripWidth);
+  m_waveProp->setGhostWidth(m_ghostWidth);
+  m_waveProp->setTaskTiles(m_taskTileRows);
+  m_waveProp->setLoadBalancing(m_loadBalanceSteps);
+  m_waveProp->setCellQuantitySharing(m_shareCellQuantities);
+  m_waveProp->setBathymetryQuantization(m_quantizedBathymetry);
+  m_waveProp->setLinearization(m_linearDepth, m_linearAmplitudeRatio);
+  m_waveProp->setLocalTimeStepping(m_localTimeStepLevels);
+#ifdef USEMPI
+  if (m_decomposition != nullptr)
+  {
+    m_decomposition->setPatch(m_waveProp);
+    m_decomposition->setLinearization(m_linearDepth, m_linearAmplitudeRatio);
   }
+#endif
+  if (m_localTimeStepLevels > 0 && m_ny > 1)
+    std::cout << ">> Splitting the time steps into " << (1 << m_localTimeStepLevels) << " local micro steps" << std::endl;
+
+  // the patch reused the buffers of its predecessor, others are not needed anymore
+  tsunami_lab::patches::Field2d::releasePool();
 
   // provide stations with new waveprop
   for (tsunami_lab::io::Station *l_s : m_stations)
@@ -387,17 +571,17 @@ void tsunami_lab::Simulator::constructSolver()
 #ifdef USEOMP
 #pragma omp parallel for
 #endif
-    for (tsunami_lab::t_idx l_cy = 0; l_cy < m_ny; l_cy++)
+    for (tsunami_lab::t_idx l_cy = 0; l_cy < m_nyLocal; l_cy++)
     {
-      tsunami_lab::t_real l_y = l_cy * m_dy + m_offsetY;
-      for (tsunami_lab::t_idx l_cx = 0; l_cx < m_nx; l_cx++)
+      tsunami_lab::t_real l_y = (m_firstCellY + l_cy) * m_dy + m_offsetY;
+      for (tsunami_lab::t_idx l_cx = 0; l_cx < m_nxLocal; l_cx++)
       {
         // BREAKPOINT
         if (m_shouldExit)
           continue;
         // END BREAKPOINT
 
-        tsunami_lab::t_real l_x = l_cx * m_dx + m_offsetX;
+        tsunami_lab::t_real l_x = (m_firstCellX + l_cx) * m_dx + m_offsetX;
         // get initial values of the setup
         tsunami_lab::t_real l_h = m_setup->getHeight(l_x,
                                                      l_y);
@@ -429,6 +613,119 @@ void tsunami_lab::Simulator::constructSolver()
       }
     }
   }
+
+  // the Roe solver ignores the bathymetry, an uneven sea floor neither slows nor reflects its waves
+  if (m_solver == "roe" && m_waveProp != nullptr)
+  {
+    tsunami_lab::t_real const *l_b = m_waveProp->getBathymetry();
+    tsunami_lab::t_idx l_stride = m_waveProp->getStride();
+    bool l_flat = true;
+    for (tsunami_lab::t_idx l_cy = 0; l_cy < m_nyLocal && l_flat; l_cy++)
+      for (tsunami_lab::t_idx l_cx = 0; l_cx < m_nxLocal && l_flat; l_cx++)
+        l_flat = l_b[l_cx + l_cy * l_stride] == l_b[0];
+    if (!l_flat)
+      std::cerr << "Warning: the roe solver ignores the uneven bathymetry of the setup, fwave takes it into account" << std::endl;
+  }
+}
+
+void tsunami_lab::Simulator::createRefinement()
+{
+  if ((m_refinementRatio < 2 && m_refinementNests.empty()) || m_ny == 1)
+    return;
+
+  m_refinement = new tsunami_lab::patches::Refinement2d(m_waveProp,
+                                                        m_nx,
+                                                        m_ny,
+                                                        m_dx,
+                                                        m_dy,
+                                                        m_offsetX,
+                                                        m_offsetY,
+                                                        m_solver,
+                                                        m_setup,
+                                                        m_refinementRatio);
+
+  // the fine cells of a new simulation sample the setup, the ones of a checkpoint the coarse cells
+  bool l_fromSetup = m_setupChoice != "CHECKPOINT";
+
+  // the nests cover the coarse cells whose centers lie in their regions
+  tsunami_lab::t_idx l_nBlocks = 0;
+  for (Nest &l_nest : m_refinementNests)
+  {
+    long l_ix0 = std::max(long(std::ceil((l_nest.x0 - m_offsetX) / m_dx)), long(0));
+    long l_iy0 = std::max(long(std::ceil((l_nest.y0 - m_offsetY) / m_dy)), long(0));
+    long l_ix1 = std::min(long(std::floor((l_nest.x1 - m_offsetX) / m_dx)) + 1, long(m_nx));
+    long l_iy1 = std::min(long(std::floor((l_nest.y1 - m_offsetY) / m_dy)) + 1, long(m_ny));
+    l_nest.block = -1;
+    if (l_ix1 > l_ix0 && l_iy1 > l_iy0 &&
+        m_refinement->addBlock(l_ix0, l_iy0, l_ix1 - l_ix0, l_iy1 - l_iy0, l_nest.ratio, l_nest.nSteps, l_fromSetup))
+    {
+      l_nest.block = l_nBlocks++;
+      std::cout << ">> Nest " << l_nest.name << " refines " << l_ix1 - l_ix0 << " x " << l_iy1 - l_iy0
+                << " cells by a ratio of " << l_nest.ratio << std::endl;
+    }
+    else
+    {
+      std::cerr << "Error: nest " << l_nest.name << " is empty or overlaps another nest, it is ignored" << std::endl;
+    }
+  }
+
+  if (m_refinementRatio >= 2)
+  {
+    std::cout << ">> Refining the blocks of " << m_refinementBlockSize << " x " << m_refinementBlockSize
+              << " cells by a ratio of " << m_refinementRatio << std::endl;
+    m_refinement->setBlockSize(m_refinementBlockSize);
+    m_refinement->setRegridFrequency(m_refinementRegridFrequency);
+    m_refinement->setCriteria(m_refinementAmplitude,
+                              m_refinementDepthGradient,
+                              m_refinementCoastDepth);
+    if (m_refinementStationRadius >= 0 && m_configData.contains("stations"))
+    {
+      for (json &elem : m_configData["stations"])
+      {
+        m_refinement->addPoint(elem.at("locX"),
+                               elem.at("locY"),
+                               m_refinementStationRadius);
+      }
+    }
+    m_refinement->regrid(l_fromSetup);
+  }
+  std::cout << ">> Refined " << m_refinement->getNumBlocks() << " blocks" << std::endl;
+
+  // stations of the nests capture the new fine patches
+  for (std::pair<tsunami_lab::io::Station *, tsunami_lab::t_idx> &l_station : m_nestStations)
+  {
+    if (m_refinementNests[l_station.second].block >= 0)
+      l_station.first->setWaveProp(m_refinement->getBlockPatch(m_refinementNests[l_station.second].block));
+  }
+
+  // the nests write their inner fine cells into files of their own
+  if (m_useFileIO && m_dataWriter == NETCDF)
+  {
+    for (Nest &l_nest : m_refinementNests)
+    {
+      if (!l_nest.output || l_nest.block < 0 || l_nest.netCdf != nullptr)
+        continue;
+
+      l_nest.outputPath = "solutions/" + m_outputFileName + "_" + l_nest.name + ".nc";
+      if (l_fromSetup && std::filesystem::exists(l_nest.outputPath))
+        std::filesystem::remove(l_nest.outputPath);
+
+      tsunami_lab::t_idx l_ix, l_iy, l_nx, l_ny;
+      m_refinement->getBlockCells(l_nest.block, l_ix, l_iy, l_nx, l_ny);
+      tsunami_lab::t_real l_dxF = m_dx / l_nest.ratio;
+      tsunami_lab::t_real l_dyF = m_dy / l_nest.ratio;
+      l_nest.netCdf = new tsunami_lab::io::NetCdf(l_nx * l_nest.ratio,
+                                                  l_ny * l_nest.ratio,
+                                                  1,
+                                                  l_nx * m_dx,
+                                                  l_ny * m_dy,
+                                                  m_offsetX + (l_ix - 0.5) * m_dx + 0.5 * l_dxF,
+                                                  m_offsetY + (l_iy - 0.5) * m_dy + 0.5 * l_dyF,
+                                                  l_nest.outputPath.c_str(),
+                                                  m_checkPointFilePath);
+      std::cout << ">> Nest " << l_nest.name << " writes to " << l_nest.outputPath << std::endl;
+    }
+  }
 }
 
 void tsunami_lab::Simulator::loadBathymetry(std::string *i_file)
@@ -486,8 +783,44 @@ void tsunami_lab::Simulator::loadStations(json i_jsonData)
       tsunami_lab::t_idx l_cx = (l_x - m_offsetX) / m_dx;
       tsunami_lab::t_idx l_cy = (l_y - m_offsetY) / m_dy;
 
-      m_stations.push_back(new tsunami_lab::io::Station(l_cx,
-                                                        l_cy,
+      // stations of a nest capture the fine cell containing their location
+      std::string l_nestName = elem.value("nest", "");
+      long l_nest = -1;
+      for (tsunami_lab::t_idx l_ne = 0; l_ne < m_refinementNests.size() && m_refinement != nullptr; l_ne++)
+        if (m_refinementNests[l_ne].name == l_nestName && m_refinementNests[l_ne].block >= 0)
+          l_nest = l_ne;
+      if (l_nestName != "" && l_nest >= 0)
+      {
+        tsunami_lab::t_idx l_ix, l_iy, l_nx, l_ny;
+        tsunami_lab::t_idx l_ratio = m_refinementNests[l_nest].ratio;
+        m_refinement->getBlockCells(m_refinementNests[l_nest].block, l_ix, l_iy, l_nx, l_ny);
+        tsunami_lab::t_real l_fx = std::floor((l_x - m_offsetX - (l_ix - 0.5) * m_dx) * l_ratio / m_dx);
+        tsunami_lab::t_real l_fy = std::floor((l_y - m_offsetY - (l_iy - 0.5) * m_dy) * l_ratio / m_dy);
+        if (l_fx >= 0 && l_fy >= 0 && l_fx < l_nx * l_ratio && l_fy < l_ny * l_ratio)
+        {
+          // the fine patch has a ring of coupling cells
+          tsunami_lab::io::Station *l_station = new tsunami_lab::io::Station(l_fx + 1,
+                                                                             l_fy + 1,
+                                                                             elem.at("name"),
+                                                                             m_refinement->getBlockPatch(m_refinementNests[l_nest].block));
+          m_stations.push_back(l_station);
+          m_nestStations.push_back(std::make_pair(l_station, tsunami_lab::t_idx(l_nest)));
+          std::cout << "Added station " << elem.at("name") << " at x: " << l_x << " and y: " << l_y
+                    << " in nest " << l_nestName << std::endl;
+          continue;
+        }
+      }
+      if (l_nestName != "")
+        std::cerr << "Warning: station " << elem.at("name") << " lies outside of the nest " << l_nestName
+                  << ", it captures the coarse cells" << std::endl;
+
+#ifdef USEMPI
+      // the process of the subdomain with the cell captures the station
+      if (m_decomposition != nullptr && !m_decomposition->isLocal(l_cx, l_cy))
+        continue;
+#endif
+      m_stations.push_back(new tsunami_lab::io::Station(l_cx - m_firstCellX,
+                                                        l_cy - m_firstCellY,
                                                         elem.at("name"),
                                                         m_waveProp));
       std::cout << "Added station " << elem.at("name") << " at x: " << l_x << " and y: " << l_y << std::endl;
@@ -507,27 +840,60 @@ void tsunami_lab::Simulator::writeStations()
   }
 }
 
-void tsunami_lab::Simulator::deriveTimeStep()
+void tsunami_lab::Simulator::setTimeStep(tsunami_lab::t_real i_speedMax)
 {
-  // derive maximum wave speed in setup; the momentum is ignored
-  tsunami_lab::t_real l_speedMax = std::sqrt(9.81 * m_hMax);
-
-  // derive constant time step; changes at simulation time are ignored
-  if (m_ny == 1)
+  // keep the current time step if the domain is at rest
+  if (i_speedMax > 0)
   {
-    m_dt = 0.5 * m_dx / l_speedMax;
+    if (m_ny == 1)
+    {
+      m_dt = 0.5 * m_dx / i_speedMax;
+    }
+    else
+    {
+      m_dt = m_timeStepScaling * 0.45 * std::min(m_dx, m_dy) / i_speedMax;
+
+      // the fastest cells take 2^L micro steps per time step
+      m_dt *= tsunami_lab::t_real(tsunami_lab::t_idx(1) << m_localTimeStepLevels);
+    }
   }
-  else
+
+  // calculate max time steps
+  m_timeStepMax = m_timeStep;
+  if (m_simTime < m_endTime)
   {
-    m_dt = m_timeStepScaling * 0.45 * std::min(m_dx, m_dy) / l_speedMax;
+    m_timeStepMax += std::ceil((m_endTime - m_simTime) / m_dt);
   }
 
-  // calculate max time steps
-  m_timeStepMax = std::ceil(m_endTime / m_dt);
-  std::cout << "Note: max " << m_timeStepMax << " steps will be computed." << std::endl;
   // derive scaling for a time step
   m_scalingX = m_dt / m_dx;
   m_scalingY = m_dt / m_dy;
+}
+
+void tsunami_lab::Simulator::deriveTimeStep()
+{
+#ifdef USEMPI
+  // all processes start with the time step of the whole domain
+  if (m_decomposition != nullptr)
+    m_hMax = m_decomposition->reduceMax(m_hMax);
+#endif
+
+  // derive maximum wave speed in setup; the momentum is ignored
+  tsunami_lab::t_real l_speedMax = std::sqrt(9.81 * m_hMax);
+
+  // derive initial time step; adapted at simulation time if enabled
+  setTimeStep(l_speedMax);
+  std::cout << "Note: max " << m_timeStepMax << " steps will be computed." << std::endl;
+  if (m_adaptiveTimeStepFrequency > 0)
+  {
+    std::cout << "Adapting the time step every " << m_adaptiveTimeStepFrequency << " time steps" << std::endl;
+  }
+#ifdef USEOMP
+  if (m_persistentParallelRegion && m_refinement == nullptr)
+  {
+    std::cout << "Running the time loop in a persistent parallel region" << std::endl;
+  }
+#endif
 
   // options for checkpointing
   if (m_useFileIO)
@@ -571,6 +937,18 @@ void tsunami_lab::Simulator::deleteSetup()
 
 void tsunami_lab::Simulator::deleteWaveProp()
 {
+#ifdef USEMPI
+  if (m_decomposition != nullptr)
+  {
+    delete m_decomposition;
+    m_decomposition = nullptr;
+  }
+#endif
+  if (m_refinement != nullptr)
+  {
+    delete m_refinement;
+    m_refinement = nullptr;
+  }
   if (m_waveProp != nullptr)
   {
     delete m_waveProp;
@@ -580,11 +958,19 @@ void tsunami_lab::Simulator::deleteWaveProp()
 
 void tsunami_lab::Simulator::deleteNetCdf()
 {
+  // the writer finishes the queued frames of the files first
+  delete m_netCdfWriter;
+  m_netCdfWriter = nullptr;
   if (m_netCdf != nullptr)
   {
     delete m_netCdf;
     m_netCdf = nullptr;
   }
+  for (Nest &l_nest : m_refinementNests)
+  {
+    delete l_nest.netCdf;
+    l_nest.netCdf = nullptr;
+  }
 }
 
 void tsunami_lab::Simulator::freeMemory()
@@ -618,6 +1004,7 @@ void tsunami_lab::Simulator::deleteStations()
     delete l_s;
   }
   m_stations.clear();
+  m_nestStations.clear();
 }
 
 void tsunami_lab::Simulator::resetSimulator()
@@ -640,6 +1027,9 @@ void tsunami_lab::Simulator::resetSimulator()
 //------------------------------------------//
 void tsunami_lab::Simulator::writeCheckpoint()
 {
+  // the checkpoint refers to the written frames, and the netcdf library is called by one thread at a time
+  if (m_netCdfWriter != nullptr)
+    m_netCdfWriter->wait();
   m_netCdf->writeCheckpoint(m_checkPointFilePath,
                             m_waveProp->getStride(),
                             m_waveProp->getHeight(),
@@ -676,8 +1066,12 @@ void tsunami_lab::Simulator::addStation(tsunami_lab::t_real i_locationX,
   tsunami_lab::t_idx l_cx = (i_locationX - m_offsetX) / m_dx;
   tsunami_lab::t_idx l_cy = (i_locationY - m_offsetY) / m_dy;
 
-  m_stations.push_back(new tsunami_lab::io::Station(l_cx,
-                                                    l_cy,
+#ifdef USEMPI
+  if (m_decomposition != nullptr && !m_decomposition->isLocal(l_cx, l_cy))
+    return;
+#endif
+  m_stations.push_back(new tsunami_lab::io::Station(l_cx - m_firstCellX,
+                                                    l_cy - m_firstCellY,
                                                     i_stationName,
                                                     m_waveProp));
 }
@@ -693,6 +1087,11 @@ void tsunami_lab::Simulator::prepareForCalculation()
   //-------------------------------------------//
   m_configData["null"] = "null";
 
+#ifdef USEMPI
+  MPI_Comm_rank(MPI_COMM_WORLD, &m_mpiRank);
+  MPI_Comm_size(MPI_COMM_WORLD, &m_nMpiRanks);
+#endif
+
   // set up folders
   if (m_useFileIO)
   {
@@ -721,6 +1120,7 @@ void tsunami_lab::Simulator::prepareForCalculation()
 
   loadConfiguration();
   constructSetup();
+  createDecomposition();
 
   // BREAKPOINT
   if (m_shouldExit)
@@ -739,6 +1139,8 @@ void tsunami_lab::Simulator::prepareForCalculation()
 
   constructSolver();
 
+  createRefinement();
+
   // loadBathymetry(&m_bathymetryFilePath);
 
   if (m_useFileIO)
@@ -755,106 +1157,268 @@ void tsunami_lab::Simulator::prepareForCalculation()
   std::cout << "Preparation complete." << std::endl;
 }
 
-void tsunami_lab::Simulator::runCalculation()
+void tsunami_lab::Simulator::writeOutput(std::chrono::system_clock::time_point &io_lastWrite)
 {
-  m_calculationTime = 0;
-  m_timePerTimeStep = 0;
-  auto l_beginCalc = std::chrono::high_resolution_clock::now();
-  deriveTimeStep();
-  auto l_lastWrite = std::chrono::system_clock::now();
-  while (m_simTime < m_endTime && !m_shouldExit)
+  if (m_useFileIO)
   {
-    //------------------------------------------//
-    //---------------Write output---------------//
-    //------------------------------------------//
-    if (m_useFileIO)
+    if (m_timeStep % m_writingFrequency == 0)
     {
-      if (m_timeStep % m_writingFrequency == 0)
+      std::cout << "  simulation time / #time steps: "
+                << m_simTime << " / " << m_timeStep << std::endl;
+      if (m_activityThreshold >= 0)
       {
-        std::cout << "  simulation time / #time steps: "
-                  << m_simTime << " / " << m_timeStep << std::endl;
+        tsunami_lab::patches::WavePropagation::StepStatistics l_statistics = m_waveProp->getStepStatistics();
+        std::cout << "  computed tiles: "
+                  << l_statistics.nTilesComputed << " / " << l_statistics.nTilesX * l_statistics.nTilesY << std::endl;
+      }
+      if (m_localTimeStepLevels > 0 && m_ny > 1)
+      {
+        tsunami_lab::patches::WavePropagation::StepStatistics l_statistics = m_waveProp->getStepStatistics();
+        std::cout << "  cell updates: "
+                  << l_statistics.nCellUpdates << " / " << l_statistics.nCellUpdatesGlobal << std::endl;
+      }
+      if (m_ny > 1)
+      {
+        tsunami_lab::patches::WavePropagation::StepStatistics l_statistics = m_waveProp->getStepStatistics();
+        if (l_statistics.threadImbalance > 0)
+          std::cout << "  thread imbalance (max / avg busy time): " << l_statistics.threadImbalance << std::endl;
+      }
 
-        switch (m_dataWriter)
+      switch (m_dataWriter)
+      {
+      case NETCDF:
+      {
+        std::cout << "  writing to netcdf to " << m_netCdfOutputPathString << std::endl;
+        if (m_netCdfWriter != nullptr)
         {
-        case NETCDF:
+          m_netCdfWriter->write(m_netCdf,
+                                m_waveProp->getStride(),
+                                m_waveProp->getHeight(),
+                                m_waveProp->getMomentumX(),
+                                m_waveProp->getMomentumY(),
+                                m_waveProp->getBathymetry(),
+                                m_simTime);
+        }
+        else
         {
-          std::cout << "  writing to netcdf to " << m_netCdfOutputPathString << std::endl;
           m_netCdf->write(m_waveProp->getStride(),
                           m_waveProp->getHeight(),
                           m_waveProp->getMomentumX(),
                           m_waveProp->getMomentumY(),
                           m_waveProp->getBathymetry(),
                           m_simTime);
-          break;
         }
-        case CSV:
+        for (Nest &l_nest : m_refinementNests)
         {
-          std::string l_csvOutputPath = "solutions/" + m_outputFileName + "_" + std::to_string(m_nOut) + ".csv";
-          std::cout << "  writing wave field to " << l_csvOutputPath << std::endl;
-          std::ofstream l_file;
-          l_file.open(l_csvOutputPath);
-          tsunami_lab::io::Csv::write(m_dx,
-                                      m_dy,
-                                      m_nx,
-                                      m_ny,
-                                      m_waveProp->getStride(),
-                                      m_waveProp->getHeight(),
-                                      m_waveProp->getMomentumX(),
-                                      m_waveProp->getMomentumY(),
-                                      m_waveProp->getBathymetry(),
-                                      l_file);
-          l_file.close();
-          m_nOut++;
-          break;
-        }
+          if (l_nest.netCdf == nullptr)
+            continue;
+          // the ring of coupling cells is skipped
+          tsunami_lab::patches::WavePropagation *l_patch = m_refinement->getBlockPatch(l_nest.block);
+          tsunami_lab::t_idx l_first = 1 + l_patch->getStride();
+          if (m_netCdfWriter != nullptr)
+          {
+            m_netCdfWriter->write(l_nest.netCdf,
+                                  l_patch->getStride(),
+                                  l_patch->getHeight() + l_first,
+                                  l_patch->getMomentumX() + l_first,
+                                  l_patch->getMomentumY() + l_first,
+                                  l_patch->getBathymetry() + l_first,
+                                  m_simTime);
+          }
+          else
+          {
+            l_nest.netCdf->write(l_patch->getStride(),
+                                 l_patch->getHeight() + l_first,
+                                 l_patch->getMomentumX() + l_first,
+                                 l_patch->getMomentumY() + l_first,
+                                 l_patch->getBathymetry() + l_first,
+                                 m_simTime);
+          }
         }
+        break;
       }
-      // write stations
-      if (m_stationFrequency > 0 && m_simTime >= m_stationFrequency * m_captureCount)
+      case CSV:
       {
-        std::cout << "  capturing station data" << std::endl;
-        for (tsunami_lab::io::Station *l_s : m_stations)
-        {
-          l_s->capture(m_simTime);
-        }
-        ++m_captureCount;
+        std::string l_csvOutputPath = "solutions/" + m_outputFileName + "_" + std::to_string(m_nOut) + ".csv";
+        std::cout << "  writing wave field to " << l_csvOutputPath << std::endl;
+        std::ofstream l_file;
+        l_file.open(l_csvOutputPath);
+        tsunami_lab::io::Csv::write(m_dx,
+                                    m_dy,
+                                    m_nxLocal,
+                                    m_nyLocal,
+                                    m_waveProp->getStride(),
+                                    m_waveProp->getHeight(),
+                                    m_waveProp->getMomentumX(),
+                                    m_waveProp->getMomentumY(),
+                                    m_waveProp->getBathymetry(),
+                                    l_file);
+        l_file.close();
+        m_nOut++;
+        break;
+      }
       }
-      // write checkpoint
-      if (m_checkpointFrequency > 0 &&
-          std::chrono::system_clock::now() - l_lastWrite >= std::chrono::duration<float>(m_checkpointFrequency))
+    }
+    // write stations
+    if (m_stationFrequency > 0 && m_simTime >= m_stationFrequency * m_captureCount)
+    {
+      std::cout << "  capturing station data" << std::endl;
+      for (tsunami_lab::io::Station *l_s : m_stations)
       {
-        std::cout << "saving checkpoint to " << m_checkPointFilePathString << std::endl;
-        writeCheckpoint();
-        l_lastWrite = std::chrono::system_clock::now();
+        l_s->capture(m_simTime);
       }
+      ++m_captureCount;
     }
-
-    // pausing the simulation
-    while (m_pauseStatus)
+    // write checkpoint
+    if (m_checkpointFrequency > 0 &&
+        std::chrono::system_clock::now() - io_lastWrite >= std::chrono::duration<float>(m_checkpointFrequency))
     {
-      std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+      std::cout << "saving checkpoint to " << m_checkPointFilePathString << std::endl;
+      writeCheckpoint();
+      io_lastWrite = std::chrono::system_clock::now();
     }
+  }
+}
 
-    // BREAKPOINT
-    if (m_shouldExit)
-      return;
-    // END BREAKPOINT
+tsunami_lab::t_idx tsunami_lab::Simulator::countTimeSteps()
+{
+  tsunami_lab::t_idx l_nSteps = 1;
+  tsunami_lab::t_real l_simTime = m_simTime + m_dt;
+  while (l_nSteps < m_ghostWidth && l_simTime < m_endTime)
+  {
+    tsunami_lab::t_idx l_timeStep = m_timeStep + l_nSteps;
+
+    // the wave field and the stations are written between the time steps
+    if (m_useFileIO && (l_timeStep % m_writingFrequency == 0 ||
+                        (m_stationFrequency > 0 && l_simTime >= m_stationFrequency * m_captureCount)))
+      break;
+
+    // the maximum wave speed of the adapting time step is needed
+    if (m_adaptiveTimeStepFrequency > 0 && l_timeStep % m_adaptiveTimeStepFrequency == 0)
+      break;
+
+    l_nSteps++;
+    l_simTime += m_dt;
+  }
+  return l_nSteps;
+}
+
+void tsunami_lab::Simulator::runCalculation()
+{
+  m_calculationTime = 0;
+  m_timePerTimeStep = 0;
+  auto l_beginCalc = std::chrono::high_resolution_clock::now();
+  deriveTimeStep();
+  auto l_lastWrite = std::chrono::system_clock::now();
+
+  // state of the time loop, written by a single thread and read by all threads
+  tsunami_lab::t_idx l_nSteps = 0;
+  bool l_adaptTimeStep = false;
+  bool l_continue = true;
+
+#ifdef USEOMP
+#pragma omp parallel if (m_persistentParallelRegion && m_refinement == nullptr)
+#endif
+  while (true)
+  {
+    // a single thread completes the last time steps, writes the output and handles pause and exit requests
+#ifdef USEOMP
+#pragma omp single
+#endif
+    {
+      if (l_nSteps > 0)
+      {
+        m_timeStep += l_nSteps;
+        for (tsunami_lab::t_idx l_st = 0; l_st < l_nSteps; l_st++)
+          m_simTime += m_dt;
+
+        // the wave speed is reduced inside the time step, the next one satisfies the CFL condition for it
+        if (l_adaptTimeStep)
+        {
+#ifdef USEMPI
+          // all processes take the wave speed of the whole domain
+          if (m_decomposition != nullptr)
+            setTimeStep(m_decomposition->getMaxWaveSpeed());
+          else
+#endif
+            setTimeStep(m_waveProp->getMaxWaveSpeed());
+        }
+
+        auto l_durationTimeSteps = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - l_beginCalc);
+        m_timePerTimeStep = (double)l_durationTimeSteps.count() / m_timeStep;
+      }
+
+      l_continue = m_simTime < m_endTime && !m_shouldExit;
+      if (l_continue)
+      {
+        //------------------------------------------//
+        //---------------Write output---------------//
+        //------------------------------------------//
+        writeOutput(l_lastWrite);
+
+        // pausing the simulation
+        while (m_pauseStatus)
+        {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        }
 
-    //------------------------------------------//
-    //------------Update loop params------------//
-    //------------------------------------------//
-    m_waveProp->setGhostOutflow();
-    m_waveProp->timeStep(m_scalingX, m_scalingY);
-    m_timeStep++;
-    m_simTime += m_dt;
+        // BREAKPOINT
+        l_continue = !m_shouldExit;
+        // END BREAKPOINT
+      }
 
-    auto l_durationTimeSteps = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - l_beginCalc);
-    m_timePerTimeStep = (double)l_durationTimeSteps.count() / m_timeStep;
+      //------------------------------------------//
+      //------------Update loop params------------//
+      //------------------------------------------//
+      l_nSteps = countTimeSteps();
+      l_adaptTimeStep = m_adaptiveTimeStepFrequency > 0 &&
+                        (m_timeStep + l_nSteps) % m_adaptiveTimeStepFrequency == 0;
+      m_waveProp->setMaxWaveSpeedTracking(l_adaptTimeStep);
+    }
+    if (!l_continue)
+      break;
+
+    // inside the persistent region, all threads share the ghost cells and the time steps;
+    // the refinement steps the patches one after another, each of them in its own parallel region
+    if (m_refinement != nullptr)
+    {
+      for (tsunami_lab::t_idx l_st = 0; l_st < l_nSteps; l_st++)
+        m_refinement->timeStep(m_scalingX, m_scalingY);
+    }
+#ifdef USEMPI
+    // the processes exchange their halo cells in every time step
+    else if (m_decomposition != nullptr)
+    {
+      for (tsunami_lab::t_idx l_st = 0; l_st < l_nSteps; l_st++)
+        m_decomposition->timeStep(m_scalingX, m_scalingY);
+    }
+#endif
+    else
+    {
+      m_waveProp->timeSteps(l_nSteps, m_scalingX, m_scalingY);
+    }
   }
 
   auto l_endCalc = std::chrono::high_resolution_clock::now();
   auto l_durationCalc = std::chrono::duration_cast<std::chrono::milliseconds>(l_endCalc - l_beginCalc);
   m_calculationTime = l_durationCalc.count();
+
+  // the load balance of the tasks of the tiles
+  if (m_taskTileRows > 0 && m_ny > 1)
+  {
+    std::vector<double> l_busy, l_idle;
+    m_waveProp->getTaskTimes(l_busy, l_idle);
+    std::cout << "Time of the threads in the tasks of the tiles:" << std::endl;
+    for (tsunami_lab::t_idx l_th = 0; l_th < l_busy.size(); l_th++)
+      std::cout << "  thread " << l_th << ": busy " << l_busy[l_th] << " s, idle " << l_idle[l_th] << " s" << std::endl;
+  }
+}
+
+double tsunami_lab::Simulator::computeEstimatedTimeLeft()
+{
+  if (m_timeStepMax <= m_timeStep)
+    return 0;
+  return (m_timeStepMax - m_timeStep) * m_timePerTimeStep / 1000;
 }
 
 //-------------------------------------------//
@@ -904,7 +1468,15 @@ int tsunami_lab::Simulator::start(std::string i_config)
   std::cout << "finished time loop" << std::endl;
 
   // write to netcdf if there is still unwritten data in the buffer
+  if (m_netCdfWriter != nullptr)
+  {
+    m_netCdfWriter->wait();
+    std::cout << "time waited for the netcdf output: " << m_netCdfWriter->getWaitTime() << " s" << std::endl;
+  }
   m_netCdf->flush();
+  for (Nest &l_nest : m_refinementNests)
+    if (l_nest.netCdf != nullptr)
+      l_nest.netCdf->flush();
 
   // write station data to files
   if (m_useFileIO)
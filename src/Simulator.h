@@ -16,6 +16,10 @@
 // waveprop patches
 #include "patches/WavePropagation1d.h"
 #include "patches/WavePropagation2d.h"
+#include "patches/Refinement2d.h"
+#ifdef USEMPI
+#include "patches/Decomposition2d.h"
+#endif
 
 // setups
 #include "setups/DamBreak1d.h"
@@ -34,6 +38,7 @@
 #include "io/BathymetryLoader.h"
 #include "io/Station.h"
 #include "io/NetCdf.h"
+#include "io/NetCdfWriter.h"
 
 // external libraries
 #include <nlohmann/json.hpp>
@@ -41,6 +46,7 @@
 
 #include <string>
 #include <atomic>
+#include <chrono>
 using json = nlohmann::json;
 using Boundary = tsunami_lab::patches::WavePropagation::Boundary;
 
@@ -85,6 +91,9 @@ private:
     };
     DataWriter m_dataWriter = NETCDF;
     tsunami_lab::io::NetCdf *m_netCdf = nullptr;
+    // asynchronous output of the netcdf files, nullptr writes on the simulation thread
+    tsunami_lab::io::NetCdfWriter *m_netCdfWriter = nullptr;
+    tsunami_lab::t_idx m_asyncOutputFrames = 0;
 
     // checkpointing
     bool m_checkpointExists = false;
@@ -98,6 +107,9 @@ private:
 
     // simulation parameters
     std::string m_solver = "";
+    bool m_inPlaceUpdates = false;
+    bool m_hugePages = false;
+    bool m_persistentParallelRegion = false;
     tsunami_lab::patches::WavePropagation *m_waveProp = nullptr;
     tsunami_lab::t_idx m_nx = 0;
     tsunami_lab::t_idx m_ny = 0;
@@ -129,6 +141,56 @@ private:
     tsunami_lab::t_idx m_nOut = 0;
     tsunami_lab::t_idx m_captureCount = 0;
     tsunami_lab::t_real m_timeStepScaling = 1;
+    tsunami_lab::t_idx m_adaptiveTimeStepFrequency = 0;
+    tsunami_lab::t_real m_activityThreshold = -1;
+    tsunami_lab::t_idx m_stripWidth = 0;
+    tsunami_lab::t_idx m_ghostWidth = 1;
+    tsunami_lab::t_idx m_taskTileRows = 0;
+    tsunami_lab::t_idx m_loadBalanceSteps = 0;
+    bool m_shareCellQuantities = false;
+    bool m_quantizedBathymetry = false;
+    tsunami_lab::t_real m_linearDepth = 0;
+    tsunami_lab::t_real m_linearAmplitudeRatio = 0.01;
+    tsunami_lab::t_idx m_localTimeStepLevels = 0;
+    tsunami_lab::patches::Refinement2d *m_refinement = nullptr;
+    tsunami_lab::t_idx m_refinementRatio = 0;
+    tsunami_lab::t_idx m_refinementBlockSize = 16;
+    tsunami_lab::t_idx m_refinementRegridFrequency = 10;
+    tsunami_lab::t_real m_refinementAmplitude = 0;
+    tsunami_lab::t_real m_refinementDepthGradient = 0;
+    tsunami_lab::t_real m_refinementCoastDepth = 0;
+    tsunami_lab::t_real m_refinementStationRadius = -1;
+
+    // processes of the domain decomposition and the subdomain of this one, the whole domain with a single process
+    int m_mpiRank = 0;
+    int m_nMpiRanks = 1;
+    tsunami_lab::t_idx m_firstCellX = 0;
+    tsunami_lab::t_idx m_firstCellY = 0;
+    tsunami_lab::t_idx m_nxLocal = 0;
+    tsunami_lab::t_idx m_nyLocal = 0;
+#ifdef USEMPI
+    tsunami_lab::patches::Decomposition2d *m_decomposition = nullptr;
+#endif
+
+    // fixed nests of the refinement
+    struct Nest
+    {
+        std::string name;
+        tsunami_lab::t_real x0 = 0;
+        tsunami_lab::t_real y0 = 0;
+        tsunami_lab::t_real x1 = 0;
+        tsunami_lab::t_real y1 = 0;
+        tsunami_lab::t_idx ratio = 2;
+        tsunami_lab::t_idx nSteps = 0;
+        bool output = false;
+        // id of the block in the refinement, -1 if the nest was rejected
+        long block = -1;
+        std::string outputPath;
+        tsunami_lab::io::NetCdf *netCdf = nullptr;
+    };
+    std::vector<Nest> m_refinementNests;
+    // stations in the fine cells of a nest and the id of the nest
+    std::vector<std::pair<tsunami_lab::io::Station *, tsunami_lab::t_idx>> m_nestStations;
 
     // simulation variables
     tsunami_lab::t_real m_hMax = std::numeric_limits<tsunami_lab::t_real>::lowest();
@@ -183,6 +245,13 @@ private:
      */
     void setUpNetCdf();
 
+    /**
+     *  Splits the domain into the subdomains of the MPI processes if there are several of them.
+     *
+     *  @return void
+     */
+    void createDecomposition();
+
     /**
      *  Creates a WavePropagation object.
      *
@@ -197,6 +266,13 @@ private:
      */
     void constructSolver();
 
+    /**
+     *  Creates the block-structured refinement of the 2d patch if it is enabled.
+     *
+     *  @return void
+     */
+    void createRefinement();
+
     /**
      *  Helper method that loads bathymetry from a .csv file into the wave propagation patch.
      *
@@ -219,6 +295,15 @@ private:
      */
     void deriveTimeStep();
 
+    /**
+     *  Sets the time step, the scalings and the number of remaining time steps
+     *  such that the CFL condition holds for the given wave speed.
+     *
+     *  @param i_speedMax maximum wave speed.
+     *  @return void
+     */
+    void setTimeStep(tsunami_lab::t_real i_speedMax);
+
     //-------------------------------------------//
     //-------------PRIVATE DELETERS--------------//
     //-------------------------------------------//
@@ -532,8 +617,25 @@ private:
      */
     void prepareForCalculation();
 
+    /**
+     *  Writes the wave field, the station data and the checkpoint if they are due.
+     *
+     *  @param io_lastWrite time of the last checkpoint; updated if a checkpoint is written.
+     *  @return void
+     */
+    void writeOutput(std::chrono::system_clock::time_point &io_lastWrite);
+
+    /**
+     *  Counts the time steps which can be performed at once, up to the ghost width.
+     *  The count stops before the end time, the next output and the next adaption of the time step.
+     *
+     *  @return number of time steps, at least 1.
+     */
+    tsunami_lab::t_idx countTimeSteps();
+
     /**
      *  Starts the calculation with the set parameters.
+     *  With a persistent parallel region, the threads stay in one team for the whole time loop.
      *
      *  @return void
      */
@@ -581,6 +683,12 @@ private:
         m_pauseStatus = i_pauseStatus;
     };
 
+    /**
+     *  Estimates the remaining computation time from the average time per time step.
+     *  Follows the number of remaining time steps if the time step is adapted.
+     *
+     *  @return estimated time left in seconds.
+     */
     double computeEstimatedTimeLeft();
 };
 
@@ -6,6 +6,7 @@
  * Interface for NetCdf
  **/
 #include "NetCdf.h"
+#include <algorithm>
 #include <iostream>
 #include <netcdf.h>
 #ifndef BENCHMARK
@@ -62,8 +63,9 @@ void tsunami_lab::io::NetCdf::setUpFile(const char *i_file)
         int l_i = 0;
         t_real *l_y = new t_real[m_nky]{0};
         t_real *l_x = new t_real[m_nkx]{0};
-        t_real l_averagingFactor = 1 / m_k;
-        for (t_idx l_gy = 0; l_gy < m_ny; l_gy += m_k)
+        // the coordinates of a group are the averages of its cells, the cells of incomplete groups are dropped
+        t_real l_averagingFactor = t_real(1) / t_real(m_k);
+        for (t_idx l_gy = 0; l_gy + m_k <= m_ny; l_gy += m_k)
         {
             for (t_idx l_iy = 0; l_iy < m_k; l_iy++)
             {
@@ -73,7 +75,7 @@ void tsunami_lab::io::NetCdf::setUpFile(const char *i_file)
             l_i++;
         }
         l_i = 0;
-        for (t_idx l_gx = 0; l_gx < m_nx; l_gx += m_k)
+        for (t_idx l_gx = 0; l_gx + m_k <= m_nx; l_gx += m_k)
         {
             for (t_idx l_ix = 0; l_ix < m_k; l_ix++)
             {
@@ -454,166 +456,294 @@ tsunami_lab::io::NetCdf::~NetCdf()
     m_outputFileOpened = false;
 }
 
-void tsunami_lab::io::NetCdf::write(t_idx i_stride,
-                                    t_real const *i_h,
-                                    t_real const *i_hu,
-                                    t_real const *i_hv,
-                                    t_real const *i_b,
-                                    t_real i_t)
+/**
+ * Sums a quantity or the sum of two quantities over a row of the groups of cells; a group spans k cells in x-direction.
+ **/
+static void accumulateRow(tsunami_lab::t_idx i_nkx,
+                          tsunami_lab::t_idx i_k,
+                          tsunami_lab::t_real const *i_a,
+                          tsunami_lab::t_real const *i_b,
+                          tsunami_lab::t_real *io_sums)
+{
+    for (tsunami_lab::t_idx l_x = 0; l_x < i_k; l_x++)
+    {
+        if (i_b == nullptr)
+        {
+#pragma omp simd
+            for (tsunami_lab::t_idx l_gx = 0; l_gx < i_nkx; l_gx++)
+                io_sums[l_gx] += i_a[l_gx * i_k + l_x];
+        }
+        else
+        {
+#pragma omp simd
+            for (tsunami_lab::t_idx l_gx = 0; l_gx < i_nkx; l_gx++)
+                io_sums[l_gx] += i_a[l_gx * i_k + l_x] + i_b[l_gx * i_k + l_x];
+        }
+    }
+}
+
+/**
+ * Averages the groups of k x k cells of all output variables in one pass over the rows of the cells, which stay in the cache for all variables.
+ * An output is skipped if it is nullptr and zero if its quantities are nullptr; the cells of a group are summed in row-major order.
+ **/
+static void coarsenCells(tsunami_lab::t_idx i_nkx,
+                         tsunami_lab::t_idx i_nky,
+                         tsunami_lab::t_idx i_k,
+                         tsunami_lab::t_idx i_stride,
+                         tsunami_lab::t_real const *i_h,
+                         tsunami_lab::t_real const *i_hu,
+                         tsunami_lab::t_real const *i_hv,
+                         tsunami_lab::t_real const *i_b,
+                         tsunami_lab::t_real *o_h,
+                         tsunami_lab::t_real *o_totalH,
+                         tsunami_lab::t_real *o_hu,
+                         tsunami_lab::t_real *o_hv,
+                         tsunami_lab::t_real *o_b)
+{
+    tsunami_lab::t_real l_averagingFactor = tsunami_lab::t_real(1) / tsunami_lab::t_real(i_k * i_k);
+    tsunami_lab::t_real *l_outputs[5] = {o_h, o_totalH, o_hu, o_hv, o_b};
+    tsunami_lab::t_real const *l_inputs[5] = {i_h, i_h, i_hu, i_hv, i_b};
+    tsunami_lab::t_real const *l_addends[5] = {nullptr, i_b, nullptr, nullptr, nullptr};
+
+    // the total heights need both quantities
+    if (i_b == nullptr)
+        l_inputs[1] = nullptr;
+
+#ifdef USEOMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (tsunami_lab::t_idx l_gy = 0; l_gy < i_nky; l_gy++)
+    {
+        for (int l_va = 0; l_va < 5; l_va++)
+        {
+            if (l_outputs[l_va] != nullptr)
+                std::fill_n(l_outputs[l_va] + l_gy * i_nkx, i_nkx, tsunami_lab::t_real(0));
+        }
+
+        for (tsunami_lab::t_idx l_y = 0; l_y < i_k; l_y++)
+        {
+            tsunami_lab::t_idx l_row = (l_gy * i_k + l_y) * i_stride;
+            for (int l_va = 0; l_va < 5; l_va++)
+            {
+                if (l_outputs[l_va] == nullptr || l_inputs[l_va] == nullptr)
+                    continue;
+                accumulateRow(i_nkx,
+                              i_k,
+                              l_inputs[l_va] + l_row,
+                              l_addends[l_va] == nullptr ? nullptr : l_addends[l_va] + l_row,
+                              l_outputs[l_va] + l_gy * i_nkx);
+            }
+        }
+
+        for (int l_va = 0; l_va < 5; l_va++)
+        {
+            if (l_outputs[l_va] == nullptr || i_k == 1)
+                continue;
+            tsunami_lab::t_real *l_output = l_outputs[l_va] + l_gy * i_nkx;
+#pragma omp simd
+            for (tsunami_lab::t_idx l_gx = 0; l_gx < i_nkx; l_gx++)
+                l_output[l_gx] *= l_averagingFactor;
+        }
+    }
+}
+
+void tsunami_lab::io::NetCdf::coarsen(t_idx i_stride,
+                                      t_real const *i_h,
+                                      t_real const *i_hu,
+                                      t_real const *i_hv,
+                                      t_real const *i_b,
+                                      t_real i_t,
+                                      Frame &o_frame)
+{
+    // the buffers keep their capacity, only the first frame allocates them
+    t_idx l_nValues = m_nkx * m_nky;
+    o_frame.t = i_t;
+    o_frame.h.resize(l_nValues);
+    o_frame.totalH.resize(l_nValues);
+    o_frame.hu.resize(l_nValues);
+    o_frame.hv.resize(l_nValues);
+
+    // the bathymetry is written with the first frame of the file
+    o_frame.b.clear();
+    if (m_nFramesCoarsened == 0)
+        o_frame.b.resize(l_nValues);
+
+    coarsenCells(m_nkx,
+                 m_nky,
+                 m_k,
+                 i_stride,
+                 i_h,
+                 i_hu,
+                 i_hv,
+                 i_b,
+                 o_frame.h.data(),
+                 o_frame.totalH.data(),
+                 o_frame.hu.data(),
+                 o_frame.hv.data(),
+                 o_frame.b.empty() ? nullptr : o_frame.b.data());
+
+    m_nFramesCoarsened++;
+}
+
+void tsunami_lab::io::NetCdf::writeFrame(Frame const &i_frame)
 {
     t_idx start[] = {m_writingStepsCount, 0, 0};
     t_idx count[] = {1, m_nky, m_nkx};
-    t_real *l_data = new t_real[m_nkx * m_nky];
-    int l_i = 0;
-
-    t_real l_averagingFactor = 1 / m_k * m_k;
 
     // set up file and write bathymetry on first call
     if (!m_outputFileOpened)
     {
         setUpFile(m_netcdfOutputFile);
     }
-    if (m_writingStepsCount == 0)
+    if (!i_frame.b.empty())
     {
-        t_real *l_b = new t_real[m_nkx * m_nky]{0};
-        l_i = 0;
-        if (i_b != nullptr)
-        {
-            for (t_idx l_gy = 0; l_gy < m_ny; l_gy += m_k)
-            {
-                for (t_idx l_gx = 0; l_gx < m_nx; l_gx += m_k)
-                {
-                    for (t_idx l_y = 0; l_y < m_k; l_y++)
-                    {
-                        for (t_idx l_x = 0; l_x < m_k; l_x++)
-                        {
-                            l_b[l_i] += i_b[l_gx + l_x + (l_y + l_gy) * i_stride];
-                        }
-                    }
-                    l_b[l_i] *= l_averagingFactor;
-                    l_i++;
-                }
-            }
-        }
         checkNcErr(nc_put_var_float(m_ncId,
                                     m_varBId,
-                                    l_b));
-        delete[] l_b;
+                                    i_frame.b.data()));
     }
     // WRITE TIME
     checkNcErr(nc_put_var1_float(m_ncId,
                                  m_varTId,
                                  &m_writingStepsCount,
-                                 &i_t));
+                                 &i_frame.t));
     // WRITE HEIGHT
-    l_i = 0;
-    memset(l_data, 0, m_nkx * m_nky * sizeof(t_real));
-    if (i_h != nullptr)
-    {
-        for (t_idx l_gy = 0; l_gy < m_ny; l_gy += m_k)
-        {
-            for (t_idx l_gx = 0; l_gx < m_nx; l_gx += m_k)
-            {
-                for (t_idx l_y = 0; l_y < m_k; l_y++)
-                {
-                    for (t_idx l_x = 0; l_x < m_k; l_x++)
-                    {
-                        l_data[l_i] += i_h[l_gx + l_x + (l_y + l_gy) * i_stride];
-                    }
-                }
-                l_data[l_i] *= l_averagingFactor;
-                l_i++;
-            }
-        }
-    }
     checkNcErr(nc_put_vara_float(m_ncId,
                                  m_varHId,
                                  start,
                                  count,
-                                 l_data));
+                                 i_frame.h.data()));
     // WRITE TOTAL HEIGHT
-    l_i = 0;
-    memset(l_data, 0, m_nkx * m_nky * sizeof(t_real));
-    if (i_h != nullptr && i_b != nullptr)
-    {
-        for (t_idx l_gy = 0; l_gy < m_ny; l_gy += m_k)
-        {
-            for (t_idx l_gx = 0; l_gx < m_nx; l_gx += m_k)
-            {
-                for (t_idx l_y = 0; l_y < m_k; l_y++)
-                {
-                    for (t_idx l_x = 0; l_x < m_k; l_x++)
-                    {
-                        l_data[l_i] += i_h[l_gx + l_x + (l_y + l_gy) * i_stride] + i_b[l_gx + l_x + (l_y + l_gy) * i_stride];
-                    }
-                }
-                l_data[l_i] *= l_averagingFactor;
-                l_i++;
-            }
-        }
-    }
     checkNcErr(nc_put_vara_float(m_ncId,
                                  m_varTHId,
                                  start,
                                  count,
-                                 l_data));
+                                 i_frame.totalH.data()));
     // WRITE MOMENTUM X
-    l_i = 0;
-    memset(l_data, 0, m_nkx * m_nky * sizeof(t_real));
-    if (i_hu != nullptr)
-    {
-        for (t_idx l_gy = 0; l_gy < m_ny; l_gy += m_k)
-        {
-            for (t_idx l_gx = 0; l_gx < m_nx; l_gx += m_k)
-            {
-                for (t_idx l_y = 0; l_y < m_k; l_y++)
-                {
-                    for (t_idx l_x = 0; l_x < m_k; l_x++)
-                    {
-                        l_data[l_i] += i_hu[l_gx + l_x + (l_y + l_gy) * i_stride];
-                    }
-                }
-                l_data[l_i] *= l_averagingFactor;
-                l_i++;
-            }
-        }
-    }
     checkNcErr(nc_put_vara_float(m_ncId,
                                  m_varHuId,
                                  start,
                                  count,
-                                 l_data));
-
+                                 i_frame.hu.data()));
     // WRITE MOMENTUM Y
-    l_i = 0;
-    memset(l_data, 0, m_nkx * m_nky * sizeof(t_real));
-    if (i_hv != nullptr)
+    checkNcErr(nc_put_vara_float(m_ncId,
+                                 m_varHvId,
+                                 start,
+                                 count,
+                                 i_frame.hv.data()));
+
+    m_writingStepsCount++;
+}
+
+void tsunami_lab::io::NetCdf::putCells(int i_varId,
+                                       t_idx const *i_start,
+                                       t_idx const *i_count,
+                                       std::ptrdiff_t const *i_imap,
+                                       t_real const *i_data)
+{
+    // missing quantities are written as zeros, which are stored densely
+    if (i_data == nullptr)
     {
-        for (t_idx l_gy = 0; l_gy < m_ny; l_gy += m_k)
-        {
-            for (t_idx l_gx = 0; l_gx < m_nx; l_gx += m_k)
-            {
-                for (t_idx l_y = 0; l_y < m_k; l_y++)
-                {
-                    for (t_idx l_x = 0; l_x < m_k; l_x++)
-                    {
-                        l_data[l_i] += i_hv[l_gx + l_x + (l_y + l_gy) * i_stride];
-                    }
-                }
-                l_data[l_i] *= l_averagingFactor;
-                l_i++;
-            }
-        }
+        m_zeros.resize(m_nx * m_ny, 0);
+        checkNcErr(nc_put_vara_float(m_ncId,
+                                     i_varId,
+                                     i_start,
+                                     i_count,
+                                     m_zeros.data()));
+        return;
     }
+    checkNcErr(nc_put_varm_float(m_ncId,
+                                 i_varId,
+                                 i_start,
+                                 i_count,
+                                 nullptr,
+                                 i_imap,
+                                 i_data));
+}
+
+void tsunami_lab::io::NetCdf::writeCells(t_idx i_stride,
+                                         t_real const *i_h,
+                                         t_real const *i_hu,
+                                         t_real const *i_hv,
+                                         t_real const *i_b,
+                                         t_real i_t)
+{
+    t_idx start[] = {m_writingStepsCount, 0, 0};
+    t_idx count[] = {1, m_ny, m_nx};
+    // distances of the cells in memory per dimension: time, y and x
+    std::ptrdiff_t l_imap[] = {std::ptrdiff_t(m_ny * i_stride), std::ptrdiff_t(i_stride), 1};
+
+    if (!m_outputFileOpened)
+    {
+        setUpFile(m_netcdfOutputFile);
+    }
+    if (m_nFramesCoarsened == 0)
+    {
+        putCells(m_varBId,
+                 start + 1,
+                 count + 1,
+                 l_imap + 1,
+                 i_b);
+    }
+    checkNcErr(nc_put_var1_float(m_ncId,
+                                 m_varTId,
+                                 &m_writingStepsCount,
+                                 &i_t));
+    putCells(m_varHId, start, count, l_imap, i_h);
+    putCells(m_varHuId, start, count, l_imap, i_hu);
+    putCells(m_varHvId, start, count, l_imap, i_hv);
+
+    // the total heights are the only derived variable
+    m_frame.totalH.resize(m_nx * m_ny);
+    coarsenCells(m_nx,
+                 m_ny,
+                 1,
+                 i_stride,
+                 i_h,
+                 nullptr,
+                 nullptr,
+                 i_b,
+                 nullptr,
+                 m_frame.totalH.data(),
+                 nullptr,
+                 nullptr,
+                 nullptr);
     checkNcErr(nc_put_vara_float(m_ncId,
-                                 m_varHvId,
+                                 m_varTHId,
                                  start,
                                  count,
-                                 l_data));
+                                 m_frame.totalH.data()));
 
+    m_nFramesCoarsened++;
     m_writingStepsCount++;
+}
 
-    delete[] l_data;
+void tsunami_lab::io::NetCdf::write(t_idx i_stride,
+                                    t_real const *i_h,
+                                    t_real const *i_hu,
+                                    t_real const *i_hv,
+                                    t_real const *i_b,
+                                    t_real i_t)
+{
+    // ungrouped cells are written straight from the arrays of the patch
+    if (m_k == 1)
+    {
+        writeCells(i_stride,
+                   i_h,
+                   i_hu,
+                   i_hv,
+                   i_b,
+                   i_t);
+        return;
+    }
+
+    coarsen(i_stride,
+            i_h,
+            i_hu,
+            i_hv,
+            i_b,
+            i_t,
+            m_frame);
+    writeFrame(m_frame);
 }
 
 void tsunami_lab::io::NetCdf::getDimensionSize(const char *i_file,
@@ -913,6 +1043,7 @@ void tsunami_lab::io::NetCdf::loadCheckpointDimensions(const char *i_checkpointF
     // start over in case the solution got lost
     if (!m_doesSolutionExist)
         m_writingStepsCount = 0;
+    m_nFramesCoarsened = m_writingStepsCount;
 
     checkNcErr(nc_close(l_ncIdCheckRead));
 }
@@ -9,7 +9,9 @@
 #define TSUNAMI_LAB_IO_NETCDF
 
 #include "../constants.h"
+#include <cstddef>
 #include <cstring>
+#include <vector>
 #include "Station.h"
 
 namespace tsunami_lab
@@ -22,6 +24,21 @@ namespace tsunami_lab
 
 class tsunami_lab::io::NetCdf
 {
+public:
+    //! output values of a time step, which coarsen fills and writeFrame writes
+    struct Frame
+    {
+        //! simulation time
+        t_real t = 0;
+        //! water heights, total heights and momenta in x- and y-direction of the groups of cells
+        std::vector<t_real> h;
+        std::vector<t_real> totalH;
+        std::vector<t_real> hu;
+        std::vector<t_real> hv;
+        //! bathymetry of the groups of cells, empty except for the first frame of the file
+        std::vector<t_real> b;
+    };
+
 private:
     // amount of cells in x direction
     t_idx m_nx = 0;
@@ -95,6 +112,15 @@ private:
     // index for timesteps
     t_idx m_writingStepsCount = 0;
 
+    // number of coarsened frames, ahead of the written ones while frames are queued
+    t_idx m_nFramesCoarsened = 0;
+
+    // buffers of the synchronous writes, kept between the calls
+    Frame m_frame;
+
+    // zeros which replace missing quantities of the cells
+    std::vector<t_real> m_zeros;
+
     // tracks if file was opened for writing
     bool m_outputFileOpened = false;
 
@@ -112,6 +138,38 @@ private:
      */
     void setUpCheckpointFile(const char *i_checkpointFile);
 
+    /**
+     * Writes a variable of the cells from a strided array, or zeros.
+     *
+     * @param i_varId id of the variable
+     * @param i_start first index per dimension
+     * @param i_count number of values per dimension
+     * @param i_imap distance of the values in memory per dimension
+     * @param i_data values, nullptr writes zeros
+     */
+    void putCells(int i_varId,
+                  t_idx const *i_start,
+                  t_idx const *i_count,
+                  std::ptrdiff_t const *i_imap,
+                  t_real const *i_data);
+
+    /**
+     * Writes the cells of a time step without grouping; the arrays of the patch are passed to netcdf without copies.
+     *
+     * @param i_stride stride
+     * @param i_h water heights
+     * @param i_hu momentum x-direction
+     * @param i_hv momentum y-direction
+     * @param i_b bathymetry
+     * @param i_t current timestep
+     */
+    void writeCells(t_idx i_stride,
+                    t_real const *i_h,
+                    t_real const *i_hu,
+                    t_real const *i_hv,
+                    t_real const *i_b,
+                    t_real i_t);
+
     /**
      * Loads dimension and variable ids from an existing netcdf file.
      *
@@ -156,6 +214,33 @@ public:
      */
     ~NetCdf();
 
+    /**
+     * Averages the groups of cells of a time step into a frame; the bathymetry is part of the first frame only.
+     * Frames have to be written in the order in which they were coarsened.
+     *
+     * @param i_stride stride
+     * @param i_h water heights
+     * @param i_hu momentum x-direction
+     * @param i_hv momentum y-direction
+     * @param i_b bathymetry
+     * @param i_t current timestep
+     * @param o_frame will be set to the output values, its buffers are reused
+     */
+    void coarsen(t_idx i_stride,
+                 t_real const *i_h,
+                 t_real const *i_hu,
+                 t_real const *i_hv,
+                 t_real const *i_b,
+                 t_real i_t,
+                 Frame &o_frame);
+
+    /**
+     * Writes a coarsened frame into netcdf file
+     *
+     * @param i_frame output values of a time step
+     */
+    void writeFrame(Frame const &i_frame);
+
     /**
      * Writes data into netcdf file
      *
@@ -16,6 +16,7 @@
 #define private public
 #include "NetCdf.h"
 #undef public
+#include "NetCdfWriter.h"
 
 #ifndef BENCHMARK
 TEST_CASE("Test NetCdf reading and writing functionality", "[NetCdf], [ReadFile], [WriteFile]")
@@ -231,4 +232,127 @@ TEST_CASE("Test NetCdf checkpointing functionality", "[NetCdf], [Checkpoint]")
     delete[] l_huRead;
     delete[] l_hvRead;
 }
+
+TEST_CASE("Test the asynchronous NetCdf writer", "[NetCdf], [WriteFile]")
+{
+    // setup: a single pooled frame, thus the second file waits for the first one
+    tsunami_lab::t_idx l_x = 10, l_y = 10;
+    const char *l_netCdfFiles[2] = {"resources/netCdfTestAsync0.nc", "resources/netCdfTestAsync1.nc"};
+    tsunami_lab::io::NetCdf *l_netCdfs[2] = {nullptr, nullptr};
+    for (int l_fi = 0; l_fi < 2; l_fi++)
+    {
+        std::filesystem::remove(l_netCdfFiles[l_fi]);
+        l_netCdfs[l_fi] = new tsunami_lab::io::NetCdf(l_x,
+                                                      l_y,
+                                                      1,
+                                                      l_x,
+                                                      l_y,
+                                                      0,
+                                                      0,
+                                                      l_netCdfFiles[l_fi],
+                                                      "");
+    }
+
+    tsunami_lab::t_real *l_h = new tsunami_lab::t_real[l_x * l_y];
+    tsunami_lab::t_real *l_b = new tsunami_lab::t_real[l_x * l_y];
+    tsunami_lab::io::NetCdfWriter *l_writer = new tsunami_lab::io::NetCdfWriter(1);
+    for (int l_fi = 0; l_fi < 2; l_fi++)
+    {
+        for (tsunami_lab::t_idx l_i = 0; l_i < l_x * l_y; l_i++)
+        {
+            l_h[l_i] = l_i + 100 * l_fi;
+            l_b[l_i] = -tsunami_lab::t_real(l_i);
+        }
+        // the writer keeps a copy, the arrays may change right away
+        l_writer->write(l_netCdfs[l_fi],
+                        l_x,
+                        l_h,
+                        nullptr,
+                        nullptr,
+                        l_b,
+                        0);
+    }
+
+    // the destructor writes the queued frames
+    delete l_writer;
+    for (int l_fi = 0; l_fi < 2; l_fi++)
+        delete l_netCdfs[l_fi];
+
+    tsunami_lab::t_real *l_hRead = new tsunami_lab::t_real[l_x * l_y];
+    tsunami_lab::t_real *l_bRead = new tsunami_lab::t_real[l_x * l_y];
+    for (int l_fi = 0; l_fi < 2; l_fi++)
+    {
+        tsunami_lab::io::NetCdf::read(l_netCdfFiles[l_fi], "height", &l_hRead);
+        tsunami_lab::io::NetCdf::read(l_netCdfFiles[l_fi], "bathymetry", &l_bRead);
+        for (tsunami_lab::t_idx l_i = 0; l_i < l_x * l_y; l_i++)
+        {
+            REQUIRE(l_hRead[l_i] == l_i + 100 * l_fi);
+            REQUIRE(l_bRead[l_i] == -tsunami_lab::t_real(l_i));
+        }
+        std::filesystem::remove(l_netCdfFiles[l_fi]);
+    }
+
+    delete[] l_h;
+    delete[] l_b;
+    delete[] l_hRead;
+    delete[] l_bRead;
+}
+TEST_CASE("Test the coarsening of the NetCdf output", "[NetCdf], [Coarsen]")
+{
+    // 6 x 4 cells with a stride of 8, grouped into 3 x 2 groups of 2 x 2 cells
+    tsunami_lab::t_idx l_stride = 8;
+    tsunami_lab::t_real l_h[32], l_hu[32], l_b[32];
+    for (tsunami_lab::t_idx l_ce = 0; l_ce < 32; l_ce++)
+    {
+        l_h[l_ce] = tsunami_lab::t_real(l_ce);
+        l_hu[l_ce] = 2 * tsunami_lab::t_real(l_ce);
+        l_b[l_ce] = -1;
+    }
+
+    for (tsunami_lab::t_idx l_k : {1, 2})
+    {
+        tsunami_lab::io::NetCdf l_netCdf(6,
+                                         4,
+                                         l_k,
+                                         6,
+                                         4,
+                                         0,
+                                         0,
+                                         "resources/netCdfTestCoarsen.nc",
+                                         "");
+        tsunami_lab::io::NetCdf::Frame l_frame;
+        for (int l_fr = 0; l_fr < 2; l_fr++)
+        {
+            l_netCdf.coarsen(l_stride,
+                             l_h,
+                             l_hu,
+                             nullptr,
+                             l_b,
+                             tsunami_lab::t_real(l_fr),
+                             l_frame);
+
+            tsunami_lab::t_idx l_nkx = 6 / l_k;
+            tsunami_lab::t_idx l_nky = 4 / l_k;
+            REQUIRE(l_frame.t == tsunami_lab::t_real(l_fr));
+            REQUIRE(l_frame.h.size() == l_nkx * l_nky);
+            REQUIRE(l_frame.b.size() == (l_fr == 0 ? l_nkx * l_nky : 0));
+            for (tsunami_lab::t_idx l_gy = 0; l_gy < l_nky; l_gy++)
+            {
+                for (tsunami_lab::t_idx l_gx = 0; l_gx < l_nkx; l_gx++)
+                {
+                    // the average of a group is the value of its center
+                    tsunami_lab::t_real l_center = l_gx * l_k + (l_k - 1) * 0.5f + (l_gy * l_k + (l_k - 1) * 0.5f) * l_stride;
+                    tsunami_lab::t_idx l_gr = l_gx + l_gy * l_nkx;
+                    REQUIRE(l_frame.h[l_gr] == Approx(l_center));
+                    REQUIRE(l_frame.totalH[l_gr] == Approx(l_center - 1));
+                    REQUIRE(l_frame.hu[l_gr] == Approx(2 * l_center));
+                    REQUIRE(l_frame.hv[l_gr] == 0);
+                    if (l_fr == 0)
+                        REQUIRE(l_frame.b[l_gr] == -1);
+                }
+            }
+        }
+    }
+}
+
 #endif
\ No newline at end of file
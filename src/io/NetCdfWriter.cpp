@@ -0,0 +1,120 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Asynchronous output of the NetCdf files on a dedicated I/O thread.
+ **/
+#include "NetCdfWriter.h"
+#include <algorithm>
+#include <chrono>
+
+/**
+ * Gets the wall clock time in seconds.
+ **/
+static double wallTime()
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Pauses a thread which polls a queue; the threads of the time steps keep the cores.
+ **/
+static void waitBriefly()
+{
+  std::this_thread::sleep_for(std::chrono::microseconds(100));
+}
+
+tsunami_lab::io::NetCdfWriter::NetCdfWriter(t_idx i_nFrames) : m_entries(std::max(i_nFrames, t_idx(1))),
+                                                               m_queued(m_entries.size()),
+                                                               m_free(m_entries.size())
+{
+  for (t_idx l_en = 0; l_en < m_entries.size(); l_en++)
+    m_free.push(l_en);
+  m_thread = std::thread(&NetCdfWriter::run, this);
+}
+
+tsunami_lab::io::NetCdfWriter::~NetCdfWriter()
+{
+  wait();
+  m_stop.store(true, std::memory_order_release);
+  m_thread.join();
+}
+
+tsunami_lab::t_idx tsunami_lab::io::NetCdfWriter::acquire()
+{
+  t_idx l_id = 0;
+  if (m_free.pop(l_id))
+    return l_id;
+
+  // back-pressure: the I/O thread fell behind
+  double l_begin = wallTime();
+  while (!m_free.pop(l_id))
+    waitBriefly();
+  m_waitTime += wallTime() - l_begin;
+  return l_id;
+}
+
+void tsunami_lab::io::NetCdfWriter::run()
+{
+  t_idx l_id = 0;
+  while (true)
+  {
+    if (m_queued.pop(l_id))
+    {
+      m_entries[l_id].netCdf->writeFrame(m_entries[l_id].frame);
+      m_free.push(l_id);
+    }
+    // the writer stops after all frames were written
+    else if (m_stop.load(std::memory_order_acquire))
+    {
+      break;
+    }
+    else
+    {
+      waitBriefly();
+    }
+  }
+}
+
+void tsunami_lab::io::NetCdfWriter::write(NetCdf *i_netCdf,
+                                          t_idx i_stride,
+                                          t_real const *i_h,
+                                          t_real const *i_hu,
+                                          t_real const *i_hv,
+                                          t_real const *i_b,
+                                          t_real i_t)
+{
+  std::lock_guard<std::mutex> l_lock(m_producerMutex);
+  t_idx l_id = acquire();
+  m_entries[l_id].netCdf = i_netCdf;
+  i_netCdf->coarsen(i_stride,
+                    i_h,
+                    i_hu,
+                    i_hv,
+                    i_b,
+                    i_t,
+                    m_entries[l_id].frame);
+  m_queued.push(l_id);
+}
+
+void tsunami_lab::io::NetCdfWriter::wait()
+{
+  std::lock_guard<std::mutex> l_lock(m_producerMutex);
+
+  // all entries are free once the I/O thread returned the queued ones
+  std::vector<t_idx> l_ids;
+  t_idx l_id = 0;
+  double l_begin = wallTime();
+  while (l_ids.size() < m_entries.size())
+  {
+    if (m_free.pop(l_id))
+      l_ids.push_back(l_id);
+    else
+      waitBriefly();
+  }
+  m_waitTime += wallTime() - l_begin;
+
+  for (t_idx l_en : l_ids)
+    m_free.push(l_en);
+}
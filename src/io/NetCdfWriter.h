@@ -0,0 +1,127 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Asynchronous output of the NetCdf files on a dedicated I/O thread.
+ **/
+#ifndef TSUNAMI_LAB_IO_NETCDF_WRITER
+#define TSUNAMI_LAB_IO_NETCDF_WRITER
+
+#include "../constants.h"
+#include "NetCdf.h"
+#include "SpscQueue.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tsunami_lab
+{
+  namespace io
+  {
+    class NetCdfWriter;
+  }
+}
+
+/**
+ * Writer of frames of one or more NetCdf files, which overlaps the output with the time steps.
+ * The simulation thread coarsens a time step into a pooled frame and queues it, the I/O thread writes the queued frames in order.
+ * All NetCdf calls of the queued frames run on the I/O thread, since the NetCdf library is not thread-safe.
+ * If all frames are queued, the simulation thread waits for the next written one.
+ **/
+class tsunami_lab::io::NetCdfWriter
+{
+private:
+  //! pooled frame and the file it belongs to
+  struct Entry
+  {
+    //! file of the frame
+    NetCdf *netCdf = nullptr;
+
+    //! coarsened output values
+    NetCdf::Frame frame;
+  };
+
+  //! pool of the frames
+  std::vector<Entry> m_entries;
+
+  //! ids of the queued entries, passed from the simulation thread to the I/O thread
+  SpscQueue<t_idx> m_queued;
+
+  //! ids of the free entries, passed from the I/O thread back to the simulation thread
+  SpscQueue<t_idx> m_free;
+
+  //! true if the I/O thread stops once the queue is empty
+  std::atomic<bool> m_stop{false};
+
+  //! serializes the producers, e.g., the checkpoints of the server next to the time steps
+  std::mutex m_producerMutex;
+
+  //! seconds which the simulation thread waited for free entries
+  double m_waitTime = 0;
+
+  //! I/O thread
+  std::thread m_thread;
+
+  /**
+   * Gets a free entry and waits for the I/O thread if all entries are queued; called by the simulation thread.
+   *
+   * @return id of the entry.
+   **/
+  t_idx acquire();
+
+  /**
+   * Writes the queued frames until the writer stops; the loop of the I/O thread.
+   **/
+  void run();
+
+public:
+  /**
+   * Constructor, which starts the I/O thread.
+   *
+   * @param i_nFrames number of pooled frames, at least 1.
+   **/
+  NetCdfWriter(t_idx i_nFrames);
+
+  /**
+   * Destructor, which writes the queued frames and stops the I/O thread.
+   **/
+  ~NetCdfWriter();
+
+  /**
+   * Coarsens a time step and queues it for the output.
+   *
+   * @param i_netCdf file of the time step, has to outlive the queued frames.
+   * @param i_stride stride of the arrays.
+   * @param i_h water heights.
+   * @param i_hu momenta in x-direction.
+   * @param i_hv momenta in y-direction.
+   * @param i_b bathymetry.
+   * @param i_t simulation time.
+   **/
+  void write(NetCdf *i_netCdf,
+             t_idx i_stride,
+             t_real const *i_h,
+             t_real const *i_hu,
+             t_real const *i_hv,
+             t_real const *i_b,
+             t_real i_t);
+
+  /**
+   * Waits until all queued frames are written; afterwards the simulation thread may call the NetCdf files itself.
+   **/
+  void wait();
+
+  /**
+   * Gets the time which the simulation thread waited for the I/O thread.
+   *
+   * @return seconds.
+   **/
+  double getWaitTime() const
+  {
+    return m_waitTime;
+  }
+};
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Lock-free queue of a single producer and a single consumer thread.
+ **/
+#ifndef TSUNAMI_LAB_IO_SPSC_QUEUE
+#define TSUNAMI_LAB_IO_SPSC_QUEUE
+
+#include "../constants.h"
+#include <atomic>
+#include <vector>
+
+namespace tsunami_lab
+{
+  namespace io
+  {
+    template <typename T>
+    class SpscQueue;
+  }
+}
+
+/**
+ * Bounded ring buffer which one thread pushes to and another one pops from, without locks.
+ * The producer owns the tail and the consumer the head; each publishes its index with release semantics after accessing the slot.
+ **/
+template <typename T>
+class tsunami_lab::io::SpscQueue
+{
+private:
+  //! alignment in bytes of the indices, which keeps them in different cache lines
+  static std::size_t constexpr m_alignment = 64;
+
+  //! slots of the ring buffer, one more than the capacity to tell a full from an empty queue
+  std::vector<T> m_slots;
+
+  //! slot of the next pop, written by the consumer
+  alignas(m_alignment) std::atomic<t_idx> m_head{0};
+
+  //! slot of the next push, written by the producer
+  alignas(m_alignment) std::atomic<t_idx> m_tail{0};
+
+public:
+  /**
+   * Constructor.
+   *
+   * @param i_capacity maximum number of elements in the queue.
+   **/
+  SpscQueue(t_idx i_capacity) : m_slots(i_capacity + 1)
+  {
+  }
+
+  /**
+   * Appends an element; called by the producer only.
+   *
+   * @param i_value element.
+   * @return false if the queue is full.
+   **/
+  bool push(T const &i_value)
+  {
+    t_idx l_tail = m_tail.load(std::memory_order_relaxed);
+    t_idx l_next = (l_tail + 1) % m_slots.size();
+    if (l_next == m_head.load(std::memory_order_acquire))
+      return false;
+    m_slots[l_tail] = i_value;
+    m_tail.store(l_next, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Removes the oldest element; called by the consumer only.
+   *
+   * @param o_value will be set to the element.
+   * @return false if the queue is empty.
+   **/
+  bool pop(T &o_value)
+  {
+    t_idx l_head = m_head.load(std::memory_order_relaxed);
+    if (l_head == m_tail.load(std::memory_order_acquire))
+      return false;
+    o_value = m_slots[l_head];
+    m_head.store((l_head + 1) % m_slots.size(), std::memory_order_release);
+    return true;
+  }
+};
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Unit tests of the single-producer single-consumer queue.
+ **/
+#include <catch2/catch.hpp>
+#include "SpscQueue.h"
+#include <thread>
+
+/**
+ * Pushes the numbers 0, ..., n - 1 and retries while the queue is full.
+ **/
+static void pushNumbers(tsunami_lab::io::SpscQueue<tsunami_lab::t_idx> *io_queue,
+                        tsunami_lab::t_idx i_n)
+{
+  for (tsunami_lab::t_idx l_nu = 0; l_nu < i_n; l_nu++)
+  {
+    while (!io_queue->push(l_nu))
+      std::this_thread::yield();
+  }
+}
+
+TEST_CASE("Test the single-producer single-consumer queue.", "[SpscQueue]")
+{
+  tsunami_lab::io::SpscQueue<tsunami_lab::t_idx> l_queue(3);
+  tsunami_lab::t_idx l_value = 0;
+
+  // the queue holds up to its capacity in order
+  REQUIRE_FALSE(l_queue.pop(l_value));
+  REQUIRE(l_queue.push(5));
+  REQUIRE(l_queue.push(6));
+  REQUIRE(l_queue.push(7));
+  REQUIRE_FALSE(l_queue.push(8));
+  REQUIRE(l_queue.pop(l_value));
+  REQUIRE(l_value == 5);
+  REQUIRE(l_queue.push(8));
+  for (tsunami_lab::t_idx l_ex : {6, 7, 8})
+  {
+    REQUIRE(l_queue.pop(l_value));
+    REQUIRE(l_value == l_ex);
+  }
+  REQUIRE_FALSE(l_queue.pop(l_value));
+
+  // a producer thread passes all elements in order while the ring wraps around
+  tsunami_lab::t_idx l_n = 100000;
+  std::thread l_producer(pushNumbers, &l_queue, l_n);
+  tsunami_lab::t_idx l_nInOrder = 0;
+  for (tsunami_lab::t_idx l_nu = 0; l_nu < l_n; l_nu++)
+  {
+    while (!l_queue.pop(l_value))
+      std::this_thread::yield();
+    l_nInOrder += l_value == l_nu ? 1 : 0;
+  }
+  l_producer.join();
+  REQUIRE(l_nInOrder == l_n);
+  REQUIRE_FALSE(l_queue.pop(l_value));
+}
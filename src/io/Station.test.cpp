@@ -11,7 +11,10 @@
 #include "../setups/DamBreak1d.h"
 #include "../patches/WavePropagation1d.h"
 #include "../patches/WavePropagation2d.h"
+#include "../patches/Boundaries.h"
+#include "../solvers/Fwave.h"
 
+using Outflow = tsunami_lab::patches::boundaries::Outflow;
 using Boundary = tsunami_lab::patches::WavePropagation::Boundary;
 
 TEST_CASE("1D test of the station implementation", "[Station], [WavePropagation1d]")
@@ -34,10 +37,9 @@ TEST_CASE("1D test of the station implementation", "[Station], [WavePropagation1
      */
 
     std::vector<tsunami_lab::io::Station *> m_stations;
-    tsunami_lab::patches::WavePropagation1d m_waveProp(100,
-                                                       "fwave",
-                                                       Boundary::OUTFLOW,
-                                                       Boundary::OUTFLOW);
+    tsunami_lab::patches::WavePropagation1d<tsunami_lab::solvers::Fwave,
+                                            Outflow,
+                                            Outflow> m_waveProp(100);
 
     for (std::size_t l_ce = 0; l_ce < 50; l_ce++)
     {
@@ -127,12 +129,13 @@ TEST_CASE("2D test of the station implementation", "[Station],[WavePropagation2d
 
     // construct solver and setup a dambreak problem
     std::vector<tsunami_lab::io::Station *> m_stations;
-    tsunami_lab::patches::WavePropagation2d m_waveProp(100,
-                                                       100,
-                                                       Boundary::OUTFLOW,
-                                                       Boundary::OUTFLOW,
-                                                       Boundary::OUTFLOW,
-                                                       Boundary::OUTFLOW);
+    tsunami_lab::patches::WavePropagation2d<tsunami_lab::solvers::Fwave> m_waveProp(100,
+                                                                                    100,
+                                                                                    Boundary::OUTFLOW,
+                                                                                    Boundary::OUTFLOW,
+                                                                                    Boundary::OUTFLOW,
+                                                                                    Boundary::OUTFLOW,
+                                                                                    false);
 
     for (std::size_t l_ce = 0; l_ce < 50; l_ce++)
     {
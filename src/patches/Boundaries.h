@@ -0,0 +1,60 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Boundary conditions as compile-time policies of the wave propagation patches.
+ **/
+#ifndef TSUNAMI_LAB_PATCHES_BOUNDARIES
+#define TSUNAMI_LAB_PATCHES_BOUNDARIES
+
+#include "../constants.h"
+
+namespace tsunami_lab
+{
+  namespace patches
+  {
+    namespace boundaries
+    {
+      class Outflow;
+      class Wall;
+    }
+  }
+}
+
+/**
+ * Outflow boundary: the ghost cells copy the adjacent inner cells.
+ **/
+class tsunami_lab::patches::boundaries::Outflow
+{
+public:
+  /**
+   * Gets the water height of a ghost cell.
+   *
+   * @param i_hInner water height of the adjacent inner cell.
+   * @return water height of the ghost cell.
+   **/
+  static t_real ghostHeight(t_real i_hInner)
+  {
+    return i_hInner;
+  }
+};
+
+/**
+ * Wall boundary: the ghost cells are dry, so that the solver reflects the adjacent inner cells.
+ **/
+class tsunami_lab::patches::boundaries::Wall
+{
+public:
+  /**
+   * Gets the water height of a ghost cell.
+   *
+   * @return water height of the ghost cell.
+   **/
+  static t_real ghostHeight(t_real)
+  {
+    return 0;
+  }
+};
+
+#endif
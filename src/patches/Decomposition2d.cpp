@@ -0,0 +1,346 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Distribution of a two-dimensional wave propagation patch over MPI processes.
+ **/
+#include "Decomposition2d.h"
+#include "WavePropagation2d.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+/**
+ * Gets the MPI datatype of the floating point type.
+ **/
+static MPI_Datatype realType()
+{
+  return sizeof(tsunami_lab::t_real) == sizeof(double) ? MPI_DOUBLE : MPI_FLOAT;
+}
+
+tsunami_lab::patches::Decomposition2d::Decomposition2d(MPI_Comm i_comm,
+                                                       t_idx i_nCellsX,
+                                                       t_idx i_nCellsY,
+                                                       t_idx i_align,
+                                                       std::string const &i_solver,
+                                                       WavePropagation::Boundary i_boundaryL,
+                                                       WavePropagation::Boundary i_boundaryR,
+                                                       WavePropagation::Boundary i_boundaryT,
+                                                       WavePropagation::Boundary i_boundaryB)
+{
+  m_nCellsX = i_nCellsX;
+  m_nCellsY = i_nCellsY;
+  m_solver = i_solver;
+  m_boundaries[LEFT] = i_boundaryL;
+  m_boundaries[RIGHT] = i_boundaryR;
+  m_boundaries[BOTTOM] = i_boundaryB;
+  m_boundaries[TOP] = i_boundaryT;
+
+  MPI_Comm_size(i_comm, &m_nRanks);
+
+  // the grid with the fewest cells on the interfaces whose subdomains keep the alignment, otherwise any grid
+  t_idx l_nRanks = m_nRanks;
+  t_idx l_noGrid = std::numeric_limits<t_idx>::max();
+  t_idx l_bestCost = l_noGrid;
+  for (t_idx l_align : {std::max(i_align, t_idx(1)), t_idx(1)})
+  {
+    for (t_idx l_px = 1; l_px <= l_nRanks; l_px++)
+    {
+      t_idx l_py = l_nRanks / l_px;
+      if (l_px * l_py != l_nRanks || l_px * l_align > m_nCellsX || l_py * l_align > m_nCellsY)
+        continue;
+      t_idx l_cost = (l_px - 1) * m_nCellsY + (l_py - 1) * m_nCellsX;
+      if (l_cost < l_bestCost)
+      {
+        l_bestCost = l_cost;
+        m_nRanksX = l_px;
+        m_nRanksY = l_py;
+      }
+    }
+    if (l_bestCost != l_noGrid)
+    {
+      partition(i_comm, l_align);
+      return;
+    }
+  }
+  std::cerr << "Error: cannot split " << m_nCellsX << " x " << m_nCellsY << " cells into " << m_nRanks << " subdomains" << std::endl;
+  MPI_Abort(i_comm, 1);
+}
+
+void tsunami_lab::patches::Decomposition2d::partition(MPI_Comm i_comm,
+                                                      t_idx i_align)
+{
+  // the ranks are kept, which names the output of a subdomain by the rank in the given communicator
+  int l_dims[2] = {int(m_nRanksX), int(m_nRanksY)};
+  int l_periods[2] = {0, 0};
+  MPI_Cart_create(i_comm, 2, l_dims, l_periods, 0, &m_comm);
+  MPI_Comm_rank(m_comm, &m_rank);
+
+  int l_coords[2] = {0, 0};
+  MPI_Cart_coords(m_comm, m_rank, 2, l_coords);
+  MPI_Cart_shift(m_comm, 0, 1, &m_neighbours[LEFT], &m_neighbours[RIGHT]);
+  MPI_Cart_shift(m_comm, 1, 1, &m_neighbours[BOTTOM], &m_neighbours[TOP]);
+
+  // the subdomains take whole groups of aligned cells, the last ones the remainders
+  t_idx l_nGroupsX = m_nCellsX / i_align;
+  t_idx l_nGroupsY = m_nCellsY / i_align;
+  t_idx l_rx = l_coords[0];
+  t_idx l_ry = l_coords[1];
+  m_firstCellX = i_align * (l_nGroupsX * l_rx / m_nRanksX);
+  m_firstCellY = i_align * (l_nGroupsY * l_ry / m_nRanksY);
+  t_idx l_endX = l_rx + 1 < m_nRanksX ? i_align * (l_nGroupsX * (l_rx + 1) / m_nRanksX) : m_nCellsX;
+  t_idx l_endY = l_ry + 1 < m_nRanksY ? i_align * (l_nGroupsY * (l_ry + 1) / m_nRanksY) : m_nCellsY;
+  m_nLocalX = l_endX - m_firstCellX;
+  m_nLocalY = l_endY - m_firstCellY;
+}
+
+tsunami_lab::patches::Decomposition2d::~Decomposition2d()
+{
+  for (Strip &l_strip : m_strips)
+    delete l_strip.patch;
+  if (m_comm != MPI_COMM_NULL)
+    MPI_Comm_free(&m_comm);
+}
+
+void tsunami_lab::patches::Decomposition2d::packBorders(t_idx i_nQuantities)
+{
+  t_real const *l_quantities[4] = {m_patch->getHeight(),
+                                   m_patch->getMomentumX(),
+                                   m_patch->getMomentumY(),
+                                   m_patch->getBathymetry()};
+  t_idx l_stride = m_patch->getStride();
+
+  for (t_idx l_si = 0; l_si < 4; l_si++)
+  {
+    if (m_neighbours[l_si] == MPI_PROC_NULL)
+      continue;
+
+    // first cell next to the interface and the distance of consecutive cells along it
+    Side l_side = Side(l_si);
+    t_idx l_length = getSideLength(l_side);
+    t_idx l_first = 0;
+    t_idx l_step = l_side == LEFT || l_side == RIGHT ? l_stride : 1;
+    if (l_side == RIGHT)
+      l_first = m_nLocalX - 1;
+    else if (l_side == TOP)
+      l_first = (m_nLocalY - 1) * l_stride;
+
+    m_sendBuffers[l_si].resize(i_nQuantities * l_length);
+    for (t_idx l_qu = 0; l_qu < i_nQuantities; l_qu++)
+      for (t_idx l_ce = 0; l_ce < l_length; l_ce++)
+        m_sendBuffers[l_si][l_qu * l_length + l_ce] = l_quantities[l_qu][l_first + l_ce * l_step];
+  }
+}
+
+void tsunami_lab::patches::Decomposition2d::startExchange(t_idx i_nQuantities)
+{
+  // a message carries the tag of the side at which the neighbour receives it
+  m_requests.clear();
+  for (t_idx l_si = 0; l_si < 4; l_si++)
+  {
+    if (m_neighbours[l_si] == MPI_PROC_NULL)
+      continue;
+
+    int l_count = i_nQuantities * getSideLength(Side(l_si));
+    m_recvBuffers[l_si].resize(l_count);
+    m_requests.push_back(MPI_REQUEST_NULL);
+    MPI_Irecv(m_recvBuffers[l_si].data(), l_count, realType(), m_neighbours[l_si], l_si, m_comm, &m_requests.back());
+    m_requests.push_back(MPI_REQUEST_NULL);
+    MPI_Isend(m_sendBuffers[l_si].data(), l_count, realType(), m_neighbours[l_si], l_si ^ 1, m_comm, &m_requests.back());
+  }
+}
+
+void tsunami_lab::patches::Decomposition2d::finishExchange()
+{
+  MPI_Waitall(m_requests.size(), m_requests.data(), MPI_STATUSES_IGNORE);
+  m_requests.clear();
+}
+
+void tsunami_lab::patches::Decomposition2d::getState(long i_ix,
+                                                     long i_iy,
+                                                     t_idx i_nQuantities,
+                                                     t_real o_state[4])
+{
+  long l_nx = m_nLocalX;
+  long l_ny = m_nLocalY;
+  if (i_ix >= 0 && i_ix < l_nx && i_iy >= 0 && i_iy < l_ny)
+  {
+    t_idx l_ce = i_ix + i_iy * m_patch->getStride();
+    t_real const *l_quantities[4] = {m_patch->getHeight(),
+                                     m_patch->getMomentumX(),
+                                     m_patch->getMomentumY(),
+                                     m_patch->getBathymetry()};
+    for (t_idx l_qu = 0; l_qu < i_nQuantities; l_qu++)
+      o_state[l_qu] = l_quantities[l_qu][l_ce];
+    return;
+  }
+
+  Side l_side = LEFT;
+  long l_pos = 0;
+  if (i_ix < 0 || i_ix >= l_nx)
+  {
+    l_side = i_ix < 0 ? LEFT : RIGHT;
+    l_pos = std::clamp(i_iy, long(0), l_ny - 1);
+  }
+  else
+  {
+    l_side = i_iy < 0 ? BOTTOM : TOP;
+    l_pos = i_ix;
+  }
+  t_idx l_length = getSideLength(l_side);
+  for (t_idx l_qu = 0; l_qu < i_nQuantities; l_qu++)
+    o_state[l_qu] = m_recvBuffers[l_side][l_qu * l_length + l_pos];
+}
+
+void tsunami_lab::patches::Decomposition2d::addStrip(t_idx i_tx,
+                                                     t_idx i_ty,
+                                                     t_idx i_tnx,
+                                                     t_idx i_tny)
+{
+  if (i_tnx == 0 || i_tny == 0)
+    return;
+
+  // the recomputed cells and their neighbours, which are halo cells at the interfaces
+  long l_loX = m_neighbours[LEFT] == MPI_PROC_NULL ? 0 : -1;
+  long l_loY = m_neighbours[BOTTOM] == MPI_PROC_NULL ? 0 : -1;
+  long l_hiX = m_nLocalX + (m_neighbours[RIGHT] == MPI_PROC_NULL ? 0 : 1);
+  long l_hiY = m_nLocalY + (m_neighbours[TOP] == MPI_PROC_NULL ? 0 : 1);
+  long l_x0 = std::max(long(i_tx) - 1, l_loX);
+  long l_y0 = std::max(long(i_ty) - 1, l_loY);
+  long l_x1 = std::min(long(i_tx + i_tnx) + 1, l_hiX);
+  long l_y1 = std::min(long(i_ty + i_tny) + 1, l_hiY);
+
+  Strip l_strip;
+  l_strip.ix = l_x0;
+  l_strip.iy = l_y0;
+  l_strip.nx = l_x1 - l_x0;
+  l_strip.ny = l_y1 - l_y0;
+  l_strip.tx = i_tx;
+  l_strip.ty = i_ty;
+  l_strip.tnx = i_tnx;
+  l_strip.tny = i_tny;
+
+  // sides of the strip at the domain boundaries keep their conditions, the others only affect cells which are not recomputed
+  l_strip.patch = createWavePropagation2d(l_strip.nx,
+                                          l_strip.ny,
+                                          m_solver,
+                                          long(i_tx) - 1 < l_loX ? m_boundaries[LEFT] : WavePropagation::OUTFLOW,
+                                          long(i_tx + i_tnx) + 1 > l_hiX ? m_boundaries[RIGHT] : WavePropagation::OUTFLOW,
+                                          long(i_ty + i_tny) + 1 > l_hiY ? m_boundaries[TOP] : WavePropagation::OUTFLOW,
+                                          long(i_ty) - 1 < l_loY ? m_boundaries[BOTTOM] : WavePropagation::OUTFLOW,
+                                          false);
+  l_strip.patch->setLinearization(m_linearDepth, m_linearAmplitudeRatio);
+
+  // the setters derive the dry cells, as the local patch did from the same states
+  for (t_idx l_cy = 0; l_cy < l_strip.ny; l_cy++)
+  {
+    for (t_idx l_cx = 0; l_cx < l_strip.nx; l_cx++)
+    {
+      t_real l_state[4] = {0, 0, 0, 0};
+      getState(l_x0 + long(l_cx), l_y0 + long(l_cy), 4, l_state);
+      l_strip.patch->setHeight(l_cx, l_cy, l_state[0]);
+      l_strip.patch->setMomentumX(l_cx, l_cy, l_state[1]);
+      l_strip.patch->setMomentumY(l_cx, l_cy, l_state[2]);
+      l_strip.patch->setBathymetry(l_cx, l_cy, l_state[3]);
+    }
+  }
+  m_strips.push_back(l_strip);
+}
+
+void tsunami_lab::patches::Decomposition2d::createStrips()
+{
+  packBorders(4);
+  startExchange(4);
+  finishExchange();
+
+  // the strips of the left and right interfaces recompute whole columns, the ones of the bottom and top interfaces the rest of their rows
+  bool l_left = m_neighbours[LEFT] != MPI_PROC_NULL;
+  bool l_right = m_neighbours[RIGHT] != MPI_PROC_NULL;
+  t_idx l_tx0 = l_left ? 1 : 0;
+  t_idx l_tx1 = std::max(l_right ? m_nLocalX - 1 : m_nLocalX, l_tx0);
+  if (l_left)
+    addStrip(0, 0, 1, m_nLocalY);
+  if (l_right)
+    addStrip(m_nLocalX - 1, 0, 1, m_nLocalY);
+  if (m_neighbours[BOTTOM] != MPI_PROC_NULL)
+    addStrip(l_tx0, 0, l_tx1 - l_tx0, 1);
+  if (m_neighbours[TOP] != MPI_PROC_NULL)
+    addStrip(l_tx0, m_nLocalY - 1, l_tx1 - l_tx0, 1);
+
+  m_stripsCreated = true;
+}
+
+void tsunami_lab::patches::Decomposition2d::loadStrip(Strip &io_strip,
+                                                      bool i_halo)
+{
+  long l_nx = m_nLocalX;
+  long l_ny = m_nLocalY;
+  for (t_idx l_cy = 0; l_cy < io_strip.ny; l_cy++)
+  {
+    long l_iy = io_strip.iy + long(l_cy);
+    for (t_idx l_cx = 0; l_cx < io_strip.nx; l_cx++)
+    {
+      long l_ix = io_strip.ix + long(l_cx);
+      bool l_halo = l_ix < 0 || l_ix >= l_nx || l_iy < 0 || l_iy >= l_ny;
+      if (l_halo != i_halo)
+        continue;
+
+      t_real l_state[4] = {0, 0, 0, 0};
+      getState(l_ix, l_iy, 3, l_state);
+      io_strip.patch->setCellState(l_cx, l_cy, l_state[0], l_state[1], l_state[2]);
+    }
+  }
+}
+
+void tsunami_lab::patches::Decomposition2d::timeStep(t_real i_scalingX,
+                                                     t_real i_scalingY)
+{
+  if (!m_stripsCreated)
+    createStrips();
+
+  // the messages are in flight while the local patch advances
+  packBorders(3);
+  startExchange(3);
+  for (Strip &l_strip : m_strips)
+    loadStrip(l_strip, false);
+
+  m_patch->timeStep(i_scalingX, i_scalingY);
+
+  // the strips replace the cells next to the interfaces, which the local patch computed with outflow boundaries
+  finishExchange();
+  for (Strip &l_strip : m_strips)
+  {
+    loadStrip(l_strip, true);
+    l_strip.patch->timeStep(i_scalingX, i_scalingY);
+
+    t_idx l_stride = l_strip.patch->getStride();
+    t_idx l_first = (l_strip.tx - l_strip.ix) + (l_strip.ty - l_strip.iy) * l_stride;
+    for (t_idx l_cy = 0; l_cy < l_strip.tny; l_cy++)
+    {
+      for (t_idx l_cx = 0; l_cx < l_strip.tnx; l_cx++)
+      {
+        t_idx l_ce = l_first + l_cx + l_cy * l_stride;
+        m_patch->setCellState(l_strip.tx + l_cx,
+                              l_strip.ty + l_cy,
+                              l_strip.patch->getHeight()[l_ce],
+                              l_strip.patch->getMomentumX()[l_ce],
+                              l_strip.patch->getMomentumY()[l_ce]);
+      }
+    }
+  }
+}
+
+tsunami_lab::t_real tsunami_lab::patches::Decomposition2d::getMaxWaveSpeed()
+{
+  // the speeds of the patch's cells after the strips replaced the ones next to the interfaces, as an undivided patch tracks them
+  return reduceMax(m_patch->computeMaxWaveSpeed(0, 0, m_nLocalX, m_nLocalY));
+}
+
+tsunami_lab::t_real tsunami_lab::patches::Decomposition2d::reduceMax(t_real i_value) const
+{
+  t_real l_max = i_value;
+  MPI_Allreduce(&i_value, &l_max, 1, realType(), MPI_MAX, m_comm);
+  return l_max;
+}
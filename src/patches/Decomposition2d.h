@@ -0,0 +1,348 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Distribution of a two-dimensional wave propagation patch over MPI processes.
+ **/
+#ifndef TSUNAMI_LAB_PATCHES_DECOMPOSITION_2D
+#define TSUNAMI_LAB_PATCHES_DECOMPOSITION_2D
+
+#include "../constants.h"
+#include "WavePropagation.h"
+#include <mpi.h>
+#include <string>
+#include <vector>
+
+namespace tsunami_lab
+{
+  namespace patches
+  {
+    class Decomposition2d;
+  }
+}
+
+/**
+ * Domain decomposition of a 2d patch into rectangular subdomains, one per MPI process.
+ *
+ * The processes form a Cartesian grid, which minimizes the number of cells on the interfaces.
+ * Every process advances a local patch with the cells of its subdomain; its sides at the interfaces are outflow boundaries.
+ * A time step sends the cells next to the interfaces to the neighbours and computes the local patch while the messages are in flight.
+ * Afterwards, thin strip patches recompute the cells next to the interfaces: they hold the received halo cells,
+ * the cells next to the interfaces and the ones further inside, thus the interface cells see the same edges as in an undivided patch.
+ * The results are the ones of a single process for any number of processes.
+ **/
+class tsunami_lab::patches::Decomposition2d
+{
+public:
+  //! sides of a subdomain
+  enum Side
+  {
+    LEFT = 0,
+    RIGHT = 1,
+    BOTTOM = 2,
+    TOP = 3
+  };
+
+private:
+  //! patch which recomputes the cells next to one or two interfaces
+  struct Strip
+  {
+    //! first cell of the strip in x- and y-direction, relative to the subdomain; -1 is a halo cell
+    long ix = 0;
+    long iy = 0;
+
+    //! number of cells of the strip in x- and y-direction
+    t_idx nx = 0;
+    t_idx ny = 0;
+
+    //! first recomputed cell of the subdomain in x- and y-direction
+    t_idx tx = 0;
+    t_idx ty = 0;
+
+    //! number of recomputed cells in x- and y-direction
+    t_idx tnx = 0;
+    t_idx tny = 0;
+
+    //! patch of the strip
+    WavePropagation *patch = nullptr;
+  };
+
+  //! Cartesian communicator of the processes
+  MPI_Comm m_comm = MPI_COMM_NULL;
+
+  //! id of the process and number of processes
+  int m_rank = 0;
+  int m_nRanks = 1;
+
+  //! number of processes in x- and y-direction
+  t_idx m_nRanksX = 1;
+  t_idx m_nRanksY = 1;
+
+  //! neighbouring processes per side, MPI_PROC_NULL at the domain boundaries
+  int m_neighbours[4] = {MPI_PROC_NULL, MPI_PROC_NULL, MPI_PROC_NULL, MPI_PROC_NULL};
+
+  //! number of cells of the whole domain in x- and y-direction
+  t_idx m_nCellsX = 0;
+  t_idx m_nCellsY = 0;
+
+  //! first cell of the subdomain in x- and y-direction
+  t_idx m_firstCellX = 0;
+  t_idx m_firstCellY = 0;
+
+  //! number of cells of the subdomain in x- and y-direction
+  t_idx m_nLocalX = 0;
+  t_idx m_nLocalY = 0;
+
+  //! solver of the strips
+  std::string m_solver = "fwave";
+
+  //! boundary conditions of the domain per side
+  WavePropagation::Boundary m_boundaries[4] = {WavePropagation::OUTFLOW,
+                                               WavePropagation::OUTFLOW,
+                                               WavePropagation::OUTFLOW,
+                                               WavePropagation::OUTFLOW};
+
+  //! deep water of the linearized edges of the strips
+  t_real m_linearDepth = 0;
+  t_real m_linearAmplitudeRatio = 0.01;
+
+  //! patch of the subdomain, not owned
+  WavePropagation *m_patch = nullptr;
+
+  //! strips at the interfaces, created at the first time step
+  std::vector<Strip> m_strips;
+  bool m_stripsCreated = false;
+
+  //! cells next to the interfaces which are sent and the received halo cells per side, one array per quantity
+  std::vector<t_real> m_sendBuffers[4];
+  std::vector<t_real> m_recvBuffers[4];
+
+  //! requests of the messages in flight
+  std::vector<MPI_Request> m_requests;
+
+  /**
+   * Creates the Cartesian communicator of the grid of processes and splits the domain into its subdomains.
+   *
+   * @param i_comm communicator of the processes.
+   * @param i_align number of cells by which the first cells of the subdomains are divisible.
+   **/
+  void partition(MPI_Comm i_comm,
+                 t_idx i_align);
+
+  /**
+   * Gets the number of cells along a side of the subdomain.
+   *
+   * @param i_side side.
+   * @return number of cells.
+   **/
+  t_idx getSideLength(Side i_side) const
+  {
+    return i_side == LEFT || i_side == RIGHT ? m_nLocalY : m_nLocalX;
+  }
+
+  /**
+   * Copies the cells next to the interfaces of the local patch into the send buffers.
+   *
+   * @param i_nQuantities number of quantities: heights, momenta in x- and y-direction and bathymetry.
+   **/
+  void packBorders(t_idx i_nQuantities);
+
+  /**
+   * Starts the non-blocking exchange of the send buffers with the neighbours.
+   *
+   * @param i_nQuantities number of quantities per cell.
+   **/
+  void startExchange(t_idx i_nQuantities);
+
+  /**
+   * Waits for the messages of the exchange.
+   **/
+  void finishExchange();
+
+  /**
+   * Gets the state of a cell of the subdomain or of a halo cell after the exchange.
+   * The diagonal halo cells take the closest halo cell in x-direction, they only affect halo cells of the strips.
+   *
+   * @param i_ix id of the cell in x-direction, -1 to m_nLocalX.
+   * @param i_iy id of the cell in y-direction, -1 to m_nLocalY.
+   * @param i_nQuantities number of quantities to get.
+   * @param o_state will be set to height, momentum in x- and y-direction and bathymetry.
+   **/
+  void getState(long i_ix,
+                long i_iy,
+                t_idx i_nQuantities,
+                t_real o_state[4]);
+
+  /**
+   * Adds the strip which recomputes a rectangle of the subdomain.
+   *
+   * @param i_tx first recomputed cell in x-direction.
+   * @param i_ty first recomputed cell in y-direction.
+   * @param i_tnx number of recomputed cells in x-direction.
+   * @param i_tny number of recomputed cells in y-direction.
+   **/
+  void addStrip(t_idx i_tx,
+                t_idx i_ty,
+                t_idx i_tnx,
+                t_idx i_tny);
+
+  /**
+   * Exchanges the halo cells including the bathymetry and creates the strips.
+   **/
+  void createStrips();
+
+  /**
+   * Sets cells of a strip before its time step.
+   *
+   * @param io_strip strip.
+   * @param i_halo true to set the halo cells, false to set the cells of the subdomain.
+   **/
+  void loadStrip(Strip &io_strip,
+                 bool i_halo);
+
+public:
+  /**
+   * Constructor, every process of the communicator has to call it.
+   *
+   * @param i_comm communicator of the processes.
+   * @param i_nCellsX number of cells of the domain in x-direction.
+   * @param i_nCellsY number of cells of the domain in y-direction.
+   * @param i_align number of cells by which the first cells of the subdomains are divisible, e.g., the grouped cells of the output.
+   * @param i_solver solver of the strips.
+   * @param i_boundaryL boundary condition on the left side of the domain.
+   * @param i_boundaryR boundary condition on the right side of the domain.
+   * @param i_boundaryT boundary condition on the top side of the domain.
+   * @param i_boundaryB boundary condition on the bottom side of the domain.
+   **/
+  Decomposition2d(MPI_Comm i_comm,
+                  t_idx i_nCellsX,
+                  t_idx i_nCellsY,
+                  t_idx i_align,
+                  std::string const &i_solver,
+                  WavePropagation::Boundary i_boundaryL,
+                  WavePropagation::Boundary i_boundaryR,
+                  WavePropagation::Boundary i_boundaryT,
+                  WavePropagation::Boundary i_boundaryB);
+
+  /**
+   * Destructor.
+   **/
+  ~Decomposition2d();
+
+  /**
+   * Gets the id of the process.
+   *
+   * @return rank in the communicator.
+   **/
+  int getRank() const
+  {
+    return m_rank;
+  }
+
+  /**
+   * Gets the number of processes in x- and y-direction.
+   *
+   * @param o_nRanksX will be set to the number of processes in x-direction.
+   * @param o_nRanksY will be set to the number of processes in y-direction.
+   **/
+  void getRanks(t_idx &o_nRanksX,
+                t_idx &o_nRanksY) const
+  {
+    o_nRanksX = m_nRanksX;
+    o_nRanksY = m_nRanksY;
+  }
+
+  /**
+   * Gets the cells of the subdomain.
+   *
+   * @param o_ix will be set to the first cell in x-direction.
+   * @param o_iy will be set to the first cell in y-direction.
+   * @param o_nx will be set to the number of cells in x-direction.
+   * @param o_ny will be set to the number of cells in y-direction.
+   **/
+  void getSubdomain(t_idx &o_ix,
+                    t_idx &o_iy,
+                    t_idx &o_nx,
+                    t_idx &o_ny) const
+  {
+    o_ix = m_firstCellX;
+    o_iy = m_firstCellY;
+    o_nx = m_nLocalX;
+    o_ny = m_nLocalY;
+  }
+
+  /**
+   * Checks whether a cell of the domain lies in the subdomain.
+   *
+   * @param i_ix id of the cell in x-direction.
+   * @param i_iy id of the cell in y-direction.
+   * @return true if the process owns the cell.
+   **/
+  bool isLocal(t_idx i_ix,
+               t_idx i_iy) const
+  {
+    return i_ix >= m_firstCellX && i_ix < m_firstCellX + m_nLocalX &&
+           i_iy >= m_firstCellY && i_iy < m_firstCellY + m_nLocalY;
+  }
+
+  /**
+   * Gets the boundary condition of a side of the local patch, the interfaces are outflow boundaries.
+   *
+   * @param i_side side.
+   * @return boundary condition.
+   **/
+  WavePropagation::Boundary getBoundary(Side i_side) const
+  {
+    return m_neighbours[i_side] == MPI_PROC_NULL ? m_boundaries[i_side] : WavePropagation::OUTFLOW;
+  }
+
+  /**
+   * Sets the patch of the subdomain, its cells have to be set before the first time step.
+   *
+   * @param i_patch 2d patch with the cells of the subdomain, has to outlive the decomposition.
+   **/
+  void setPatch(WavePropagation *i_patch)
+  {
+    m_patch = i_patch;
+  }
+
+  /**
+   * Sets the deep water in which the strips use the linearized solver, as for the local patch.
+   *
+   * @param i_minDepth minimum still water depth of the linearized edges; 0 or less disables the linearization.
+   * @param i_maxAmplitudeRatio maximum ratio of the surface elevation to the still water depth of the linearized edges.
+   **/
+  void setLinearization(t_real i_minDepth,
+                        t_real i_maxAmplitudeRatio)
+  {
+    m_linearDepth = i_minDepth;
+    m_linearAmplitudeRatio = i_maxAmplitudeRatio;
+  }
+
+  /**
+   * Performs a time step of the subdomain, every process has to call it.
+   *
+   * @param i_scalingX scaling of the time step (dt / dx).
+   * @param i_scalingY scaling of the time step (dt / dy).
+   **/
+  void timeStep(t_real i_scalingX,
+                t_real i_scalingY);
+
+  /**
+   * Gets the maximum wave speed |u| + sqrt(g * h) of the cells of all subdomains, every process has to call it.
+   *
+   * @return maximum wave speed.
+   **/
+  t_real getMaxWaveSpeed();
+
+  /**
+   * Gets the maximum of a value over all processes, every process has to call it.
+   *
+   * @param i_value value of the process.
+   * @return maximum value.
+   **/
+  t_real reduceMax(t_real i_value) const;
+};
+
+#endif
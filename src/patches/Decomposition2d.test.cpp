@@ -0,0 +1,184 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Unit tests of the domain decomposition, run them with mpirun -np N for N processes.
+ **/
+#include <catch2/catch.hpp>
+#include "Decomposition2d.h"
+#include "WavePropagation2d.h"
+#include "../systeminfo/Isa.h"
+#include <cmath>
+
+/**
+ * Gets the state of a cell of a basin with an island, which is dry in its center, and a bump of the surface.
+ **/
+static void getBasinState(tsunami_lab::t_idx i_ix,
+                          tsunami_lab::t_idx i_iy,
+                          tsunami_lab::t_real &o_h,
+                          tsunami_lab::t_real &o_b)
+{
+  tsunami_lab::t_real l_rIsland = std::hypot(tsunami_lab::t_real(i_ix) - 23, tsunami_lab::t_real(i_iy) - 16);
+  tsunami_lab::t_real l_rBump = std::hypot(tsunami_lab::t_real(i_ix) - 12, tsunami_lab::t_real(i_iy) - 9);
+  o_b = l_rIsland < 6 ? 6 - 2 * l_rIsland : -10;
+  o_h = std::max(-o_b, tsunami_lab::t_real(0));
+  if (l_rBump < 5)
+    o_h += 2;
+}
+
+TEST_CASE("Test the splitting of the domain into subdomains.", "[Decomposition2d]")
+{
+  int l_nRanks = 1;
+  MPI_Comm_size(MPI_COMM_WORLD, &l_nRanks);
+
+  for (tsunami_lab::t_idx l_align : {1, 4})
+  {
+    tsunami_lab::patches::Decomposition2d l_decomposition(MPI_COMM_WORLD,
+                                                          45,
+                                                          31,
+                                                          l_align,
+                                                          "fwave",
+                                                          tsunami_lab::patches::WavePropagation::WALL,
+                                                          tsunami_lab::patches::WavePropagation::OUTFLOW,
+                                                          tsunami_lab::patches::WavePropagation::WALL,
+                                                          tsunami_lab::patches::WavePropagation::OUTFLOW);
+    tsunami_lab::t_idx l_nRanksX, l_nRanksY;
+    l_decomposition.getRanks(l_nRanksX, l_nRanksY);
+    REQUIRE(l_nRanksX * l_nRanksY == tsunami_lab::t_idx(l_nRanks));
+
+    tsunami_lab::t_idx l_ix, l_iy, l_nx, l_ny;
+    l_decomposition.getSubdomain(l_ix, l_iy, l_nx, l_ny);
+    REQUIRE(l_nx > 0);
+    REQUIRE(l_ny > 0);
+    REQUIRE(l_ix % l_align == 0);
+    REQUIRE(l_iy % l_align == 0);
+    REQUIRE(l_decomposition.isLocal(l_ix, l_iy));
+    REQUIRE(l_decomposition.isLocal(l_ix + l_nx - 1, l_iy + l_ny - 1));
+    REQUIRE_FALSE(l_decomposition.isLocal(l_ix + l_nx, l_iy));
+    REQUIRE_FALSE(l_decomposition.isLocal(l_ix, l_iy + l_ny));
+
+    // every cell of the domain belongs to exactly one subdomain
+    long l_nCells = l_nx * l_ny;
+    long l_nCellsAll = 0;
+    MPI_Allreduce(&l_nCells, &l_nCellsAll, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+    REQUIRE(l_nCellsAll == 45 * 31);
+
+    // the interfaces keep the boundary conditions of the domain only at its sides
+    REQUIRE(l_decomposition.getBoundary(tsunami_lab::patches::Decomposition2d::LEFT) ==
+            (l_ix == 0 ? tsunami_lab::patches::WavePropagation::WALL : tsunami_lab::patches::WavePropagation::OUTFLOW));
+    REQUIRE(l_decomposition.getBoundary(tsunami_lab::patches::Decomposition2d::TOP) ==
+            (l_iy + l_ny == 31 ? tsunami_lab::patches::WavePropagation::WALL : tsunami_lab::patches::WavePropagation::OUTFLOW));
+
+    REQUIRE(l_decomposition.reduceMax(l_decomposition.getRank()) == l_nRanks - 1);
+  }
+}
+
+TEST_CASE("Test the time steps of the decomposed 2d wave propagation patch.", "[Decomposition2d]")
+{
+  tsunami_lab::t_idx const l_nCellsX = 45;
+  tsunami_lab::t_idx const l_nCellsY = 31;
+
+  // the AVX-512 kernels contract multiplications and additions in their vector loops only, which rounds the cells by their position in the rows
+  tsunami_lab::systeminfo::Isa::Level l_detected = tsunami_lab::systeminfo::Isa::detect();
+  for (int l_level = tsunami_lab::systeminfo::Isa::SCALAR; l_level <= 2 * l_detected + 1; l_level++)
+  {
+    tsunami_lab::systeminfo::Isa::select(tsunami_lab::systeminfo::Isa::Level(l_level / 2));
+    bool l_inPlace = l_level % 2;
+
+    // every process computes the reference of the whole domain
+    tsunami_lab::patches::WavePropagation *l_reference = tsunami_lab::patches::createWavePropagation2d(l_nCellsX,
+                                                                                                        l_nCellsY,
+                                                                                                        "fwave",
+                                                                                                        tsunami_lab::patches::WavePropagation::WALL,
+                                                                                                        tsunami_lab::patches::WavePropagation::OUTFLOW,
+                                                                                                        tsunami_lab::patches::WavePropagation::WALL,
+                                                                                                        tsunami_lab::patches::WavePropagation::OUTFLOW,
+                                                                                                        false);
+    tsunami_lab::patches::Decomposition2d l_decomposition(MPI_COMM_WORLD,
+                                                          l_nCellsX,
+                                                          l_nCellsY,
+                                                          1,
+                                                          "fwave",
+                                                          tsunami_lab::patches::WavePropagation::WALL,
+                                                          tsunami_lab::patches::WavePropagation::OUTFLOW,
+                                                          tsunami_lab::patches::WavePropagation::WALL,
+                                                          tsunami_lab::patches::WavePropagation::OUTFLOW);
+    tsunami_lab::t_idx l_ix, l_iy, l_nx, l_ny;
+    l_decomposition.getSubdomain(l_ix, l_iy, l_nx, l_ny);
+    tsunami_lab::patches::WavePropagation *l_local = tsunami_lab::patches::createWavePropagation2d(l_nx,
+                                                                                                    l_ny,
+                                                                                                    "fwave",
+                                                                                                    l_decomposition.getBoundary(tsunami_lab::patches::Decomposition2d::LEFT),
+                                                                                                    l_decomposition.getBoundary(tsunami_lab::patches::Decomposition2d::RIGHT),
+                                                                                                    l_decomposition.getBoundary(tsunami_lab::patches::Decomposition2d::TOP),
+                                                                                                    l_decomposition.getBoundary(tsunami_lab::patches::Decomposition2d::BOTTOM),
+                                                                                                    l_inPlace);
+    l_decomposition.setPatch(l_local);
+
+    // the in-place patches also skip the tiles at rest, the interface cells wake them
+    if (l_inPlace)
+      l_local->setActivityThreshold(0);
+
+    for (tsunami_lab::t_idx l_cy = 0; l_cy < l_nCellsY; l_cy++)
+    {
+      for (tsunami_lab::t_idx l_cx = 0; l_cx < l_nCellsX; l_cx++)
+      {
+        tsunami_lab::t_real l_h, l_b;
+        getBasinState(l_cx, l_cy, l_h, l_b);
+        l_reference->setHeight(l_cx, l_cy, l_h);
+        l_reference->setMomentumX(l_cx, l_cy, 0);
+        l_reference->setMomentumY(l_cx, l_cy, 0);
+        l_reference->setBathymetry(l_cx, l_cy, l_b);
+        if (l_decomposition.isLocal(l_cx, l_cy))
+        {
+          l_local->setHeight(l_cx - l_ix, l_cy - l_iy, l_h);
+          l_local->setMomentumX(l_cx - l_ix, l_cy - l_iy, 0);
+          l_local->setMomentumY(l_cx - l_ix, l_cy - l_iy, 0);
+          l_local->setBathymetry(l_cx - l_ix, l_cy - l_iy, l_b);
+        }
+      }
+    }
+
+    // the wave crosses the interfaces, which also cut the island
+    l_reference->setMaxWaveSpeedTracking(true);
+    for (tsunami_lab::t_idx l_st = 0; l_st < 80; l_st++)
+    {
+      l_reference->timeStep(0.05, 0.05);
+      l_decomposition.timeStep(0.05, 0.05);
+    }
+
+    // the subdomains hold the cells of the undivided patch, all processes take the wave speed of the whole domain
+    tsunami_lab::t_idx l_nDifferent = 0;
+    tsunami_lab::t_real l_maxDifference = 0;
+    for (tsunami_lab::t_idx l_cy = 0; l_cy < l_ny; l_cy++)
+    {
+      for (tsunami_lab::t_idx l_cx = 0; l_cx < l_nx; l_cx++)
+      {
+        tsunami_lab::t_idx l_ceRef = l_ix + l_cx + (l_iy + l_cy) * l_reference->getStride();
+        tsunami_lab::t_idx l_ce = l_cx + l_cy * l_local->getStride();
+        if (l_local->getHeight()[l_ce] != l_reference->getHeight()[l_ceRef] ||
+            l_local->getMomentumX()[l_ce] != l_reference->getMomentumX()[l_ceRef] ||
+            l_local->getMomentumY()[l_ce] != l_reference->getMomentumY()[l_ceRef])
+          l_nDifferent++;
+        l_maxDifference = std::max(l_maxDifference, std::abs(l_local->getHeight()[l_ce] - l_reference->getHeight()[l_ceRef]));
+      }
+    }
+    tsunami_lab::t_real l_maxWaveSpeed = l_decomposition.getMaxWaveSpeed();
+    REQUIRE(l_maxDifference < 1E-4);
+    REQUIRE(l_maxWaveSpeed == Approx(l_reference->getMaxWaveSpeed()));
+    if (l_level / 2 < tsunami_lab::systeminfo::Isa::AVX512)
+    {
+      REQUIRE(l_nDifferent == 0);
+      REQUIRE(l_maxWaveSpeed == l_reference->getMaxWaveSpeed());
+    }
+
+    // the wave passed the island
+    tsunami_lab::t_idx l_ceBehind = 40 + 28 * l_reference->getStride();
+    REQUIRE(l_reference->getHeight()[l_ceBehind] > 10);
+
+    delete l_local;
+    delete l_reference;
+  }
+  tsunami_lab::systeminfo::Isa::select(l_detected);
+}
@@ -0,0 +1,126 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Aligned and padded storage of the cell arrays of the wave propagation patches.
+ **/
+#include "Field2d.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include <cstdlib>
+#include <new>
+
+tsunami_lab::patches::Field2d::Pool tsunami_lab::patches::Field2d::m_pool;
+bool tsunami_lab::patches::Field2d::m_useHugePages = false;
+
+tsunami_lab::patches::Field2d::Pool::~Pool()
+{
+  for (Buffer const &l_buffer : buffers)
+    std::free(l_buffer.data);
+}
+
+tsunami_lab::patches::Field2d::Field2d(t_idx i_nCellsX,
+                                       t_idx i_nCellsY)
+{
+  allocate(i_nCellsX, i_nCellsY);
+}
+
+tsunami_lab::patches::Field2d::~Field2d()
+{
+  release();
+}
+
+void tsunami_lab::patches::Field2d::allocate(t_idx i_nCellsX,
+                                             t_idx i_nCellsY)
+{
+  release();
+
+  m_pitch = padPitch(i_nCellsX);
+
+  // aligned allocations have to span whole multiples of the alignment
+  std::size_t l_nBytes = m_pitch * i_nCellsY * sizeof(t_real);
+  m_hugePages = m_useHugePages && l_nBytes >= m_hugePageSize;
+  std::size_t l_granularity = m_hugePages ? m_hugePageSize : m_alignment;
+  m_nBytes = (l_nBytes + l_granularity - 1) / l_granularity * l_granularity;
+  if (m_nBytes == 0)
+    m_nBytes = l_granularity;
+
+  m_data = static_cast<t_real *>(acquire(m_nBytes, m_hugePages));
+}
+
+void tsunami_lab::patches::Field2d::release()
+{
+  if (m_data != nullptr)
+  {
+    std::lock_guard<std::mutex> l_lock(m_pool.mutex);
+    if (m_pool.buffers.size() < m_maxPoolSize)
+      m_pool.buffers.push_back({m_data, m_nBytes, m_hugePages});
+    else
+      std::free(m_data);
+  }
+  m_data = nullptr;
+  m_nBytes = 0;
+  m_hugePages = false;
+  m_pitch = 0;
+}
+
+void *tsunami_lab::patches::Field2d::acquire(std::size_t i_nBytes,
+                                             bool i_hugePages)
+{
+  {
+    std::lock_guard<std::mutex> l_lock(m_pool.mutex);
+    for (std::size_t l_bu = 0; l_bu < m_pool.buffers.size(); l_bu++)
+    {
+      if (m_pool.buffers[l_bu].nBytes == i_nBytes && m_pool.buffers[l_bu].hugePages == i_hugePages)
+      {
+        void *l_data = m_pool.buffers[l_bu].data;
+        m_pool.buffers.erase(m_pool.buffers.begin() + l_bu);
+        return l_data;
+      }
+    }
+  }
+
+  void *l_data = std::aligned_alloc(i_hugePages ? m_hugePageSize : m_alignment, i_nBytes);
+  if (l_data == nullptr)
+    throw std::bad_alloc();
+
+#ifdef __linux__
+  // the advice is a hint, the buffer is usable without huge pages as well
+  if (i_hugePages)
+    madvise(l_data, i_nBytes, MADV_HUGEPAGE);
+#endif
+
+  return l_data;
+}
+
+tsunami_lab::t_idx tsunami_lab::patches::Field2d::padPitch(t_idx i_nCellsX)
+{
+  t_idx l_cellsPerLine = m_alignment / sizeof(t_real);
+  t_idx l_nLines = (i_nCellsX + l_cellsPerLine - 1) / l_cellsPerLine;
+  if (l_nLines % 2 == 0)
+    l_nLines++;
+  return l_nLines * l_cellsPerLine;
+}
+
+void tsunami_lab::patches::Field2d::setHugePages(bool i_hugePages)
+{
+  m_useHugePages = i_hugePages;
+}
+
+void tsunami_lab::patches::Field2d::releasePool()
+{
+  std::lock_guard<std::mutex> l_lock(m_pool.mutex);
+  for (Buffer const &l_buffer : m_pool.buffers)
+    std::free(l_buffer.data);
+  m_pool.buffers.clear();
+}
+
+std::size_t tsunami_lab::patches::Field2d::getPoolSize()
+{
+  std::lock_guard<std::mutex> l_lock(m_pool.mutex);
+  return m_pool.buffers.size();
+}
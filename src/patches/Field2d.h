@@ -0,0 +1,183 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Aligned and padded storage of the cell arrays of the wave propagation patches.
+ **/
+#ifndef TSUNAMI_LAB_PATCHES_FIELD_2D
+#define TSUNAMI_LAB_PATCHES_FIELD_2D
+
+#include "../constants.h"
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace tsunami_lab
+{
+  namespace patches
+  {
+    class Field2d;
+  }
+}
+
+/**
+ * Row-major array of cells whose rows start at cache line boundaries.
+ * The rows are padded to an odd number of cache lines, which maps the cells of a column to different cache sets for every row length.
+ * Released buffers are kept in a pool and reused by fields of the same size, which spares the page faults of fresh allocations.
+ **/
+class tsunami_lab::patches::Field2d
+{
+public:
+  //! alignment in bytes of the rows
+  static std::size_t constexpr m_alignment = 64;
+
+  //! size in bytes of the transparent huge pages
+  static std::size_t constexpr m_hugePageSize = std::size_t(2) << 20;
+
+  //! maximum number of pooled buffers, which covers the fields of a patch
+  static std::size_t constexpr m_maxPoolSize = 16;
+
+private:
+  //! buffer of a field or of the pool
+  struct Buffer
+  {
+    //! memory of the buffer
+    void *data;
+
+    //! size of the buffer in bytes
+    std::size_t nBytes;
+
+    //! true if the buffer is advised to use transparent huge pages
+    bool hugePages;
+  };
+
+  //! cells of the field
+  t_real *m_data = nullptr;
+
+  //! size of the buffer in bytes
+  std::size_t m_nBytes = 0;
+
+  //! true if the buffer is advised to use transparent huge pages
+  bool m_hugePages = false;
+
+  //! number of cells from one row to the next, including the padding
+  t_idx m_pitch = 0;
+
+  //! released buffers, which are reused by fields of the same size
+  struct Pool
+  {
+    //! pooled buffers
+    std::vector<Buffer> buffers;
+
+    //! guards the buffers
+    std::mutex mutex;
+
+    /**
+     * Destructor which frees the pooled buffers.
+     **/
+    ~Pool();
+  };
+
+  //! pool of the released buffers
+  static Pool m_pool;
+
+  //! true if new buffers of at least one huge page are advised to use transparent huge pages
+  static bool m_useHugePages;
+
+  /**
+   * Gets a buffer from the pool or allocates a new one.
+   *
+   * @param i_nBytes size of the buffer in bytes.
+   * @param i_hugePages true if the buffer is advised to use transparent huge pages.
+   * @return aligned buffer; its contents are undefined.
+   **/
+  static void *acquire(std::size_t i_nBytes,
+                       bool i_hugePages);
+
+public:
+  /**
+   * Constructs an empty field.
+   **/
+  Field2d() = default;
+
+  /**
+   * Constructs a field; the cells are not initialized.
+   *
+   * @param i_nCellsX number of cells per row.
+   * @param i_nCellsY number of rows.
+   **/
+  Field2d(t_idx i_nCellsX,
+          t_idx i_nCellsY);
+
+  /**
+   * Destructor which returns the buffer to the pool.
+   **/
+  ~Field2d();
+
+  Field2d(Field2d const &) = delete;
+  Field2d &operator=(Field2d const &) = delete;
+
+  /**
+   * Allocates the cells of the field and releases the previous ones; the cells are not initialized.
+   *
+   * @param i_nCellsX number of cells per row.
+   * @param i_nCellsY number of rows.
+   **/
+  void allocate(t_idx i_nCellsX,
+                t_idx i_nCellsY);
+
+  /**
+   * Returns the buffer to the pool and leaves the field empty; the buffer is freed if the pool is full.
+   **/
+  void release();
+
+  /**
+   * Gets the cells of the field.
+   *
+   * @return cells; nullptr if the field is empty.
+   **/
+  t_real *getData() const
+  {
+    return m_data;
+  }
+
+  /**
+   * Gets the number of cells from one row to the next.
+   *
+   * @return pitch of the rows.
+   **/
+  t_idx getPitch() const
+  {
+    return m_pitch;
+  }
+
+  /**
+   * Gets the padded pitch of rows of the given length.
+   *
+   * @param i_nCellsX number of cells per row.
+   * @return smallest number of cells of at least i_nCellsX which spans an odd number of cache lines.
+   **/
+  static t_idx padPitch(t_idx i_nCellsX);
+
+  /**
+   * Sets whether new buffers of at least one huge page are advised to use transparent huge pages (Linux only).
+   *
+   * @param i_hugePages true to advise transparent huge pages.
+   **/
+  static void setHugePages(bool i_hugePages);
+
+  /**
+   * Frees the buffers of the pool, e.g. the ones which a new patch did not reuse.
+   **/
+  static void releasePool();
+
+  /**
+   * Gets the number of buffers in the pool.
+   *
+   * @return number of pooled buffers.
+   **/
+  static std::size_t getPoolSize();
+};
+
+#endif
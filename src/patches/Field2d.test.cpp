@@ -0,0 +1,76 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Unit tests of the field storage.
+ **/
+#include <catch2/catch.hpp>
+#include "Field2d.h"
+#include <cstdint>
+
+TEST_CASE("Test the padded pitch of the fields.", "[Field2d]")
+{
+  tsunami_lab::t_idx l_cellsPerLine = tsunami_lab::patches::Field2d::m_alignment / sizeof(tsunami_lab::t_real);
+
+  for (tsunami_lab::t_idx l_nx : {1, 15, 16, 17, 102, 256, 1000, 1024, 4096})
+  {
+    tsunami_lab::t_idx l_pitch = tsunami_lab::patches::Field2d::padPitch(l_nx);
+
+    // the rows span an odd number of cache lines and are as short as possible
+    REQUIRE(l_pitch >= l_nx);
+    REQUIRE(l_pitch % l_cellsPerLine == 0);
+    REQUIRE((l_pitch / l_cellsPerLine) % 2 == 1);
+    REQUIRE(l_pitch < l_nx + 2 * l_cellsPerLine);
+  }
+
+  // power-of-two rows are padded
+  REQUIRE(tsunami_lab::patches::Field2d::padPitch(1024) == 1024 + l_cellsPerLine);
+  REQUIRE(tsunami_lab::patches::Field2d::padPitch(102) == 7 * l_cellsPerLine);
+}
+
+TEST_CASE("Test the alignment and the pool of the fields.", "[Field2d]")
+{
+  tsunami_lab::patches::Field2d::releasePool();
+
+  tsunami_lab::patches::Field2d l_field(102, 50);
+  REQUIRE(l_field.getPitch() == tsunami_lab::patches::Field2d::padPitch(102));
+  REQUIRE(reinterpret_cast<std::uintptr_t>(l_field.getData()) % tsunami_lab::patches::Field2d::m_alignment == 0);
+
+  // every row is writable and starts at a cache line
+  for (tsunami_lab::t_idx l_ro = 0; l_ro < 50; l_ro++)
+  {
+    tsunami_lab::t_real *l_row = l_field.getData() + l_ro * l_field.getPitch();
+    REQUIRE(reinterpret_cast<std::uintptr_t>(l_row) % tsunami_lab::patches::Field2d::m_alignment == 0);
+    for (tsunami_lab::t_idx l_co = 0; l_co < l_field.getPitch(); l_co++)
+      l_row[l_co] = l_co;
+  }
+
+  // a released buffer is reused by a field of the same size
+  tsunami_lab::t_real *l_data = l_field.getData();
+  l_field.release();
+  REQUIRE(l_field.getData() == nullptr);
+  REQUIRE(tsunami_lab::patches::Field2d::getPoolSize() == 1);
+
+  tsunami_lab::patches::Field2d l_other(30, 7);
+  REQUIRE(tsunami_lab::patches::Field2d::getPoolSize() == 1);
+
+  l_field.allocate(102, 50);
+  REQUIRE(l_field.getData() == l_data);
+  REQUIRE(tsunami_lab::patches::Field2d::getPoolSize() == 0);
+
+  // reallocating returns the previous buffer to the pool
+  l_other.allocate(30, 8);
+  REQUIRE(tsunami_lab::patches::Field2d::getPoolSize() == 1);
+
+  tsunami_lab::patches::Field2d::releasePool();
+  REQUIRE(tsunami_lab::patches::Field2d::getPoolSize() == 0);
+
+  // the pool keeps a limited number of buffers, the others are freed
+  {
+    tsunami_lab::patches::Field2d l_fields[tsunami_lab::patches::Field2d::m_maxPoolSize + 4];
+    for (tsunami_lab::patches::Field2d &l_fi : l_fields)
+      l_fi.allocate(10, 10);
+  }
+  REQUIRE(tsunami_lab::patches::Field2d::getPoolSize() == tsunami_lab::patches::Field2d::m_maxPoolSize);
+}
@@ -0,0 +1,732 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Block-structured refinement of a two-dimensional wave propagation patch.
+ **/
+#include "Refinement2d.h"
+#include "WavePropagation2d.h"
+#include "../solvers/Roe.h"
+#include "../solvers/Fwave.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Divides with rounding towards negative infinity, ring cells of the fine patches have negative global ids.
+ **/
+static long floorDiv(long i_a,
+                     long i_b)
+{
+  return i_a >= 0 ? i_a / i_b : -((-i_a + i_b - 1) / i_b);
+}
+
+/**
+ * Prolongs a coarse state to one of its fine cells.
+ * The water fills the lowest of the i_nCells fine cells with the ascending bathymetries i_bSorted first,
+ * which keeps the volume of the coarse cell, and moves with the coarse velocity.
+ **/
+static void prolong(tsunami_lab::t_real const *i_bSorted,
+                    tsunami_lab::t_idx i_nCells,
+                    tsunami_lab::t_real i_h,
+                    tsunami_lab::t_real i_hu,
+                    tsunami_lab::t_real i_hv,
+                    tsunami_lab::t_real i_bF,
+                    tsunami_lab::t_real &o_hF,
+                    tsunami_lab::t_real &o_huF,
+                    tsunami_lab::t_real &o_hvF)
+{
+  o_hF = 0;
+  o_huF = 0;
+  o_hvF = 0;
+  if (i_h <= 0)
+    return;
+
+  // surface of the volume over the k lowest fine cells, further cells are flooded as long as they lie below it
+  tsunami_lab::t_real l_volume = i_h * tsunami_lab::t_real(i_nCells);
+  tsunami_lab::t_real l_bSum = i_bSorted[0];
+  tsunami_lab::t_real l_surface = l_bSum + l_volume;
+  for (tsunami_lab::t_idx l_ce = 1; l_ce < i_nCells && l_surface > i_bSorted[l_ce]; l_ce++)
+  {
+    l_bSum += i_bSorted[l_ce];
+    l_surface = (l_volume + l_bSum) / tsunami_lab::t_real(l_ce + 1);
+  }
+
+  o_hF = std::max(l_surface - i_bF, tsunami_lab::t_real(0));
+  o_huF = i_hu / i_h * o_hF;
+  o_hvF = i_hv / i_h * o_hF;
+}
+
+/**
+ * Computes the net-updates of the Roe solver, which ignores the bathymetry.
+ **/
+static void roeNetUpdates(tsunami_lab::t_real i_hL,
+                          tsunami_lab::t_real i_hR,
+                          tsunami_lab::t_real i_huL,
+                          tsunami_lab::t_real i_huR,
+                          tsunami_lab::t_real,
+                          tsunami_lab::t_real,
+                          tsunami_lab::t_real o_netUpdateL[2],
+                          tsunami_lab::t_real o_netUpdateR[2])
+{
+  tsunami_lab::solvers::Roe::netUpdates(i_hL, i_hR, i_huL, i_huR, o_netUpdateL, o_netUpdateR);
+}
+
+tsunami_lab::patches::Refinement2d::Refinement2d(WavePropagation *i_coarse,
+                                                 t_idx i_nCellsX,
+                                                 t_idx i_nCellsY,
+                                                 t_real i_dx,
+                                                 t_real i_dy,
+                                                 t_real i_offsetX,
+                                                 t_real i_offsetY,
+                                                 std::string const &i_solver,
+                                                 setups::Setup const *i_setup,
+                                                 t_idx i_ratio)
+{
+  m_coarse = i_coarse;
+  m_nCellsX = i_nCellsX;
+  m_nCellsY = i_nCellsY;
+  m_dx = i_dx;
+  m_dy = i_dy;
+  m_offsetX = i_offsetX;
+  m_offsetY = i_offsetY;
+  m_solver = i_solver;
+  m_netUpdates = m_solver == "roe" ? roeNetUpdates : solvers::Fwave::netUpdates;
+  m_setup = i_setup;
+  m_ratio = std::max(i_ratio, t_idx(1));
+  m_blockOfCell.assign(m_nCellsX * m_nCellsY, -1);
+}
+
+tsunami_lab::patches::Refinement2d::~Refinement2d()
+{
+  for (Block *l_block : m_blocks)
+  {
+    delete l_block->patch;
+    delete l_block;
+  }
+}
+
+void tsunami_lab::patches::Refinement2d::setBlockSize(t_idx i_nCells)
+{
+  m_blockSize = std::max(i_nCells, t_idx(1));
+}
+
+void tsunami_lab::patches::Refinement2d::setRegridFrequency(t_idx i_nSteps)
+{
+  m_regridFrequency = i_nSteps;
+}
+
+void tsunami_lab::patches::Refinement2d::setCriteria(t_real i_amplitude,
+                                                     t_real i_depthGradient,
+                                                     t_real i_coastDepth)
+{
+  m_amplitude = i_amplitude;
+  m_depthGradient = i_depthGradient;
+  m_coastDepth = i_coastDepth;
+}
+
+void tsunami_lab::patches::Refinement2d::addPoint(t_real i_x,
+                                                  t_real i_y,
+                                                  t_real i_radius)
+{
+  m_points.push_back(i_x);
+  m_points.push_back(i_y);
+  m_points.push_back(i_radius);
+}
+
+void tsunami_lab::patches::Refinement2d::getBlockCells(t_idx i_bl,
+                                                       t_idx &o_ix,
+                                                       t_idx &o_iy,
+                                                       t_idx &o_nx,
+                                                       t_idx &o_ny) const
+{
+  o_ix = m_blocks[i_bl]->ix;
+  o_iy = m_blocks[i_bl]->iy;
+  o_nx = m_blocks[i_bl]->nx;
+  o_ny = m_blocks[i_bl]->ny;
+}
+
+void tsunami_lab::patches::Refinement2d::getCoarseState(long i_ix,
+                                                        long i_iy,
+                                                        t_real &o_h,
+                                                        t_real &o_hu,
+                                                        t_real &o_hv,
+                                                        t_real &o_b)
+{
+  t_idx l_ix = std::clamp(i_ix, long(0), long(m_nCellsX) - 1);
+  t_idx l_iy = std::clamp(i_iy, long(0), long(m_nCellsY) - 1);
+  t_idx l_ce = l_ix + l_iy * m_coarse->getStride();
+
+  o_h = m_coarse->getHeight()[l_ce];
+  o_hu = m_coarse->getMomentumX()[l_ce];
+  o_hv = m_coarse->getMomentumY()[l_ce];
+  o_b = m_coarse->getBathymetry()[l_ce];
+}
+
+bool tsunami_lab::patches::Refinement2d::isUncovered(long i_ix,
+                                                     long i_iy) const
+{
+  if (i_ix < 0 || i_iy < 0 || i_ix >= long(m_nCellsX) || i_iy >= long(m_nCellsY))
+    return false;
+  return m_blockOfCell[i_ix + i_iy * m_nCellsX] < 0;
+}
+
+tsunami_lab::t_real tsunami_lab::patches::Refinement2d::massFlux(t_real i_hL,
+                                                                 t_real i_hR,
+                                                                 t_real i_huL,
+                                                                 t_real i_huR,
+                                                                 t_real i_bL,
+                                                                 t_real i_bR) const
+{
+  // the patches reflect dry sides with the same margin, no water crosses such edges
+  t_real const l_margin = 0.00001;
+  if (i_hL <= l_margin || i_hR <= l_margin)
+    return 0;
+
+  // the left net-update is the flux difference between the edge and the left cell
+  t_real l_netUpdateL[2] = {0, 0};
+  t_real l_netUpdateR[2] = {0, 0};
+  m_netUpdates(i_hL, i_hR, i_huL, i_huR, i_bL, i_bR, l_netUpdateL, l_netUpdateR);
+
+  return i_huL + l_netUpdateL[0];
+}
+
+tsunami_lab::patches::Refinement2d::Block *tsunami_lab::patches::Refinement2d::createBlock(t_idx i_ix,
+                                                                                             t_idx i_iy,
+                                                                                             t_idx i_nx,
+                                                                                             t_idx i_ny,
+                                                                                             t_idx i_ratio,
+                                                                                             t_idx i_nSteps,
+                                                                                             bool i_fromSetup)
+{
+  Block *l_block = new Block;
+  l_block->ix = i_ix;
+  l_block->iy = i_iy;
+  l_block->nx = i_nx;
+  l_block->ny = i_ny;
+  l_block->ratio = i_ratio;
+  l_block->nSteps = i_nSteps;
+
+  t_idx l_nxF = i_nx * i_ratio + 2;
+  t_idx l_nyF = i_ny * i_ratio + 2;
+  l_block->patch = createWavePropagation2d(l_nxF,
+                                           l_nyF,
+                                           m_solver,
+                                           WavePropagation::OUTFLOW,
+                                           WavePropagation::OUTFLOW,
+                                           WavePropagation::OUTFLOW,
+                                           WavePropagation::OUTFLOW,
+                                           false);
+  l_block->hOld.assign((i_nx + 2) * (i_ny + 2), 0);
+  l_block->huOld.assign((i_nx + 2) * (i_ny + 2), 0);
+  l_block->hvOld.assign((i_nx + 2) * (i_ny + 2), 0);
+  l_block->bRing.assign(l_nxF * l_nyF, 0);
+  l_block->fluxL.assign(i_ny, 0);
+  l_block->fluxR.assign(i_ny, 0);
+  l_block->fluxB.assign(i_nx, 0);
+  l_block->fluxT.assign(i_nx, 0);
+
+  // the fine cells partition the coarse cells, whose samples were taken at their centers;
+  // ring cells outside of the domain take the adjacent fine cell
+  t_real l_dxF = m_dx / i_ratio;
+  t_real l_dyF = m_dy / i_ratio;
+  t_idx l_nFine = i_ratio * i_ratio;
+  l_block->bSorted.resize((i_nx + 2) * (i_ny + 2) * l_nFine);
+  for (t_idx l_oy = 0; l_oy < i_ny + 2; l_oy++)
+  {
+    long l_cy = std::clamp(long(i_iy + l_oy) - 1, long(0), long(m_nCellsY) - 1);
+    for (t_idx l_ox = 0; l_ox < i_nx + 2; l_ox++)
+    {
+      long l_cx = std::clamp(long(i_ix + l_ox) - 1, long(0), long(m_nCellsX) - 1);
+      t_real *l_bSorted = &l_block->bSorted[(l_ox + l_oy * (i_nx + 2)) * l_nFine];
+      for (t_idx l_sy = 0; l_sy < i_ratio; l_sy++)
+      {
+        t_real l_y = m_offsetY + (l_cy * i_ratio + l_sy + t_real(0.5)) * l_dyF - t_real(0.5) * m_dy;
+        for (t_idx l_sx = 0; l_sx < i_ratio; l_sx++)
+        {
+          t_real l_x = m_offsetX + (l_cx * i_ratio + l_sx + t_real(0.5)) * l_dxF - t_real(0.5) * m_dx;
+          l_bSorted[l_sx + l_sy * i_ratio] = m_setup != nullptr ? m_setup->getCellBathymetry(l_x, l_y, l_dxF, l_dyF)
+                                                                : m_coarse->getBathymetry()[l_cx + l_cy * m_coarse->getStride()];
+        }
+      }
+      std::sort(l_bSorted, l_bSorted + l_nFine);
+    }
+  }
+
+  for (t_idx l_fy = 0; l_fy < l_nyF; l_fy++)
+  {
+    long l_gy = std::clamp(long(i_iy * i_ratio + l_fy) - 1, long(0), long(m_nCellsY * i_ratio) - 1);
+    long l_cy = l_gy / long(i_ratio);
+    t_real l_y = m_offsetY + (l_gy + t_real(0.5)) * l_dyF - t_real(0.5) * m_dy;
+    for (t_idx l_fx = 0; l_fx < l_nxF; l_fx++)
+    {
+      long l_gx = std::clamp(long(i_ix * i_ratio + l_fx) - 1, long(0), long(m_nCellsX * i_ratio) - 1);
+      long l_cx = l_gx / long(i_ratio);
+      t_real l_x = m_offsetX + (l_gx + t_real(0.5)) * l_dxF - t_real(0.5) * m_dx;
+
+      t_real l_h, l_hu, l_hv, l_b;
+      getCoarseState(l_cx, l_cy, l_h, l_hu, l_hv, l_b);
+      t_real l_bF = m_setup != nullptr ? m_setup->getCellBathymetry(l_x, l_y, l_dxF, l_dyF) : l_b;
+
+      // the fine cells take the volumes and velocities of the coarse cells, the ones of the setup keep its surface elevation
+      t_real l_hF = 0;
+      t_real l_huF = 0;
+      t_real l_hvF = 0;
+      if (i_fromSetup && m_setup != nullptr)
+      {
+        t_real l_hSetup = m_setup->getHeight(l_x, l_y);
+        if (l_hSetup > 0)
+        {
+          l_hF = std::max(l_hSetup + m_setup->getBathymetry(l_x, l_y) - l_bF, t_real(0));
+          l_huF = l_hF > 0 ? m_setup->getMomentumX(l_x, l_y) : 0;
+          l_hvF = l_hF > 0 ? m_setup->getMomentumY(l_x, l_y) : 0;
+        }
+      }
+      else
+      {
+        t_idx l_ceOld = (l_cx - long(i_ix) + 1) + (l_cy - long(i_iy) + 1) * (i_nx + 2);
+        prolong(&l_block->bSorted[l_ceOld * l_nFine], l_nFine, l_h, l_hu, l_hv, l_bF, l_hF, l_huF, l_hvF);
+      }
+
+      l_block->patch->setHeight(l_fx, l_fy, l_hF);
+      l_block->patch->setMomentumX(l_fx, l_fy, l_huF);
+      l_block->patch->setMomentumY(l_fx, l_fy, l_hvF);
+      l_block->patch->setBathymetry(l_fx, l_fy, l_bF);
+      l_block->bRing[l_fx + l_fy * l_nxF] = l_bF;
+    }
+  }
+
+  // the covered coarse cells take the means, which keeps their surface elevation and makes the mass of both levels match
+  t_idx l_strideF = l_block->patch->getStride();
+  t_real const *l_bF = l_block->patch->getBathymetry();
+  t_real l_scale = t_real(1) / t_real(i_ratio * i_ratio);
+  for (t_idx l_cy = 0; l_cy < i_ny; l_cy++)
+  {
+    for (t_idx l_cx = 0; l_cx < i_nx; l_cx++)
+    {
+      t_real l_bSum = 0;
+      for (t_idx l_sy = 0; l_sy < i_ratio; l_sy++)
+        for (t_idx l_sx = 0; l_sx < i_ratio; l_sx++)
+          l_bSum += l_bF[1 + l_cx * i_ratio + l_sx + (1 + l_cy * i_ratio + l_sy) * l_strideF];
+      m_coarse->setBathymetry(i_ix + l_cx, i_iy + l_cy, l_bSum * l_scale);
+    }
+  }
+  // the bathymetry setter lets the coarse patch derive its dry cells again
+  restrictToCoarse(*l_block);
+
+  return l_block;
+}
+
+void tsunami_lab::patches::Refinement2d::setRing(Block &io_block,
+                                                 t_real i_weight)
+{
+  WavePropagation *l_patch = io_block.patch;
+  t_idx l_nxF = io_block.nx * io_block.ratio + 2;
+  t_idx l_nyF = io_block.ny * io_block.ratio + 2;
+  t_idx l_stride = l_patch->getStride();
+  t_idx l_strideOld = io_block.nx + 2;
+
+  for (t_idx l_fy = 0; l_fy < l_nyF; l_fy++)
+  {
+    long l_gy = long(io_block.iy * io_block.ratio + l_fy) - 1;
+    long l_cy = floorDiv(l_gy, io_block.ratio);
+    bool l_ringRow = l_fy == 0 || l_fy + 1 == l_nyF;
+    for (t_idx l_fx = 0; l_fx < l_nxF; l_fx += (l_ringRow ? 1 : l_nxF - 1))
+    {
+      long l_gx = long(io_block.ix * io_block.ratio + l_fx) - 1;
+      long l_cx = floorDiv(l_gx, io_block.ratio);
+
+      t_real l_hF = 0;
+      t_real l_huF = 0;
+      t_real l_hvF = 0;
+      if (l_cx < 0 || l_cy < 0 || l_cx >= long(m_nCellsX) || l_cy >= long(m_nCellsY))
+      {
+        // outside of the domain, the ring copies the adjacent fine cell
+        t_idx l_ixIn = std::clamp(l_fx, t_idx(1), l_nxF - 2);
+        t_idx l_iyIn = std::clamp(l_fy, t_idx(1), l_nyF - 2);
+        t_idx l_ceIn = l_ixIn + l_iyIn * l_stride;
+        l_hF = l_patch->getHeight()[l_ceIn];
+        l_huF = l_patch->getMomentumX()[l_ceIn];
+        l_hvF = l_patch->getMomentumY()[l_ceIn];
+      }
+      else if (m_blockOfCell[l_cx + l_cy * m_nCellsX] >= 0 &&
+               isInStep(*m_blocks[m_blockOfCell[l_cx + l_cy * m_nCellsX]], io_block))
+      {
+        // a neighbouring block which advances together provides the fine cells at the same time
+        Block const &l_other = *m_blocks[m_blockOfCell[l_cx + l_cy * m_nCellsX]];
+        t_idx l_ceOther = (l_gx - l_other.ix * io_block.ratio + 1) + (l_gy - l_other.iy * io_block.ratio + 1) * l_other.patch->getStride();
+        l_hF = l_other.patch->getHeight()[l_ceOther];
+        l_huF = l_other.patch->getMomentumX()[l_ceOther];
+        l_hvF = l_other.patch->getMomentumY()[l_ceOther];
+      }
+      else
+      {
+        // the coarse states, linear in time, keep their volume and velocity;
+        // other blocks provide the means of their fine cells
+        t_real l_hNew, l_huNew, l_hvNew, l_b;
+        getCoarseState(l_cx, l_cy, l_hNew, l_huNew, l_hvNew, l_b);
+        t_idx l_ceOld = (l_cx - io_block.ix + 1) + (l_cy - io_block.iy + 1) * l_strideOld;
+        t_real l_h = (1 - i_weight) * io_block.hOld[l_ceOld] + i_weight * l_hNew;
+        t_real l_hu = (1 - i_weight) * io_block.huOld[l_ceOld] + i_weight * l_huNew;
+        t_real l_hv = (1 - i_weight) * io_block.hvOld[l_ceOld] + i_weight * l_hvNew;
+        t_idx l_nFine = io_block.ratio * io_block.ratio;
+        prolong(&io_block.bSorted[l_ceOld * l_nFine], l_nFine, l_h, l_hu, l_hv, io_block.bRing[l_fx + l_fy * l_nxF], l_hF, l_huF, l_hvF);
+      }
+      l_patch->setCellState(l_fx, l_fy, l_hF, l_huF, l_hvF);
+    }
+  }
+
+  // mass fluxes through the interfaces to uncovered coarse cells, the fine time step solves the same edges
+  t_real const *l_h = l_patch->getHeight();
+  t_real const *l_hu = l_patch->getMomentumX();
+  t_real const *l_hv = l_patch->getMomentumY();
+  t_real const *l_b = l_patch->getBathymetry();
+  for (t_idx l_fy = 1; l_fy < l_nyF - 1; l_fy++)
+  {
+    t_idx l_cy = (l_fy - 1) / io_block.ratio;
+    t_idx l_ceL = l_fy * l_stride;
+    t_idx l_ceR = l_nxF - 2 + l_fy * l_stride;
+    if (isUncovered(long(io_block.ix) - 1, io_block.iy + l_cy))
+      io_block.fluxL[l_cy] += massFlux(l_h[l_ceL], l_h[l_ceL + 1], l_hu[l_ceL], l_hu[l_ceL + 1], l_b[l_ceL], l_b[l_ceL + 1]);
+    if (isUncovered(io_block.ix + io_block.nx, io_block.iy + l_cy))
+      io_block.fluxR[l_cy] += massFlux(l_h[l_ceR], l_h[l_ceR + 1], l_hu[l_ceR], l_hu[l_ceR + 1], l_b[l_ceR], l_b[l_ceR + 1]);
+  }
+  for (t_idx l_fx = 1; l_fx < l_nxF - 1; l_fx++)
+  {
+    t_idx l_cx = (l_fx - 1) / io_block.ratio;
+    t_idx l_ceB = l_fx;
+    t_idx l_ceT = l_fx + (l_nyF - 2) * l_stride;
+    if (isUncovered(io_block.ix + l_cx, long(io_block.iy) - 1))
+      io_block.fluxB[l_cx] += massFlux(l_h[l_ceB], l_h[l_ceB + l_stride], l_hv[l_ceB], l_hv[l_ceB + l_stride], l_b[l_ceB], l_b[l_ceB + l_stride]);
+    if (isUncovered(io_block.ix + l_cx, io_block.iy + io_block.ny))
+      io_block.fluxT[l_cx] += massFlux(l_h[l_ceT], l_h[l_ceT + l_stride], l_hv[l_ceT], l_hv[l_ceT + l_stride], l_b[l_ceT], l_b[l_ceT + l_stride]);
+  }
+}
+
+void tsunami_lab::patches::Refinement2d::restrictToCoarse(Block const &i_block)
+{
+  t_idx l_strideF = i_block.patch->getStride();
+  t_real const *l_h = i_block.patch->getHeight();
+  t_real const *l_hu = i_block.patch->getMomentumX();
+  t_real const *l_hv = i_block.patch->getMomentumY();
+  t_real l_scale = t_real(1) / t_real(i_block.ratio * i_block.ratio);
+
+  for (t_idx l_cy = 0; l_cy < i_block.ny; l_cy++)
+  {
+    for (t_idx l_cx = 0; l_cx < i_block.nx; l_cx++)
+    {
+      t_real l_hSum = 0;
+      t_real l_huSum = 0;
+      t_real l_hvSum = 0;
+      for (t_idx l_sy = 0; l_sy < i_block.ratio; l_sy++)
+      {
+        t_idx l_ceF = 1 + l_cx * i_block.ratio + (1 + l_cy * i_block.ratio + l_sy) * l_strideF;
+        for (t_idx l_sx = 0; l_sx < i_block.ratio; l_sx++)
+        {
+          l_hSum += l_h[l_ceF + l_sx];
+          l_huSum += l_hu[l_ceF + l_sx];
+          l_hvSum += l_hv[l_ceF + l_sx];
+        }
+      }
+      m_coarse->setCellState(i_block.ix + l_cx,
+                             i_block.iy + l_cy,
+                             l_hSum * l_scale,
+                             l_huSum * l_scale,
+                             l_hvSum * l_scale);
+    }
+  }
+}
+
+void tsunami_lab::patches::Refinement2d::reflux(Block const &i_block,
+                                                t_real i_scalingX,
+                                                t_real i_scalingY)
+{
+  t_idx l_strideOld = i_block.nx + 2;
+  t_idx l_stride = m_coarse->getStride();
+  t_real const *l_b = m_coarse->getBathymetry();
+  // the fine fluxes were summed over ratio edges and nSteps time steps
+  t_real l_scale = t_real(1) / t_real(i_block.ratio * i_block.nSteps);
+
+  // edges to the left and right neighbours; the coarse flux is recomputed from the states before the coarse time step
+  for (t_idx l_cy = 0; l_cy < i_block.ny; l_cy++)
+  {
+    t_idx l_iy = i_block.iy + l_cy;
+    t_idx l_ceOld = (l_cy + 1) * l_strideOld;
+
+    long l_ixL = long(i_block.ix) - 1;
+    if (isUncovered(l_ixL, l_iy))
+    {
+      t_real l_fluxCoarse = massFlux(i_block.hOld[l_ceOld], i_block.hOld[l_ceOld + 1],
+                                     i_block.huOld[l_ceOld], i_block.huOld[l_ceOld + 1],
+                                     l_b[l_ixL + l_iy * l_stride], l_b[l_ixL + 1 + l_iy * l_stride]);
+      t_real l_dh = -i_scalingX * (i_block.fluxL[l_cy] * l_scale - l_fluxCoarse);
+      t_idx l_ce = l_ixL + l_iy * l_stride;
+      m_coarse->setCellState(l_ixL, l_iy, std::max(m_coarse->getHeight()[l_ce] + l_dh, t_real(0)),
+                             m_coarse->getMomentumX()[l_ce], m_coarse->getMomentumY()[l_ce]);
+    }
+
+    t_idx l_ixR = i_block.ix + i_block.nx;
+    if (isUncovered(l_ixR, l_iy))
+    {
+      t_idx l_ceOldR = l_ceOld + i_block.nx;
+      t_real l_fluxCoarse = massFlux(i_block.hOld[l_ceOldR], i_block.hOld[l_ceOldR + 1],
+                                     i_block.huOld[l_ceOldR], i_block.huOld[l_ceOldR + 1],
+                                     l_b[l_ixR - 1 + l_iy * l_stride], l_b[l_ixR + l_iy * l_stride]);
+      t_real l_dh = i_scalingX * (i_block.fluxR[l_cy] * l_scale - l_fluxCoarse);
+      t_idx l_ce = l_ixR + l_iy * l_stride;
+      m_coarse->setCellState(l_ixR, l_iy, std::max(m_coarse->getHeight()[l_ce] + l_dh, t_real(0)),
+                             m_coarse->getMomentumX()[l_ce], m_coarse->getMomentumY()[l_ce]);
+    }
+  }
+
+  // edges to the bottom and top neighbours; the coarse patch has no y-edges in its last column, their coarse mass flux is zero
+  for (t_idx l_cx = 0; l_cx < i_block.nx; l_cx++)
+  {
+    t_idx l_ix = i_block.ix + l_cx;
+    bool l_lastColumn = l_ix + 1 == m_nCellsX;
+
+    long l_iyB = long(i_block.iy) - 1;
+    if (isUncovered(l_ix, l_iyB))
+    {
+      t_idx l_ceOld = l_cx + 1;
+      t_real l_fluxCoarse = l_lastColumn ? 0
+                                         : massFlux(i_block.hOld[l_ceOld], i_block.hOld[l_ceOld + l_strideOld],
+                                                    i_block.hvOld[l_ceOld], i_block.hvOld[l_ceOld + l_strideOld],
+                                                    l_b[l_ix + l_iyB * l_stride], l_b[l_ix + (l_iyB + 1) * l_stride]);
+      t_real l_dh = -i_scalingY * (i_block.fluxB[l_cx] * l_scale - l_fluxCoarse);
+      t_idx l_ce = l_ix + l_iyB * l_stride;
+      m_coarse->setCellState(l_ix, l_iyB, std::max(m_coarse->getHeight()[l_ce] + l_dh, t_real(0)),
+                             m_coarse->getMomentumX()[l_ce], m_coarse->getMomentumY()[l_ce]);
+    }
+
+    t_idx l_iyT = i_block.iy + i_block.ny;
+    if (isUncovered(l_ix, l_iyT))
+    {
+      t_idx l_ceOld = l_cx + 1 + i_block.ny * l_strideOld;
+      t_real l_fluxCoarse = l_lastColumn ? 0
+                                         : massFlux(i_block.hOld[l_ceOld], i_block.hOld[l_ceOld + l_strideOld],
+                                                    i_block.hvOld[l_ceOld], i_block.hvOld[l_ceOld + l_strideOld],
+                                                    l_b[l_ix + (l_iyT - 1) * l_stride], l_b[l_ix + l_iyT * l_stride]);
+      t_real l_dh = i_scalingY * (i_block.fluxT[l_cx] * l_scale - l_fluxCoarse);
+      t_idx l_ce = l_ix + l_iyT * l_stride;
+      m_coarse->setCellState(l_ix, l_iyT, std::max(m_coarse->getHeight()[l_ce] + l_dh, t_real(0)),
+                             m_coarse->getMomentumX()[l_ce], m_coarse->getMomentumY()[l_ce]);
+    }
+  }
+}
+
+bool tsunami_lab::patches::Refinement2d::isTagged(t_idx i_ix,
+                                                  t_idx i_iy)
+{
+  // surroundings of the points, e.g., stations
+  t_real l_x = m_offsetX + i_ix * m_dx;
+  t_real l_y = m_offsetY + i_iy * m_dy;
+  for (t_idx l_pt = 0; l_pt < m_points.size(); l_pt += 3)
+  {
+    t_real l_distX = std::max(std::abs(m_points[l_pt] - l_x) - t_real(0.5) * m_dx, t_real(0));
+    t_real l_distY = std::max(std::abs(m_points[l_pt + 1] - l_y) - t_real(0.5) * m_dy, t_real(0));
+    if (l_distX * l_distX + l_distY * l_distY <= m_points[l_pt + 2] * m_points[l_pt + 2])
+      return true;
+  }
+
+  t_real l_h, l_hu, l_hv, l_b;
+  getCoarseState(i_ix, i_iy, l_h, l_hu, l_hv, l_b);
+  if (l_h <= 0)
+    return false;
+
+  // wave amplitude and shallow water near the coast
+  if (m_amplitude > 0 && std::abs(l_h + l_b) >= m_amplitude)
+    return true;
+  if (m_coastDepth > 0 && l_b > -m_coastDepth)
+    return true;
+
+  // steep bathymetry towards a neighbour
+  if (m_depthGradient > 0)
+  {
+    t_real const *l_bCoarse = m_coarse->getBathymetry();
+    t_idx l_stride = m_coarse->getStride();
+    t_idx l_ce = i_ix + i_iy * l_stride;
+    if (i_ix > 0 && std::abs(l_bCoarse[l_ce - 1] - l_b) >= m_depthGradient * m_dx)
+      return true;
+    if (i_ix + 1 < m_nCellsX && std::abs(l_bCoarse[l_ce + 1] - l_b) >= m_depthGradient * m_dx)
+      return true;
+    if (i_iy > 0 && std::abs(l_bCoarse[l_ce - l_stride] - l_b) >= m_depthGradient * m_dy)
+      return true;
+    if (i_iy + 1 < m_nCellsY && std::abs(l_bCoarse[l_ce + l_stride] - l_b) >= m_depthGradient * m_dy)
+      return true;
+  }
+
+  return false;
+}
+
+void tsunami_lab::patches::Refinement2d::indexBlocks()
+{
+  std::fill(m_blockOfCell.begin(), m_blockOfCell.end(), -1);
+  for (t_idx l_bl = 0; l_bl < m_blocks.size(); l_bl++)
+  {
+    Block const &l_block = *m_blocks[l_bl];
+    for (t_idx l_cy = l_block.iy; l_cy < l_block.iy + l_block.ny; l_cy++)
+      for (t_idx l_cx = l_block.ix; l_cx < l_block.ix + l_block.nx; l_cx++)
+        m_blockOfCell[l_cx + l_cy * m_nCellsX] = l_bl;
+  }
+}
+
+bool tsunami_lab::patches::Refinement2d::addBlock(t_idx i_ix,
+                                                  t_idx i_iy,
+                                                  t_idx i_nx,
+                                                  t_idx i_ny,
+                                                  t_idx i_ratio,
+                                                  t_idx i_nSteps,
+                                                  bool i_fromSetup)
+{
+  if (i_nx == 0 || i_ny == 0 || i_ix + i_nx > m_nCellsX || i_iy + i_ny > m_nCellsY)
+    return false;
+
+  // blocks of the criteria in the rectangle are removed, their coarse cells already hold the means
+  std::vector<Block *> l_blocks;
+  for (Block *l_block : m_blocks)
+  {
+    bool l_overlaps = l_block->ix < i_ix + i_nx && i_ix < l_block->ix + l_block->nx &&
+                      l_block->iy < i_iy + i_ny && i_iy < l_block->iy + l_block->ny;
+    if (l_overlaps && l_block->fixed)
+      return false;
+    if (l_overlaps)
+    {
+      delete l_block->patch;
+      delete l_block;
+    }
+    else
+    {
+      l_blocks.push_back(l_block);
+    }
+  }
+
+  t_idx l_ratio = std::max(i_ratio, t_idx(1));
+  Block *l_block = createBlock(i_ix, i_iy, i_nx, i_ny, l_ratio, i_nSteps > 0 ? i_nSteps : l_ratio, i_fromSetup);
+  l_block->fixed = true;
+  l_blocks.insert(l_blocks.begin() + m_nFixedBlocks, l_block);
+  m_nFixedBlocks++;
+
+  m_blocks = l_blocks;
+  indexBlocks();
+  return true;
+}
+
+void tsunami_lab::patches::Refinement2d::regrid(bool i_fromSetup)
+{
+  t_idx l_nBlocksX = (m_nCellsX + m_blockSize - 1) / m_blockSize;
+  t_idx l_nBlocksY = (m_nCellsY + m_blockSize - 1) / m_blockSize;
+
+  // blocks are kept, removed or created; the coarse cells already hold the means of removed blocks
+  std::vector<Block *> l_blocks(m_blocks.begin(), m_blocks.begin() + m_nFixedBlocks);
+  for (t_idx l_by = 0; l_by < l_nBlocksY; l_by++)
+  {
+    for (t_idx l_bx = 0; l_bx < l_nBlocksX; l_bx++)
+    {
+      t_idx l_ix = l_bx * m_blockSize;
+      t_idx l_iy = l_by * m_blockSize;
+      t_idx l_nx = std::min(m_blockSize, m_nCellsX - l_ix);
+      t_idx l_ny = std::min(m_blockSize, m_nCellsY - l_iy);
+
+      // fixed blocks replace the ones of the criteria
+      bool l_fixed = false;
+      for (t_idx l_bl = 0; l_bl < m_nFixedBlocks && !l_fixed; l_bl++)
+      {
+        Block const &l_block = *m_blocks[l_bl];
+        l_fixed = l_block.ix < l_ix + l_nx && l_ix < l_block.ix + l_block.nx &&
+                  l_block.iy < l_iy + l_ny && l_iy < l_block.iy + l_block.ny;
+      }
+      if (l_fixed)
+        continue;
+
+      bool l_tagged = false;
+      for (t_idx l_cy = l_iy; l_cy < l_iy + l_ny && !l_tagged; l_cy++)
+        for (t_idx l_cx = l_ix; l_cx < l_ix + l_nx && !l_tagged; l_cx++)
+          l_tagged = isTagged(l_cx, l_cy);
+
+      long l_existing = m_blockOfCell[l_ix + l_iy * m_nCellsX];
+      if (l_existing >= 0 && l_tagged)
+      {
+        l_blocks.push_back(m_blocks[l_existing]);
+      }
+      else if (l_existing >= 0)
+      {
+        delete m_blocks[l_existing]->patch;
+        delete m_blocks[l_existing];
+      }
+      else if (l_tagged)
+      {
+        l_blocks.push_back(createBlock(l_ix, l_iy, l_nx, l_ny, m_ratio, m_ratio, i_fromSetup));
+      }
+    }
+  }
+
+  m_blocks = l_blocks;
+  indexBlocks();
+  m_stepsSinceRegrid = 0;
+}
+
+void tsunami_lab::patches::Refinement2d::timeStep(t_real i_scalingX,
+                                                  t_real i_scalingY)
+{
+  // coarse states of the covered cells and the rings before the coarse time step
+  for (Block *l_block : m_blocks)
+  {
+    t_idx l_strideOld = l_block->nx + 2;
+    for (t_idx l_cy = 0; l_cy < l_block->ny + 2; l_cy++)
+    {
+      for (t_idx l_cx = 0; l_cx < l_block->nx + 2; l_cx++)
+      {
+        t_real l_b;
+        getCoarseState(long(l_block->ix + l_cx) - 1,
+                       long(l_block->iy + l_cy) - 1,
+                       l_block->hOld[l_cx + l_cy * l_strideOld],
+                       l_block->huOld[l_cx + l_cy * l_strideOld],
+                       l_block->hvOld[l_cx + l_cy * l_strideOld],
+                       l_b);
+      }
+    }
+    std::fill(l_block->fluxL.begin(), l_block->fluxL.end(), t_real(0));
+    std::fill(l_block->fluxR.begin(), l_block->fluxR.end(), t_real(0));
+    std::fill(l_block->fluxB.begin(), l_block->fluxB.end(), t_real(0));
+    std::fill(l_block->fluxT.begin(), l_block->fluxT.end(), t_real(0));
+  }
+
+  m_coarse->timeStep(i_scalingX, i_scalingY);
+
+  // nSteps fine time steps cover the coarse one, the scaling dt / dx of ratio steps is the coarse one;
+  // all rings of blocks which advance together are set before the first of them moves on, neighbours see each other at the same time
+  std::vector<Block const *> l_groups;
+  for (Block *l_block : m_blocks)
+  {
+    bool l_found = false;
+    for (Block const *l_group : l_groups)
+      l_found = l_found || isInStep(*l_group, *l_block);
+    if (!l_found)
+      l_groups.push_back(l_block);
+  }
+
+  for (Block const *l_group : l_groups)
+  {
+    t_real l_scalingX = i_scalingX * t_real(l_group->ratio) / t_real(l_group->nSteps);
+    t_real l_scalingY = i_scalingY * t_real(l_group->ratio) / t_real(l_group->nSteps);
+    for (t_idx l_st = 0; l_st < l_group->nSteps; l_st++)
+    {
+      t_real l_weight = t_real(l_st) / t_real(l_group->nSteps);
+      for (Block *l_block : m_blocks)
+        if (isInStep(*l_group, *l_block))
+          setRing(*l_block, l_weight);
+      for (Block *l_block : m_blocks)
+        if (isInStep(*l_group, *l_block))
+          l_block->patch->timeStep(l_scalingX, l_scalingY);
+    }
+  }
+
+  for (Block *l_block : m_blocks)
+    restrictToCoarse(*l_block);
+  for (Block *l_block : m_blocks)
+    reflux(*l_block, i_scalingX, i_scalingY);
+
+  if (m_regridFrequency > 0 && ++m_stepsSinceRegrid >= m_regridFrequency)
+    regrid(false);
+}
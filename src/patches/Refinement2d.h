@@ -0,0 +1,442 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Block-structured refinement of a two-dimensional wave propagation patch.
+ **/
+#ifndef TSUNAMI_LAB_PATCHES_REFINEMENT_2D
+#define TSUNAMI_LAB_PATCHES_REFINEMENT_2D
+
+#include "../constants.h"
+#include "WavePropagation.h"
+#include "../setups/Setup.h"
+#include <string>
+#include <vector>
+
+namespace tsunami_lab
+{
+  namespace patches
+  {
+    class Refinement2d;
+  }
+}
+
+/**
+ * Two-level block-structured refinement of a coarse 2d patch.
+ *
+ * The coarse domain is divided into blocks of blockSize x blockSize cells.
+ * Blocks whose cells meet a refinement criterion are covered by fine WavePropagation2d patches with ratio x ratio cells per coarse cell.
+ * A fine patch has one ring of additional cells, which lie in the neighbouring coarse cells and hold the coupling data:
+ * the states of a neighbouring block or the coarse states, interpolated linearly in time.
+ * The water of a coarse cell fills its lowest fine cells first, which keeps its volume on coastlines.
+ *
+ * A time step of the coarse patch is followed by ratio time steps of the fine patches with the same scaling dt / dx, unless a block sets its own number of time steps.
+ * Afterwards, the covered coarse cells are replaced by the means of their fine cells
+ * and the mass fluxes through the coarse-fine interfaces are corrected in the neighbouring coarse cells, which conserves the total mass.
+ *
+ * Besides the blocks of the criteria, fixed blocks cover given rectangles with their own ratio, e.g., nested grids of harbours.
+ * Regrids keep them. Blocks of different ratios or numbers of time steps exchange their data through the coarse cells,
+ * the mass fluxes through their common interfaces are not corrected.
+ **/
+class tsunami_lab::patches::Refinement2d
+{
+private:
+  //! fine patch covering a rectangle of coarse cells
+  struct Block
+  {
+    //! first coarse cell in x- and y-direction
+    t_idx ix = 0;
+    t_idx iy = 0;
+
+    //! number of covered coarse cells in x- and y-direction
+    t_idx nx = 0;
+    t_idx ny = 0;
+
+    //! number of fine cells per coarse cell in each direction
+    t_idx ratio = 2;
+
+    //! number of fine time steps per coarse time step
+    t_idx nSteps = 2;
+
+    //! true if regrids keep the block
+    bool fixed = false;
+
+    //! fine patch with (nx * ratio + 2) x (ny * ratio + 2) cells, the outer ring holds the coupling data
+    WavePropagation *patch = nullptr;
+
+    //! coarse states of the covered cells and their ring before the coarse time step, row-major with (nx + 2) x (ny + 2) entries
+    std::vector<t_real> hOld;
+    std::vector<t_real> huOld;
+    std::vector<t_real> hvOld;
+
+    //! bathymetry of the fine ring cells, row-major over the fine patch; the inner entries are unused
+    std::vector<t_real> bRing;
+
+    //! fine bathymetries of the covered coarse cells and their ring in the order of hOld, ratio * ratio ascending values per coarse cell
+    std::vector<t_real> bSorted;
+
+    //! accumulated fine mass fluxes through the left, right, bottom and top coarse edges
+    std::vector<t_real> fluxL;
+    std::vector<t_real> fluxR;
+    std::vector<t_real> fluxB;
+    std::vector<t_real> fluxT;
+  };
+
+  //! coarse patch, not owned
+  WavePropagation *m_coarse = nullptr;
+
+  //! number of coarse cells in x- and y-direction
+  t_idx m_nCellsX = 0;
+  t_idx m_nCellsY = 0;
+
+  //! coarse cell size in x- and y-direction
+  t_real m_dx = 1;
+  t_real m_dy = 1;
+
+  //! position of the coarse cell (0, 0)
+  t_real m_offsetX = 0;
+  t_real m_offsetY = 0;
+
+  //! solver of the fine patches
+  std::string m_solver = "fwave";
+
+  //! net-updates of an edge, see solvers::Fwave::netUpdates
+  typedef void (*NetUpdates)(t_real i_hL,
+                             t_real i_hR,
+                             t_real i_huL,
+                             t_real i_huR,
+                             t_real i_bL,
+                             t_real i_bR,
+                             t_real o_netUpdateL[2],
+                             t_real o_netUpdateR[2]);
+
+  //! net-updates of the solver of the patches, chosen once by the constructor
+  NetUpdates m_netUpdates = nullptr;
+
+  //! setup which provides the fine bathymetry, not owned; nullptr takes the coarse one
+  setups::Setup const *m_setup = nullptr;
+
+  //! number of fine cells per coarse cell in each direction of the blocks of the criteria
+  t_idx m_ratio = 2;
+
+  //! number of coarse cells per block in each direction
+  t_idx m_blockSize = 16;
+
+  //! number of coarse time steps between two regrids; 0 keeps the blocks
+  t_idx m_regridFrequency = 0;
+
+  //! number of coarse time steps since the last regrid
+  t_idx m_stepsSinceRegrid = 0;
+
+  //! minimum surface elevation of tagged cells; 0 or less disables the criterion
+  t_real m_amplitude = 0;
+
+  //! minimum bathymetry slope of tagged cells; 0 or less disables the criterion
+  t_real m_depthGradient = 0;
+
+  //! wet cells with a smaller still water depth are tagged; 0 or less disables the criterion
+  t_real m_coastDepth = 0;
+
+  //! points whose surroundings are tagged, e.g., stations; x, y and radius per point
+  std::vector<t_real> m_points;
+
+  //! refined blocks, the fixed ones first
+  std::vector<Block *> m_blocks;
+
+  //! number of fixed blocks
+  t_idx m_nFixedBlocks = 0;
+
+  //! block of every coarse cell, row-major; -1 for uncovered cells
+  std::vector<long> m_blockOfCell;
+
+  /**
+   * Gets the state of a coarse cell, cells outside of the domain take the closest inner cell.
+   *
+   * @param i_ix id of the cell in x-direction, may be -1 or m_nCellsX.
+   * @param i_iy id of the cell in y-direction, may be -1 or m_nCellsY.
+   * @param o_h will be set to the water height.
+   * @param o_hu will be set to the momentum in x-direction.
+   * @param o_hv will be set to the momentum in y-direction.
+   * @param o_b will be set to the bathymetry.
+   **/
+  void getCoarseState(long i_ix,
+                      long i_iy,
+                      t_real &o_h,
+                      t_real &o_hu,
+                      t_real &o_hv,
+                      t_real &o_b);
+
+  /**
+   * Checks whether a coarse cell lies inside the domain and is not covered by a block.
+   *
+   * @param i_ix id of the cell in x-direction.
+   * @param i_iy id of the cell in y-direction.
+   * @return true if the coarse cell is a neighbour which receives flux corrections.
+   **/
+  bool isUncovered(long i_ix,
+                   long i_iy) const;
+
+  /**
+   * Computes the mass flux through an edge as the solver of the patches sees it; edges with a dry side are walls.
+   *
+   * @param i_hL height of the left side.
+   * @param i_hR height of the right side.
+   * @param i_huL momentum of the left side.
+   * @param i_huR momentum of the right side.
+   * @param i_bL bathymetry of the left side.
+   * @param i_bR bathymetry of the right side.
+   * @return mass flux from the left to the right side.
+   **/
+  t_real massFlux(t_real i_hL,
+                  t_real i_hR,
+                  t_real i_huL,
+                  t_real i_huR,
+                  t_real i_bL,
+                  t_real i_bR) const;
+
+  /**
+   * Creates a block and initializes its fine cells.
+   * The fine cells take the coarse volumes and velocities, or the states of the setup if requested;
+   * the covered coarse cells take the means of the fine cells and their bathymetry.
+   *
+   * @param i_ix first coarse cell in x-direction.
+   * @param i_iy first coarse cell in y-direction.
+   * @param i_nx number of covered coarse cells in x-direction.
+   * @param i_ny number of covered coarse cells in y-direction.
+   * @param i_ratio number of fine cells per coarse cell in each direction.
+   * @param i_nSteps number of fine time steps per coarse time step.
+   * @param i_fromSetup true if the fine heights and momenta are sampled from the setup.
+   * @return created block.
+   **/
+  Block *createBlock(t_idx i_ix,
+                     t_idx i_iy,
+                     t_idx i_nx,
+                     t_idx i_ny,
+                     t_idx i_ratio,
+                     t_idx i_nSteps,
+                     bool i_fromSetup);
+
+  /**
+   * Checks whether two blocks advance together and exchange their fine cells.
+   *
+   * @param i_block0 first block.
+   * @param i_block1 second block.
+   * @return true if the blocks have the same ratio and number of time steps.
+   **/
+  static bool isInStep(Block const &i_block0,
+                       Block const &i_block1)
+  {
+    return i_block0.ratio == i_block1.ratio && i_block0.nSteps == i_block1.nSteps;
+  }
+
+  /**
+   * Derives the block of every coarse cell.
+   **/
+  void indexBlocks();
+
+  /**
+   * Sets the ring cells of a block before a fine time step and accumulates the mass fluxes through its coarse-fine interfaces.
+   *
+   * @param io_block block.
+   * @param i_weight weight of the new coarse states in the time interpolation, in [0, 1).
+   **/
+  void setRing(Block &io_block,
+               t_real i_weight);
+
+  /**
+   * Replaces the covered coarse cells of a block by the means of their fine cells.
+   *
+   * @param i_block block.
+   **/
+  void restrictToCoarse(Block const &i_block);
+
+  /**
+   * Corrects the coarse neighbours of a block by the differences of the fine and the coarse mass fluxes of the last coarse time step.
+   *
+   * @param i_block block.
+   * @param i_scalingX scaling of the coarse time step (dt / dx).
+   * @param i_scalingY scaling of the coarse time step (dt / dy).
+   **/
+  void reflux(Block const &i_block,
+              t_real i_scalingX,
+              t_real i_scalingY);
+
+  /**
+   * Checks whether a coarse cell meets one of the refinement criteria.
+   *
+   * @param i_ix id of the cell in x-direction.
+   * @param i_iy id of the cell in y-direction.
+   * @return true if the cell is tagged.
+   **/
+  bool isTagged(t_idx i_ix,
+                t_idx i_iy);
+
+public:
+  /**
+   * Constructor.
+   *
+   * @param i_coarse coarse 2d patch, has to outlive the refinement.
+   * @param i_nCellsX number of coarse cells in x-direction.
+   * @param i_nCellsY number of coarse cells in y-direction.
+   * @param i_dx coarse cell size in x-direction.
+   * @param i_dy coarse cell size in y-direction.
+   * @param i_offsetX x-coordinate at which the coarse cell (0, 0) was sampled.
+   * @param i_offsetY y-coordinate at which the coarse cell (0, 0) was sampled.
+   * @param i_solver solver of the fine patches.
+   * @param i_setup setup which provides the fine bathymetry; nullptr takes the coarse one.
+   * @param i_ratio number of fine cells per coarse cell in each direction of the blocks of the criteria.
+   **/
+  Refinement2d(WavePropagation *i_coarse,
+               t_idx i_nCellsX,
+               t_idx i_nCellsY,
+               t_real i_dx,
+               t_real i_dy,
+               t_real i_offsetX,
+               t_real i_offsetY,
+               std::string const &i_solver,
+               setups::Setup const *i_setup,
+               t_idx i_ratio);
+
+  /**
+   * Destructor.
+   **/
+  ~Refinement2d();
+
+  /**
+   * Sets the size of the blocks.
+   *
+   * @param i_nCells number of coarse cells per block in each direction.
+   **/
+  void setBlockSize(t_idx i_nCells);
+
+  /**
+   * Sets the number of coarse time steps between two regrids.
+   *
+   * @param i_nSteps number of time steps; 0 keeps the blocks.
+   **/
+  void setRegridFrequency(t_idx i_nSteps);
+
+  /**
+   * Sets the refinement criteria of the cells, values of 0 or less disable a criterion.
+   *
+   * @param i_amplitude minimum absolute surface elevation.
+   * @param i_depthGradient minimum bathymetry slope towards a neighbouring cell.
+   * @param i_coastDepth maximum still water depth of wet cells.
+   **/
+  void setCriteria(t_real i_amplitude,
+                   t_real i_depthGradient,
+                   t_real i_coastDepth);
+
+  /**
+   * Adds a point whose surroundings are refined, e.g., a station.
+   *
+   * @param i_x x-coordinate of the point.
+   * @param i_y y-coordinate of the point.
+   * @param i_radius radius of the refined surroundings.
+   **/
+  void addPoint(t_real i_x,
+                t_real i_y,
+                t_real i_radius);
+
+  /**
+   * Adds a fixed block, which replaces the blocks of the criteria in its rectangle and is kept by the regrids.
+   * The fixed blocks have the ids 0, 1, ... in the order of their creation.
+   *
+   * @param i_ix first coarse cell in x-direction.
+   * @param i_iy first coarse cell in y-direction.
+   * @param i_nx number of covered coarse cells in x-direction.
+   * @param i_ny number of covered coarse cells in y-direction.
+   * @param i_ratio number of fine cells per coarse cell in each direction.
+   * @param i_nSteps number of fine time steps per coarse time step, at least the ratio keeps the stability of the coarse time step; 0 takes the ratio.
+   * @param i_fromSetup true if the fine heights and momenta are sampled from the setup.
+   * @return false if the rectangle is empty, leaves the domain or overlaps another fixed block.
+   **/
+  bool addBlock(t_idx i_ix,
+                t_idx i_iy,
+                t_idx i_nx,
+                t_idx i_ny,
+                t_idx i_ratio,
+                t_idx i_nSteps,
+                bool i_fromSetup);
+
+  /**
+   * Refines the blocks with tagged cells and removes the blocks without, fixed blocks are kept.
+   * Kept blocks continue with their fine cells, the coarse cells of removed blocks keep the means.
+   *
+   * @param i_fromSetup true if new blocks sample their heights and momenta from the setup, e.g., at the start of the simulation.
+   **/
+  void regrid(bool i_fromSetup);
+
+  /**
+   * Performs a time step of the coarse patch and the sub-cycled time steps of the fine patches.
+   * Every block performs its number of time steps, which divide the coarse time step.
+   *
+   * @param i_scalingX scaling of the coarse time step (dt / dx).
+   * @param i_scalingY scaling of the coarse time step (dt / dy).
+   **/
+  void timeStep(t_real i_scalingX,
+                t_real i_scalingY);
+
+  /**
+   * Gets the number of refined blocks.
+   *
+   * @return number of blocks.
+   **/
+  t_idx getNumBlocks() const
+  {
+    return m_blocks.size();
+  }
+
+  /**
+   * Gets the covered coarse cells of a block.
+   *
+   * @param i_bl id of the block.
+   * @param o_ix will be set to the first coarse cell in x-direction.
+   * @param o_iy will be set to the first coarse cell in y-direction.
+   * @param o_nx will be set to the number of coarse cells in x-direction.
+   * @param o_ny will be set to the number of coarse cells in y-direction.
+   **/
+  void getBlockCells(t_idx i_bl,
+                     t_idx &o_ix,
+                     t_idx &o_iy,
+                     t_idx &o_nx,
+                     t_idx &o_ny) const;
+
+  /**
+   * Gets the refinement ratio of a block.
+   *
+   * @param i_bl id of the block.
+   * @return number of fine cells per coarse cell in each direction.
+   **/
+  t_idx getBlockRatio(t_idx i_bl) const
+  {
+    return m_blocks[i_bl]->ratio;
+  }
+
+  /**
+   * Gets the fine patch of a block. Its cell (1, 1) is the first fine cell of the covered coarse cells.
+   *
+   * @param i_bl id of the block.
+   * @return fine patch.
+   **/
+  WavePropagation *getBlockPatch(t_idx i_bl)
+  {
+    return m_blocks[i_bl]->patch;
+  }
+
+  /**
+   * Checks whether a coarse cell is covered by a block.
+   *
+   * @param i_ix id of the cell in x-direction.
+   * @param i_iy id of the cell in y-direction.
+   * @return true if the cell is refined.
+   **/
+  bool isRefined(t_idx i_ix,
+                 t_idx i_iy) const
+  {
+    return m_blockOfCell[i_ix + i_iy * m_nCellsX] >= 0;
+  }
+};
+
+#endif
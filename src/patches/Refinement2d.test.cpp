@@ -0,0 +1,379 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Unit tests of the block-structured refinement.
+ **/
+#include <catch2/catch.hpp>
+#include "Refinement2d.h"
+#include "WavePropagation2d.h"
+#include "../setups/CircularDamBreak2d.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Coastline of a slope which rises by 0.2 m per m, dry from x = 117 m on; the water is at rest.
+ **/
+class Coast : public tsunami_lab::setups::Setup
+{
+public:
+  tsunami_lab::t_real getHeight(tsunami_lab::t_real i_x,
+                                tsunami_lab::t_real i_y) const
+  {
+    return std::max(-getBathymetry(i_x, i_y), tsunami_lab::t_real(0));
+  }
+
+  tsunami_lab::t_real getMomentumX(tsunami_lab::t_real,
+                                   tsunami_lab::t_real) const
+  {
+    return 0;
+  }
+
+  tsunami_lab::t_real getMomentumY(tsunami_lab::t_real,
+                                   tsunami_lab::t_real) const
+  {
+    return 0;
+  }
+
+  tsunami_lab::t_real getBathymetry(tsunami_lab::t_real i_x,
+                                    tsunami_lab::t_real) const
+  {
+    return tsunami_lab::t_real(0.2) * (i_x - 117);
+  }
+};
+
+/**
+ * Sets the cells of a patch to the ones of a setup, sampled at the cell centers.
+ **/
+static void setCells(tsunami_lab::patches::WavePropagation *io_waveProp,
+                     tsunami_lab::setups::Setup const &i_setup,
+                     tsunami_lab::t_idx i_nx,
+                     tsunami_lab::t_idx i_ny,
+                     tsunami_lab::t_real i_dx,
+                     tsunami_lab::t_real i_offset)
+{
+  for (tsunami_lab::t_idx l_cy = 0; l_cy < i_ny; l_cy++)
+  {
+    for (tsunami_lab::t_idx l_cx = 0; l_cx < i_nx; l_cx++)
+    {
+      tsunami_lab::t_real l_x = i_offset + l_cx * i_dx;
+      tsunami_lab::t_real l_y = i_offset + l_cy * i_dx;
+      io_waveProp->setHeight(l_cx, l_cy, i_setup.getHeight(l_x, l_y));
+      io_waveProp->setMomentumX(l_cx, l_cy, 0);
+      io_waveProp->setMomentumY(l_cx, l_cy, 0);
+      io_waveProp->setBathymetry(l_cx, l_cy, i_setup.getBathymetry(l_x, l_y));
+    }
+  }
+}
+
+/**
+ * Gets the total water volume of a patch in units of its cell area.
+ **/
+static double getVolume(tsunami_lab::patches::WavePropagation *i_waveProp,
+                        tsunami_lab::t_idx i_nx,
+                        tsunami_lab::t_idx i_ny)
+{
+  double l_volume = 0;
+  for (tsunami_lab::t_idx l_cy = 0; l_cy < i_ny; l_cy++)
+    for (tsunami_lab::t_idx l_cx = 0; l_cx < i_nx; l_cx++)
+      l_volume += i_waveProp->getHeight()[l_cx + l_cy * i_waveProp->getStride()];
+  return l_volume;
+}
+
+/**
+ * Gets the summed surface errors of 80 x 80 cells against the means of a patch with 160 x 160 cells.
+ **/
+static double getSurfaceError(tsunami_lab::patches::WavePropagation *i_waveProp,
+                              tsunami_lab::patches::WavePropagation *i_reference)
+{
+  double l_error = 0;
+  for (tsunami_lab::t_idx l_cy = 0; l_cy < 80; l_cy++)
+  {
+    for (tsunami_lab::t_idx l_cx = 0; l_cx < 80; l_cx++)
+    {
+      double l_surface = 0;
+      for (tsunami_lab::t_idx l_sy = 0; l_sy < 2; l_sy++)
+      {
+        for (tsunami_lab::t_idx l_sx = 0; l_sx < 2; l_sx++)
+        {
+          tsunami_lab::t_idx l_ce = 2 * l_cx + l_sx + (2 * l_cy + l_sy) * i_reference->getStride();
+          l_surface += 0.25 * (i_reference->getHeight()[l_ce] + i_reference->getBathymetry()[l_ce]);
+        }
+      }
+      tsunami_lab::t_idx l_ce = l_cx + l_cy * i_waveProp->getStride();
+      l_error += std::abs(i_waveProp->getHeight()[l_ce] + i_waveProp->getBathymetry()[l_ce] - l_surface);
+    }
+  }
+  return l_error;
+}
+
+/**
+ * Creates the 80 x 80 coarse cells of 5 m, the unrefined ones and the 160 x 160 reference cells of a setup.
+ **/
+static void createPatches(tsunami_lab::setups::Setup const &i_setup,
+                          tsunami_lab::patches::WavePropagation *&o_coarse,
+                          tsunami_lab::patches::WavePropagation *&o_unrefined,
+                          tsunami_lab::patches::WavePropagation *&o_reference)
+{
+  tsunami_lab::patches::WavePropagation **l_patches[3] = {&o_coarse, &o_unrefined, &o_reference};
+  for (tsunami_lab::patches::WavePropagation **l_patch : l_patches)
+  {
+    tsunami_lab::t_idx l_nCells = l_patch == &o_reference ? 160 : 80;
+    *l_patch = tsunami_lab::patches::createWavePropagation2d(l_nCells,
+                                                             l_nCells,
+                                                             "fwave",
+                                                             tsunami_lab::patches::WavePropagation::WALL,
+                                                             tsunami_lab::patches::WavePropagation::WALL,
+                                                             tsunami_lab::patches::WavePropagation::WALL,
+                                                             tsunami_lab::patches::WavePropagation::WALL,
+                                                             false);
+  }
+  setCells(o_coarse, i_setup, 80, 80, 5, -197.5);
+  setCells(o_unrefined, i_setup, 80, 80, 5, -197.5);
+  setCells(o_reference, i_setup, 160, 160, 2.5, -198.75);
+}
+
+TEST_CASE("Test the refinement of a lake at rest.", "[Refinement2dLakeAtRest]")
+{
+  /*
+   * Test case:
+   *   40 x 30 coarse cells with a varying bathymetry and a resting surface.
+   *   The surroundings of a point are refined with a ratio of 3 in blocks of 8 x 8 cells.
+   *   The surfaces of both levels stay at rest.
+   */
+  tsunami_lab::patches::WavePropagation *l_coarse = tsunami_lab::patches::createWavePropagation2d(40,
+                                                                                                 30,
+                                                                                                 "fwave",
+                                                                                                 tsunami_lab::patches::WavePropagation::WALL,
+                                                                                                 tsunami_lab::patches::WavePropagation::WALL,
+                                                                                                 tsunami_lab::patches::WavePropagation::WALL,
+                                                                                                 tsunami_lab::patches::WavePropagation::WALL,
+                                                                                                 false);
+  for (tsunami_lab::t_idx l_cy = 0; l_cy < 30; l_cy++)
+  {
+    for (tsunami_lab::t_idx l_cx = 0; l_cx < 40; l_cx++)
+    {
+      tsunami_lab::t_real l_b = -100 - 10 * tsunami_lab::t_real((l_cx + 2 * l_cy) % 3);
+      l_coarse->setHeight(l_cx, l_cy, -l_b);
+      l_coarse->setMomentumX(l_cx, l_cy, 0);
+      l_coarse->setMomentumY(l_cx, l_cy, 0);
+      l_coarse->setBathymetry(l_cx, l_cy, l_b);
+    }
+  }
+
+  tsunami_lab::patches::Refinement2d l_refinement(l_coarse, 40, 30, 10, 10, 0, 0, "fwave", nullptr, 3);
+  l_refinement.setBlockSize(8);
+  l_refinement.addPoint(205, 155, 20);
+  l_refinement.regrid(false);
+
+  // the point lies in the block (16, 8), its surroundings reach the block (16, 16)
+  REQUIRE(l_refinement.getNumBlocks() == 2);
+  REQUIRE(l_refinement.isRefined(20, 15));
+  REQUIRE(l_refinement.isRefined(20, 16));
+  REQUIRE_FALSE(l_refinement.isRefined(24, 16));
+  REQUIRE_FALSE(l_refinement.isRefined(5, 5));
+
+  for (int l_st = 0; l_st < 20; l_st++)
+    l_refinement.timeStep(0.01, 0.01);
+
+  for (tsunami_lab::t_idx l_cy = 0; l_cy < 30; l_cy++)
+  {
+    for (tsunami_lab::t_idx l_cx = 0; l_cx < 40; l_cx++)
+    {
+      tsunami_lab::t_idx l_ce = l_cx + l_cy * l_coarse->getStride();
+      REQUIRE(l_coarse->getHeight()[l_ce] + l_coarse->getBathymetry()[l_ce] == Approx(0).margin(1E-3));
+      REQUIRE(l_coarse->getMomentumX()[l_ce] == Approx(0).margin(0.05));
+      REQUIRE(l_coarse->getMomentumY()[l_ce] == Approx(0).margin(0.05));
+    }
+  }
+
+  for (tsunami_lab::t_idx l_bl = 0; l_bl < l_refinement.getNumBlocks(); l_bl++)
+  {
+    tsunami_lab::patches::WavePropagation *l_fine = l_refinement.getBlockPatch(l_bl);
+    tsunami_lab::t_idx l_ix, l_iy, l_nx, l_ny;
+    l_refinement.getBlockCells(l_bl, l_ix, l_iy, l_nx, l_ny);
+    for (tsunami_lab::t_idx l_fy = 1; l_fy < 3 * l_ny + 1; l_fy++)
+    {
+      for (tsunami_lab::t_idx l_fx = 1; l_fx < 3 * l_nx + 1; l_fx++)
+      {
+        tsunami_lab::t_idx l_ce = l_fx + l_fy * l_fine->getStride();
+        REQUIRE(l_fine->getHeight()[l_ce] + l_fine->getBathymetry()[l_ce] == Approx(0).margin(1E-3));
+        REQUIRE(l_fine->getMomentumX()[l_ce] == Approx(0).margin(0.05));
+        REQUIRE(l_fine->getMomentumY()[l_ce] == Approx(0).margin(0.05));
+      }
+    }
+  }
+
+  delete l_coarse;
+}
+
+TEST_CASE("Test the mass conservation and the accuracy of the refinement.", "[Refinement2dConservation]")
+{
+  /*
+   * Test case:
+   *   Circular dam break with a surface elevation of 1 m in 100 m deep water, 80 x 80 coarse cells of 5 m.
+   *   The wave is refined with a ratio of 2, the blocks follow it.
+   *   The total mass is conserved and the solution is closer to the one of 160 x 160 cells than the coarse one.
+   */
+  tsunami_lab::setups::CircularDamBreak2d l_setup(1, 0, 40);
+  tsunami_lab::patches::WavePropagation *l_coarse = nullptr;
+  tsunami_lab::patches::WavePropagation *l_unrefined = nullptr;
+  tsunami_lab::patches::WavePropagation *l_reference = nullptr;
+  createPatches(l_setup, l_coarse, l_unrefined, l_reference);
+
+  tsunami_lab::patches::Refinement2d l_refinement(l_coarse, 80, 80, 5, 5, -197.5, -197.5, "fwave", &l_setup, 2);
+  l_refinement.setBlockSize(8);
+  l_refinement.setRegridFrequency(4);
+  l_refinement.setCriteria(0.01, 0, 0);
+  l_refinement.regrid(true);
+  REQUIRE(l_refinement.getNumBlocks() > 0);
+  REQUIRE(l_refinement.isRefined(40, 40));
+  REQUIRE_FALSE(l_refinement.isRefined(10, 10));
+
+  // the refined coarse cells hold the means of the fine cells sampled from the setup
+  double l_volume = getVolume(l_coarse, 80, 80);
+
+  for (int l_st = 0; l_st < 60; l_st++)
+  {
+    l_refinement.timeStep(0.01, 0.01);
+    l_unrefined->timeStep(0.01, 0.01);
+    l_reference->timeStep(0.01, 0.01);
+    l_reference->timeStep(0.01, 0.01);
+  }
+
+  // the blocks followed the wave front, which travelled about 19 cells
+  REQUIRE(l_refinement.isRefined(40 + 19, 40));
+  REQUIRE(l_refinement.isRefined(40, 40 - 19));
+  REQUIRE_FALSE(l_refinement.isRefined(10, 10));
+
+  // the wave holds a volume of about 50 cells times 1 m, the interfaces without flux corrections lose or gain more than 0.5
+  REQUIRE(getVolume(l_coarse, 80, 80) == Approx(l_volume).margin(0.01));
+
+  // surface errors of the coarse cells against the means of the reference
+  REQUIRE(getSurfaceError(l_coarse, l_reference) < 0.5 * getSurfaceError(l_unrefined, l_reference));
+
+  delete l_coarse;
+  delete l_unrefined;
+  delete l_reference;
+}
+
+TEST_CASE("Test the fixed nests of the refinement.", "[Refinement2dNests]")
+{
+  /*
+   * Test case:
+   *   Circular dam break of the conservation test without criteria.
+   *   A nest with a ratio of 4 covers the dam, one with a ratio of 2 and 4 time steps per coarse one lies in the path of the wave.
+   *   The regrids keep both nests, the total mass is conserved and the solution is closer to the reference than the coarse one.
+   */
+  tsunami_lab::setups::CircularDamBreak2d l_setup(1, 0, 40);
+  tsunami_lab::patches::WavePropagation *l_coarse = nullptr;
+  tsunami_lab::patches::WavePropagation *l_unrefined = nullptr;
+  tsunami_lab::patches::WavePropagation *l_reference = nullptr;
+  createPatches(l_setup, l_coarse, l_unrefined, l_reference);
+
+  tsunami_lab::patches::Refinement2d l_refinement(l_coarse, 80, 80, 5, 5, -197.5, -197.5, "fwave", &l_setup, 2);
+  l_refinement.setBlockSize(8);
+  l_refinement.setRegridFrequency(4);
+  REQUIRE(l_refinement.addBlock(32, 32, 16, 16, 4, 0, true));
+  REQUIRE(l_refinement.addBlock(52, 36, 12, 8, 2, 4, true));
+
+  // overlapping nests and nests outside of the domain are rejected
+  REQUIRE_FALSE(l_refinement.addBlock(44, 30, 10, 4, 2, 0, true));
+  REQUIRE_FALSE(l_refinement.addBlock(76, 10, 8, 8, 2, 0, true));
+  REQUIRE_FALSE(l_refinement.addBlock(10, 10, 0, 8, 2, 0, true));
+  l_refinement.regrid(true);
+
+  REQUIRE(l_refinement.getNumBlocks() == 2);
+  REQUIRE(l_refinement.getBlockRatio(0) == 4);
+  REQUIRE(l_refinement.getBlockRatio(1) == 2);
+  REQUIRE(l_refinement.getBlockPatch(0)->getStride() >= 16 * 4 + 2);
+
+  double l_volume = getVolume(l_coarse, 80, 80);
+
+  for (int l_st = 0; l_st < 60; l_st++)
+  {
+    l_refinement.timeStep(0.01, 0.01);
+    l_unrefined->timeStep(0.01, 0.01);
+    l_reference->timeStep(0.01, 0.01);
+    l_reference->timeStep(0.01, 0.01);
+  }
+
+  tsunami_lab::t_idx l_ix, l_iy, l_nx, l_ny;
+  REQUIRE(l_refinement.getNumBlocks() == 2);
+  l_refinement.getBlockCells(1, l_ix, l_iy, l_nx, l_ny);
+  REQUIRE(l_ix == 52);
+  REQUIRE(l_iy == 36);
+  REQUIRE(l_nx == 12);
+  REQUIRE(l_ny == 8);
+  REQUIRE(l_refinement.isRefined(40, 40));
+  REQUIRE_FALSE(l_refinement.isRefined(40, 20));
+
+  // the rounding errors of the total volume of about 640000 stay below the margin, nests without flux corrections lose about 0.4
+  REQUIRE(getVolume(l_coarse, 80, 80) == Approx(l_volume).margin(0.05));
+  REQUIRE(getSurfaceError(l_coarse, l_reference) < 0.75 * getSurfaceError(l_unrefined, l_reference));
+
+  delete l_coarse;
+  delete l_unrefined;
+  delete l_reference;
+}
+
+TEST_CASE("Test the volume of blocks which are created again on a coastline.", "[Refinement2dCoast]")
+{
+  /*
+   * Test case:
+   *   24 x 8 coarse cells of 10 m on a coastline, the cells at x = 115 m are partly dry.
+   *   The cells with a still water depth below 5 m are refined with a ratio of 4; every cycle removes the block,
+   *   creates it again from the coarse cells and performs 5 time steps.
+   *   The total volume is conserved and the fine land cells stay dry.
+   */
+  Coast l_setup;
+  tsunami_lab::patches::WavePropagation *l_coarse = tsunami_lab::patches::createWavePropagation2d(24,
+                                                                                                 8,
+                                                                                                 "fwave",
+                                                                                                 tsunami_lab::patches::WavePropagation::WALL,
+                                                                                                 tsunami_lab::patches::WavePropagation::WALL,
+                                                                                                 tsunami_lab::patches::WavePropagation::WALL,
+                                                                                                 tsunami_lab::patches::WavePropagation::WALL,
+                                                                                                 false);
+  setCells(l_coarse, l_setup, 24, 8, 10, 5);
+
+  tsunami_lab::patches::Refinement2d l_refinement(l_coarse, 24, 8, 10, 10, 5, 5, "fwave", &l_setup, 4);
+  l_refinement.setBlockSize(8);
+  l_refinement.setCriteria(0, 0, 5);
+  l_refinement.regrid(true);
+  REQUIRE(l_refinement.getNumBlocks() == 1);
+  REQUIRE(l_refinement.isRefined(11, 0));
+
+  double l_volume = getVolume(l_coarse, 24, 8);
+
+  for (int l_cy = 0; l_cy < 10; l_cy++)
+  {
+    l_refinement.setCriteria(0, 0, 0);
+    l_refinement.regrid(false);
+    REQUIRE(l_refinement.getNumBlocks() == 0);
+
+    l_refinement.setCriteria(0, 0, 5);
+    l_refinement.regrid(false);
+    REQUIRE(l_refinement.getNumBlocks() == 1);
+
+    for (int l_st = 0; l_st < 5; l_st++)
+      l_refinement.timeStep(0.01, 0.01);
+
+    REQUIRE(getVolume(l_coarse, 24, 8) == Approx(l_volume).margin(0.01));
+  }
+
+  // the fine cells above the surface of the partly dry coarse cells stay dry
+  tsunami_lab::patches::WavePropagation *l_fine = l_refinement.getBlockPatch(0);
+  for (tsunami_lab::t_idx l_fy = 1; l_fy < 33; l_fy++)
+  {
+    for (tsunami_lab::t_idx l_fx = 1; l_fx < 33; l_fx++)
+    {
+      tsunami_lab::t_idx l_ce = l_fx + l_fy * l_fine->getStride();
+      if (l_fine->getBathymetry()[l_ce] > 0.1)
+        REQUIRE(l_fine->getHeight()[l_ce] == 0);
+    }
+  }
+
+  delete l_coarse;
+}
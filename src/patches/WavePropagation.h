@@ -9,6 +9,7 @@
 #define TSUNAMI_LAB_PATCHES_WAVE_PROPAGATION
 
 #include "../constants.h"
+#include <vector>
 
 namespace tsunami_lab
 {
@@ -26,6 +27,23 @@ public:
     OUTFLOW = 0,
     WALL = 1
   };
+
+  //! Statistics of the last time step
+  struct StepStatistics
+  {
+    //! number of tiles in x- and y-direction
+    t_idx nTilesX = 1;
+    t_idx nTilesY = 1;
+    //! number of computed tiles
+    t_idx nTilesComputed = 1;
+    //! row-major flags of the computed tiles, valid until the next time step; nullptr if all tiles were computed
+    unsigned char const *tilesComputed = nullptr;
+    //! number of cell updates with the local time stepping and with the micro step for all cells; 0 if not counted
+    t_idx nCellUpdates = 0;
+    t_idx nCellUpdatesGlobal = 0;
+    //! ratio of the maximum to the average time which the threads spent updating their blocks of rows; 0 if not measured
+    double threadImbalance = 0;
+  };
   
   /**
    * Virtual destructor for base class.
@@ -34,6 +52,7 @@ public:
 
   /**
    * Performs a time step.
+   * Inside an active OpenMP parallel region, every thread of the team has to call it and the threads share the work.
    *
    * @param i_scalingX scaling of the time step.
    * @param i_scalingY scaling of the time step.
@@ -43,9 +62,22 @@ public:
 
   /**
    * Sets the values of the ghost cells according to outflow boundary conditions.
+   * Inside an active OpenMP parallel region, every thread of the team has to call it and the threads share the work.
    **/
   virtual void setGhostOutflow() = 0;
 
+  /**
+   * Performs multiple time steps, each of them applies the boundary conditions.
+   * Inside an active OpenMP parallel region, every thread of the team has to call it and the threads share the work.
+   *
+   * @param i_nSteps number of time steps.
+   * @param i_scalingX scaling of the time steps (dt / dx).
+   * @param i_scalingY scaling of the time steps (dt / dy).
+   **/
+  virtual void timeSteps(t_idx i_nSteps,
+                         t_real i_scalingX,
+                         t_real i_scalingY) = 0;
+
   /**
    * Gets the stride in y-direction. x-direction is stride-1.
    *
@@ -127,11 +159,178 @@ public:
                              t_idx i_iy,
                              t_real i_b) = 0;
 
+  /**
+   * Overwrites the state of a cell between two time steps, e.g., with the coupling data of a refined patch.
+   * Unlike the other setters, the dry cells and the computed intervals are not derived again:
+   * a cell which was dry when the cells were last set exchanges water with its wet neighbours only.
+   * The active-region tracking wakes the tiles around a cell which changes by more than its threshold.
+   *
+   * @param i_ix id of the cell in x-direction.
+   * @param i_iy id of the cell in y-direction.
+   * @param i_h water height.
+   * @param i_hu momentum in x-direction.
+   * @param i_hv momentum in y-direction.
+   **/
+  virtual void setCellState(t_idx i_ix,
+                            t_idx i_iy,
+                            t_real i_h,
+                            t_real i_hu,
+                            t_real i_hv) = 0;
+
   /**
    * Corrects the water height based on the bathymetry
    *
    **/
   virtual void adjustWaterHeight() = 0;
+
+  /**
+   * Enables or disables the computation of the maximum wave speed in the following time steps.
+   *
+   * @param i_track true to compute the maximum wave speed.
+   **/
+  virtual void setMaxWaveSpeedTracking(bool i_track) = 0;
+
+  /**
+   * Gets the maximum wave speed |u| + sqrt(g * h) of the cells after the last time step which computed it.
+   *
+   * @return maximum wave speed.
+   **/
+  virtual t_real getMaxWaveSpeed() = 0;
+
+  /**
+   * Computes the maximum wave speed |u| + sqrt(g * h) of the current states of a rectangle of cells, as the time steps track it.
+   *
+   * @param i_ix first cell in x-direction.
+   * @param i_iy first cell in y-direction.
+   * @param i_nx number of cells in x-direction.
+   * @param i_ny number of cells in y-direction.
+   * @return maximum wave speed; 0 for an empty rectangle.
+   **/
+  virtual t_real computeMaxWaveSpeed(t_idx i_ix,
+                                     t_idx i_iy,
+                                     t_idx i_nx,
+                                     t_idx i_ny) = 0;
+
+  /*
+   * Tuning settings of the time steps and their statistics.
+   * The settings default to no-ops and the statistics to empty ones, thus a patch which does not support a setting ignores it.
+   */
+
+  /**
+   * Sets the threshold of the active-region tracking.
+   * A tile is skipped in a time step if neither it nor a neighbouring tile changed by more than the threshold in the previous one.
+   *
+   * @param i_threshold maximum change of the heights and momenta of a tile at rest; negative values compute all tiles.
+   **/
+  virtual void setActivityThreshold(t_real)
+  {
+  }
+
+  /**
+   * Sets the width of the column strips in which the time steps sweep the rows.
+   * Narrow strips keep the rows of a strip in the cache for the solution of the edges between them.
+   *
+   * @param i_nCells number of columns of a strip; 0 sweeps whole rows.
+   **/
+  virtual void setStripWidth(t_idx)
+  {
+  }
+
+  /**
+   * Sets the width of the ghost layers for the temporal blocking of multiple time steps.
+   * A tile advances as many time steps at once out of the cache, the intermediate states of its halo are recomputed.
+   *
+   * @param i_nSteps number of time steps which a tile advances at once; 1 disables the temporal blocking.
+   **/
+  virtual void setGhostWidth(t_idx)
+  {
+  }
+
+  /**
+   * Sets whether the time steps precompute the square roots, velocities and momentum fluxes of the cells once per row and share them between the edges.
+   * Only used by solvers which support the shared quantities.
+   *
+   * @param i_share true if the cell quantities are precomputed, false if every edge derives them from the states.
+   **/
+  virtual void setCellQuantitySharing(bool)
+  {
+  }
+
+  /**
+   * Sets whether the time steps read the bathymetry quantized to 16-bit integers, which halves its memory traffic.
+   * The water surface elevation is kept, the bathymetry changes by at most half the quantization step.
+   *
+   * @param i_quantize true to quantize the bathymetry, false to read it as float.
+   **/
+  virtual void setBathymetryQuantization(bool)
+  {
+  }
+
+  /**
+   * Sets the deep water in which the time steps use the shallow water equations linearized about the ocean at rest.
+   * Edges with smaller depths or larger amplitudes are solved by the nonlinear solver.
+   *
+   * @param i_minDepth minimum still water depth of the linearized edges; 0 or less disables the linearization.
+   * @param i_maxAmplitudeRatio maximum ratio of the surface elevation to the still water depth of the linearized edges, less than 1.
+   **/
+  virtual void setLinearization(t_real,
+                                t_real)
+  {
+  }
+
+  /**
+   * Sets the number of levels of the local time stepping, which splits a time step into 2^L micro steps.
+   * The cells are grouped into classes c = 0, ..., L by their wave speed, a class advances 2^c micro steps at once.
+   * The caller has to scale the time steps by 2^L, the fastest cells keep the time step of the CFL condition.
+   *
+   * @param i_nLevels number of levels L; 0 advances all cells with the time step.
+   **/
+  virtual void setLocalTimeStepping(t_idx)
+  {
+  }
+
+  /**
+   * Sets the number of rows of the tiles which the time steps schedule as tasks.
+   * Idle threads take the next tile whose neighbours of the previous time step are done, thus multiple time steps overlap.
+   *
+   * @param i_nRows number of rows of a tile; 0 assigns a fixed block of rows to every thread.
+   **/
+  virtual void setTaskTiles(t_idx)
+  {
+  }
+
+  /**
+   * Gets the time which the threads spent in the tasks of the tiles and waiting for them, since the tiles were set.
+   *
+   * @param o_busy will be set to the seconds in tasks per thread; empty without tasks.
+   * @param o_idle will be set to the seconds without a task per thread; empty without tasks.
+   **/
+  virtual void getTaskTimes(std::vector<double> &o_busy,
+                            std::vector<double> &o_idle)
+  {
+    o_busy.clear();
+    o_idle.clear();
+  }
+
+  /**
+   * Sets the number of time steps after which the threads' blocks of rows are rebalanced.
+   * The blocks split the cost of the rows evenly, which counts the wet cells and follows the measured times of the blocks.
+   *
+   * @param i_nSteps number of time steps between the rebalancings; 0 splits the rows evenly.
+   **/
+  virtual void setLoadBalancing(t_idx)
+  {
+  }
+
+  /**
+   * Gets the statistics of the last time step; the default is a single tile.
+   *
+   * @return statistics.
+   **/
+  virtual StepStatistics getStepStatistics()
+  {
+    return StepStatistics();
+  }
 };
 
 #endif
\ No newline at end of file
@@ -2,31 +2,34 @@
  * @author Luca-Philipp Grumbach
  * @author Richard Hofmann
  *
- * # Description 
+ * # Description
  * One-dimensional wave propagation patch.
  **/
 #include "WavePropagation1d.h"
+#include "Boundaries.h"
 #include "../solvers/Roe.h"
 #include "../solvers/Fwave.h"
+#include <algorithm>
+#include <cmath>
 #include <string>
 
-tsunami_lab::patches::WavePropagation1d::WavePropagation1d(t_idx i_nCells,
-                                                           const std::string &i_solver,
-                                                           Boundary i_boundaryL,
-                                                           Boundary i_boundaryR)
+template <typename T_Solver,
+          typename T_BoundaryL,
+          typename T_BoundaryR>
+tsunami_lab::patches::WavePropagation1d<T_Solver, T_BoundaryL, T_BoundaryR>::WavePropagation1d(t_idx i_nCells)
 {
   m_nCells = i_nCells;
-  m_solver = i_solver;
-  m_boundaryL = i_boundaryL;
-  m_boundaryR = i_boundaryR;
 
   // allocate memory including a single ghost cell on each side
   for (unsigned short l_st = 0; l_st < 2; l_st++)
   {
-    m_h[l_st] = new t_real[m_nCells + 2];
-    m_hu[l_st] = new t_real[m_nCells + 2];
+    m_hStorage[l_st].allocate(m_nCells + 2, 1);
+    m_huStorage[l_st].allocate(m_nCells + 2, 1);
+    m_h[l_st] = m_hStorage[l_st].getData();
+    m_hu[l_st] = m_huStorage[l_st].getData();
   }
-  m_b = new t_real[m_nCells + 2];
+  m_bStorage.allocate(m_nCells + 2, 1);
+  m_b = m_bStorage.getData();
 
   // init to zero
   for (unsigned short l_st = 0; l_st < 2; l_st++)
@@ -40,161 +43,272 @@ tsunami_lab::patches::WavePropagation1d::WavePropagation1d(t_idx i_nCells,
   }
 }
 
-tsunami_lab::patches::WavePropagation1d::~WavePropagation1d()
+template <typename T_Solver,
+          typename T_BoundaryL,
+          typename T_BoundaryR>
+void tsunami_lab::patches::WavePropagation1d<T_Solver, T_BoundaryL, T_BoundaryR>::timeStep(t_real i_scaling,
+                                                                                           t_real)
 {
-  for (unsigned short l_st = 0; l_st < 2; l_st++)
+  // a single thread updates the patch, also inside a parallel region
+#ifdef USEOMP
+#pragma omp single
+#endif
   {
-    delete[] m_h[l_st];
-    delete[] m_hu[l_st];
-  }
-  delete[] m_b;
-}
+    // pointers to old and new data
+    t_real *l_hOld = m_h[m_step];
+    t_real *l_huOld = m_hu[m_step];
 
-void tsunami_lab::patches::WavePropagation1d::timeStep(t_real i_scaling,
-                                                       t_real)
-{
-  // pointers to old and new data
-  t_real *l_hOld = m_h[m_step];
-  t_real *l_huOld = m_hu[m_step];
-
-  m_step = (m_step + 1) % 2;
-  t_real *l_hNew = m_h[m_step];
-  t_real *l_huNew = m_hu[m_step];
-
-  // init new cell quantities
-  for (t_idx l_ce = 1; l_ce < m_nCells + 1; l_ce++)
-  {
-    l_hNew[l_ce] = l_hOld[l_ce];
-    l_huNew[l_ce] = l_huOld[l_ce];
-  }
+    m_step = (m_step + 1) % 2;
+    t_real *l_hNew = m_h[m_step];
+    t_real *l_huNew = m_hu[m_step];
 
-  // iterate over edges and update with Riemann solutions
-  for (t_idx l_ed = 0; l_ed < m_nCells + 1; l_ed++)
-  {
-    // determine left and right cell-id
-    t_idx l_ceL = l_ed;
-    t_idx l_ceR = l_ed + 1;
-
-    t_real l_hL = l_hOld[l_ceL];
-    t_real l_hR = l_hOld[l_ceR];
-    t_real l_huL = l_huOld[l_ceL];
-    t_real l_huR = l_huOld[l_ceR];
-    t_real l_bL = m_b[l_ceL];
-    t_real l_bR = m_b[l_ceR];
-
-    // handle reflections
-    handleReflections(l_hOld,
-                      l_huOld,
-                      l_ceL,
-                      l_ceR,
-                      l_hL,
-                      l_hR,
-                      l_huL,
-                      l_huR,
-                      l_bL,
-                      l_bR);
-
-    // compute net-updates
-    t_real l_netUpdates[2][2];
-    if (m_solver == "roe")
-    {
-      solvers::Roe::netUpdates(l_hL,
-                               l_hR,
-                               l_huL,
-                               l_huR,
-                               l_netUpdates[0],
-                               l_netUpdates[1]);
-    }
-    else if (m_solver == "fwave")
-    {
-      solvers::Fwave::netUpdates(l_hL,
-                                 l_hR,
-                                 l_huL,
-                                 l_huR,
-                                 l_bL,
-                                 l_bR,
-                                 l_netUpdates[0],
-                                 l_netUpdates[1]);
-    }
-    if (l_hOld[l_ceL] > 0)
-    {
-      l_hNew[l_ceL] -= i_scaling * l_netUpdates[0][0];
-      l_huNew[l_ceL] -= i_scaling * l_netUpdates[0][1];
-    }
-    else
+    // init new cell quantities
+    for (t_idx l_ce = 1; l_ce < m_nCells + 1; l_ce++)
     {
-      l_hNew[l_ceL] = 0;
-      l_huNew[l_ceL] = 0;
+      l_hNew[l_ce] = l_hOld[l_ce];
+      l_huNew[l_ce] = l_huOld[l_ce];
     }
 
-    if (l_hOld[l_ceR] > 0)
-    {
-      l_hNew[l_ceR] -= i_scaling * l_netUpdates[1][0];
-      l_huNew[l_ceR] -= i_scaling * l_netUpdates[1][1];
-    }
-    else
+    // edge states and net-updates of a batch
+    t_real l_hL[m_batchSize];
+    t_real l_hR[m_batchSize];
+    t_real l_huL[m_batchSize];
+    t_real l_huR[m_batchSize];
+    t_real l_bL[m_batchSize];
+    t_real l_bR[m_batchSize];
+    t_real l_netUpdatesLH[m_batchSize];
+    t_real l_netUpdatesLHu[m_batchSize];
+    t_real l_netUpdatesRH[m_batchSize];
+    t_real l_netUpdatesRHu[m_batchSize];
+
+    // iterate over batches of edges and update with Riemann solutions
+    for (t_idx l_first = 0; l_first < m_nCells + 1; l_first += m_batchSize)
     {
-      l_hNew[l_ceR] = 0;
-      l_huNew[l_ceR] = 0;
+      t_idx l_nEdges = std::min(m_batchSize, m_nCells + 1 - l_first);
+
+      // handle reflections
+      loadEdges(l_hOld,
+                l_huOld,
+                l_first,
+                l_nEdges,
+                l_hL,
+                l_hR,
+                l_huL,
+                l_huR,
+                l_bL,
+                l_bR);
+
+      // compute net-updates
+      T_Solver::netUpdatesBatch(l_nEdges,
+                                l_hL,
+                                l_hR,
+                                l_huL,
+                                l_huR,
+                                l_bL,
+                                l_bR,
+                                l_netUpdatesLH,
+                                l_netUpdatesLHu,
+                                l_netUpdatesRH,
+                                l_netUpdatesRHu);
+
+      // a cell receives the update of its left edge before the one of its right edge
+      for (t_idx l_ed = 0; l_ed < l_nEdges; l_ed++)
+      {
+        t_idx l_ceR = l_first + l_ed + 1;
+        if (l_hOld[l_ceR] > 0)
+        {
+          l_hNew[l_ceR] -= i_scaling * l_netUpdatesRH[l_ed];
+          l_huNew[l_ceR] -= i_scaling * l_netUpdatesRHu[l_ed];
+        }
+        else
+        {
+          l_hNew[l_ceR] = 0;
+          l_huNew[l_ceR] = 0;
+        }
+      }
+
+      for (t_idx l_ed = 0; l_ed < l_nEdges; l_ed++)
+      {
+        t_idx l_ceL = l_first + l_ed;
+        if (l_hOld[l_ceL] > 0)
+        {
+          l_hNew[l_ceL] -= i_scaling * l_netUpdatesLH[l_ed];
+          l_huNew[l_ceL] -= i_scaling * l_netUpdatesLHu[l_ed];
+        }
+        else
+        {
+          l_hNew[l_ceL] = 0;
+          l_huNew[l_ceL] = 0;
+        }
+      }
     }
+
+    if (m_trackMaxWaveSpeed)
+      m_maxWaveSpeed = computeMaxWaveSpeed(0, 0, m_nCells, 1);
   }
 }
 
-void tsunami_lab::patches::WavePropagation1d::setGhostOutflow()
+template <typename T_Solver,
+          typename T_BoundaryL,
+          typename T_BoundaryR>
+tsunami_lab::t_real tsunami_lab::patches::WavePropagation1d<T_Solver, T_BoundaryL, T_BoundaryR>::computeMaxWaveSpeed(t_idx i_ix,
+                                                                                                                     t_idx,
+                                                                                                                     t_idx i_nx,
+                                                                                                                     t_idx)
 {
-  t_real *l_h = m_h[m_step];
-  t_real *l_hu = m_hu[m_step];
-  t_real *l_b = m_b;
+  t_real const *l_h = m_h[m_step];
+  t_real const *l_hu = m_hu[m_step];
 
-  // left boundary
-  if (m_boundaryL == WALL)
+  t_real l_maxSpeed = 0;
+  for (t_idx l_ce = i_ix + 1; l_ce < i_ix + i_nx + 1; l_ce++)
   {
-    l_h[0] = 0;
+    if (l_h[l_ce] > 0)
+    {
+      t_real l_speed = std::abs(l_hu[l_ce] / l_h[l_ce]) + std::sqrt(T_Solver::m_g * l_h[l_ce]);
+      l_maxSpeed = std::max(l_maxSpeed, l_speed);
+    }
   }
-  else
+  return l_maxSpeed;
+}
+
+template <typename T_Solver,
+          typename T_BoundaryL,
+          typename T_BoundaryR>
+void tsunami_lab::patches::WavePropagation1d<T_Solver, T_BoundaryL, T_BoundaryR>::setGhostOutflow()
+{
+  // a single thread sets the ghost cells, also inside a parallel region
+#ifdef USEOMP
+#pragma omp single
+#endif
   {
-    l_h[0] = l_h[1];
+    t_real *l_h = m_h[m_step];
+    t_real *l_hu = m_hu[m_step];
+
+    // left boundary
+    l_h[0] = T_BoundaryL::ghostHeight(l_h[1]);
     l_hu[0] = l_hu[1];
-    l_b[0] = l_b[1];
-  }
-  // right boundary
-  if (m_boundaryR == WALL)
-  {
-    l_h[m_nCells + 1] = 0;
+
+    // right boundary
+    l_h[m_nCells + 1] = T_BoundaryR::ghostHeight(l_h[m_nCells]);
+    l_hu[m_nCells + 1] = l_hu[m_nCells];
   }
-  else
+}
+
+template <typename T_Solver,
+          typename T_BoundaryL,
+          typename T_BoundaryR>
+void tsunami_lab::patches::WavePropagation1d<T_Solver, T_BoundaryL, T_BoundaryR>::timeSteps(t_idx i_nSteps,
+                                                                                            t_real i_scaling,
+                                                                                            t_real)
+{
+  for (t_idx l_st = 0; l_st < i_nSteps; l_st++)
   {
-    l_h[m_nCells + 1] = l_h[m_nCells];
-    l_hu[m_nCells + 1] = l_hu[m_nCells];
-    l_b[m_nCells + 1] = l_b[m_nCells];
+    setGhostOutflow();
+    timeStep(i_scaling, 0);
   }
 }
 
-void tsunami_lab::patches::WavePropagation1d::handleReflections(t_real *i_h,
-                                                                t_real *i_hu,
-                                                                t_idx i_ceL,
-                                                                t_idx i_ceR,
-                                                                t_real &o_hL,
-                                                                t_real &o_hR,
-                                                                t_real &o_huL,
-                                                                t_real &o_huR,
-                                                                t_real &o_bL,
-                                                                t_real &o_bR)
+template <typename T_Solver,
+          typename T_BoundaryL,
+          typename T_BoundaryR>
+void tsunami_lab::patches::WavePropagation1d<T_Solver, T_BoundaryL, T_BoundaryR>::loadEdges(t_real const *i_h,
+                                                                                            t_real const *i_hu,
+                                                                                            t_idx i_ceL,
+                                                                                            t_idx i_nEdges,
+                                                                                            t_real *o_hL,
+                                                                                            t_real *o_hR,
+                                                                                            t_real *o_huL,
+                                                                                            t_real *o_huR,
+                                                                                            t_real *o_bL,
+                                                                                            t_real *o_bR)
 {
   // use margin for comparison in case of rounding errors
-  tsunami_lab::t_real margin = 0.00001;
-  if (i_h[i_ceR] <= margin)
+  t_real const l_margin = 0.00001;
+
+  t_real const *l_hL = i_h + i_ceL;
+  t_real const *l_huL = i_hu + i_ceL;
+  t_real const *l_bL = m_b + i_ceL;
+
+#pragma omp simd
+  for (t_idx l_ed = 0; l_ed < i_nEdges; l_ed++)
   {
-    // right cell dry
-    o_hR = i_h[i_ceL];
-    o_bR = m_b[i_ceL];
-    o_huR = -i_hu[i_ceL];
+    // a dry right cell reflects the left one, otherwise a dry left cell reflects the right one
+    bool l_dryR = l_hL[l_ed + 1] <= l_margin;
+    bool l_dryL = !l_dryR && l_hL[l_ed] <= l_margin;
+
+    o_hL[l_ed] = l_dryL ? l_hL[l_ed + 1] : l_hL[l_ed];
+    o_hR[l_ed] = l_dryR ? l_hL[l_ed] : l_hL[l_ed + 1];
+    o_huL[l_ed] = l_dryL ? -l_huL[l_ed + 1] : l_huL[l_ed];
+    o_huR[l_ed] = l_dryR ? -l_huL[l_ed] : l_huL[l_ed + 1];
+    o_bL[l_ed] = l_dryL ? l_bL[l_ed + 1] : l_bL[l_ed];
+    o_bR[l_ed] = l_dryR ? l_bL[l_ed] : l_bL[l_ed + 1];
   }
-  else if (i_h[i_ceL] <= margin)
+}
+
+/**
+ * Constructs the patch for fixed boundary conditions.
+ **/
+template <typename T_Solver,
+          typename T_BoundaryL,
+          typename T_BoundaryR>
+static tsunami_lab::patches::WavePropagation *instantiate(tsunami_lab::t_idx i_nCells)
+{
+  return new tsunami_lab::patches::WavePropagation1d<T_Solver, T_BoundaryL, T_BoundaryR>(i_nCells);
+}
+
+/**
+ * Constructs the patch for a fixed solver.
+ **/
+template <typename T_Solver>
+static tsunami_lab::patches::WavePropagation *instantiate(tsunami_lab::t_idx i_nCells,
+                                                          tsunami_lab::patches::WavePropagation::Boundary i_boundaryL,
+                                                          tsunami_lab::patches::WavePropagation::Boundary i_boundaryR)
+{
+  using namespace tsunami_lab::patches;
+
+  if (i_boundaryL == WavePropagation::WALL)
   {
-    // left cell dry
-    o_hL = i_h[i_ceR];
-    o_bL = m_b[i_ceR];
-    o_huL = -i_hu[i_ceR];
+    if (i_boundaryR == WavePropagation::WALL)
+      return instantiate<T_Solver, boundaries::Wall, boundaries::Wall>(i_nCells);
+    return instantiate<T_Solver, boundaries::Wall, boundaries::Outflow>(i_nCells);
   }
+  if (i_boundaryR == WavePropagation::WALL)
+    return instantiate<T_Solver, boundaries::Outflow, boundaries::Wall>(i_nCells);
+  return instantiate<T_Solver, boundaries::Outflow, boundaries::Outflow>(i_nCells);
+}
+
+tsunami_lab::patches::WavePropagation *tsunami_lab::patches::createWavePropagation1d(t_idx i_nCells,
+                                                                                     std::string const &i_solver,
+                                                                                     WavePropagation::Boundary i_boundaryL,
+                                                                                     WavePropagation::Boundary i_boundaryR)
+{
+  if (i_solver == "roe")
+    return instantiate<solvers::Roe>(i_nCells, i_boundaryL, i_boundaryR);
+  return instantiate<solvers::Fwave>(i_nCells, i_boundaryL, i_boundaryR);
 }
+
+// instantiations for all combinations of solvers and boundary conditions
+template class tsunami_lab::patches::WavePropagation1d<tsunami_lab::solvers::Roe,
+                                                       tsunami_lab::patches::boundaries::Outflow,
+                                                       tsunami_lab::patches::boundaries::Outflow>;
+template class tsunami_lab::patches::WavePropagation1d<tsunami_lab::solvers::Roe,
+                                                       tsunami_lab::patches::boundaries::Outflow,
+                                                       tsunami_lab::patches::boundaries::Wall>;
+template class tsunami_lab::patches::WavePropagation1d<tsunami_lab::solvers::Roe,
+                                                       tsunami_lab::patches::boundaries::Wall,
+                                                       tsunami_lab::patches::boundaries::Outflow>;
+template class tsunami_lab::patches::WavePropagation1d<tsunami_lab::solvers::Roe,
+                                                       tsunami_lab::patches::boundaries::Wall,
+                                                       tsunami_lab::patches::boundaries::Wall>;
+template class tsunami_lab::patches::WavePropagation1d<tsunami_lab::solvers::Fwave,
+                                                       tsunami_lab::patches::boundaries::Outflow,
+                                                       tsunami_lab::patches::boundaries::Outflow>;
+template class tsunami_lab::patches::WavePropagation1d<tsunami_lab::solvers::Fwave,
+                                                       tsunami_lab::patches::boundaries::Outflow,
+                                                       tsunami_lab::patches::boundaries::Wall>;
+template class tsunami_lab::patches::WavePropagation1d<tsunami_lab::solvers::Fwave,
+                                                       tsunami_lab::patches::boundaries::Wall,
+                                                       tsunami_lab::patches::boundaries::Outflow>;
+template class tsunami_lab::patches::WavePropagation1d<tsunami_lab::solvers::Fwave,
+                                                       tsunami_lab::patches::boundaries::Wall,
+                                                       tsunami_lab::patches::boundaries::Wall>;
@@ -9,16 +9,44 @@
 #define TSUNAMI_LAB_PATCHES_WAVE_PROPAGATION_1D
 
 #include "WavePropagation.h"
+#include "Field2d.h"
 #include <string>
 
 namespace tsunami_lab
 {
   namespace patches
   {
+    template <typename T_Solver,
+              typename T_BoundaryL,
+              typename T_BoundaryR>
     class WavePropagation1d;
+
+    /**
+     * Constructs the 1d wave propagation patch instantiated for the given solver and boundary conditions.
+     *
+     * @param i_nCells number of cells.
+     * @param i_solver selected solver (roe or fwave).
+     * @param i_boundaryL boundary condition on the left side.
+     * @param i_boundaryR boundary condition on the right side.
+     * @return patch; the caller takes ownership.
+     **/
+    WavePropagation *createWavePropagation1d(t_idx i_nCells,
+                                             std::string const &i_solver,
+                                             WavePropagation::Boundary i_boundaryL,
+                                             WavePropagation::Boundary i_boundaryR);
   }
 }
 
+/**
+ * One-dimensional wave propagation patch.
+ *
+ * @tparam T_Solver Riemann solver providing netUpdatesBatch (solvers::Roe or solvers::Fwave).
+ * @tparam T_BoundaryL boundary policy on the left side (boundaries::Outflow or boundaries::Wall).
+ * @tparam T_BoundaryR boundary policy on the right side (boundaries::Outflow or boundaries::Wall).
+ **/
+template <typename T_Solver,
+          typename T_BoundaryL,
+          typename T_BoundaryR>
 class tsunami_lab::patches::WavePropagation1d : public WavePropagation
 {
 private:
@@ -28,6 +56,11 @@ private:
   //! number of cells discretizing the computational domain
   t_idx m_nCells = 0;
 
+  //! storage of the arrays below
+  Field2d m_hStorage[2];
+  Field2d m_huStorage[2];
+  Field2d m_bStorage;
+
   //! water heights for the current and next time step for all cells
   t_real *m_h[2] = {nullptr, nullptr};
 
@@ -37,58 +70,48 @@ private:
   //! bathymetry 
   t_real *m_b = nullptr;
 
-  //! selected solver (roe or fwave)
-  std::string m_solver = "";
+  //! true if the time steps compute the maximum wave speed
+  bool m_trackMaxWaveSpeed = false;
 
-  //! boundary condition on the left side
-  Boundary m_boundaryL = OUTFLOW;
+  //! maximum wave speed after the last time step which computed it
+  t_real m_maxWaveSpeed = 0;
 
-  //! boundary condition on the right side
-  Boundary m_boundaryR = OUTFLOW;
+  //! number of edges which are solved by a single batch call of the solver
+  static t_idx constexpr m_batchSize = 256;
 
  /**
-  * Compute the reflection effect
+  * Loads the states of a batch of edges and applies the reflection effect.
+  * Edge i of the batch lies between the cells i_ceL + i and i_ceL + i + 1.
   * 
-  * @param i_h water height
-  * @param i_hu water momentum
-  * @param i_ceL left cell
-  * @param i_ceR right cell
-  * @param o_hL water height on the left side
-  * @param o_hR water height on the right side
-  * @param o_huL water momentum on the left side
-  * @param o_huR water momentum on the right side
-  * @param o_bL bathymetry on the left side 
-  * @param o_bR bathymetry on the right side
+  * @param i_h water heights.
+  * @param i_hu water momenta.
+  * @param i_ceL left cell of the first edge.
+  * @param i_nEdges number of edges in the batch.
+  * @param o_hL will be set to the water heights on the left sides.
+  * @param o_hR will be set to the water heights on the right sides.
+  * @param o_huL will be set to the water momenta on the left sides.
+  * @param o_huR will be set to the water momenta on the right sides.
+  * @param o_bL will be set to the bathymetry on the left sides.
+  * @param o_bR will be set to the bathymetry on the right sides.
   */
-  void handleReflections(t_real *i_h,
-                         t_real *i_hu,
-                         t_idx i_ceL,
-                         t_idx i_ceR,
-                         t_real &o_hL,
-                         t_real &o_hR,
-                         t_real &o_huL,
-                         t_real &o_huR,
-                         t_real &o_bL,
-                         t_real &o_bR);
+  void loadEdges(t_real const *i_h,
+                 t_real const *i_hu,
+                 t_idx i_ceL,
+                 t_idx i_nEdges,
+                 t_real *o_hL,
+                 t_real *o_hR,
+                 t_real *o_huL,
+                 t_real *o_huR,
+                 t_real *o_bL,
+                 t_real *o_bR);
 
 public:
   /**
    * Constructs the 1d wave propagation solver.
    *
    * @param i_nCells number of cells.
-   * @param i_solver selected solver.
-   * @param i_boundaryL boundary condition on the left side
-   * @param i_boundaryR boundary condition on the right side
    **/
-  WavePropagation1d(t_idx i_nCells,
-                    const std::string &i_solver,
-                    Boundary i_boundaryL,
-                    Boundary i_boundaryR);
-
-  /**
-   * Destructor which frees all allocated memory.
-   **/
-  ~WavePropagation1d();
+  WavePropagation1d(t_idx i_nCells);
 
   /**
    * Performs a time step.
@@ -103,6 +126,16 @@ public:
    **/
   void setGhostOutflow();
 
+  /**
+   * Performs multiple time steps and sets the ghost cells before each of them.
+   *
+   * @param i_nSteps number of time steps.
+   * @param i_scaling scaling of the time steps.
+   **/
+  void timeSteps(t_idx i_nSteps,
+                 t_real i_scaling,
+                 t_real);
+
   /**
    * Gets the stride in y-direction. x-direction is stride-1.
    *
@@ -198,6 +231,29 @@ public:
                      t_real i_b)
   {
     m_b[i_ix + 1] = i_b;
+
+    // the bathymetry is static, thus the ghost cells copy it once
+    if (i_ix == 0)
+      m_b[0] = i_b;
+    if (i_ix + 1 == m_nCells)
+      m_b[m_nCells + 1] = i_b;
+  }
+
+  /**
+   * Overwrites the state of a cell between two time steps.
+   *
+   * @param i_ix id of the cell in x-direction.
+   * @param i_h water height.
+   * @param i_hu momentum in x-direction.
+   **/
+  void setCellState(t_idx i_ix,
+                    t_idx,
+                    t_real i_h,
+                    t_real i_hu,
+                    t_real)
+  {
+    m_h[m_step][i_ix + 1] = i_h;
+    m_hu[m_step][i_ix + 1] = i_hu;
   }
 
   /**
@@ -213,6 +269,38 @@ public:
         m_h[m_step][i] = 0;
     }
   }
+
+  /**
+   * Enables or disables the computation of the maximum wave speed in the following time steps.
+   *
+   * @param i_track true to compute the maximum wave speed.
+   **/
+  void setMaxWaveSpeedTracking(bool i_track)
+  {
+    m_trackMaxWaveSpeed = i_track;
+  }
+
+  /**
+   * Gets the maximum wave speed |u| + sqrt(g * h) of the cells after the last time step which computed it.
+   *
+   * @return maximum wave speed.
+   **/
+  t_real getMaxWaveSpeed()
+  {
+    return m_maxWaveSpeed;
+  }
+
+  /**
+   * Computes the maximum wave speed |u| + sqrt(g * h) of the current states of consecutive cells, as the time steps track it.
+   *
+   * @param i_ix first cell.
+   * @param i_nx number of cells.
+   * @return maximum wave speed; 0 for no cells.
+   **/
+  t_real computeMaxWaveSpeed(t_idx i_ix,
+                             t_idx,
+                             t_idx i_nx,
+                             t_idx);
 };
 
 #endif
\ No newline at end of file
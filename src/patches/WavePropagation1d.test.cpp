@@ -7,9 +7,13 @@
  **/
 #include <catch2/catch.hpp>
 #include "WavePropagation1d.h"
+#include "Boundaries.h"
+#include "../solvers/Roe.h"
+#include "../solvers/Fwave.h"
 #include "../io/Csv.h"
+#include <cmath>
 
-using Boundary = tsunami_lab::patches::WavePropagation::Boundary;
+using Outflow = tsunami_lab::patches::boundaries::Outflow;
 
 TEST_CASE("Test the 1d wave propagation solver using roe.", "[WaveProp1d],[Roe]")
 {
@@ -31,10 +35,9 @@ TEST_CASE("Test the 1d wave propagation solver using roe.", "[WaveProp1d],[Roe]"
    */
 
   // construct solver and setup a dambreak problem
-  tsunami_lab::patches::WavePropagation1d m_waveProp(100,
-                                                     "roe",
-                                                     Boundary::OUTFLOW,
-                                                     Boundary::OUTFLOW);
+  tsunami_lab::patches::WavePropagation1d<tsunami_lab::solvers::Roe,
+                                          Outflow,
+                                          Outflow> m_waveProp(100);
 
   for (std::size_t l_ce = 0; l_ce < 50; l_ce++)
   {
@@ -103,10 +106,9 @@ TEST_CASE("Test the 1d wave propagation solver using fwave.", "[WaveProp1d],[Fwa
    */
 
   // construct solver and setup a dambreak problem
-  tsunami_lab::patches::WavePropagation1d m_waveProp(100,
-                                                     "fwave",
-                                                     Boundary::OUTFLOW,
-                                                     Boundary::OUTFLOW);
+  tsunami_lab::patches::WavePropagation1d<tsunami_lab::solvers::Fwave,
+                                          Outflow,
+                                          Outflow> m_waveProp(100);
 
   for (std::size_t l_ce = 0; l_ce < 50; l_ce++)
   {
@@ -130,7 +132,8 @@ TEST_CASE("Test the 1d wave propagation solver using fwave.", "[WaveProp1d],[Fwa
   // set outflow boundary condition
   m_waveProp.setGhostOutflow();
 
-  // perform a time step
+  // perform a time step and track the maximum wave speed
+  m_waveProp.setMaxWaveSpeedTracking(true);
   m_waveProp.timeStep(0.1, 0);
 
   // steady state
@@ -153,4 +156,8 @@ TEST_CASE("Test the 1d wave propagation solver using fwave.", "[WaveProp1d],[Fwa
     REQUIRE(m_waveProp.getHeight()[l_ce] == Approx(8));
     REQUIRE(m_waveProp.getMomentumX()[l_ce] == Approx(0));
   }
+
+  // maximum wave speed is reached in the left cell of the dam-break
+  REQUIRE(m_waveProp.getMaxWaveSpeed() == Approx(0.1 * 88.25985 / (10 - 0.1 * 9.394671362) +
+                                                 std::sqrt(9.80665 * (10 - 0.1 * 9.394671362))));
 }
\ No newline at end of file
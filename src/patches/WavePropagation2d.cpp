@@ -6,20 +6,29 @@
  * Two-dimensional wave propagation patch.
  **/
 #include "WavePropagation2d.h"
+#include "Boundaries.h"
 #include "../solvers/Roe.h"
 #include "../solvers/Fwave.h"
+#include "../solvers/Linear.h"
+#include "../systeminfo/Isa.h"
 #ifdef USEOMP
 #include <omp.h>
 #endif
 
-#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 
-tsunami_lab::patches::WavePropagation2d::WavePropagation2d(t_idx i_nCellsX,
-                                                           t_idx i_nCellsY,
-                                                           Boundary i_boundaryL,
-                                                           Boundary i_boundaryR,
-                                                           Boundary i_boundaryT,
-                                                           Boundary i_boundaryB)
+template <typename T_Solver>
+tsunami_lab::patches::WavePropagation2d<T_Solver>::WavePropagation2d(t_idx i_nCellsX,
+                                                                     t_idx i_nCellsY,
+                                                                     Boundary i_boundaryL,
+                                                                     Boundary i_boundaryR,
+                                                                     Boundary i_boundaryT,
+                                                                     Boundary i_boundaryB,
+                                                                     bool i_inPlace)
 {
   m_nCellsX = i_nCellsX;
   m_nCellsY = i_nCellsY;
@@ -27,290 +36,2912 @@ tsunami_lab::patches::WavePropagation2d::WavePropagation2d(t_idx i_nCellsX,
   m_boundaryR = i_boundaryR;
   m_boundaryT = i_boundaryT;
   m_boundaryB = i_boundaryB;
+  m_inPlace = i_inPlace;
 
-  // allocate memory including a single ghost cell on each side
-  t_idx l_totalCells = (m_nCellsX + 2) * (m_nCellsY + 2);
+  // allocate memory including a single ghost cell on each side; the rows are padded
+  unsigned short l_nBuffers = m_inPlace ? 1 : 2;
 
-  for (unsigned short l_st = 0; l_st < 2; l_st++)
+  for (unsigned short l_st = 0; l_st < l_nBuffers; l_st++)
   {
-    m_h[l_st] = new t_real[l_totalCells];
-    m_huX[l_st] = new t_real[l_totalCells];
-    m_huY[l_st] = new t_real[l_totalCells];
+    m_hStorage[l_st].allocate(m_nCellsX + 2, m_nCellsY + 2);
+    m_huXStorage[l_st].allocate(m_nCellsX + 2, m_nCellsY + 2);
+    m_huYStorage[l_st].allocate(m_nCellsX + 2, m_nCellsY + 2);
+    m_h[l_st] = m_hStorage[l_st].getData();
+    m_huX[l_st] = m_huXStorage[l_st].getData();
+    m_huY[l_st] = m_huYStorage[l_st].getData();
   }
-  m_b = new t_real[l_totalCells];
+  m_bStorage.allocate(m_nCellsX + 2, m_nCellsY + 2);
+  m_b = m_bStorage.getData();
+  m_stride = m_bStorage.getPitch();
 
-// init to zero
-  for (unsigned short l_st = 0; l_st < 2; l_st++)
+  // a tile spans one chunk of m_tileSizeY rows
+  m_nTilesX = (m_nCellsX + 2 + m_batchSize - 1) / m_batchSize;
+  m_nTilesY = (m_nCellsY + 2 + m_tileSizeY - 1) / m_tileSizeY;
+  m_nTilesComputed = m_nTilesX * m_nTilesY;
+  m_tilesActive = new unsigned char[m_nTilesX * m_nTilesY];
+  m_tilesChanged = new unsigned char[m_nTilesX * m_nTilesY];
+  m_chunksChanged = new unsigned char[m_nTilesX * (m_nCellsY + 2)];
+  std::fill_n(m_tilesActive, m_nTilesX * m_nTilesY, 1);
+
+  // both steps share the buffer of in-place updates
+  if (m_inPlace)
+  {
+    m_h[1] = m_h[0];
+    m_huX[1] = m_huX[0];
+    m_huY[1] = m_huY[0];
+  }
+
+  // init to zero; the threads touch the rows of their time steps first, which places the pages on their NUMA nodes
+#ifdef USEOMP
+#pragma omp parallel
+#endif
   {
-    for (t_idx l_ce = 0; l_ce < l_totalCells; l_ce++)
+    t_idx l_first = 0;
+    t_idx l_last = 0;
+    getRowBlock(l_first, l_last);
+
+    // the ghost rows belong to the adjacent blocks
+    if (l_first == 1)
+      l_first = 0;
+    if (l_last == m_nCellsY + 1)
+      l_last = m_nCellsY + 2;
+
+    for (unsigned short l_st = 0; l_st < l_nBuffers; l_st++)
     {
-      m_h[l_st][l_ce] = 0;
-      m_huX[l_st][l_ce] = 0;
-      m_huY[l_st][l_ce] = 0;
-      m_b[l_ce] = 0;
+      std::fill(m_h[l_st] + l_first * getStride(), m_h[l_st] + l_last * getStride(), t_real(0));
+      std::fill(m_huX[l_st] + l_first * getStride(), m_huX[l_st] + l_last * getStride(), t_real(0));
+      std::fill(m_huY[l_st] + l_first * getStride(), m_huY[l_st] + l_last * getStride(), t_real(0));
     }
+    std::fill(m_b + l_first * getStride(), m_b + l_last * getStride(), t_real(0));
   }
+
+  // the scratch buffers of the threads are reused by all time steps
+  t_idx l_nThreads = 1;
+#ifdef USEOMP
+  l_nThreads = omp_get_max_threads();
+#endif
+  allocateScratch(l_nThreads);
 }
 
-tsunami_lab::patches::WavePropagation2d::~WavePropagation2d()
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::getRowBlock(t_idx &o_first,
+                                                                    t_idx &o_last)
 {
+  t_idx l_nThreads = 1;
+  t_idx l_thread = 0;
 #ifdef USEOMP
-#pragma omp parallel for
+  l_nThreads = omp_get_num_threads();
+  l_thread = omp_get_thread_num();
 #endif
-  for (unsigned short l_st = 0; l_st < 2; l_st++)
+  if (m_rowBlocks.size() == l_nThreads + 1)
   {
-    delete[] m_h[l_st];
-    delete[] m_huX[l_st];
-    delete[] m_huY[l_st];
+    o_first = m_rowBlocks[l_thread];
+    o_last = m_rowBlocks[l_thread + 1];
+    return;
   }
-  delete[] m_b;
+  o_first = 1 + m_nCellsY * l_thread / l_nThreads;
+  o_last = 1 + m_nCellsY * (l_thread + 1) / l_nThreads;
 }
 
-void tsunami_lab::patches::WavePropagation2d::timeStep(t_real i_scalingX,
-                                                       t_real i_scalingY)
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::balanceRowBlocks(t_idx i_nSteps)
 {
-  // pointers to old and new data
-  t_real *l_hOld = m_h[m_step];
-  t_real *l_huOldX = m_huX[m_step];
-  t_real *l_huOldY = m_huY[m_step];
+  t_idx l_nThreads = 1;
+#ifdef USEOMP
+  l_nThreads = omp_get_num_threads();
+#endif
+
+  // the times and the blocks of another team are discarded
+  if (m_blockBusy.size() != l_nThreads)
+  {
+    m_blockBusy.assign(l_nThreads, 0);
+    m_stepBusy.assign(l_nThreads, 0);
+    m_rowBlocks.clear();
+  }
+
+  bool l_due = m_balanceSteps > 0 && (m_rowBlocks.empty() || m_stepsSinceBalance >= m_balanceSteps);
+  m_stepsSinceBalance += i_nSteps;
+  if (!l_due)
+    return;
+
+  // modelled cost of the inner rows; the wet cells change with the inundation, the computed ones when cells are set
+  t_real const *l_h = m_h[m_step];
+  std::vector<double> l_costs(m_nCellsY + 2, 0);
+  for (t_idx l_ro = 1; l_ro < m_nCellsY + 1; l_ro++)
+  {
+    t_idx l_nCells = m_rowCostOverhead;
+    for (t_idx l_in = m_wetIntervalsOffsets[l_ro]; l_in < m_wetIntervalsOffsets[l_ro + 1]; l_in += 2)
+    {
+      l_nCells += m_wetIntervals[l_in + 1] - m_wetIntervals[l_in];
+      for (t_idx l_co = m_wetIntervals[l_in]; l_co < m_wetIntervals[l_in + 1]; l_co++)
+        l_nCells += l_h[l_ro * getStride() + l_co] > 0 ? 1 : 0;
+    }
+    l_costs[l_ro] = double(l_nCells);
+  }
+  if (m_rowCostFactors.size() != m_nCellsY + 2)
+    m_rowCostFactors.assign(m_nCellsY + 2, 1);
+
+  // a block which took a larger share of the time than of the cost has more expensive rows, e.g., more wet cells of active tiles
+  if (m_rowBlocks.size() == l_nThreads + 1)
+  {
+    double l_costAll = 0;
+    double l_busyAll = 0;
+    for (t_idx l_ro = 1; l_ro < m_nCellsY + 1; l_ro++)
+      l_costAll += l_costs[l_ro] * m_rowCostFactors[l_ro];
+    for (t_idx l_th = 0; l_th < l_nThreads; l_th++)
+      l_busyAll += m_blockBusy[l_th];
+
+    for (t_idx l_th = 0; l_th < l_nThreads && l_busyAll > 0; l_th++)
+    {
+      double l_cost = 0;
+      for (t_idx l_ro = m_rowBlocks[l_th]; l_ro < m_rowBlocks[l_th + 1]; l_ro++)
+        l_cost += l_costs[l_ro] * m_rowCostFactors[l_ro];
+      if (l_cost <= 0 || m_blockBusy[l_th] <= 0)
+        continue;
+
+      // the correction is damped, which smooths the noise of the measurements
+      double l_correction = (m_blockBusy[l_th] / l_busyAll) / (l_cost / l_costAll);
+      for (t_idx l_ro = m_rowBlocks[l_th]; l_ro < m_rowBlocks[l_th + 1]; l_ro++)
+        m_rowCostFactors[l_ro] *= 0.5 * (1 + l_correction);
+    }
+  }
+
+  // every block gets the same share of the total cost, a row belongs to the block which holds its center
+  double l_costAll = 0;
+  for (t_idx l_ro = 1; l_ro < m_nCellsY + 1; l_ro++)
+  {
+    l_costs[l_ro] *= m_rowCostFactors[l_ro];
+    l_costAll += l_costs[l_ro];
+  }
+  m_rowBlocks.assign(l_nThreads + 1, m_nCellsY + 1);
+  m_rowBlocks[0] = 1;
+  double l_costBefore = 0;
+  t_idx l_th = 1;
+  for (t_idx l_ro = 1; l_ro < m_nCellsY + 1; l_ro++)
+  {
+    while (l_th < l_nThreads && l_costBefore + 0.5 * l_costs[l_ro] >= l_costAll * l_th / l_nThreads)
+      m_rowBlocks[l_th++] = l_ro;
+    l_costBefore += l_costs[l_ro];
+  }
+
+  std::fill(m_blockBusy.begin(), m_blockBusy.end(), 0);
+  m_stepsSinceBalance = i_nSteps;
+}
+
+/**
+ * Gets the wall clock time in seconds.
+ **/
+static double wallTime()
+{
+#ifdef USEOMP
+  return omp_get_wtime();
+#else
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * Gets the id of the calling thread in the current team.
+ **/
+static tsunami_lab::t_idx threadNum()
+{
+#ifdef USEOMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::allocateScratch(t_idx i_nThreads)
+{
+  if (m_scratch.size() < i_nThreads)
+    m_scratch.resize(i_nThreads);
+
+  t_idx l_windowCells = 0;
+  if (m_ghostWidth > 1)
+    l_windowCells = 6 * (getBlockedTileRows(m_ghostWidth) + 2 * m_ghostWidth) * getStride();
+
+  for (Scratch &l_scratch : m_scratch)
+  {
+    l_scratch.updates.resize(m_nScratchRows * getStride());
+    l_scratch.carry.resize(2 * (m_nCellsY + 2));
+    l_scratch.quantities.resize(10 * getStride());
+    if (l_scratch.window.size() < l_windowCells)
+      l_scratch.window.resize(l_windowCells);
+  }
+}
+
+template <typename T_Solver>
+typename tsunami_lab::patches::WavePropagation2d<T_Solver>::Scratch &tsunami_lab::patches::WavePropagation2d<T_Solver>::getScratch()
+{
+  return m_scratch[threadNum()];
+}
+
+template <typename T_Solver>
+tsunami_lab::t_idx tsunami_lab::patches::WavePropagation2d<T_Solver>::getBlockedTileRows(t_idx i_nSteps)
+{
+  // a tile and its halo of i_nSteps rows on each side fill the targeted cache
+  t_idx l_cacheRows = m_blockingCacheSize / (6 * sizeof(t_real) * getStride());
+  return std::max(l_cacheRows > 2 * i_nSteps ? l_cacheRows - 2 * i_nSteps : 0, 4 * i_nSteps);
+}
+
+template <typename T_Solver>
+tsunami_lab::patches::WavePropagation2d<T_Solver>::~WavePropagation2d()
+{
+  delete[] m_tilesActive;
+  delete[] m_tilesChanged;
+  delete[] m_chunksChanged;
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::timeStep(t_real i_scalingX,
+                                                                 t_real i_scalingY)
+{
+#ifdef USEOMP
+  // the threads of an enclosing parallel region share the time step
+  if (omp_in_parallel())
+  {
+    timeStepTeam(i_scalingX, i_scalingY);
+    return;
+  }
+#pragma omp parallel
+#endif
+  timeStepTeam(i_scalingX, i_scalingY);
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::timeSteps(t_idx i_nSteps,
+                                                                  t_real i_scalingX,
+                                                                  t_real i_scalingY)
+{
+#ifdef USEOMP
+  // the threads of an enclosing parallel region share the time steps
+  if (omp_in_parallel())
+  {
+    timeStepsTeam(i_nSteps, i_scalingX, i_scalingY);
+    return;
+  }
+#pragma omp parallel
+#endif
+  timeStepsTeam(i_nSteps, i_scalingX, i_scalingY);
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::timeStepsTeam(t_idx i_nSteps,
+                                                                      t_real i_scalingX,
+                                                                      t_real i_scalingY)
+{
+  // the tasks of the tiles overlap the time steps on their own
+  if (m_taskRows > 0 && !m_inPlace && m_timeStepLevels == 0)
+  {
+    timeStepsTasks(i_nSteps, i_scalingX, i_scalingY);
+    return;
+  }
+
+  for (t_idx l_st = 0; l_st < i_nSteps;)
+  {
+    // the blocked time steps read the old states of all tiles until the end, which rules out in-place updates, skipped tiles and local time steps
+    t_idx l_nBlocked = std::min(i_nSteps - l_st, m_ghostWidth);
+    if (m_inPlace || m_activityThreshold >= 0 || m_timeStepLevels > 0)
+      l_nBlocked = 1;
+
+    if (l_nBlocked > 1)
+      timeStepsBlocked(l_nBlocked, i_scalingX, i_scalingY);
+    else
+      timeStepTeam(i_scalingX, i_scalingY);
+    l_st += l_nBlocked;
+  }
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::prepareCells()
+{
+  // a team which is larger than the one of the construction gets buffers for its further threads
+  t_idx l_nThreads = 1;
+#ifdef USEOMP
+  l_nThreads = omp_get_num_threads();
+#endif
+  if (m_scratch.size() < l_nThreads)
+    allocateScratch(l_nThreads);
+
+  // the intervals and the tiles are derived from the cells which were set
+  if (m_cellsSet)
+  {
+    setGhostBathymetry();
+    if (m_quantizeBathymetry)
+      quantizeBathymetry();
+    updateWetIntervals();
+    m_resetActivity = true;
+    m_cellsSet = false;
+  }
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::prepareTimeStep()
+{
+  prepareCells();
+
+  if (m_activityThreshold >= 0)
+    updateActiveTiles();
+  else
+    m_nTilesComputed = m_nTilesX * m_nTilesY;
+
+  if (m_trackMaxWaveSpeed)
+    m_maxWaveSpeed = 0;
 
   m_step = (m_step + 1) % 2;
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::timeStepTeam(t_real i_scalingX,
+                                                                     t_real i_scalingY)
+{
+  if (m_timeStepLevels > 0)
+  {
+    timeStepLocalTeam(i_scalingX, i_scalingY);
+    return;
+  }
+  if (m_taskRows > 0 && !m_inPlace)
+  {
+    timeStepsTasks(1, i_scalingX, i_scalingY);
+    return;
+  }
+
+  // one thread prepares the time step and the blocks, the implicit barrier publishes them
+#ifdef USEOMP
+#pragma omp single
+#endif
+  {
+    prepareCells();
+    balanceRowBlocks(1);
+    prepareTimeStep();
+  }
+
+  // pointers to old and new data
+  t_real *l_hOld = m_h[(m_step + 1) % 2];
+  t_real *l_huOldX = m_huX[(m_step + 1) % 2];
+  t_real *l_huOldY = m_huY[(m_step + 1) % 2];
+
   t_real *l_hNew = m_h[m_step];
   t_real *l_huNewX = m_huX[m_step];
   t_real *l_huNewY = m_huY[m_step];
 
-// init new cell quantities
+  t_real l_maxWaveSpeed = 0;
+
+  // every thread updates a block of consecutive rows
+  t_idx l_first = 0;
+  t_idx l_last = 0;
+  getRowBlock(l_first, l_last);
+
+  Scratch &l_scratch = getScratch();
+
+  // net-updates which the cells of the next row receive from the y-edges below them
+  t_real *l_updatesBottomH = l_scratch.updates.data();
+  t_real *l_updatesBottomHu = l_updatesBottomH + getStride();
+  // net-updates which the block's last row receives from the y-edges above it
+  t_real *l_updatesTopH = l_updatesBottomH + 2 * getStride();
+  t_real *l_updatesTopHu = l_updatesBottomH + 3 * getStride();
+  // net-updates of the cells outside the block, which are not needed
+  t_real *l_updatesOutH = l_updatesBottomH + 4 * getStride();
+  t_real *l_updatesOutHu = l_updatesBottomH + 5 * getStride();
+
+  if (l_first < l_last)
+  {
+    solveEdgesBelow(l_first,
+                    l_hOld,
+                    l_huOldY,
+                    l_updatesOutH,
+                    l_updatesOutHu,
+                    l_updatesBottomH,
+                    l_updatesBottomHu);
+  }
+
+  // neighbouring blocks overwrite the rows next to the block in place, thus the edges in between are solved upfront
+  if (m_inPlace)
+  {
+    if (l_first < l_last)
+    {
+      solveEdgesBelow(l_last,
+                      l_hOld,
+                      l_huOldY,
+                      l_updatesTopH,
+                      l_updatesTopHu,
+                      l_updatesOutH,
+                      l_updatesOutHu);
+    }
 #ifdef USEOMP
-#pragma omp parallel for
+#pragma omp barrier
 #endif
-  for (t_idx l_ce = 0; l_ce < (m_nCellsX + 2) * (m_nCellsY + 2); l_ce++)
+  }
+
+  // the block's time excludes the wait for the neighbouring blocks
+  double l_begin = wallTime();
+
+  // net-updates which the first cell of a strip receives from the x-edge left of it, one per row of the block
+  t_real *l_carryH = l_scratch.carry.data();
+  t_real *l_carryHu = l_carryH + (l_last - l_first);
+
+  // quantities which the edges of a cell share, for the row and the one above; skipped tiles would compute them in vain
+  bool l_shareQuantities = T_Solver::m_sharesCellQuantities && m_shareCellQuantities && m_activityThreshold < 0;
+  RowQuantities l_quantities[2];
+  if (l_shareQuantities)
+    getRowQuantities(l_scratch, l_quantities);
+
+  // the block is swept in strips of columns, which keeps the rows of a strip in the cache for the y-edges
+  t_idx l_stripWidth = m_stripWidth > 0 ? m_stripWidth : m_nCellsX + 2;
+  for (t_idx l_co = 0; l_co < m_nCellsX + 2; l_co += l_stripWidth)
   {
-    l_hNew[l_ce] = l_hOld[l_ce];
-    l_huNewX[l_ce] = l_huOldX[l_ce];
-    l_huNewY[l_ce] = l_huOldY[l_ce];
+    t_idx l_coEnd = std::min(l_co + l_stripWidth, m_nCellsX + 2);
+    if (l_shareQuantities && l_first < l_last)
+      computeRowQuantities(l_first, l_co, l_coEnd, l_hOld, l_huOldX, l_huOldY, l_quantities[l_first % 2]);
+
+    for (t_idx l_ro = l_first; l_ro < l_last; l_ro++)
+    {
+      bool l_precomputed = m_inPlace && l_ro + 1 == l_last;
+      if (l_shareQuantities && !l_precomputed && l_ro < m_nCellsY)
+        computeRowQuantities(l_ro + 1, l_co, l_coEnd, l_hOld, l_huOldX, l_huOldY, l_quantities[(l_ro + 1) % 2]);
+
+      updateRow(l_ro,
+                l_co,
+                l_coEnd,
+                i_scalingX,
+                i_scalingY,
+                l_hOld,
+                l_huOldX,
+                l_huOldY,
+                l_shareQuantities ? l_quantities : nullptr,
+                l_updatesBottomH,
+                l_updatesBottomHu,
+                l_precomputed ? l_updatesTopH : nullptr,
+                l_precomputed ? l_updatesTopHu : nullptr,
+                l_carryH[l_ro - l_first],
+                l_carryHu[l_ro - l_first],
+                l_hNew,
+                l_huNewX,
+                l_huNewY,
+                l_maxWaveSpeed);
+    }
   }
 
-// iterate over edges and update with Riemann solutions
-// X-SWEEP
+  if (m_trackMaxWaveSpeed)
+  {
 #ifdef USEOMP
-#pragma omp parallel for
+#pragma omp critical
 #endif
-  for (t_idx l_ed = 0; l_ed < m_nCellsY + 1; l_ed++)
-  {
-    for (t_idx l_ec = 1; l_ec < m_nCellsX; l_ec++)
-    {
-      // determine left and right cell-id
-      t_idx l_ceL = l_ec + getStride() * l_ed;
-      t_idx l_ceR = l_ceL + 1;
-
-      t_real l_hL = l_hOld[l_ceL];
-      t_real l_hR = l_hOld[l_ceR];
-      t_real l_huL = l_huOldX[l_ceL];
-      t_real l_huR = l_huOldX[l_ceR];
-      t_real l_bL = m_b[l_ceL];
-      t_real l_bR = m_b[l_ceR];
-
-      // handle reflections
-      handleReflections(l_hOld,
-                        l_huOldX,
-                        l_ceL,
-                        l_ceR,
-                        l_hL,
-                        l_hR,
-                        l_huL,
-                        l_huR,
-                        l_bL,
-                        l_bR);
-
-      // compute net-updates
-      t_real l_netUpdates[2][2];
-
-      if (l_hL == 0 && l_hR == 0)
-        continue;
-      solvers::Fwave::netUpdates(l_hL,
-                                 l_hR,
-                                 l_huL,
-                                 l_huR,
-                                 l_bL,
-                                 l_bR,
-                                 l_netUpdates[0],
-                                 l_netUpdates[1]);
-
-      if (l_hOld[l_ceL] > 0)
-      {
-        l_hNew[l_ceL] -= i_scalingX * l_netUpdates[0][0];
-        l_huNewX[l_ceL] -= i_scalingX * l_netUpdates[0][1];
-      }
-      else
+    m_maxWaveSpeed = std::max(m_maxWaveSpeed, l_maxWaveSpeed);
+  }
+
+  double l_busy = wallTime() - l_begin;
+  m_blockBusy[threadNum()] += l_busy;
+  m_stepBusy[threadNum()] = l_busy;
+
+  // the new states are complete once all blocks are updated
+#ifdef USEOMP
+#pragma omp barrier
+#endif
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::timeStepsBlocked(t_idx i_nSteps,
+                                                                         t_real i_scalingX,
+                                                                         t_real i_scalingY)
+{
+#ifdef USEOMP
+#pragma omp single
+#endif
+  {
+    prepareCells();
+    balanceRowBlocks(i_nSteps);
+    prepareTimeStep();
+  }
+  double l_begin = wallTime();
+
+  // the old states are read in the first and the new states written in the last of the time steps
+  t_real const *l_hOld = m_h[(m_step + 1) % 2];
+  t_real const *l_huOldX = m_huX[(m_step + 1) % 2];
+  t_real const *l_huOldY = m_huY[(m_step + 1) % 2];
+
+  t_real *l_hNew = m_h[m_step];
+  t_real *l_huNewX = m_huX[m_step];
+  t_real *l_huNewY = m_huY[m_step];
+
+  t_real l_maxWaveSpeed = 0;
+  t_real l_maxWaveSpeedHalo = 0;
+
+  t_idx l_first = 0;
+  t_idx l_last = 0;
+  getRowBlock(l_first, l_last);
+
+  t_idx l_tileRows = getBlockedTileRows(i_nSteps);
+  t_idx l_windowCells = (l_tileRows + 2 * i_nSteps) * getStride();
+
+  // intermediate states of a tile and its halo
+  Scratch &l_scratch = getScratch();
+  t_real *l_window = l_scratch.window.data();
+  t_real *l_h[2] = {l_window, l_window + l_windowCells};
+  t_real *l_huX[2] = {l_window + 2 * l_windowCells, l_window + 3 * l_windowCells};
+  t_real *l_huY[2] = {l_window + 4 * l_windowCells, l_window + 5 * l_windowCells};
+
+  t_real *l_updatesBottomH = l_scratch.updates.data();
+  t_real *l_updatesBottomHu = l_updatesBottomH + getStride();
+  t_real *l_updatesOutH = l_updatesBottomH + 2 * getStride();
+  t_real *l_updatesOutHu = l_updatesBottomH + 3 * getStride();
+  t_real l_carryH = 0;
+  t_real l_carryHu = 0;
+
+  for (t_idx l_r0 = l_first; l_r0 < l_last; l_r0 += l_tileRows)
+  {
+    t_idx l_r1 = std::min(l_r0 + l_tileRows, l_last);
+
+    // the intermediate states are addressed by the indices of the patch's cells; the window starts with the rows of the first time step
+    t_idx l_window = std::max(l_r0, i_nSteps) - (i_nSteps - 1);
+    l_window *= getStride();
+
+    for (t_idx l_st = 0; l_st < i_nSteps; l_st++)
+    {
+      // the rows outside the tile shrink by one per time step
+      t_idx l_halo = i_nSteps - 1 - l_st;
+      t_idx l_ro0 = std::max(l_r0, l_halo + 1) - l_halo;
+      t_idx l_ro1 = std::min(l_r1 + l_halo, m_nCellsY + 1);
+
+      t_real const *l_hSrc = l_hOld;
+      t_real const *l_huXSrc = l_huOldX;
+      t_real const *l_huYSrc = l_huOldY;
+      if (l_st > 0)
       {
-        l_hNew[l_ceL] = 0;
-        l_huNewX[l_ceL] = 0;
+        l_hSrc = l_h[(l_st + 1) % 2] - l_window;
+        l_huXSrc = l_huX[(l_st + 1) % 2] - l_window;
+        l_huYSrc = l_huY[(l_st + 1) % 2] - l_window;
       }
 
-      if (l_hOld[l_ceR] > 0)
+      t_real *l_hDst = l_hNew;
+      t_real *l_huXDst = l_huNewX;
+      t_real *l_huYDst = l_huNewY;
+      if (l_st + 1 < i_nSteps)
       {
-        l_hNew[l_ceR] -= i_scalingX * l_netUpdates[1][0];
-        l_huNewX[l_ceR] -= i_scalingX * l_netUpdates[1][1];
+        l_hDst = l_h[l_st % 2] - l_window;
+        l_huXDst = l_huX[l_st % 2] - l_window;
+        l_huYDst = l_huY[l_st % 2] - l_window;
+
+        // the permanently dry cells are not written, their rows may hold states of the previous tile
+        std::fill(l_hDst + l_ro0 * getStride(), l_hDst + l_ro1 * getStride(), t_real(0));
+        std::fill(l_huXDst + l_ro0 * getStride(), l_huXDst + l_ro1 * getStride(), t_real(0));
+        std::fill(l_huYDst + l_ro0 * getStride(), l_huYDst + l_ro1 * getStride(), t_real(0));
       }
-      else
+
+      solveEdgesBelow(l_ro0,
+                      l_hSrc,
+                      l_huYSrc,
+                      l_updatesOutH,
+                      l_updatesOutHu,
+                      l_updatesBottomH,
+                      l_updatesBottomHu);
+
+      for (t_idx l_ro = l_ro0; l_ro < l_ro1; l_ro++)
       {
-        l_hNew[l_ceR] = 0;
-        l_huNewX[l_ceR] = 0;
+        updateRow(l_ro,
+                  0,
+                  m_nCellsX + 2,
+                  i_scalingX,
+                  i_scalingY,
+                  l_hSrc,
+                  l_huXSrc,
+                  l_huYSrc,
+                  nullptr,
+                  l_updatesBottomH,
+                  l_updatesBottomHu,
+                  nullptr,
+                  nullptr,
+                  l_carryH,
+                  l_carryHu,
+                  l_hDst,
+                  l_huXDst,
+                  l_huYDst,
+                  l_halo == 0 ? l_maxWaveSpeed : l_maxWaveSpeedHalo);
       }
     }
   }
 
-// Y-SWEEP
+  if (m_trackMaxWaveSpeed)
+  {
 #ifdef USEOMP
-#pragma omp parallel for
+#pragma omp critical
+#endif
+    m_maxWaveSpeed = std::max(m_maxWaveSpeed, l_maxWaveSpeed);
+  }
+
+  double l_busy = wallTime() - l_begin;
+  m_blockBusy[threadNum()] += l_busy;
+  m_stepBusy[threadNum()] = l_busy;
+
+  // the new states are complete once all tiles are updated
+#ifdef USEOMP
+#pragma omp barrier
+#endif
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::timeStepsTasks(t_idx i_nSteps,
+                                                                       t_real i_scalingX,
+                                                                       t_real i_scalingY)
+{
+  double l_begin = wallTime();
+
+  // the other threads take the tasks while they are created
+#ifdef USEOMP
+#pragma omp single
+#endif
+  {
+    t_idx l_nTiles = (m_nCellsY + m_taskRows - 1) / m_taskRows;
+
+#ifdef USEOMP
+    // addresses of the dependencies per tile, one set per parity of the time steps with a spare entry on each side
+    std::vector<unsigned char> l_dependencies(2 * (l_nTiles + 2));
 #endif
-  for (t_idx l_ec = 0; l_ec < m_nCellsY + 1; l_ec++)
-  {
-    for (t_idx l_ed = 1; l_ed < m_nCellsX; l_ed++)
-    {
-      // determine upper and lower cell-id
-      t_idx l_ceB = l_ec * getStride() + l_ed;
-      t_idx l_ceT = l_ceB + getStride();
-
-      t_real l_hB = l_hOld[l_ceB];
-      t_real l_hT = l_hOld[l_ceT];
-      t_real l_huB = l_huOldY[l_ceB];
-      t_real l_huT = l_huOldY[l_ceT];
-      t_real l_bB = m_b[l_ceB];
-      t_real l_bT = m_b[l_ceT];
-
-      // handle reflections
-      handleReflections(l_hOld,
-                        l_huOldY,
-                        l_ceB,
-                        l_ceT,
-                        l_hB,
-                        l_hT,
-                        l_huB,
-                        l_huT,
-                        l_bB,
-                        l_bT);
-
-      // compute net-updates
-      t_real l_netUpdates[2][2];
-
-      if (l_hB == 0 && l_hT == 0)
-        continue;
-      solvers::Fwave::netUpdates(l_hB,
-                                 l_hT,
-                                 l_huB,
-                                 l_huT,
-                                 l_bB,
-                                 l_bT,
-                                 l_netUpdates[0],
-                                 l_netUpdates[1]);
-
-      if (l_hOld[l_ceB] > 0)
-      {
-        l_hNew[l_ceB] -= i_scalingY * l_netUpdates[0][0];
-        l_huNewY[l_ceB] -= i_scalingY * l_netUpdates[0][1];
-      }
-      else
-      {
-        l_hNew[l_ceB] = 0;
-        l_huNewY[l_ceB] = 0;
-      }
 
-      if (l_hOld[l_ceT] > 0)
+    for (t_idx l_st = 0; l_st < i_nSteps; l_st++)
+    {
+      // the tiles are selected by the changes of the whole previous time step
+      if (l_st > 0 && m_activityThreshold >= 0)
       {
-        l_hNew[l_ceT] -= i_scalingY * l_netUpdates[1][0];
-        l_huNewY[l_ceT] -= i_scalingY * l_netUpdates[1][1];
+#ifdef USEOMP
+#pragma omp taskwait
+#endif
       }
-      else
+      prepareTimeStep();
+
+      t_real const *l_hOld = m_h[(m_step + 1) % 2];
+      t_real const *l_huOldX = m_huX[(m_step + 1) % 2];
+      t_real const *l_huOldY = m_huY[(m_step + 1) % 2];
+
+      t_real *l_hNew = m_h[m_step];
+      t_real *l_huNewX = m_huX[m_step];
+      t_real *l_huNewY = m_huY[m_step];
+
+      // the maximum wave speed of the last time step is kept
+      bool l_trackMaxWaveSpeed = m_trackMaxWaveSpeed && l_st + 1 == i_nSteps;
+
+#ifdef USEOMP
+      // a task writes the rows of its tile, which the neighbouring tiles of the previous time step read;
+      // the writing task waits for them through the entries of its parity, which they read
+      unsigned char *l_written = l_dependencies.data() + (l_st % 2) * (l_nTiles + 2);
+      unsigned char *l_read = l_dependencies.data() + ((l_st + 1) % 2) * (l_nTiles + 2);
+#endif
+      for (t_idx l_ti = 0; l_ti < l_nTiles; l_ti++)
       {
-        l_hNew[l_ceT] = 0;
-        l_huNewY[l_ceT] = 0;
+        t_idx l_first = 1 + l_ti * m_taskRows;
+        t_idx l_last = std::min(l_first + m_taskRows, m_nCellsY + 1);
+#ifdef USEOMP
+#pragma omp task depend(out : l_written[l_ti + 1]) depend(in : l_read[l_ti], l_read[l_ti + 1], l_read[l_ti + 2])
+#endif
+        {
+          double l_taskBegin = wallTime();
+          t_real l_maxWaveSpeed = 0;
+          updateTile(l_first,
+                     l_last,
+                     i_scalingX,
+                     i_scalingY,
+                     l_hOld,
+                     l_huOldX,
+                     l_huOldY,
+                     l_hNew,
+                     l_huNewX,
+                     l_huNewY,
+                     l_maxWaveSpeed);
+          if (l_trackMaxWaveSpeed)
+          {
+#ifdef USEOMP
+#pragma omp critical
+#endif
+            m_maxWaveSpeed = std::max(m_maxWaveSpeed, l_maxWaveSpeed);
+          }
+
+          t_idx l_thread = threadNum();
+          if (l_thread < m_taskBusy.size())
+            m_taskBusy[l_thread] += wallTime() - l_taskBegin;
+        }
       }
     }
+
+    // the dependencies have to outlive the tasks
+#ifdef USEOMP
+#pragma omp taskwait
+#endif
   }
+
+  // the implicit barrier of the single construct completes all tasks
+  t_idx l_thread = threadNum();
+  if (l_thread < m_taskTotal.size())
+    m_taskTotal[l_thread] += wallTime() - l_begin;
 }
 
-void tsunami_lab::patches::WavePropagation2d::setGhostOutflow()
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::updateTile(t_idx i_first,
+                                                                   t_idx i_last,
+                                                                   t_real i_scalingX,
+                                                                   t_real i_scalingY,
+                                                                   t_real const *i_hOld,
+                                                                   t_real const *i_huXOld,
+                                                                   t_real const *i_huYOld,
+                                                                   t_real *o_hNew,
+                                                                   t_real *o_huXNew,
+                                                                   t_real *o_huYNew,
+                                                                   t_real &io_maxWaveSpeed)
 {
-  t_real *l_h = m_h[m_step];
-  t_real *l_huX = m_huX[m_step];
-  t_real *l_huY = m_huY[m_step];
-  t_real *l_b = m_b;
+  // a task runs on one thread without interruptions, thus it uses the scratch buffers of its thread
+  Scratch &l_scratch = getScratch();
 
-#ifdef USEOMP
-#pragma omp parallel for
-#endif
-  for (t_idx i = 1; i < m_nCellsY; i++)
+  // net-updates which the cells of the next row receive from the y-edges below them
+  t_real *l_updatesBottomH = l_scratch.updates.data();
+  t_real *l_updatesBottomHu = l_updatesBottomH + getStride();
+  // net-updates of the cells below the tile, which are not needed
+  t_real *l_updatesOutH = l_updatesBottomH + 2 * getStride();
+  t_real *l_updatesOutHu = l_updatesBottomH + 3 * getStride();
+
+  solveEdgesBelow(i_first,
+                  i_hOld,
+                  i_huYOld,
+                  l_updatesOutH,
+                  l_updatesOutHu,
+                  l_updatesBottomH,
+                  l_updatesBottomHu);
+
+  // net-updates which the first cell of a strip receives from the x-edge left of it, one per row of the tile
+  t_real *l_carryH = l_scratch.carry.data();
+  t_real *l_carryHu = l_carryH + (i_last - i_first);
+
+  bool l_shareQuantities = T_Solver::m_sharesCellQuantities && m_shareCellQuantities && m_activityThreshold < 0;
+  RowQuantities l_quantities[2];
+  if (l_shareQuantities)
+    getRowQuantities(l_scratch, l_quantities);
+
+  t_idx l_stripWidth = m_stripWidth > 0 ? m_stripWidth : m_nCellsX + 2;
+  for (t_idx l_co = 0; l_co < m_nCellsX + 2; l_co += l_stripWidth)
   {
-    t_idx ceL = getStride() * i;
-    t_idx ceR = ceL + m_nCellsX + 1;
-    // left column
-    l_h[ceL] = m_boundaryL == WALL ? 0 : l_h[ceL + 1];
-    l_huX[ceL] = l_huX[ceL + 1];
-    l_huY[ceL] = l_huY[ceL + 1];
-    l_b[ceL] = l_b[ceL + 1];
-    // right column
-    l_h[ceR] = m_boundaryR == WALL ? 0 : l_h[ceR - 1];
-    l_huX[ceR] = l_huX[ceR - 1];
-    l_huY[ceR] = l_huY[ceR - 1];
-    l_b[ceR] = l_b[ceR - 1];
+    t_idx l_coEnd = std::min(l_co + l_stripWidth, m_nCellsX + 2);
+    if (l_shareQuantities)
+      computeRowQuantities(i_first, l_co, l_coEnd, i_hOld, i_huXOld, i_huYOld, l_quantities[i_first % 2]);
+
+    for (t_idx l_ro = i_first; l_ro < i_last; l_ro++)
+    {
+      if (l_shareQuantities && l_ro < m_nCellsY)
+        computeRowQuantities(l_ro + 1, l_co, l_coEnd, i_hOld, i_huXOld, i_huYOld, l_quantities[(l_ro + 1) % 2]);
+
+      updateRow(l_ro,
+                l_co,
+                l_coEnd,
+                i_scalingX,
+                i_scalingY,
+                i_hOld,
+                i_huXOld,
+                i_huYOld,
+                l_shareQuantities ? l_quantities : nullptr,
+                l_updatesBottomH,
+                l_updatesBottomHu,
+                nullptr,
+                nullptr,
+                l_carryH[l_ro - i_first],
+                l_carryHu[l_ro - i_first],
+                o_hNew,
+                o_huXNew,
+                o_huYNew,
+                io_maxWaveSpeed);
+    }
   }
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::setTaskTiles(t_idx i_nRows)
+{
+  m_taskRows = i_nRows;
 
+  // the times are kept per thread of the teams of the time steps
+  t_idx l_nThreads = 1;
 #ifdef USEOMP
-#pragma omp parallel for
+  l_nThreads = omp_get_max_threads();
 #endif
-  for (t_idx i = 0; i < m_nCellsX + 2; i++)
-  {
-    t_idx ceB = i;
-    t_idx ceT = i + (m_nCellsY + 1) * getStride();
-    // bottom row
-    l_h[ceB] = m_boundaryB == WALL ? 0 : l_h[ceB + getStride()];
-    l_huX[ceB] = l_huX[ceB + getStride()];
-    l_huY[ceB] = l_huY[ceB + getStride()];
-    l_b[ceB] = l_b[ceB + getStride()];
-    // top row
-    l_h[ceT] = m_boundaryT == WALL ? 0 : l_h[ceT - getStride()];
-    l_huX[ceT] = l_huX[ceT - getStride()];
-    l_huY[ceT] = l_huY[ceT - getStride()];
-    l_b[ceT] = l_b[ceT - getStride()];
-  }
-}
-
-void tsunami_lab::patches::WavePropagation2d::handleReflections(t_real *i_h,
-                                                                t_real *i_hu,
-                                                                t_idx i_ceL,
-                                                                t_idx i_ceR,
-                                                                t_real &o_hL,
-                                                                t_real &o_hR,
-                                                                t_real &o_huL,
-                                                                t_real &o_huR,
-                                                                t_real &o_bL,
-                                                                t_real &o_bR)
+  m_taskBusy.assign(l_nThreads, 0);
+  m_taskTotal.assign(l_nThreads, 0);
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::getTaskTimes(std::vector<double> &o_busy,
+                                                                     std::vector<double> &o_idle)
 {
-  // use margin for comparison in case of rounding errors
-  tsunami_lab::t_real margin = 0.00001;
-  if (i_h[i_ceR] <= margin)
+  o_busy = m_taskBusy;
+  o_idle.resize(m_taskTotal.size());
+  for (t_idx l_th = 0; l_th < m_taskTotal.size(); l_th++)
+    o_idle[l_th] = m_taskTotal[l_th] - m_taskBusy[l_th];
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::setLoadBalancing(t_idx i_nSteps)
+{
+  m_balanceSteps = i_nSteps;
+  m_stepsSinceBalance = 0;
+  m_rowBlocks.clear();
+  m_rowCostFactors.clear();
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::getRowBlocks(std::vector<t_idx> &o_blocks)
+{
+  o_blocks = m_rowBlocks;
+
+  // the even split of the last team
+  if (o_blocks.empty())
   {
-    // right cell dry
-    o_hR = i_h[i_ceL];
-    o_bR = m_b[i_ceL];
-    o_huR = -i_hu[i_ceL];
+    t_idx l_nThreads = std::max(m_blockBusy.size(), std::size_t(1));
+    for (t_idx l_th = 0; l_th <= l_nThreads; l_th++)
+      o_blocks.push_back(1 + m_nCellsY * l_th / l_nThreads);
   }
-  else if (i_h[i_ceL] <= margin)
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::setLocalTimeStepping(t_idx i_nLevels)
+{
+  m_timeStepLevels = std::min(i_nLevels, m_maxTimeStepLevels);
+  if (m_timeStepLevels > 0 && m_accumulatedHStorage.getData() == nullptr)
   {
-    // left cell dry
-    o_hL = i_h[i_ceR];
-    o_bL = m_b[i_ceR];
-    o_huL = -i_hu[i_ceR];
+    m_accumulatedHStorage.allocate(m_nCellsX + 2, m_nCellsY + 2);
+    m_accumulatedHuXStorage.allocate(m_nCellsX + 2, m_nCellsY + 2);
+    m_accumulatedHuYStorage.allocate(m_nCellsX + 2, m_nCellsY + 2);
   }
 }
 
-void tsunami_lab::patches::WavePropagation2d::adjustWaterHeight()
+/**
+ * Gets the number of trailing zero bits of a micro step, which is the largest class starting or completing a local time step.
+ **/
+static tsunami_lab::t_idx trailingZeros(tsunami_lab::t_idx i_step,
+                                        tsunami_lab::t_idx i_max)
 {
-#ifdef USEOMP
-#pragma omp parallel for
-#endif
-  for (t_idx l_iy = 1; l_iy < m_nCellsY + 1; l_iy++)
+  tsunami_lab::t_idx l_nZeros = 0;
+  while (l_nZeros < i_max && (i_step >> l_nZeros) % 2 == 0)
+    l_nZeros++;
+  return l_nZeros;
+}
+
+/**
+ * Appends the runs [begin, end) of consecutive columns with equal classes to the runs of their classes; the dry class is skipped.
+ **/
+static void appendRuns(unsigned char const *i_classes,
+                       tsunami_lab::t_idx i_colBegin,
+                       tsunami_lab::t_idx i_colEnd,
+                       unsigned char i_dryClass,
+                       std::vector<tsunami_lab::t_idx> *const *io_runs)
+{
+  for (tsunami_lab::t_idx l_co = i_colBegin; l_co < i_colEnd;)
+  {
+    tsunami_lab::t_idx l_end = l_co + 1;
+    while (l_end < i_colEnd && i_classes[l_end] == i_classes[l_co])
+      l_end++;
+    if (i_classes[l_co] != i_dryClass)
+    {
+      io_runs[i_classes[l_co]]->push_back(l_co);
+      io_runs[i_classes[l_co]]->push_back(l_end);
+    }
+    l_co = l_end;
+  }
+}
+
+/**
+ * Derives the classes of consecutive cells; 2^c times the wave speed of a wet cell of class c does not exceed the maximum one.
+ * The speeds are the ones of maxWaveSpeedKernel with the gravity i_g, their doubled bounds are exact.
+ **/
+static void cellClassesKernel(tsunami_lab::t_idx i_nCells,
+                              tsunami_lab::t_real i_g,
+                              tsunami_lab::t_real const *i_h,
+                              tsunami_lab::t_real const *i_huX,
+                              tsunami_lab::t_real const *i_huY,
+                              tsunami_lab::t_real i_speedMax,
+                              tsunami_lab::t_idx i_nLevels,
+                              unsigned char i_dryClass,
+                              tsunami_lab::t_real *o_bounds,
+                              unsigned char *o_classes)
+{
+  tsunami_lab::t_real const l_hDry = std::numeric_limits<tsunami_lab::t_real>::max();
+
+#pragma omp simd
+  for (tsunami_lab::t_idx l_ce = 0; l_ce < i_nCells; l_ce++)
+  {
+    tsunami_lab::t_real l_h = std::abs(i_h[l_ce]);
+    tsunami_lab::t_real l_hDiv = i_h[l_ce] > 0 ? i_h[l_ce] : l_hDry;
+    tsunami_lab::t_real l_hu = std::max(std::abs(i_huX[l_ce]), std::abs(i_huY[l_ce]));
+    o_bounds[l_ce] = l_hu / l_hDiv + std::sqrt(i_g * l_h);
+    o_classes[l_ce] = 0;
+  }
+
+  // the levels are the outer loop, which keeps the inner one vectorizable
+  for (tsunami_lab::t_idx l_le = 0; l_le < i_nLevels; l_le++)
+  {
+#pragma omp simd
+    for (tsunami_lab::t_idx l_ce = 0; l_ce < i_nCells; l_ce++)
+    {
+      o_bounds[l_ce] *= 2;
+      o_classes[l_ce] += o_bounds[l_ce] <= i_speedMax ? 1 : 0;
+    }
+  }
+
+#pragma omp simd
+  for (tsunami_lab::t_idx l_ce = 0; l_ce < i_nCells; l_ce++)
+    o_classes[l_ce] = i_h[l_ce] > 0 ? o_classes[l_ce] : i_dryClass;
+}
+
+/**
+ * Accumulates the scaled net-updates of a batch of edges in their left (or bottom) and right (or top) cells.
+ * The cells of edge i are io_accumulatedL[i] and io_accumulatedR[i], nullptr skips a side; the left cells receive their updates first.
+ **/
+static void accumulateKernel(tsunami_lab::t_idx i_nEdges,
+                             tsunami_lab::t_real i_scaling,
+                             tsunami_lab::t_real const *i_netUpdatesL,
+                             tsunami_lab::t_real const *i_netUpdatesR,
+                             tsunami_lab::t_real *io_accumulatedL,
+                             tsunami_lab::t_real *io_accumulatedR)
+{
+  if (io_accumulatedL != nullptr)
+  {
+#pragma omp simd
+    for (tsunami_lab::t_idx l_ed = 0; l_ed < i_nEdges; l_ed++)
+      io_accumulatedL[l_ed] -= i_scaling * i_netUpdatesL[l_ed];
+  }
+  if (io_accumulatedR != nullptr)
+  {
+#pragma omp simd
+    for (tsunami_lab::t_idx l_ed = 0; l_ed < i_nEdges; l_ed++)
+      io_accumulatedR[l_ed] -= i_scaling * i_netUpdatesR[l_ed];
+  }
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::classifyCells(t_idx i_first,
+                                                                      t_idx i_last)
+{
+  t_real *l_h = m_h[m_step];
+  t_real *l_huX = m_huX[m_step];
+  t_real *l_huY = m_huY[m_step];
+  t_idx l_nClasses = m_timeStepLevels + 1;
+
+  // the classes refer to the fastest wet cell of all blocks
+  t_real l_speedMax = 0;
+  for (t_idx l_ro = i_first; l_ro < i_last; l_ro++)
+    l_speedMax = std::max(l_speedMax, maxWaveSpeed(l_ro * getStride() + 1, m_nCellsX, l_h, l_huX, l_huY));
+#ifdef USEOMP
+#pragma omp critical
+#endif
+  m_classSpeedMax = std::max(m_classSpeedMax, l_speedMax);
+#ifdef USEOMP
+#pragma omp barrier
+#endif
+
+  // the accumulated net-updates of the dry cells are discarded
+  std::vector<t_idx> l_nCells(l_nClasses, 0);
+  std::vector<t_real> l_bounds(m_nCellsX);
+  for (t_idx l_ro = i_first; l_ro < i_last; l_ro++)
+  {
+    t_idx l_ceRow = l_ro * getStride();
+    cellClassesKernel(m_nCellsX,
+                      T_Solver::m_g,
+                      l_h + l_ceRow + 1,
+                      l_huX + l_ceRow + 1,
+                      l_huY + l_ceRow + 1,
+                      m_classSpeedMax,
+                      m_timeStepLevels,
+                      m_dryClass,
+                      l_bounds.data(),
+                      m_cellClasses.data() + l_ceRow + 1);
+    std::fill_n(m_accumulatedHStorage.getData() + l_ceRow, getStride(), t_real(0));
+    std::fill_n(m_accumulatedHuXStorage.getData() + l_ceRow, getStride(), t_real(0));
+    std::fill_n(m_accumulatedHuYStorage.getData() + l_ceRow, getStride(), t_real(0));
+  }
+
+  // the y-edges below the block's first row read the classes of the block below
+#ifdef USEOMP
+#pragma omp barrier
+#endif
+
+  // the edges get the smaller class of their cells, which is the dry class if both are dry
+  std::vector<unsigned char> l_edgeClasses(getStride(), m_dryClass);
+  std::vector<std::vector<t_idx> *> l_runs(l_nClasses);
+  for (t_idx l_ro = i_first; l_ro < i_last; l_ro++)
+  {
+    unsigned char const *l_classes = m_cellClasses.data() + l_ro * getStride();
+    for (t_idx l_cl = 0; l_cl < l_nClasses; l_cl++)
+    {
+      m_classRuns[l_ro * l_nClasses + l_cl].cells.clear();
+      l_runs[l_cl] = &m_classRuns[l_ro * l_nClasses + l_cl].cells;
+    }
+    appendRuns(l_classes, 1, m_nCellsX + 1, m_dryClass, l_runs.data());
+
+    // x-edges right of the cells 1, ..., nx - 1, identified by their right cells
+    for (t_idx l_co = 2; l_co < m_nCellsX + 1; l_co++)
+      l_edgeClasses[l_co] = std::min(l_classes[l_co - 1], l_classes[l_co]);
+    for (t_idx l_cl = 0; l_cl < l_nClasses; l_cl++)
+    {
+      m_classRuns[l_ro * l_nClasses + l_cl].edgesX.clear();
+      l_runs[l_cl] = &m_classRuns[l_ro * l_nClasses + l_cl].edgesX;
+    }
+    appendRuns(l_edgeClasses.data(), 2, m_nCellsX + 1, m_dryClass, l_runs.data());
+
+    for (t_idx l_cl = 0; l_cl < l_nClasses; l_cl++)
+    {
+      std::vector<t_idx> const &l_cells = m_classRuns[l_ro * l_nClasses + l_cl].cells;
+      for (t_idx l_ru = 0; l_ru < l_cells.size(); l_ru += 2)
+        l_nCells[l_cl] += l_cells[l_ru + 1] - l_cells[l_ru];
+    }
+  }
+
+  // the y-edges above the rows of the block, the first block also has the ones of the bottom boundary
+  t_idx l_firstEdges = i_first == 1 && i_last > 1 ? 0 : i_first;
+  for (t_idx l_ro = l_firstEdges; l_ro < i_last; l_ro++)
+  {
+    // the ghost cells of the boundaries are derived from the inner ones
+    unsigned char const *l_bottom = m_cellClasses.data() + (l_ro == 0 ? getStride() : l_ro * getStride());
+    unsigned char const *l_top = m_cellClasses.data() + (l_ro == m_nCellsY ? l_ro * getStride() : (l_ro + 1) * getStride());
+    for (t_idx l_co = 1; l_co < m_nCellsX; l_co++)
+      l_edgeClasses[l_co] = std::min(l_bottom[l_co], l_top[l_co]);
+    for (t_idx l_cl = 0; l_cl < l_nClasses; l_cl++)
+    {
+      m_classRuns[l_ro * l_nClasses + l_cl].edgesY.clear();
+      l_runs[l_cl] = &m_classRuns[l_ro * l_nClasses + l_cl].edgesY;
+    }
+    appendRuns(l_edgeClasses.data(), 1, m_nCellsX, m_dryClass, l_runs.data());
+  }
+
+  // a cell of class c is updated 2^(L - c) times instead of 2^L times
+  t_idx l_nCellUpdates = 0;
+  t_idx l_nCellUpdatesGlobal = 0;
+  for (t_idx l_cl = 0; l_cl < l_nClasses; l_cl++)
+  {
+    l_nCellUpdates += l_nCells[l_cl] << (m_timeStepLevels - l_cl);
+    l_nCellUpdatesGlobal += l_nCells[l_cl] << m_timeStepLevels;
+  }
+#ifdef USEOMP
+#pragma omp critical
+#endif
+  {
+    m_nCellUpdates += l_nCellUpdates;
+    m_nCellUpdatesGlobal += l_nCellUpdatesGlobal;
+  }
+
+  // the micro steps solve the y-edges of neighbouring blocks
+#ifdef USEOMP
+#pragma omp barrier
+#endif
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::accumulateEdgesX(t_idx i_row,
+                                                                         t_idx i_class,
+                                                                         t_real i_scaling)
+{
+  t_real l_netUpdatesLH[m_batchSize];
+  t_real l_netUpdatesLHu[m_batchSize];
+  t_real l_netUpdatesRH[m_batchSize];
+  t_real l_netUpdatesRHu[m_batchSize];
+
+  t_idx l_ceRow = i_row * getStride();
+  std::vector<t_idx> const &l_runs = m_classRuns[i_row * (m_timeStepLevels + 1) + i_class].edgesX;
+  for (t_idx l_ru = 0; l_ru < l_runs.size(); l_ru += 2)
+  {
+    for (t_idx l_co = l_runs[l_ru], l_nEdges = 0; l_co < l_runs[l_ru + 1]; l_co += l_nEdges)
+    {
+      l_nEdges = std::min(l_runs[l_ru + 1] - l_co, m_batchSize);
+      solveEdges(m_h[m_step],
+                 m_huX[m_step],
+                 l_ceRow + l_co - 1,
+                 1,
+                 l_nEdges,
+                 l_netUpdatesLH,
+                 l_netUpdatesLHu,
+                 l_netUpdatesRH,
+                 l_netUpdatesRHu);
+
+      t_idx l_ceL = l_ceRow + l_co - 1;
+      accumulateKernel(l_nEdges, i_scaling, l_netUpdatesLH, l_netUpdatesRH, m_accumulatedHStorage.getData() + l_ceL, m_accumulatedHStorage.getData() + l_ceL + 1);
+      accumulateKernel(l_nEdges, i_scaling, l_netUpdatesLHu, l_netUpdatesRHu, m_accumulatedHuXStorage.getData() + l_ceL, m_accumulatedHuXStorage.getData() + l_ceL + 1);
+    }
+  }
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::solveClassEdgesY(t_idx i_row,
+                                                                         t_idx i_class,
+                                                                         t_real *o_netUpdatesLH,
+                                                                         t_real *o_netUpdatesLHu,
+                                                                         t_real *o_netUpdatesRH,
+                                                                         t_real *o_netUpdatesRHu)
+{
+  std::vector<t_idx> const &l_runs = m_classRuns[i_row * (m_timeStepLevels + 1) + i_class].edgesY;
+  for (t_idx l_ru = 0; l_ru < l_runs.size(); l_ru += 2)
+  {
+    for (t_idx l_co = l_runs[l_ru], l_nEdges = 0; l_co < l_runs[l_ru + 1]; l_co += l_nEdges)
+    {
+      l_nEdges = std::min(l_runs[l_ru + 1] - l_co, m_batchSize);
+      solveEdgesY(i_row,
+                  l_co,
+                  l_nEdges,
+                  m_h[m_step],
+                  m_huY[m_step],
+                  nullptr,
+                  o_netUpdatesLH + l_co,
+                  o_netUpdatesLHu + l_co,
+                  o_netUpdatesRH + l_co,
+                  o_netUpdatesRHu + l_co);
+    }
+  }
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::accumulateEdgesY(t_idx i_row,
+                                                                         t_idx i_class,
+                                                                         t_real i_scaling,
+                                                                         t_real const *i_netUpdatesLH,
+                                                                         t_real const *i_netUpdatesLHu,
+                                                                         t_real const *i_netUpdatesRH,
+                                                                         t_real const *i_netUpdatesRHu)
+{
+  // the ghost rows do not accumulate net-updates
+  bool l_bottom = i_row > 0 && i_netUpdatesLH != nullptr;
+  bool l_top = i_row < m_nCellsY && i_netUpdatesRH != nullptr;
+
+  t_idx l_ceRow = i_row * getStride();
+  std::vector<t_idx> const &l_runs = m_classRuns[i_row * (m_timeStepLevels + 1) + i_class].edgesY;
+  for (t_idx l_ru = 0; l_ru < l_runs.size(); l_ru += 2)
+  {
+    t_idx l_co = l_runs[l_ru];
+    t_idx l_nEdges = l_runs[l_ru + 1] - l_co;
+    t_idx l_ceB = l_ceRow + l_co;
+    t_idx l_ceT = l_ceB + getStride();
+    accumulateKernel(l_nEdges,
+                     i_scaling,
+                     l_bottom ? i_netUpdatesLH + l_co : nullptr,
+                     l_top ? i_netUpdatesRH + l_co : nullptr,
+                     l_bottom ? m_accumulatedHStorage.getData() + l_ceB : nullptr,
+                     l_top ? m_accumulatedHStorage.getData() + l_ceT : nullptr);
+    accumulateKernel(l_nEdges,
+                     i_scaling,
+                     l_bottom ? i_netUpdatesLHu + l_co : nullptr,
+                     l_top ? i_netUpdatesRHu + l_co : nullptr,
+                     l_bottom ? m_accumulatedHuYStorage.getData() + l_ceB : nullptr,
+                     l_top ? m_accumulatedHuYStorage.getData() + l_ceT : nullptr);
+  }
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::applyAccumulatedUpdates(t_idx i_row,
+                                                                                t_idx i_class)
+{
+  t_real *l_h = m_h[m_step];
+  t_real *l_huX = m_huX[m_step];
+  t_real *l_huY = m_huY[m_step];
+  t_real *l_accumulatedH = m_accumulatedHStorage.getData();
+  t_real *l_accumulatedHuX = m_accumulatedHuXStorage.getData();
+  t_real *l_accumulatedHuY = m_accumulatedHuYStorage.getData();
+
+  t_idx l_ceRow = i_row * getStride();
+  std::vector<t_idx> const &l_runs = m_classRuns[i_row * (m_timeStepLevels + 1) + i_class].cells;
+  for (t_idx l_ru = 0; l_ru < l_runs.size(); l_ru += 2)
+  {
+    // cells which ran dry in an earlier local time step are reset, as in the global time steps
+#pragma omp simd
+    for (t_idx l_ce = l_ceRow + l_runs[l_ru]; l_ce < l_ceRow + l_runs[l_ru + 1]; l_ce++)
+    {
+      bool l_wet = l_h[l_ce] > 0;
+      l_h[l_ce] = l_wet ? l_h[l_ce] + l_accumulatedH[l_ce] : 0;
+      l_huX[l_ce] = l_wet ? l_huX[l_ce] + l_accumulatedHuX[l_ce] : 0;
+      l_huY[l_ce] = l_wet ? l_huY[l_ce] + l_accumulatedHuY[l_ce] : 0;
+      l_accumulatedH[l_ce] = 0;
+      l_accumulatedHuX[l_ce] = 0;
+      l_accumulatedHuY[l_ce] = 0;
+    }
+  }
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::timeStepLocalTeam(t_real i_scalingX,
+                                                                          t_real i_scalingY)
+{
+  // one thread prepares the time step, the implicit barrier publishes it
+#ifdef USEOMP
+#pragma omp single
+#endif
+  {
+    prepareCells();
+    balanceRowBlocks(1);
+    t_idx l_nEntries = (m_nCellsY + 2) * (m_timeStepLevels + 1);
+    if (m_classRuns.size() != l_nEntries)
+      m_classRuns.assign(l_nEntries, ClassRuns());
+    // the ghost cells keep the dry class
+    if (m_cellClasses.size() != (m_nCellsY + 2) * getStride())
+      m_cellClasses.assign((m_nCellsY + 2) * getStride(), m_dryClass);
+    m_classSpeedMax = 0;
+    m_nCellUpdates = 0;
+    m_nCellUpdatesGlobal = 0;
+    m_nTilesComputed = m_nTilesX * m_nTilesY;
+    if (m_trackMaxWaveSpeed)
+      m_maxWaveSpeed = 0;
+  }
+
+  t_idx l_first = 0;
+  t_idx l_last = 0;
+  getRowBlock(l_first, l_last);
+  classifyCells(l_first, l_last);
+
+  // net-updates of the y-edges of a row, below the block's first row and above its last row
+  t_real *l_netUpdates = getScratch().updates.data();
+  t_real *l_rowLH = l_netUpdates;
+  t_real *l_rowLHu = l_netUpdates + getStride();
+  t_real *l_rowRH = l_netUpdates + 2 * getStride();
+  t_real *l_rowRHu = l_netUpdates + 3 * getStride();
+  t_real *l_bottomLH = l_netUpdates + 4 * getStride();
+  t_real *l_bottomLHu = l_netUpdates + 5 * getStride();
+  t_real *l_bottomRH = l_netUpdates + 6 * getStride();
+  t_real *l_bottomRHu = l_netUpdates + 7 * getStride();
+  t_real *l_topLH = l_netUpdates + 8 * getStride();
+  t_real *l_topLHu = l_netUpdates + 9 * getStride();
+  t_real *l_topRH = l_netUpdates + 10 * getStride();
+  t_real *l_topRHu = l_netUpdates + 11 * getStride();
+
+  // the micro steps scale the time step by 2^(c - L) in class c, which is exact
+  t_idx l_nMicroSteps = t_idx(1) << m_timeStepLevels;
+  // the block's time sums the micro steps without the waits for the neighbouring blocks
+  double l_busy = 0;
+  for (t_idx l_ms = 0; l_ms < l_nMicroSteps; l_ms++)
+  {
+    t_idx l_lastEdgeClass = trailingZeros(l_ms, m_timeStepLevels);
+    t_idx l_lastCellClass = trailingZeros(l_ms + 1, m_timeStepLevels);
+    double l_begin = wallTime();
+
+    // neighbouring blocks update the rows next to the block in place, thus the edges in between are solved upfront by both blocks
+    for (t_idx l_cl = 0; l_cl <= l_lastEdgeClass && l_first < l_last; l_cl++)
+    {
+      solveClassEdgesY(l_first - 1, l_cl, l_bottomLH, l_bottomLHu, l_bottomRH, l_bottomRHu);
+      solveClassEdgesY(l_last - 1, l_cl, l_topLH, l_topLHu, l_topRH, l_topRHu);
+    }
+    l_busy += wallTime() - l_begin;
+#ifdef USEOMP
+#pragma omp barrier
+#endif
+    l_begin = wallTime();
+
+    // a cell accumulates the net-updates of the edges below, above, left and right of it in this order, independent of the blocks
+    for (t_idx l_ro = l_first; l_ro < l_last; l_ro++)
+    {
+      for (t_idx l_cl = 0; l_cl <= l_lastEdgeClass; l_cl++)
+      {
+        t_real l_scalingY = i_scalingY * t_real(t_idx(1) << l_cl) / t_real(l_nMicroSteps);
+        if (l_ro == l_first)
+          accumulateEdgesY(l_ro - 1, l_cl, l_scalingY, nullptr, nullptr, l_bottomRH, l_bottomRHu);
+        if (l_ro + 1 == l_last)
+        {
+          accumulateEdgesY(l_ro, l_cl, l_scalingY, l_topLH, l_topLHu, nullptr, nullptr);
+        }
+        else
+        {
+          solveClassEdgesY(l_ro, l_cl, l_rowLH, l_rowLHu, l_rowRH, l_rowRHu);
+          accumulateEdgesY(l_ro, l_cl, l_scalingY, l_rowLH, l_rowLHu, l_rowRH, l_rowRHu);
+        }
+      }
+      for (t_idx l_cl = 0; l_cl <= l_lastEdgeClass; l_cl++)
+        accumulateEdgesX(l_ro, l_cl, i_scalingX * t_real(t_idx(1) << l_cl) / t_real(l_nMicroSteps));
+      for (t_idx l_cl = 0; l_cl <= l_lastCellClass; l_cl++)
+        applyAccumulatedUpdates(l_ro, l_cl);
+    }
+    l_busy += wallTime() - l_begin;
+
+    // the next micro step reads the updated rows of the neighbouring blocks
+#ifdef USEOMP
+#pragma omp barrier
+#endif
+  }
+  m_blockBusy[threadNum()] += l_busy;
+  m_stepBusy[threadNum()] = l_busy;
+
+  // the ghost cells are excluded from the maximum wave speed
+  if (m_trackMaxWaveSpeed)
+  {
+    t_real l_maxWaveSpeed = 0;
+    for (t_idx l_ro = l_first; l_ro < l_last; l_ro++)
+      l_maxWaveSpeed = std::max(l_maxWaveSpeed, maxWaveSpeed(l_ro * getStride() + 1, m_nCellsX, m_h[m_step], m_huX[m_step], m_huY[m_step]));
+#ifdef USEOMP
+#pragma omp critical
+#endif
+    m_maxWaveSpeed = std::max(m_maxWaveSpeed, l_maxWaveSpeed);
+#ifdef USEOMP
+#pragma omp barrier
+#endif
+  }
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::updateWetIntervals()
+{
+  t_idx l_nRows = m_nCellsY + 2;
+  t_idx l_nCols = m_nCellsX + 2;
+  t_idx l_stride = getStride();
+
+  // the ghost cells follow the inner cells or the boundary conditions, thus they are never considered dry
+  std::vector<unsigned char> l_dry(l_stride * l_nRows, 0);
+  for (t_idx l_ro = 1; l_ro < m_nCellsY + 1; l_ro++)
+  {
+    for (t_idx l_co = 1; l_co < m_nCellsX + 1; l_co++)
+    {
+      l_dry[l_ro * l_stride + l_co] = m_h[m_step][l_ro * l_stride + l_co] <= 0;
+    }
+  }
+
+  for (unsigned short l_st = 0; l_st < (m_inPlace ? 1 : 2); l_st++)
+  {
+    for (t_idx l_ce = 0; l_ce < l_stride * l_nRows; l_ce++)
+    {
+      if (l_dry[l_ce])
+      {
+        m_h[l_st][l_ce] = 0;
+        m_huX[l_st][l_ce] = 0;
+        m_huY[l_st][l_ce] = 0;
+      }
+    }
+  }
+
+  m_wetIntervals.clear();
+  m_wetIntervalsOffsets.assign(1, 0);
+  for (t_idx l_ro = 0; l_ro < l_nRows; l_ro++)
+  {
+    for (t_idx l_co = 0; l_co < l_nCols; l_co++)
+    {
+      // a column is computed if the cell itself, the one above or the one to the right is wet
+      bool l_wet = !l_dry[l_ro * l_stride + l_co];
+      bool l_wetAbove = l_ro + 1 < l_nRows && !l_dry[(l_ro + 1) * l_stride + l_co];
+      bool l_wetRight = l_co + 1 < l_nCols && !l_dry[l_ro * l_stride + l_co + 1];
+      if (!l_wet && !l_wetAbove && !l_wetRight)
+        continue;
+
+      // short dry gaps are computed as well
+      if (m_wetIntervals.size() > m_wetIntervalsOffsets.back() && l_co < m_wetIntervals.back() + m_minDryGap)
+      {
+        m_wetIntervals.back() = l_co + 1;
+      }
+      else
+      {
+        m_wetIntervals.push_back(l_co);
+        m_wetIntervals.push_back(l_co + 1);
+      }
+    }
+    m_wetIntervalsOffsets.push_back(m_wetIntervals.size());
+  }
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::updateActiveTiles()
+{
+  t_idx l_nTiles = m_nTilesX * m_nTilesY;
+
+  // all tiles are computed if the changes of the last time step are unknown
+  if (m_resetActivity)
+  {
+    std::fill_n(m_tilesActive, l_nTiles, 1);
+    m_nTilesComputed = l_nTiles;
+    m_resetActivity = false;
+    return;
+  }
+
+  // a tile changed if any of its chunks did; the ghost rows are not updated
+  std::fill_n(m_tilesChanged, l_nTiles, 0);
+  for (t_idx l_ro = 1; l_ro < m_nCellsY + 1; l_ro++)
+  {
+    for (t_idx l_tx = 0; l_tx < m_nTilesX; l_tx++)
+    {
+      m_tilesChanged[(l_ro / m_tileSizeY) * m_nTilesX + l_tx] |= m_chunksChanged[l_ro * m_nTilesX + l_tx];
+    }
+  }
+
+  // a tile is computed if it or one of its eight neighbours changed
+  m_nTilesComputed = 0;
+  for (t_idx l_ty = 0; l_ty < m_nTilesY; l_ty++)
+  {
+    for (t_idx l_tx = 0; l_tx < m_nTilesX; l_tx++)
+    {
+      unsigned char l_active = 0;
+      for (t_idx l_ny = (l_ty > 0 ? l_ty - 1 : 0); l_ny < std::min(l_ty + 2, m_nTilesY); l_ny++)
+      {
+        for (t_idx l_nx = (l_tx > 0 ? l_tx - 1 : 0); l_nx < std::min(l_tx + 2, m_nTilesX); l_nx++)
+        {
+          l_active |= m_tilesChanged[l_ny * m_nTilesX + l_nx];
+        }
+      }
+      m_tilesActive[l_ty * m_nTilesX + l_tx] = l_active;
+      m_nTilesComputed += l_active;
+    }
+  }
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::solveEdges(t_real const *i_h,
+                                                                   t_real const *i_hu,
+                                                                   t_idx i_ceL,
+                                                                   t_idx i_offsetR,
+                                                                   t_idx i_nEdges,
+                                                                   t_real *o_netUpdatesLH,
+                                                                   t_real *o_netUpdatesLHu,
+                                                                   t_real *o_netUpdatesRH,
+                                                                   t_real *o_netUpdatesRHu)
+{
+  // edge states of the batch
+  t_real l_hL[m_batchSize];
+  t_real l_hR[m_batchSize];
+  t_real l_huL[m_batchSize];
+  t_real l_huR[m_batchSize];
+  t_real l_bL[m_batchSize];
+  t_real l_bR[m_batchSize];
+
+  // handle reflections
+  loadEdges(i_h,
+            i_hu,
+            i_ceL,
+            i_offsetR,
+            i_nEdges,
+            l_hL,
+            l_hR,
+            l_huL,
+            l_huR,
+            l_bL,
+            l_bR);
+
+  // compute net-updates
+  if (m_linearDepth > 0 && linearEdges(i_nEdges, l_hL, l_hR, l_bL, l_bR))
+    solvers::Linear::netUpdatesBatch(i_nEdges,
+                                     l_hL,
+                                     l_hR,
+                                     l_huL,
+                                     l_huR,
+                                     l_bL,
+                                     l_bR,
+                                     o_netUpdatesLH,
+                                     o_netUpdatesLHu,
+                                     o_netUpdatesRH,
+                                     o_netUpdatesRHu);
+  else
+    T_Solver::netUpdatesBatch(i_nEdges,
+                              l_hL,
+                              l_hR,
+                              l_huL,
+                              l_huR,
+                              l_bL,
+                              l_bR,
+                              o_netUpdatesLH,
+                              o_netUpdatesLHu,
+                              o_netUpdatesRH,
+                              o_netUpdatesRHu);
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::solveEdges(t_real const *i_h,
+                                                                   t_real const *i_hu,
+                                                                   t_idx i_ceL,
+                                                                   t_idx i_offsetR,
+                                                                   t_idx i_nEdges,
+                                                                   t_real const *i_hSqrtL,
+                                                                   t_real const *i_hSqrtR,
+                                                                   t_real const *i_uL,
+                                                                   t_real const *i_uR,
+                                                                   t_real const *i_fluxL,
+                                                                   t_real const *i_fluxR,
+                                                                   t_real *o_netUpdatesLH,
+                                                                   t_real *o_netUpdatesLHu,
+                                                                   t_real *o_netUpdatesRH,
+                                                                   t_real *o_netUpdatesRHu)
+{
+  // edge states and shared quantities of the batch
+  t_real l_hL[m_batchSize];
+  t_real l_hR[m_batchSize];
+  t_real l_huL[m_batchSize];
+  t_real l_huR[m_batchSize];
+  t_real l_bL[m_batchSize];
+  t_real l_bR[m_batchSize];
+  t_real l_hSqrtL[m_batchSize];
+  t_real l_hSqrtR[m_batchSize];
+  t_real l_uL[m_batchSize];
+  t_real l_uR[m_batchSize];
+  t_real l_fluxL[m_batchSize];
+  t_real l_fluxR[m_batchSize];
+
+  // handle reflections
+  loadEdges(i_h,
+            i_hu,
+            i_ceL,
+            i_offsetR,
+            i_nEdges,
+            i_hSqrtL,
+            i_hSqrtR,
+            i_uL,
+            i_uR,
+            i_fluxL,
+            i_fluxR,
+            l_hL,
+            l_hR,
+            l_huL,
+            l_huR,
+            l_bL,
+            l_bR,
+            l_hSqrtL,
+            l_hSqrtR,
+            l_uL,
+            l_uR,
+            l_fluxL,
+            l_fluxR);
+
+  // compute net-updates
+  if (m_linearDepth > 0 && linearEdges(i_nEdges, l_hL, l_hR, l_bL, l_bR))
+    solvers::Linear::netUpdatesBatch(i_nEdges,
+                                     l_hL,
+                                     l_hR,
+                                     l_huL,
+                                     l_huR,
+                                     l_bL,
+                                     l_bR,
+                                     o_netUpdatesLH,
+                                     o_netUpdatesLHu,
+                                     o_netUpdatesRH,
+                                     o_netUpdatesRHu);
+  else
+    T_Solver::netUpdatesBatch(i_nEdges,
+                              l_hL,
+                              l_hR,
+                              l_huL,
+                              l_huR,
+                              l_bL,
+                              l_bR,
+                              l_hSqrtL,
+                              l_hSqrtR,
+                              l_uL,
+                              l_uR,
+                              l_fluxL,
+                              l_fluxR,
+                              o_netUpdatesLH,
+                              o_netUpdatesLHu,
+                              o_netUpdatesRH,
+                              o_netUpdatesRHu);
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::computeRowQuantities(t_idx i_row,
+                                                                             t_idx i_colBegin,
+                                                                             t_idx i_colEnd,
+                                                                             t_real const *i_h,
+                                                                             t_real const *i_huX,
+                                                                             t_real const *i_huY,
+                                                                             RowQuantities const &o_quantities)
+{
+  t_idx l_ceRow = i_row * getStride();
+
+  // the x-edge right of the strip reads the first cell of the next strip
+  t_idx l_colEnd = std::min(i_colEnd + 1, m_nCellsX + 2);
+
+  // the union of the row's intervals, extended by the cells right of them, and the intervals of the row below, whose y-edges read the row
+  t_idx l_in = m_wetIntervalsOffsets[i_row];
+  t_idx l_inBelow = m_wetIntervalsOffsets[i_row - 1];
+  t_idx l_begin = 0;
+  t_idx l_end = 0;
+  for (;;)
+  {
+    // next interval of the two rows by its first column
+    t_idx l_nextBegin = std::numeric_limits<t_idx>::max();
+    t_idx l_nextEnd = l_nextBegin;
+    bool l_nextRow = l_in < m_wetIntervalsOffsets[i_row + 1];
+    bool l_nextBelow = l_inBelow < m_wetIntervalsOffsets[i_row];
+    if (l_nextRow && (!l_nextBelow || m_wetIntervals[l_in] <= m_wetIntervals[l_inBelow]))
+    {
+      l_nextBegin = m_wetIntervals[l_in];
+      l_nextEnd = m_wetIntervals[l_in + 1] + 1;
+      l_in += 2;
+    }
+    else if (l_nextBelow)
+    {
+      l_nextBegin = m_wetIntervals[l_inBelow];
+      l_nextEnd = m_wetIntervals[l_inBelow + 1];
+      l_inBelow += 2;
+    }
+
+    if (l_nextBegin <= l_end)
+    {
+      l_end = std::max(l_end, l_nextEnd);
+      continue;
+    }
+
+    // the part of the finished range inside the strip
+    t_idx l_first = std::max(l_begin, i_colBegin);
+    t_idx l_last = std::min(l_end, l_colEnd);
+    if (l_first < l_last)
+    {
+      RowQuantities l_quantities = o_quantities;
+      l_quantities.hSqrt += l_first;
+      l_quantities.uX += l_first;
+      l_quantities.uY += l_first;
+      l_quantities.fluxX += l_first;
+      l_quantities.fluxY += l_first;
+      cellQuantities(l_last - l_first,
+                     i_h + l_ceRow + l_first,
+                     i_huX + l_ceRow + l_first,
+                     i_huY + l_ceRow + l_first,
+                     l_quantities);
+    }
+
+    if (l_nextBegin >= l_colEnd)
+      break;
+    l_begin = l_nextBegin;
+    l_end = l_nextEnd;
+  }
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::getRowQuantities(Scratch &i_scratch,
+                                                                        RowQuantities o_quantities[2])
+{
+  t_real *l_storage = i_scratch.quantities.data();
+  for (unsigned short l_sl = 0; l_sl < 2; l_sl++)
+  {
+    o_quantities[l_sl].hSqrt = l_storage;
+    o_quantities[l_sl].uX = l_storage + getStride();
+    o_quantities[l_sl].uY = l_storage + 2 * getStride();
+    o_quantities[l_sl].fluxX = l_storage + 3 * getStride();
+    o_quantities[l_sl].fluxY = l_storage + 4 * getStride();
+    l_storage += 5 * getStride();
+  }
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::solveEdgesBelow(t_idx i_row,
+                                                                        t_real const *i_hOld,
+                                                                        t_real const *i_huYOld,
+                                                                        t_real *o_updatesLowerH,
+                                                                        t_real *o_updatesLowerHu,
+                                                                        t_real *o_updatesUpperH,
+                                                                        t_real *o_updatesUpperHu)
+{
+  std::fill_n(o_updatesLowerH, getStride(), t_real(0));
+  std::fill_n(o_updatesLowerHu, getStride(), t_real(0));
+  std::fill_n(o_updatesUpperH, getStride(), t_real(0));
+  std::fill_n(o_updatesUpperHu, getStride(), t_real(0));
+  if (i_row == 0 || i_row > m_nCellsY + 1)
+    return;
+
+  for (t_idx l_co = 1; l_co < m_nCellsX; l_co += m_batchSize)
+  {
+    t_idx l_nEdges = std::min(m_batchSize, m_nCellsX - l_co);
+    solveEdgesY(i_row - 1,
+                l_co,
+                l_nEdges,
+                i_hOld,
+                i_huYOld,
+                nullptr,
+                o_updatesLowerH + l_co,
+                o_updatesLowerHu + l_co,
+                o_updatesUpperH + l_co,
+                o_updatesUpperHu + l_co);
+  }
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::solveEdgesY(t_idx i_row,
+                                                                    t_idx i_col,
+                                                                    t_idx i_nEdges,
+                                                                    t_real const *i_h,
+                                                                    t_real const *i_huY,
+                                                                    RowQuantities const *i_quantities,
+                                                                    t_real *o_netUpdatesLH,
+                                                                    t_real *o_netUpdatesLHu,
+                                                                    t_real *o_netUpdatesRH,
+                                                                    t_real *o_netUpdatesRHu)
+{
+  // the ghost cells of the bottom and top boundaries are derived from the adjacent inner cells
+  if (i_row == 0)
+  {
+    solveBoundaryEdges(m_boundaryB,
+                       i_h,
+                       i_huY,
+                       getStride() + i_col,
+                       i_nEdges,
+                       false,
+                       o_netUpdatesLH,
+                       o_netUpdatesLHu,
+                       o_netUpdatesRH,
+                       o_netUpdatesRHu);
+  }
+  else if (i_row == m_nCellsY)
+  {
+    solveBoundaryEdges(m_boundaryT,
+                       i_h,
+                       i_huY,
+                       m_nCellsY * getStride() + i_col,
+                       i_nEdges,
+                       true,
+                       o_netUpdatesLH,
+                       o_netUpdatesLHu,
+                       o_netUpdatesRH,
+                       o_netUpdatesRHu);
+  }
+  else if (i_quantities != nullptr)
+  {
+    RowQuantities const &l_bottom = i_quantities[i_row % 2];
+    RowQuantities const &l_top = i_quantities[(i_row + 1) % 2];
+    solveEdges(i_h,
+               i_huY,
+               i_row * getStride() + i_col,
+               getStride(),
+               i_nEdges,
+               l_bottom.hSqrt + i_col,
+               l_top.hSqrt + i_col,
+               l_bottom.uY + i_col,
+               l_top.uY + i_col,
+               l_bottom.fluxY + i_col,
+               l_top.fluxY + i_col,
+               o_netUpdatesLH,
+               o_netUpdatesLHu,
+               o_netUpdatesRH,
+               o_netUpdatesRHu);
+  }
+  else
+  {
+    solveEdges(i_h,
+               i_huY,
+               i_row * getStride() + i_col,
+               getStride(),
+               i_nEdges,
+               o_netUpdatesLH,
+               o_netUpdatesLHu,
+               o_netUpdatesRH,
+               o_netUpdatesRHu);
+  }
+}
+
+template <typename T_Solver>
+template <typename T_Boundary>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::solveBoundaryEdges(t_real const *i_h,
+                                                                           t_real const *i_hu,
+                                                                           t_idx i_ce,
+                                                                           t_idx i_nEdges,
+                                                                           bool i_ghostAbove,
+                                                                           t_real *o_netUpdatesLH,
+                                                                           t_real *o_netUpdatesLHu,
+                                                                           t_real *o_netUpdatesRH,
+                                                                           t_real *o_netUpdatesRHu)
+{
+  // use margin for comparison in case of rounding errors
+  t_real const l_margin = 0.00001;
+
+  // edge states of the batch
+  t_real l_hL[m_batchSize];
+  t_real l_hR[m_batchSize];
+  t_real l_huL[m_batchSize];
+  t_real l_huR[m_batchSize];
+  t_real l_bL[m_batchSize];
+  t_real l_bR[m_batchSize];
+
+#pragma omp simd
+  for (t_idx l_ed = 0; l_ed < i_nEdges; l_ed++)
+  {
+    // the ghost cell copies the momentum and the bathymetry of the inner cell
+    t_real l_hInner = i_h[i_ce + l_ed];
+    t_real l_hGhost = T_Boundary::ghostHeight(l_hInner);
+    t_real l_hBottom = i_ghostAbove ? l_hInner : l_hGhost;
+    t_real l_hTop = i_ghostAbove ? l_hGhost : l_hInner;
+    t_real l_hu = i_hu[i_ce + l_ed];
+
+    // a dry top cell reflects the bottom one, otherwise a dry bottom cell reflects the top one
+    bool l_dryR = l_hTop <= l_margin;
+    bool l_dryL = !l_dryR && l_hBottom <= l_margin;
+
+    l_hL[l_ed] = l_dryL ? l_hTop : l_hBottom;
+    l_hR[l_ed] = l_dryR ? l_hBottom : l_hTop;
+    l_huL[l_ed] = l_dryL ? -l_hu : l_hu;
+    l_huR[l_ed] = l_dryR ? -l_hu : l_hu;
+    l_bL[l_ed] = m_b[i_ce + l_ed];
+    l_bR[l_ed] = m_b[i_ce + l_ed];
+  }
+
+  T_Solver::netUpdatesBatch(i_nEdges,
+                            l_hL,
+                            l_hR,
+                            l_huL,
+                            l_huR,
+                            l_bL,
+                            l_bR,
+                            o_netUpdatesLH,
+                            o_netUpdatesLHu,
+                            o_netUpdatesRH,
+                            o_netUpdatesRHu);
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::solveBoundaryEdges(Boundary i_boundary,
+                                                                           t_real const *i_h,
+                                                                           t_real const *i_hu,
+                                                                           t_idx i_ce,
+                                                                           t_idx i_nEdges,
+                                                                           bool i_ghostAbove,
+                                                                           t_real *o_netUpdatesLH,
+                                                                           t_real *o_netUpdatesLHu,
+                                                                           t_real *o_netUpdatesRH,
+                                                                           t_real *o_netUpdatesRHu)
+{
+  if (i_boundary == WALL)
+  {
+    solveBoundaryEdges<boundaries::Wall>(i_h, i_hu, i_ce, i_nEdges, i_ghostAbove, o_netUpdatesLH, o_netUpdatesLHu, o_netUpdatesRH, o_netUpdatesRHu);
+  }
+  else
+  {
+    solveBoundaryEdges<boundaries::Outflow>(i_h, i_hu, i_ce, i_nEdges, i_ghostAbove, o_netUpdatesLH, o_netUpdatesLHu, o_netUpdatesRH, o_netUpdatesRHu);
+  }
+}
+
+/**
+ * Computes the maximum change of the heights and momenta of consecutive cells.
+ **/
+static tsunami_lab::t_real maxChange(tsunami_lab::t_idx i_nCells,
+                                     tsunami_lab::t_real const *i_hOld,
+                                     tsunami_lab::t_real const *i_huXOld,
+                                     tsunami_lab::t_real const *i_huYOld,
+                                     tsunami_lab::t_real const *i_hNew,
+                                     tsunami_lab::t_real const *i_huXNew,
+                                     tsunami_lab::t_real const *i_huYNew)
+{
+  tsunami_lab::t_real l_maxChange = 0;
+
+#pragma omp simd reduction(max : l_maxChange)
+  for (tsunami_lab::t_idx l_ce = 0; l_ce < i_nCells; l_ce++)
+  {
+    tsunami_lab::t_real l_changeH = std::abs(i_hNew[l_ce] - i_hOld[l_ce]);
+    tsunami_lab::t_real l_changeHuX = std::abs(i_huXNew[l_ce] - i_huXOld[l_ce]);
+    tsunami_lab::t_real l_changeHuY = std::abs(i_huYNew[l_ce] - i_huYOld[l_ce]);
+    l_maxChange = std::max(l_maxChange, std::max(l_changeH, std::max(l_changeHuX, l_changeHuY)));
+  }
+  return l_maxChange;
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::updateRow(t_idx i_row,
+                                                                  t_idx i_colBegin,
+                                                                  t_idx i_colEnd,
+                                                                  t_real i_scalingX,
+                                                                  t_real i_scalingY,
+                                                                  t_real const *i_hOld,
+                                                                  t_real const *i_huXOld,
+                                                                  t_real const *i_huYOld,
+                                                                  RowQuantities const *i_quantities,
+                                                                  t_real *io_updatesBottomH,
+                                                                  t_real *io_updatesBottomHu,
+                                                                  t_real const *i_updatesTopH,
+                                                                  t_real const *i_updatesTopHu,
+                                                                  t_real &io_carryH,
+                                                                  t_real &io_carryHu,
+                                                                  t_real *o_hNew,
+                                                                  t_real *o_huXNew,
+                                                                  t_real *o_huYNew,
+                                                                  t_real &io_maxWaveSpeed)
+{
+  // net-updates of the x-edges of a chunk; edge i lies left of the chunk's cell i
+  t_real l_xUpdatesLH[m_batchSize + 1];
+  t_real l_xUpdatesLHu[m_batchSize + 1];
+  t_real l_xUpdatesRH[m_batchSize + 1];
+  t_real l_xUpdatesRHu[m_batchSize + 1];
+
+  // net-updates of the y-edges above the chunk's cells
+  t_real l_yUpdatesLH[m_batchSize];
+  t_real l_yUpdatesLHu[m_batchSize];
+  t_real l_yUpdatesRH[m_batchSize];
+  t_real l_yUpdatesRHu[m_batchSize];
+
+  // old states of the chunk, kept for the change detection of in-place updates
+  t_real l_hKept[m_batchSize];
+  t_real l_huXKept[m_batchSize];
+  t_real l_huYKept[m_batchSize];
+
+  t_idx l_ceRow = i_row * getStride();
+  bool l_trackActivity = m_activityThreshold >= 0;
+
+  // chunks without computed cells do not change
+  if (l_trackActivity)
+  {
+    std::fill(m_chunksChanged + i_row * m_nTilesX + i_colBegin / m_batchSize,
+              m_chunksChanged + i_row * m_nTilesX + (i_colEnd + m_batchSize - 1) / m_batchSize,
+              0);
+  }
+
+  for (t_idx l_in = m_wetIntervalsOffsets[i_row]; l_in < m_wetIntervalsOffsets[i_row + 1]; l_in += 2)
+  {
+    if (m_wetIntervals[l_in] >= i_colEnd)
+      break;
+
+    // the part of the interval inside the strip
+    t_idx l_begin = std::max(m_wetIntervals[l_in], i_colBegin);
+    t_idx l_end = std::min(m_wetIntervals[l_in + 1], i_colEnd);
+    if (l_begin >= l_end)
+      continue;
+
+    // the edge left of an interval is not solved, its right cell is dry or the row's first cell; the one left of a strip was solved by the strip before
+    bool l_continued = m_wetIntervals[l_in] < i_colBegin;
+    l_xUpdatesRH[0] = l_continued ? io_carryH : 0;
+    l_xUpdatesRHu[0] = l_continued ? io_carryHu : 0;
+
+    for (t_idx l_co = l_begin, l_nCells = 0; l_co < l_end; l_co += l_nCells)
+    {
+      // chunks end at multiples of m_batchSize, which are the borders of the tiles
+      l_nCells = std::min((l_co / m_batchSize + 1) * m_batchSize, l_end) - l_co;
+      t_idx l_tile = (i_row / m_tileSizeY) * m_nTilesX + l_co / m_batchSize;
+      unsigned char &l_changed = m_chunksChanged[i_row * m_nTilesX + l_co / m_batchSize];
+
+      if (l_trackActivity && !m_tilesActive[l_tile])
+      {
+        // the states are kept
+        if (!m_inPlace)
+        {
+          std::copy_n(i_hOld + l_ceRow + l_co, l_nCells, o_hNew + l_ceRow + l_co);
+          std::copy_n(i_huXOld + l_ceRow + l_co, l_nCells, o_huXNew + l_ceRow + l_co);
+          std::copy_n(i_huYOld + l_ceRow + l_co, l_nCells, o_huYNew + l_ceRow + l_co);
+        }
+
+        // the x-edge right of the chunk if the chunk right of it is computed
+        t_idx l_ceR = l_co + l_nCells;
+        l_xUpdatesRH[l_nCells] = 0;
+        l_xUpdatesRHu[l_nCells] = 0;
+        if (i_row <= m_nCellsY && l_ceR >= 2 && l_ceR <= m_nCellsX && l_ceR < m_wetIntervals[l_in + 1] && m_tilesActive[l_tile + 1])
+        {
+          solveEdges(i_hOld,
+                     i_huXOld,
+                     l_ceRow + l_ceR - 1,
+                     1,
+                     1,
+                     l_xUpdatesLH + l_nCells,
+                     l_xUpdatesLHu + l_nCells,
+                     l_xUpdatesRH + l_nCells,
+                     l_xUpdatesRHu + l_nCells);
+        }
+
+        // the y-edges above the chunk if the tile above is computed
+        t_idx l_first = std::max(l_co, t_idx(1));
+        t_idx l_last = std::min(l_co + l_nCells, m_nCellsX);
+        bool l_tileAbove = (i_row + 1) % m_tileSizeY == 0 && i_row + 1 < m_nCellsY + 2;
+        if (i_row <= m_nCellsY && l_first < l_last && i_updatesTopH == nullptr && l_tileAbove && m_tilesActive[l_tile + m_nTilesX])
+        {
+          std::fill_n(l_yUpdatesRH, l_nCells, t_real(0));
+          std::fill_n(l_yUpdatesRHu, l_nCells, t_real(0));
+          solveEdgesY(i_row,
+                      l_first,
+                      l_last - l_first,
+                      i_hOld,
+                      i_huYOld,
+                      nullptr,
+                      l_yUpdatesLH + l_first - l_co,
+                      l_yUpdatesLHu + l_first - l_co,
+                      l_yUpdatesRH + l_first - l_co,
+                      l_yUpdatesRHu + l_first - l_co);
+          std::copy_n(l_yUpdatesRH, l_nCells, io_updatesBottomH + l_co);
+          std::copy_n(l_yUpdatesRHu, l_nCells, io_updatesBottomHu + l_co);
+        }
+      }
+      else
+      {
+        std::fill_n(l_xUpdatesLH + 1, l_nCells, t_real(0));
+        std::fill_n(l_xUpdatesLHu + 1, l_nCells, t_real(0));
+        std::fill_n(l_xUpdatesRH + 1, l_nCells, t_real(0));
+        std::fill_n(l_xUpdatesRHu + 1, l_nCells, t_real(0));
+        std::fill_n(l_yUpdatesLH, l_nCells, t_real(0));
+        std::fill_n(l_yUpdatesLHu, l_nCells, t_real(0));
+        std::fill_n(l_yUpdatesRH, l_nCells, t_real(0));
+        std::fill_n(l_yUpdatesRHu, l_nCells, t_real(0));
+
+        // solved are the x-edges between the columns 1, ..., nx and the y-edges between the rows 0, ..., ny + 1 in the columns 1, ..., nx - 1
+        if (i_row <= m_nCellsY)
+        {
+          // x-edges right of the chunk's cells, identified by their right cells 2, ..., nx
+          t_idx l_first = std::max(l_co + 1, t_idx(2));
+          t_idx l_last = std::min(l_co + l_nCells + 1, m_nCellsX + 1);
+          if (l_first < l_last && i_quantities != nullptr)
+          {
+            RowQuantities const &l_row = i_quantities[i_row % 2];
+            solveEdges(i_hOld,
+                       i_huXOld,
+                       l_ceRow + l_first - 1,
+                       1,
+                       l_last - l_first,
+                       l_row.hSqrt + l_first - 1,
+                       l_row.hSqrt + l_first,
+                       l_row.uX + l_first - 1,
+                       l_row.uX + l_first,
+                       l_row.fluxX + l_first - 1,
+                       l_row.fluxX + l_first,
+                       l_xUpdatesLH + l_first - l_co,
+                       l_xUpdatesLHu + l_first - l_co,
+                       l_xUpdatesRH + l_first - l_co,
+                       l_xUpdatesRHu + l_first - l_co);
+          }
+          else if (l_first < l_last)
+          {
+            solveEdges(i_hOld,
+                       i_huXOld,
+                       l_ceRow + l_first - 1,
+                       1,
+                       l_last - l_first,
+                       l_xUpdatesLH + l_first - l_co,
+                       l_xUpdatesLHu + l_first - l_co,
+                       l_xUpdatesRH + l_first - l_co,
+                       l_xUpdatesRHu + l_first - l_co);
+          }
+
+          // y-edges above the cells 1, ..., nx - 1
+          l_first = std::max(l_co, t_idx(1));
+          l_last = std::min(l_co + l_nCells, m_nCellsX);
+          if (l_first < l_last && i_updatesTopH == nullptr)
+          {
+            solveEdgesY(i_row,
+                        l_first,
+                        l_last - l_first,
+                        i_hOld,
+                        i_huYOld,
+                        i_quantities,
+                        l_yUpdatesLH + l_first - l_co,
+                        l_yUpdatesLHu + l_first - l_co,
+                        l_yUpdatesRH + l_first - l_co,
+                        l_yUpdatesRHu + l_first - l_co);
+          }
+        }
+
+        // in-place updates overwrite the old states
+        t_real const *l_hPrev = i_hOld + l_ceRow + l_co;
+        t_real const *l_huXPrev = i_huXOld + l_ceRow + l_co;
+        t_real const *l_huYPrev = i_huYOld + l_ceRow + l_co;
+        if (l_trackActivity && m_inPlace)
+        {
+          std::copy_n(l_hPrev, l_nCells, l_hKept);
+          std::copy_n(l_huXPrev, l_nCells, l_huXKept);
+          std::copy_n(l_huYPrev, l_nCells, l_huYKept);
+          l_hPrev = l_hKept;
+          l_huXPrev = l_huXKept;
+          l_huYPrev = l_huYKept;
+        }
+
+        updateCells(l_ceRow + l_co,
+                    l_nCells,
+                    i_scalingX,
+                    i_scalingY,
+                    i_hOld,
+                    i_huXOld,
+                    i_huYOld,
+                    l_xUpdatesRH,
+                    l_xUpdatesRHu,
+                    l_xUpdatesLH + 1,
+                    l_xUpdatesLHu + 1,
+                    io_updatesBottomH + l_co,
+                    io_updatesBottomHu + l_co,
+                    i_updatesTopH != nullptr ? i_updatesTopH + l_co : l_yUpdatesLH,
+                    i_updatesTopHu != nullptr ? i_updatesTopHu + l_co : l_yUpdatesLHu,
+                    o_hNew,
+                    o_huXNew,
+                    o_huYNew);
+
+        if (l_trackActivity)
+        {
+          l_changed |= maxChange(l_nCells,
+                                 l_hPrev,
+                                 l_huXPrev,
+                                 l_huYPrev,
+                                 o_hNew + l_ceRow + l_co,
+                                 o_huXNew + l_ceRow + l_co,
+                                 o_huYNew + l_ceRow + l_co) > m_activityThreshold;
+        }
+
+        // the cells of the next row receive the updates of the top cells
+        std::copy_n(l_yUpdatesRH, l_nCells, io_updatesBottomH + l_co);
+        std::copy_n(l_yUpdatesRHu, l_nCells, io_updatesBottomHu + l_co);
+      }
+
+      // the ghost cells are excluded from the maximum wave speed
+      if (m_trackMaxWaveSpeed && i_row >= 1 && i_row <= m_nCellsY)
+      {
+        t_idx l_first = std::max(l_co, t_idx(1));
+        t_idx l_last = std::min(l_co + l_nCells, m_nCellsX + 1);
+        if (l_first < l_last)
+        {
+          io_maxWaveSpeed = std::max(io_maxWaveSpeed,
+                                     maxWaveSpeed(l_ceRow + l_first,
+                                                  l_last - l_first,
+                                                  o_hNew,
+                                                  o_huXNew,
+                                                  o_huYNew));
+        }
+      }
+
+      // the edge right of the chunk's last cell lies left of the next chunk
+      l_xUpdatesRH[0] = l_xUpdatesRH[l_nCells];
+      l_xUpdatesRHu[0] = l_xUpdatesRHu[l_nCells];
+    }
+
+    // the edge right of the strip lies left of the next strip
+    io_carryH = l_xUpdatesRH[0];
+    io_carryHu = l_xUpdatesRHu[0];
+  }
+}
+
+/**
+ * Gets the bathymetry of a cell stored as float.
+ **/
+static TSUNAMI_LAB_INLINE tsunami_lab::t_real bathymetry(tsunami_lab::t_real i_b,
+                                                         tsunami_lab::t_real,
+                                                         tsunami_lab::t_real)
+{
+  return i_b;
+}
+
+/**
+ * Gets the bathymetry of a cell stored as quantized 16-bit integer.
+ * The scale is a power of two, the product is exact and the result does not depend on contracted multiply-adds.
+ **/
+static TSUNAMI_LAB_INLINE tsunami_lab::t_real bathymetry(std::int16_t i_b,
+                                                         tsunami_lab::t_real i_scale,
+                                                         tsunami_lab::t_real i_offset)
+{
+  return i_offset + i_scale * tsunami_lab::t_real(i_b);
+}
+
+/**
+ * Loads the states of a batch of edges and applies the reflection effect.
+ * The loop is compiled for every instruction set by the variants below.
+ **/
+template <typename T_Bathymetry>
+static TSUNAMI_LAB_INLINE void loadEdgesKernel(tsunami_lab::t_real const *i_hL,
+                                               tsunami_lab::t_real const *i_huL,
+                                               T_Bathymetry const *i_bL,
+                                               tsunami_lab::t_real i_bScale,
+                                               tsunami_lab::t_real i_bOffset,
+                                               tsunami_lab::t_idx i_offsetR,
+                                               tsunami_lab::t_idx i_nEdges,
+                                               tsunami_lab::t_real *o_hL,
+                                               tsunami_lab::t_real *o_hR,
+                                               tsunami_lab::t_real *o_huL,
+                                               tsunami_lab::t_real *o_huR,
+                                               tsunami_lab::t_real *o_bL,
+                                               tsunami_lab::t_real *o_bR)
+{
+  // use margin for comparison in case of rounding errors
+  tsunami_lab::t_real const l_margin = 0.00001;
+
+  tsunami_lab::t_real const *l_hR = i_hL + i_offsetR;
+  tsunami_lab::t_real const *l_huR = i_huL + i_offsetR;
+  T_Bathymetry const *l_bR = i_bL + i_offsetR;
+
+#pragma omp simd
+  for (tsunami_lab::t_idx l_ed = 0; l_ed < i_nEdges; l_ed++)
+  {
+    // a dry right cell reflects the left one, otherwise a dry left cell reflects the right one
+    bool l_dryR = l_hR[l_ed] <= l_margin;
+    bool l_dryL = !l_dryR && i_hL[l_ed] <= l_margin;
+
+    o_hL[l_ed] = l_dryL ? l_hR[l_ed] : i_hL[l_ed];
+    o_hR[l_ed] = l_dryR ? i_hL[l_ed] : l_hR[l_ed];
+    o_huL[l_ed] = l_dryL ? -l_huR[l_ed] : i_huL[l_ed];
+    o_huR[l_ed] = l_dryR ? -i_huL[l_ed] : l_huR[l_ed];
+    tsunami_lab::t_real l_bL = bathymetry(i_bL[l_ed], i_bScale, i_bOffset);
+    tsunami_lab::t_real l_bRight = bathymetry(l_bR[l_ed], i_bScale, i_bOffset);
+    o_bL[l_ed] = l_dryL ? l_bRight : l_bL;
+    o_bR[l_ed] = l_dryR ? l_bL : l_bRight;
+  }
+}
+
+/**
+ * Loads the states and the shared cell quantities of a batch of edges and applies the reflection effect.
+ * A reflected side takes the square root and the flux of the other side and its negated velocity, (-hu) / h = -(hu / h) holds exactly.
+ * The loop is compiled for every instruction set by the variants below.
+ **/
+template <typename T_Bathymetry>
+static TSUNAMI_LAB_INLINE void loadEdgesKernel(tsunami_lab::t_real const *i_hL,
+                                               tsunami_lab::t_real const *i_huL,
+                                               T_Bathymetry const *i_bL,
+                                               tsunami_lab::t_real i_bScale,
+                                               tsunami_lab::t_real i_bOffset,
+                                               tsunami_lab::t_idx i_offsetR,
+                                               tsunami_lab::t_idx i_nEdges,
+                                               tsunami_lab::t_real const *i_hSqrtL,
+                                               tsunami_lab::t_real const *i_hSqrtR,
+                                               tsunami_lab::t_real const *i_uL,
+                                               tsunami_lab::t_real const *i_uR,
+                                               tsunami_lab::t_real const *i_fluxL,
+                                               tsunami_lab::t_real const *i_fluxR,
+                                               tsunami_lab::t_real *o_hL,
+                                               tsunami_lab::t_real *o_hR,
+                                               tsunami_lab::t_real *o_huL,
+                                               tsunami_lab::t_real *o_huR,
+                                               tsunami_lab::t_real *o_bL,
+                                               tsunami_lab::t_real *o_bR,
+                                               tsunami_lab::t_real *o_hSqrtL,
+                                               tsunami_lab::t_real *o_hSqrtR,
+                                               tsunami_lab::t_real *o_uL,
+                                               tsunami_lab::t_real *o_uR,
+                                               tsunami_lab::t_real *o_fluxL,
+                                               tsunami_lab::t_real *o_fluxR)
+{
+  // use margin for comparison in case of rounding errors
+  tsunami_lab::t_real const l_margin = 0.00001;
+
+  tsunami_lab::t_real const *l_hR = i_hL + i_offsetR;
+  tsunami_lab::t_real const *l_huR = i_huL + i_offsetR;
+  T_Bathymetry const *l_bR = i_bL + i_offsetR;
+
+#pragma omp simd
+  for (tsunami_lab::t_idx l_ed = 0; l_ed < i_nEdges; l_ed++)
+  {
+    // a dry right cell reflects the left one, otherwise a dry left cell reflects the right one
+    bool l_dryR = l_hR[l_ed] <= l_margin;
+    bool l_dryL = !l_dryR && i_hL[l_ed] <= l_margin;
+
+    o_hL[l_ed] = l_dryL ? l_hR[l_ed] : i_hL[l_ed];
+    o_hR[l_ed] = l_dryR ? i_hL[l_ed] : l_hR[l_ed];
+    o_huL[l_ed] = l_dryL ? -l_huR[l_ed] : i_huL[l_ed];
+    o_huR[l_ed] = l_dryR ? -i_huL[l_ed] : l_huR[l_ed];
+    tsunami_lab::t_real l_bL = bathymetry(i_bL[l_ed], i_bScale, i_bOffset);
+    tsunami_lab::t_real l_bRight = bathymetry(l_bR[l_ed], i_bScale, i_bOffset);
+    o_bL[l_ed] = l_dryL ? l_bRight : l_bL;
+    o_bR[l_ed] = l_dryR ? l_bL : l_bRight;
+    o_hSqrtL[l_ed] = l_dryL ? i_hSqrtR[l_ed] : i_hSqrtL[l_ed];
+    o_hSqrtR[l_ed] = l_dryR ? i_hSqrtL[l_ed] : i_hSqrtR[l_ed];
+    o_uL[l_ed] = l_dryL ? -i_uR[l_ed] : i_uL[l_ed];
+    o_uR[l_ed] = l_dryR ? -i_uL[l_ed] : i_uR[l_ed];
+    o_fluxL[l_ed] = l_dryL ? i_fluxR[l_ed] : i_fluxL[l_ed];
+    o_fluxR[l_ed] = l_dryR ? i_fluxL[l_ed] : i_fluxR[l_ed];
+  }
+}
+
+/**
+ * Computes the shared quantities of consecutive cells.
+ * The operations match the ones of the solvers, which keeps the net-updates bitwise identical.
+ * The loop is compiled for every instruction set by the variants below.
+ **/
+static TSUNAMI_LAB_INLINE void cellQuantitiesKernel(tsunami_lab::t_idx i_nCells,
+                                                    tsunami_lab::t_real const *i_h,
+                                                    tsunami_lab::t_real const *i_huX,
+                                                    tsunami_lab::t_real const *i_huY,
+                                                    tsunami_lab::t_real *o_hSqrt,
+                                                    tsunami_lab::t_real *o_uX,
+                                                    tsunami_lab::t_real *o_uY,
+                                                    tsunami_lab::t_real *o_fluxX,
+                                                    tsunami_lab::t_real *o_fluxY)
+{
+  tsunami_lab::t_real const l_gHalf = 4.903325;
+
+#pragma omp simd
+  for (tsunami_lab::t_idx l_ce = 0; l_ce < i_nCells; l_ce++)
+  {
+    // dry cells divide by one and have no velocity; a select after the divisions would turn them into branches, thus the mask is multiplied
+    // (the sign of a dry cell's zero velocity never matters: the edges reflect dry sides or have no net-updates)
+    tsunami_lab::t_real l_h = i_h[l_ce];
+    bool l_wet = l_h != 0;
+    tsunami_lab::t_real l_hDiv = l_wet ? l_h : 1;
+    tsunami_lab::t_real l_wetMask = l_wet ? 1 : 0;
+    tsunami_lab::t_real l_uX = i_huX[l_ce] / l_hDiv * l_wetMask;
+    tsunami_lab::t_real l_uY = i_huY[l_ce] / l_hDiv * l_wetMask;
+    tsunami_lab::t_real l_pressure = l_gHalf * l_h * l_h;
+
+    o_hSqrt[l_ce] = std::sqrt(l_h);
+    o_uX[l_ce] = l_uX;
+    o_uY[l_ce] = l_uY;
+    o_fluxX[l_ce] = i_huX[l_ce] * l_uX + l_pressure;
+    o_fluxY[l_ce] = i_huY[l_ce] * l_uY + l_pressure;
+  }
+}
+
+/**
+ * Writes the new states of consecutive cells.
+ * The loop is compiled for every instruction set by the variants below.
+ **/
+static TSUNAMI_LAB_INLINE void updateCellsKernel(tsunami_lab::t_idx i_nCells,
+                                                 tsunami_lab::t_real i_scalingX,
+                                                 tsunami_lab::t_real i_scalingY,
+                                                 tsunami_lab::t_real const *i_hOld,
+                                                 tsunami_lab::t_real const *i_huXOld,
+                                                 tsunami_lab::t_real const *i_huYOld,
+                                                 tsunami_lab::t_real const *i_xLeftH,
+                                                 tsunami_lab::t_real const *i_xLeftHu,
+                                                 tsunami_lab::t_real const *i_xRightH,
+                                                 tsunami_lab::t_real const *i_xRightHu,
+                                                 tsunami_lab::t_real const *i_yBottomH,
+                                                 tsunami_lab::t_real const *i_yBottomHu,
+                                                 tsunami_lab::t_real const *i_yTopH,
+                                                 tsunami_lab::t_real const *i_yTopHu,
+                                                 tsunami_lab::t_real *o_hNew,
+                                                 tsunami_lab::t_real *o_huXNew,
+                                                 tsunami_lab::t_real *o_huYNew)
+{
+#pragma omp simd
+  for (tsunami_lab::t_idx l_ce = 0; l_ce < i_nCells; l_ce++)
+  {
+    // dry cells are reset; selecting the operands keeps the loop free of branches
+    bool l_wet = i_hOld[l_ce] > 0;
+    o_hNew[l_ce] = (l_wet ? i_hOld[l_ce] : 0) - i_scalingX * (l_wet ? i_xLeftH[l_ce] : 0) - i_scalingX * (l_wet ? i_xRightH[l_ce] : 0) - i_scalingY * (l_wet ? i_yBottomH[l_ce] : 0) - i_scalingY * (l_wet ? i_yTopH[l_ce] : 0);
+    o_huXNew[l_ce] = (l_wet ? i_huXOld[l_ce] : 0) - i_scalingX * (l_wet ? i_xLeftHu[l_ce] : 0) - i_scalingX * (l_wet ? i_xRightHu[l_ce] : 0);
+    o_huYNew[l_ce] = (l_wet ? i_huYOld[l_ce] : 0) - i_scalingY * (l_wet ? i_yBottomHu[l_ce] : 0) - i_scalingY * (l_wet ? i_yTopHu[l_ce] : 0);
+  }
+}
+
+/**
+ * Computes the maximum wave speed of consecutive cells with the gravity i_g of the solver.
+ * The loop is compiled for every instruction set by the variants below.
+ **/
+static TSUNAMI_LAB_INLINE tsunami_lab::t_real maxWaveSpeedKernel(tsunami_lab::t_idx i_nCells,
+                                                                 tsunami_lab::t_real i_g,
+                                                                 tsunami_lab::t_real const *i_h,
+                                                                 tsunami_lab::t_real const *i_huX,
+                                                                 tsunami_lab::t_real const *i_huY)
+{
+  tsunami_lab::t_real const l_hDry = std::numeric_limits<tsunami_lab::t_real>::max();
+  tsunami_lab::t_real l_maxSpeed = 0;
+
+  // the selects only pick loaded values and no operation depends on them being taken,
+  // which keeps the loop free of conditional sqrts and vectorizable without -fno-trapping-math
+#pragma omp simd reduction(max : l_maxSpeed)
+  for (tsunami_lab::t_idx l_ce = 0; l_ce < i_nCells; l_ce++)
+  {
+    // dry cells divide the momentum by a huge height, i.e., they have no velocity
+    tsunami_lab::t_real l_h = std::abs(i_h[l_ce]);
+    tsunami_lab::t_real l_hDiv = i_h[l_ce] > 0 ? i_h[l_ce] : l_hDry;
+    tsunami_lab::t_real l_hu = std::max(std::abs(i_huX[l_ce]), std::abs(i_huY[l_ce]));
+    tsunami_lab::t_real l_speed = l_hu / l_hDiv + std::sqrt(i_g * l_h);
+    l_maxSpeed = std::max(l_maxSpeed, l_speed);
+  }
+  return l_maxSpeed;
+}
+
+/**
+ * Checks whether all edges of a batch lie in deep water with small amplitudes.
+ * The loop is compiled for every instruction set by the variants below.
+ **/
+static TSUNAMI_LAB_INLINE bool linearEdgesKernel(tsunami_lab::t_idx i_nEdges,
+                                                 tsunami_lab::t_real const *i_hL,
+                                                 tsunami_lab::t_real const *i_hR,
+                                                 tsunami_lab::t_real const *i_bL,
+                                                 tsunami_lab::t_real const *i_bR,
+                                                 tsunami_lab::t_real i_minDepth,
+                                                 tsunami_lab::t_real i_maxAmplitudeRatio)
+{
+  // the largest violation of the criteria is reduced over the whole batch, which keeps the loop free of branches and early exits
+  tsunami_lab::t_real l_violation = 0;
+#pragma omp simd reduction(max : l_violation)
+  for (tsunami_lab::t_idx l_ed = 0; l_ed < i_nEdges; l_ed++)
+  {
+    tsunami_lab::t_real l_depthL = -i_bL[l_ed];
+    tsunami_lab::t_real l_depthR = -i_bR[l_ed];
+    tsunami_lab::t_real l_shallow = i_minDepth - std::min(l_depthL, l_depthR);
+    tsunami_lab::t_real l_largeL = std::abs(i_hL[l_ed] - l_depthL) - i_maxAmplitudeRatio * l_depthL;
+    tsunami_lab::t_real l_largeR = std::abs(i_hR[l_ed] - l_depthR) - i_maxAmplitudeRatio * l_depthR;
+    l_violation = std::max(l_violation, std::max(l_shallow, std::max(l_largeL, l_largeR)));
+  }
+  return l_violation <= 0;
+}
+
+#ifdef TSUNAMI_LAB_ISA_X86
+template <typename T_Bathymetry>
+TSUNAMI_LAB_TARGET_AVX2 static void loadEdgesAvx2(tsunami_lab::t_real const *i_hL,
+                                                  tsunami_lab::t_real const *i_huL,
+                                                  T_Bathymetry const *i_bL,
+                                                  tsunami_lab::t_real i_bScale,
+                                                  tsunami_lab::t_real i_bOffset,
+                                                  tsunami_lab::t_idx i_offsetR,
+                                                  tsunami_lab::t_idx i_nEdges,
+                                                  tsunami_lab::t_real *o_hL,
+                                                  tsunami_lab::t_real *o_hR,
+                                                  tsunami_lab::t_real *o_huL,
+                                                  tsunami_lab::t_real *o_huR,
+                                                  tsunami_lab::t_real *o_bL,
+                                                  tsunami_lab::t_real *o_bR)
+{
+  loadEdgesKernel(i_hL, i_huL, i_bL, i_bScale, i_bOffset, i_offsetR, i_nEdges, o_hL, o_hR, o_huL, o_huR, o_bL, o_bR);
+}
+
+template <typename T_Bathymetry>
+TSUNAMI_LAB_TARGET_AVX512 static void loadEdgesAvx512(tsunami_lab::t_real const *i_hL,
+                                                      tsunami_lab::t_real const *i_huL,
+                                                      T_Bathymetry const *i_bL,
+                                                      tsunami_lab::t_real i_bScale,
+                                                      tsunami_lab::t_real i_bOffset,
+                                                      tsunami_lab::t_idx i_offsetR,
+                                                      tsunami_lab::t_idx i_nEdges,
+                                                      tsunami_lab::t_real *o_hL,
+                                                      tsunami_lab::t_real *o_hR,
+                                                      tsunami_lab::t_real *o_huL,
+                                                      tsunami_lab::t_real *o_huR,
+                                                      tsunami_lab::t_real *o_bL,
+                                                      tsunami_lab::t_real *o_bR)
+{
+  loadEdgesKernel(i_hL, i_huL, i_bL, i_bScale, i_bOffset, i_offsetR, i_nEdges, o_hL, o_hR, o_huL, o_huR, o_bL, o_bR);
+}
+
+template <typename T_Bathymetry>
+TSUNAMI_LAB_TARGET_AVX2 static void loadEdgesAvx2(tsunami_lab::t_real const *i_hL,
+                                                  tsunami_lab::t_real const *i_huL,
+                                                  T_Bathymetry const *i_bL,
+                                                  tsunami_lab::t_real i_bScale,
+                                                  tsunami_lab::t_real i_bOffset,
+                                                  tsunami_lab::t_idx i_offsetR,
+                                                  tsunami_lab::t_idx i_nEdges,
+                                                  tsunami_lab::t_real const *i_hSqrtL,
+                                                  tsunami_lab::t_real const *i_hSqrtR,
+                                                  tsunami_lab::t_real const *i_uL,
+                                                  tsunami_lab::t_real const *i_uR,
+                                                  tsunami_lab::t_real const *i_fluxL,
+                                                  tsunami_lab::t_real const *i_fluxR,
+                                                  tsunami_lab::t_real *o_hL,
+                                                  tsunami_lab::t_real *o_hR,
+                                                  tsunami_lab::t_real *o_huL,
+                                                  tsunami_lab::t_real *o_huR,
+                                                  tsunami_lab::t_real *o_bL,
+                                                  tsunami_lab::t_real *o_bR,
+                                                  tsunami_lab::t_real *o_hSqrtL,
+                                                  tsunami_lab::t_real *o_hSqrtR,
+                                                  tsunami_lab::t_real *o_uL,
+                                                  tsunami_lab::t_real *o_uR,
+                                                  tsunami_lab::t_real *o_fluxL,
+                                                  tsunami_lab::t_real *o_fluxR)
+{
+  loadEdgesKernel(i_hL, i_huL, i_bL, i_bScale, i_bOffset, i_offsetR, i_nEdges, i_hSqrtL, i_hSqrtR, i_uL, i_uR, i_fluxL, i_fluxR, o_hL, o_hR, o_huL, o_huR, o_bL, o_bR, o_hSqrtL, o_hSqrtR, o_uL, o_uR, o_fluxL, o_fluxR);
+}
+
+template <typename T_Bathymetry>
+TSUNAMI_LAB_TARGET_AVX512 static void loadEdgesAvx512(tsunami_lab::t_real const *i_hL,
+                                                      tsunami_lab::t_real const *i_huL,
+                                                      T_Bathymetry const *i_bL,
+                                                      tsunami_lab::t_real i_bScale,
+                                                      tsunami_lab::t_real i_bOffset,
+                                                      tsunami_lab::t_idx i_offsetR,
+                                                      tsunami_lab::t_idx i_nEdges,
+                                                      tsunami_lab::t_real const *i_hSqrtL,
+                                                      tsunami_lab::t_real const *i_hSqrtR,
+                                                      tsunami_lab::t_real const *i_uL,
+                                                      tsunami_lab::t_real const *i_uR,
+                                                      tsunami_lab::t_real const *i_fluxL,
+                                                      tsunami_lab::t_real const *i_fluxR,
+                                                      tsunami_lab::t_real *o_hL,
+                                                      tsunami_lab::t_real *o_hR,
+                                                      tsunami_lab::t_real *o_huL,
+                                                      tsunami_lab::t_real *o_huR,
+                                                      tsunami_lab::t_real *o_bL,
+                                                      tsunami_lab::t_real *o_bR,
+                                                      tsunami_lab::t_real *o_hSqrtL,
+                                                      tsunami_lab::t_real *o_hSqrtR,
+                                                      tsunami_lab::t_real *o_uL,
+                                                      tsunami_lab::t_real *o_uR,
+                                                      tsunami_lab::t_real *o_fluxL,
+                                                      tsunami_lab::t_real *o_fluxR)
+{
+  loadEdgesKernel(i_hL, i_huL, i_bL, i_bScale, i_bOffset, i_offsetR, i_nEdges, i_hSqrtL, i_hSqrtR, i_uL, i_uR, i_fluxL, i_fluxR, o_hL, o_hR, o_huL, o_huR, o_bL, o_bR, o_hSqrtL, o_hSqrtR, o_uL, o_uR, o_fluxL, o_fluxR);
+}
+
+TSUNAMI_LAB_TARGET_AVX2 static void cellQuantitiesAvx2(tsunami_lab::t_idx i_nCells,
+                                                       tsunami_lab::t_real const *i_h,
+                                                       tsunami_lab::t_real const *i_huX,
+                                                       tsunami_lab::t_real const *i_huY,
+                                                       tsunami_lab::t_real *o_hSqrt,
+                                                       tsunami_lab::t_real *o_uX,
+                                                       tsunami_lab::t_real *o_uY,
+                                                       tsunami_lab::t_real *o_fluxX,
+                                                       tsunami_lab::t_real *o_fluxY)
+{
+  cellQuantitiesKernel(i_nCells, i_h, i_huX, i_huY, o_hSqrt, o_uX, o_uY, o_fluxX, o_fluxY);
+}
+
+TSUNAMI_LAB_TARGET_AVX512 static void cellQuantitiesAvx512(tsunami_lab::t_idx i_nCells,
+                                                           tsunami_lab::t_real const *i_h,
+                                                           tsunami_lab::t_real const *i_huX,
+                                                           tsunami_lab::t_real const *i_huY,
+                                                           tsunami_lab::t_real *o_hSqrt,
+                                                           tsunami_lab::t_real *o_uX,
+                                                           tsunami_lab::t_real *o_uY,
+                                                           tsunami_lab::t_real *o_fluxX,
+                                                           tsunami_lab::t_real *o_fluxY)
+{
+  cellQuantitiesKernel(i_nCells, i_h, i_huX, i_huY, o_hSqrt, o_uX, o_uY, o_fluxX, o_fluxY);
+}
+
+TSUNAMI_LAB_TARGET_AVX2 static void updateCellsAvx2(tsunami_lab::t_idx i_nCells,
+                                                    tsunami_lab::t_real i_scalingX,
+                                                    tsunami_lab::t_real i_scalingY,
+                                                    tsunami_lab::t_real const *i_hOld,
+                                                    tsunami_lab::t_real const *i_huXOld,
+                                                    tsunami_lab::t_real const *i_huYOld,
+                                                    tsunami_lab::t_real const *i_xLeftH,
+                                                    tsunami_lab::t_real const *i_xLeftHu,
+                                                    tsunami_lab::t_real const *i_xRightH,
+                                                    tsunami_lab::t_real const *i_xRightHu,
+                                                    tsunami_lab::t_real const *i_yBottomH,
+                                                    tsunami_lab::t_real const *i_yBottomHu,
+                                                    tsunami_lab::t_real const *i_yTopH,
+                                                    tsunami_lab::t_real const *i_yTopHu,
+                                                    tsunami_lab::t_real *o_hNew,
+                                                    tsunami_lab::t_real *o_huXNew,
+                                                    tsunami_lab::t_real *o_huYNew)
+{
+  updateCellsKernel(i_nCells, i_scalingX, i_scalingY, i_hOld, i_huXOld, i_huYOld, i_xLeftH, i_xLeftHu, i_xRightH, i_xRightHu, i_yBottomH, i_yBottomHu, i_yTopH, i_yTopHu, o_hNew, o_huXNew, o_huYNew);
+}
+
+TSUNAMI_LAB_TARGET_AVX512 static void updateCellsAvx512(tsunami_lab::t_idx i_nCells,
+                                                        tsunami_lab::t_real i_scalingX,
+                                                        tsunami_lab::t_real i_scalingY,
+                                                        tsunami_lab::t_real const *i_hOld,
+                                                        tsunami_lab::t_real const *i_huXOld,
+                                                        tsunami_lab::t_real const *i_huYOld,
+                                                        tsunami_lab::t_real const *i_xLeftH,
+                                                        tsunami_lab::t_real const *i_xLeftHu,
+                                                        tsunami_lab::t_real const *i_xRightH,
+                                                        tsunami_lab::t_real const *i_xRightHu,
+                                                        tsunami_lab::t_real const *i_yBottomH,
+                                                        tsunami_lab::t_real const *i_yBottomHu,
+                                                        tsunami_lab::t_real const *i_yTopH,
+                                                        tsunami_lab::t_real const *i_yTopHu,
+                                                        tsunami_lab::t_real *o_hNew,
+                                                        tsunami_lab::t_real *o_huXNew,
+                                                        tsunami_lab::t_real *o_huYNew)
+{
+  updateCellsKernel(i_nCells, i_scalingX, i_scalingY, i_hOld, i_huXOld, i_huYOld, i_xLeftH, i_xLeftHu, i_xRightH, i_xRightHu, i_yBottomH, i_yBottomHu, i_yTopH, i_yTopHu, o_hNew, o_huXNew, o_huYNew);
+}
+
+TSUNAMI_LAB_TARGET_AVX2 static tsunami_lab::t_real maxWaveSpeedAvx2(tsunami_lab::t_idx i_nCells,
+                                                                    tsunami_lab::t_real i_g,
+                                                                    tsunami_lab::t_real const *i_h,
+                                                                    tsunami_lab::t_real const *i_huX,
+                                                                    tsunami_lab::t_real const *i_huY)
+{
+  return maxWaveSpeedKernel(i_nCells, i_g, i_h, i_huX, i_huY);
+}
+
+TSUNAMI_LAB_TARGET_AVX512 static tsunami_lab::t_real maxWaveSpeedAvx512(tsunami_lab::t_idx i_nCells,
+                                                                        tsunami_lab::t_real i_g,
+                                                                        tsunami_lab::t_real const *i_h,
+                                                                        tsunami_lab::t_real const *i_huX,
+                                                                        tsunami_lab::t_real const *i_huY)
+{
+  return maxWaveSpeedKernel(i_nCells, i_g, i_h, i_huX, i_huY);
+}
+#endif
+
+#ifdef TSUNAMI_LAB_ISA_X86
+TSUNAMI_LAB_TARGET_AVX2 static bool linearEdgesAvx2(tsunami_lab::t_idx i_nEdges,
+                                                    tsunami_lab::t_real const *i_hL,
+                                                    tsunami_lab::t_real const *i_hR,
+                                                    tsunami_lab::t_real const *i_bL,
+                                                    tsunami_lab::t_real const *i_bR,
+                                                    tsunami_lab::t_real i_minDepth,
+                                                    tsunami_lab::t_real i_maxAmplitudeRatio)
+{
+  return linearEdgesKernel(i_nEdges, i_hL, i_hR, i_bL, i_bR, i_minDepth, i_maxAmplitudeRatio);
+}
+
+TSUNAMI_LAB_TARGET_AVX512 static bool linearEdgesAvx512(tsunami_lab::t_idx i_nEdges,
+                                                        tsunami_lab::t_real const *i_hL,
+                                                        tsunami_lab::t_real const *i_hR,
+                                                        tsunami_lab::t_real const *i_bL,
+                                                        tsunami_lab::t_real const *i_bR,
+                                                        tsunami_lab::t_real i_minDepth,
+                                                        tsunami_lab::t_real i_maxAmplitudeRatio)
+{
+  return linearEdgesKernel(i_nEdges, i_hL, i_hR, i_bL, i_bR, i_minDepth, i_maxAmplitudeRatio);
+}
+#endif
+
+/**
+ * Loads the states of a batch of edges with the variant matching systeminfo::Isa::active(); the portable loop covers SSE2, which is part of every x86-64 CPU.
+ **/
+template <typename T_Bathymetry>
+static void loadEdgesVariant(tsunami_lab::t_real const *i_h,
+                             tsunami_lab::t_real const *i_hu,
+                             T_Bathymetry const *i_b,
+                             tsunami_lab::t_real i_bScale,
+                             tsunami_lab::t_real i_bOffset,
+                             tsunami_lab::t_idx i_offsetR,
+                             tsunami_lab::t_idx i_nEdges,
+                             tsunami_lab::t_real *o_hL,
+                             tsunami_lab::t_real *o_hR,
+                             tsunami_lab::t_real *o_huL,
+                             tsunami_lab::t_real *o_huR,
+                             tsunami_lab::t_real *o_bL,
+                             tsunami_lab::t_real *o_bR)
+{
+#ifdef TSUNAMI_LAB_ISA_X86
+  switch (tsunami_lab::systeminfo::Isa::active())
+  {
+  case tsunami_lab::systeminfo::Isa::AVX512:
+    loadEdgesAvx512(i_h, i_hu, i_b, i_bScale, i_bOffset, i_offsetR, i_nEdges, o_hL, o_hR, o_huL, o_huR, o_bL, o_bR);
+    return;
+  case tsunami_lab::systeminfo::Isa::AVX2:
+    loadEdgesAvx2(i_h, i_hu, i_b, i_bScale, i_bOffset, i_offsetR, i_nEdges, o_hL, o_hR, o_huL, o_huR, o_bL, o_bR);
+    return;
+  default:
+    break;
+  }
+#endif
+  loadEdgesKernel(i_h, i_hu, i_b, i_bScale, i_bOffset, i_offsetR, i_nEdges, o_hL, o_hR, o_huL, o_huR, o_bL, o_bR);
+}
+
+/**
+ * Loads the states and the shared cell quantities of a batch of edges with the variant matching systeminfo::Isa::active().
+ **/
+template <typename T_Bathymetry>
+static void loadEdgesVariant(tsunami_lab::t_real const *i_h,
+                             tsunami_lab::t_real const *i_hu,
+                             T_Bathymetry const *i_b,
+                             tsunami_lab::t_real i_bScale,
+                             tsunami_lab::t_real i_bOffset,
+                             tsunami_lab::t_idx i_offsetR,
+                             tsunami_lab::t_idx i_nEdges,
+                             tsunami_lab::t_real const *i_hSqrtL,
+                             tsunami_lab::t_real const *i_hSqrtR,
+                             tsunami_lab::t_real const *i_uL,
+                             tsunami_lab::t_real const *i_uR,
+                             tsunami_lab::t_real const *i_fluxL,
+                             tsunami_lab::t_real const *i_fluxR,
+                             tsunami_lab::t_real *o_hL,
+                             tsunami_lab::t_real *o_hR,
+                             tsunami_lab::t_real *o_huL,
+                             tsunami_lab::t_real *o_huR,
+                             tsunami_lab::t_real *o_bL,
+                             tsunami_lab::t_real *o_bR,
+                             tsunami_lab::t_real *o_hSqrtL,
+                             tsunami_lab::t_real *o_hSqrtR,
+                             tsunami_lab::t_real *o_uL,
+                             tsunami_lab::t_real *o_uR,
+                             tsunami_lab::t_real *o_fluxL,
+                             tsunami_lab::t_real *o_fluxR)
+{
+#ifdef TSUNAMI_LAB_ISA_X86
+  switch (tsunami_lab::systeminfo::Isa::active())
+  {
+  case tsunami_lab::systeminfo::Isa::AVX512:
+    loadEdgesAvx512(i_h, i_hu, i_b, i_bScale, i_bOffset, i_offsetR, i_nEdges, i_hSqrtL, i_hSqrtR, i_uL, i_uR, i_fluxL, i_fluxR, o_hL, o_hR, o_huL, o_huR, o_bL, o_bR, o_hSqrtL, o_hSqrtR, o_uL, o_uR, o_fluxL, o_fluxR);
+    return;
+  case tsunami_lab::systeminfo::Isa::AVX2:
+    loadEdgesAvx2(i_h, i_hu, i_b, i_bScale, i_bOffset, i_offsetR, i_nEdges, i_hSqrtL, i_hSqrtR, i_uL, i_uR, i_fluxL, i_fluxR, o_hL, o_hR, o_huL, o_huR, o_bL, o_bR, o_hSqrtL, o_hSqrtR, o_uL, o_uR, o_fluxL, o_fluxR);
+    return;
+  default:
+    break;
+  }
+#endif
+  loadEdgesKernel(i_h, i_hu, i_b, i_bScale, i_bOffset, i_offsetR, i_nEdges, i_hSqrtL, i_hSqrtR, i_uL, i_uR, i_fluxL, i_fluxR, o_hL, o_hR, o_huL, o_huR, o_bL, o_bR, o_hSqrtL, o_hSqrtR, o_uL, o_uR, o_fluxL, o_fluxR);
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::loadEdges(t_real const *i_h,
+                                                                  t_real const *i_hu,
+                                                                  t_idx i_ceL,
+                                                                  t_idx i_offsetR,
+                                                                  t_idx i_nEdges,
+                                                                  t_real *o_hL,
+                                                                  t_real *o_hR,
+                                                                  t_real *o_huL,
+                                                                  t_real *o_huR,
+                                                                  t_real *o_bL,
+                                                                  t_real *o_bR)
+{
+  // the quantized bathymetry halves the memory traffic of the bathymetry
+  if (m_quantizeBathymetry)
+    loadEdgesVariant(i_h + i_ceL, i_hu + i_ceL, m_bQuantized.data() + i_ceL, m_bScale, m_bOffset, i_offsetR, i_nEdges, o_hL, o_hR, o_huL, o_huR, o_bL, o_bR);
+  else
+    loadEdgesVariant(i_h + i_ceL, i_hu + i_ceL, m_b + i_ceL, t_real(1), t_real(0), i_offsetR, i_nEdges, o_hL, o_hR, o_huL, o_huR, o_bL, o_bR);
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::loadEdges(t_real const *i_h,
+                                                                  t_real const *i_hu,
+                                                                  t_idx i_ceL,
+                                                                  t_idx i_offsetR,
+                                                                  t_idx i_nEdges,
+                                                                  t_real const *i_hSqrtL,
+                                                                  t_real const *i_hSqrtR,
+                                                                  t_real const *i_uL,
+                                                                  t_real const *i_uR,
+                                                                  t_real const *i_fluxL,
+                                                                  t_real const *i_fluxR,
+                                                                  t_real *o_hL,
+                                                                  t_real *o_hR,
+                                                                  t_real *o_huL,
+                                                                  t_real *o_huR,
+                                                                  t_real *o_bL,
+                                                                  t_real *o_bR,
+                                                                  t_real *o_hSqrtL,
+                                                                  t_real *o_hSqrtR,
+                                                                  t_real *o_uL,
+                                                                  t_real *o_uR,
+                                                                  t_real *o_fluxL,
+                                                                  t_real *o_fluxR)
+{
+  if (m_quantizeBathymetry)
+    loadEdgesVariant(i_h + i_ceL, i_hu + i_ceL, m_bQuantized.data() + i_ceL, m_bScale, m_bOffset, i_offsetR, i_nEdges, i_hSqrtL, i_hSqrtR, i_uL, i_uR, i_fluxL, i_fluxR, o_hL, o_hR, o_huL, o_huR, o_bL, o_bR, o_hSqrtL, o_hSqrtR, o_uL, o_uR, o_fluxL, o_fluxR);
+  else
+    loadEdgesVariant(i_h + i_ceL, i_hu + i_ceL, m_b + i_ceL, t_real(1), t_real(0), i_offsetR, i_nEdges, i_hSqrtL, i_hSqrtR, i_uL, i_uR, i_fluxL, i_fluxR, o_hL, o_hR, o_huL, o_huR, o_bL, o_bR, o_hSqrtL, o_hSqrtR, o_uL, o_uR, o_fluxL, o_fluxR);
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::cellQuantities(t_idx i_nCells,
+                                                                       t_real const *i_h,
+                                                                       t_real const *i_huX,
+                                                                       t_real const *i_huY,
+                                                                       RowQuantities const &o_quantities)
+{
+#ifdef TSUNAMI_LAB_ISA_X86
+  switch (systeminfo::Isa::active())
+  {
+  case systeminfo::Isa::AVX512:
+    cellQuantitiesAvx512(i_nCells, i_h, i_huX, i_huY, o_quantities.hSqrt, o_quantities.uX, o_quantities.uY, o_quantities.fluxX, o_quantities.fluxY);
+    return;
+  case systeminfo::Isa::AVX2:
+    cellQuantitiesAvx2(i_nCells, i_h, i_huX, i_huY, o_quantities.hSqrt, o_quantities.uX, o_quantities.uY, o_quantities.fluxX, o_quantities.fluxY);
+    return;
+  default:
+    break;
+  }
+#endif
+  cellQuantitiesKernel(i_nCells, i_h, i_huX, i_huY, o_quantities.hSqrt, o_quantities.uX, o_quantities.uY, o_quantities.fluxX, o_quantities.fluxY);
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::updateCells(t_idx i_ce,
+                                                                    t_idx i_nCells,
+                                                                    t_real i_scalingX,
+                                                                    t_real i_scalingY,
+                                                                    t_real const *i_hOld,
+                                                                    t_real const *i_huXOld,
+                                                                    t_real const *i_huYOld,
+                                                                    t_real const *i_xLeftH,
+                                                                    t_real const *i_xLeftHu,
+                                                                    t_real const *i_xRightH,
+                                                                    t_real const *i_xRightHu,
+                                                                    t_real const *i_yBottomH,
+                                                                    t_real const *i_yBottomHu,
+                                                                    t_real const *i_yTopH,
+                                                                    t_real const *i_yTopHu,
+                                                                    t_real *o_hNew,
+                                                                    t_real *o_huXNew,
+                                                                    t_real *o_huYNew)
+{
+#ifdef TSUNAMI_LAB_ISA_X86
+  switch (systeminfo::Isa::active())
+  {
+  case systeminfo::Isa::AVX512:
+    updateCellsAvx512(i_nCells, i_scalingX, i_scalingY, i_hOld + i_ce, i_huXOld + i_ce, i_huYOld + i_ce, i_xLeftH, i_xLeftHu, i_xRightH, i_xRightHu, i_yBottomH, i_yBottomHu, i_yTopH, i_yTopHu, o_hNew + i_ce, o_huXNew + i_ce, o_huYNew + i_ce);
+    return;
+  case systeminfo::Isa::AVX2:
+    updateCellsAvx2(i_nCells, i_scalingX, i_scalingY, i_hOld + i_ce, i_huXOld + i_ce, i_huYOld + i_ce, i_xLeftH, i_xLeftHu, i_xRightH, i_xRightHu, i_yBottomH, i_yBottomHu, i_yTopH, i_yTopHu, o_hNew + i_ce, o_huXNew + i_ce, o_huYNew + i_ce);
+    return;
+  default:
+    break;
+  }
+#endif
+  updateCellsKernel(i_nCells, i_scalingX, i_scalingY, i_hOld + i_ce, i_huXOld + i_ce, i_huYOld + i_ce, i_xLeftH, i_xLeftHu, i_xRightH, i_xRightHu, i_yBottomH, i_yBottomHu, i_yTopH, i_yTopHu, o_hNew + i_ce, o_huXNew + i_ce, o_huYNew + i_ce);
+}
+
+template <typename T_Solver>
+tsunami_lab::t_real tsunami_lab::patches::WavePropagation2d<T_Solver>::maxWaveSpeed(t_idx i_ce,
+                                                                                    t_idx i_nCells,
+                                                                                    t_real const *i_h,
+                                                                                    t_real const *i_huX,
+                                                                                    t_real const *i_huY)
+{
+#ifdef TSUNAMI_LAB_ISA_X86
+  switch (systeminfo::Isa::active())
+  {
+  case systeminfo::Isa::AVX512:
+    return maxWaveSpeedAvx512(i_nCells, T_Solver::m_g, i_h + i_ce, i_huX + i_ce, i_huY + i_ce);
+  case systeminfo::Isa::AVX2:
+    return maxWaveSpeedAvx2(i_nCells, T_Solver::m_g, i_h + i_ce, i_huX + i_ce, i_huY + i_ce);
+  default:
+    break;
+  }
+#endif
+  return maxWaveSpeedKernel(i_nCells, T_Solver::m_g, i_h + i_ce, i_huX + i_ce, i_huY + i_ce);
+}
+
+template <typename T_Solver>
+tsunami_lab::t_real tsunami_lab::patches::WavePropagation2d<T_Solver>::computeMaxWaveSpeed(t_idx i_ix,
+                                                                                           t_idx i_iy,
+                                                                                           t_idx i_nx,
+                                                                                           t_idx i_ny)
+{
+  t_real l_maxSpeed = 0;
+#ifdef USEOMP
+#pragma omp parallel for reduction(max : l_maxSpeed)
+#endif
+  for (t_idx l_ro = i_iy + 1; l_ro < i_iy + i_ny + 1; l_ro++)
+    l_maxSpeed = std::max(l_maxSpeed, maxWaveSpeed(l_ro * getStride() + i_ix + 1, i_nx, m_h[m_step], m_huX[m_step], m_huY[m_step]));
+  return l_maxSpeed;
+}
+
+template <typename T_Solver>
+bool tsunami_lab::patches::WavePropagation2d<T_Solver>::linearEdges(t_idx i_nEdges,
+                                                                    t_real const *i_hL,
+                                                                    t_real const *i_hR,
+                                                                    t_real const *i_bL,
+                                                                    t_real const *i_bR) const
+{
+#ifdef TSUNAMI_LAB_ISA_X86
+  switch (systeminfo::Isa::active())
+  {
+  case systeminfo::Isa::AVX512:
+    return linearEdgesAvx512(i_nEdges, i_hL, i_hR, i_bL, i_bR, m_linearDepth, m_linearAmplitudeRatio);
+  case systeminfo::Isa::AVX2:
+    return linearEdgesAvx2(i_nEdges, i_hL, i_hR, i_bL, i_bR, m_linearDepth, m_linearAmplitudeRatio);
+  default:
+    break;
+  }
+#endif
+  return linearEdgesKernel(i_nEdges, i_hL, i_hR, i_bL, i_bR, m_linearDepth, m_linearAmplitudeRatio);
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::setGhostBathymetry()
+{
+  t_idx l_stride = getStride();
+
+  // left and right columns
+  for (t_idx l_ro = 1; l_ro < m_nCellsY + 1; l_ro++)
+  {
+    m_b[l_ro * l_stride] = m_b[l_ro * l_stride + 1];
+    m_b[l_ro * l_stride + m_nCellsX + 1] = m_b[l_ro * l_stride + m_nCellsX];
+  }
+
+  // bottom and top rows including the corners
+  std::copy_n(m_b + l_stride, l_stride, m_b);
+  std::copy_n(m_b + m_nCellsY * l_stride, l_stride, m_b + (m_nCellsY + 1) * l_stride);
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::quantizeBathymetry()
+{
+  t_idx l_stride = getStride();
+  t_idx l_nCells = l_stride * (m_nCellsY + 2);
+
+  // range of the bathymetry including the ghost cells, the padding of the rows is skipped
+  t_real l_min = std::numeric_limits<t_real>::max();
+  t_real l_max = std::numeric_limits<t_real>::lowest();
+  for (t_idx l_ro = 0; l_ro < m_nCellsY + 2; l_ro++)
+  {
+    for (t_idx l_co = 0; l_co < m_nCellsX + 2; l_co++)
+    {
+      l_min = std::min(l_min, m_b[l_ro * l_stride + l_co]);
+      l_max = std::max(l_max, m_b[l_ro * l_stride + l_co]);
+    }
+  }
+
+  // power of two which maps the range to the levels -32767, ..., 32767, leaving room for an offset at a multiple of the scale;
+  // quantizing quantized values again keeps them
+  int l_exponent = 0;
+  std::frexp((l_max - l_min) / 65532, &l_exponent);
+  m_bScale = l_max > l_min ? std::ldexp(t_real(1), l_exponent) : t_real(1);
+  m_bOffset = std::round((l_min + (l_max - l_min) / 2) / m_bScale) * m_bScale;
+
+  m_bQuantized.assign(l_nCells, 0);
+  for (t_idx l_ro = 0; l_ro < m_nCellsY + 2; l_ro++)
+  {
+    for (t_idx l_co = 0; l_co < m_nCellsX + 2; l_co++)
+    {
+      t_idx l_ce = l_ro * l_stride + l_co;
+      t_real l_level = std::round((m_b[l_ce] - m_bOffset) / m_bScale);
+      std::int16_t l_quantized = std::int16_t(std::max(t_real(-32767), std::min(l_level, t_real(32767))));
+      t_real l_b = m_bOffset + m_bScale * t_real(l_quantized);
+
+      // the surface of the water is kept, the ghost cells follow the inner ones in the time steps
+      bool l_inner = l_ro >= 1 && l_ro <= m_nCellsY && l_co >= 1 && l_co <= m_nCellsX;
+      if (l_inner && m_h[m_step][l_ce] > 0)
+        m_h[m_step][l_ce] = std::max(m_h[m_step][l_ce] + m_b[l_ce] - l_b, t_real(0));
+
+      m_bQuantized[l_ce] = l_quantized;
+      m_b[l_ce] = l_b;
+    }
+  }
+}
+
+template <typename T_Solver>
+void tsunami_lab::patches::WavePropagation2d<T_Solver>::adjustWaterHeight()
+{
+#ifdef USEOMP
+#pragma omp parallel for
+#endif
+  for (t_idx l_iy = 1; l_iy < m_nCellsY + 1; l_iy++)
   {
     for (t_idx l_ix = 1; l_ix < m_nCellsX + 1; l_ix++)
     {
@@ -320,4 +2951,37 @@ void tsunami_lab::patches::WavePropagation2d::adjustWaterHeight()
         m_h[m_step][l_ix + l_iy * getStride()] = 0;
     }
   }
+  m_cellsSet = true;
 }
+
+tsunami_lab::patches::WavePropagation *tsunami_lab::patches::createWavePropagation2d(t_idx i_nCellsX,
+                                                                                     t_idx i_nCellsY,
+                                                                                     std::string const &i_solver,
+                                                                                     WavePropagation::Boundary i_boundaryL,
+                                                                                     WavePropagation::Boundary i_boundaryR,
+                                                                                     WavePropagation::Boundary i_boundaryT,
+                                                                                     WavePropagation::Boundary i_boundaryB,
+                                                                                     bool i_inPlace)
+{
+  if (i_solver == "roe")
+  {
+    return new WavePropagation2d<solvers::Roe>(i_nCellsX,
+                                               i_nCellsY,
+                                               i_boundaryL,
+                                               i_boundaryR,
+                                               i_boundaryT,
+                                               i_boundaryB,
+                                               i_inPlace);
+  }
+  return new WavePropagation2d<solvers::Fwave>(i_nCellsX,
+                                               i_nCellsY,
+                                               i_boundaryL,
+                                               i_boundaryR,
+                                               i_boundaryT,
+                                               i_boundaryB,
+                                               i_inPlace);
+}
+
+// instantiations for all solvers
+template class tsunami_lab::patches::WavePropagation2d<tsunami_lab::solvers::Roe>;
+template class tsunami_lab::patches::WavePropagation2d<tsunami_lab::solvers::Fwave>;
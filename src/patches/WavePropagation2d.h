@@ -9,15 +9,50 @@
 #define TSUNAMI_LAB_PATCHES_WAVE_PROPAGATION_2D
 
 #include "WavePropagation.h"
+#include "Field2d.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 namespace tsunami_lab
 {
   namespace patches
   {
+    template <typename T_Solver>
     class WavePropagation2d;
+
+    /**
+     * Constructs the 2d wave propagation patch instantiated for the given solver.
+     *
+     * @param i_nCellsX number of cells in x direction.
+     * @param i_nCellsY number of cells in y direction.
+     * @param i_solver selected solver (roe or fwave).
+     * @param i_boundaryL boundary condition on the left side.
+     * @param i_boundaryR boundary condition on the right side.
+     * @param i_boundaryT boundary condition on the top side.
+     * @param i_boundaryB boundary condition on the bottom side.
+     * @param i_inPlace true to update the cells in place.
+     * @return patch; the caller takes ownership.
+     **/
+    WavePropagation *createWavePropagation2d(t_idx i_nCellsX,
+                                             t_idx i_nCellsY,
+                                             std::string const &i_solver,
+                                             WavePropagation::Boundary i_boundaryL,
+                                             WavePropagation::Boundary i_boundaryR,
+                                             WavePropagation::Boundary i_boundaryT,
+                                             WavePropagation::Boundary i_boundaryB,
+                                             bool i_inPlace);
   }
 }
 
+/**
+ * Two-dimensional wave propagation patch.
+ *
+ * @tparam T_Solver Riemann solver providing netUpdatesBatch (solvers::Roe or solvers::Fwave).
+ **/
+template <typename T_Solver>
 class tsunami_lab::patches::WavePropagation2d : public WavePropagation
 {
 private:
@@ -29,6 +64,15 @@ private:
 
   t_idx m_nCellsY = 0;
 
+  //! number of cells from one row to the next, including the padding of the rows
+  t_idx m_stride = 0;
+
+  //! storage of the arrays below; in-place updates use the first ones only
+  Field2d m_hStorage[2];
+  Field2d m_huXStorage[2];
+  Field2d m_huYStorage[2];
+  Field2d m_bStorage;
+
   //! water heights for the current and next time step for all cells
   t_real *m_h[2] = {nullptr, nullptr};
 
@@ -41,6 +85,15 @@ private:
   //! bathymetry 
   t_real *m_b = nullptr;
 
+  //! true if the time steps compute the maximum wave speed
+  bool m_trackMaxWaveSpeed = false;
+
+  //! maximum wave speed after the last time step which computed it
+  t_real m_maxWaveSpeed = 0;
+
+  //! true if the new states overwrite the old ones in a single buffer
+  bool m_inPlace = false;
+
   //! boundary condition on the left side
   Boundary m_boundaryL = OUTFLOW;
 
@@ -53,30 +106,816 @@ private:
   //! boundary condition on the bottom side
   Boundary m_boundaryB = OUTFLOW;
 
- /**
-  * Compute the reflection effect
-  * 
-  * @param i_h water height
-  * @param i_hu water momentum
-  * @param i_ceL left cell
-  * @param i_ceR right cell
-  * @param o_hL water height on the left side
-  * @param o_hR water height on the right side
-  * @param o_huL water momentum on the left side
-  * @param o_huR water momentum on the right side
-  * @param o_bL bathymetry on the left side 
-  * @param o_bR bathymetry on the right side
-  */
-  void handleReflections(t_real *i_h,
-                         t_real *i_hu,
-                         t_idx i_ceL,
-                         t_idx i_ceR,
-                         t_real &o_hL,
-                         t_real &o_hR,
-                         t_real &o_huL,
-                         t_real &o_huR,
-                         t_real &o_bL,
-                         t_real &o_bR);
+  //! number of cells which are updated per chunk of a row; the edges of a chunk are solved by single batch calls of the solver
+  static t_idx constexpr m_batchSize = 256;
+
+  //! number of columns of the strips in which the rows are swept, a multiple of m_batchSize; 0 sweeps whole rows
+  t_idx m_stripWidth = 0;
+
+  //! true if the sweeps precompute the cell quantities once per row, see RowQuantities
+  bool m_shareCellQuantities = false;
+
+  //! true if the sweeps read the bathymetry from m_bQuantized, see quantizeBathymetry
+  bool m_quantizeBathymetry = false;
+
+  //! bathymetry of all cells as 16-bit integers; m_b holds the dequantized values
+  std::vector<std::int16_t> m_bQuantized;
+
+  //! scale of the quantized bathymetry, a power of two
+  t_real m_bScale = 1;
+
+  //! offset of the quantized bathymetry
+  t_real m_bOffset = 0;
+
+  //! minimum still water depth of the edges which are solved by the linearized solver; 0 solves all edges with T_Solver
+  t_real m_linearDepth = 0;
+
+  //! maximum ratio of the surface elevation to the still water depth of the edges which are solved by the linearized solver
+  t_real m_linearAmplitudeRatio = 0;
+
+  //! number of time steps which a tile advances at once; its halo in y-direction has as many rows
+  t_idx m_ghostWidth = 1;
+
+  //! targeted size in bytes of the cells which a tile and its halo keep in the cache over the blocked time steps
+  static t_idx constexpr m_blockingCacheSize = 1 << 20;
+
+  //! number of rows of a tile; a tile spans one chunk in x-direction
+  static t_idx constexpr m_tileSizeY = 8;
+
+  //! threshold of the active-region tracking; negative values compute all tiles
+  t_real m_activityThreshold = -1;
+
+  //! true if the activity of the tiles is unknown, e.g., after cells were set
+  bool m_resetActivity = true;
+
+  //! true if cells were set since the last time step
+  bool m_cellsSet = true;
+
+  //! smallest number of dry cells which separates two intervals of a row
+  static t_idx constexpr m_minDryGap = 16;
+
+  //! columns [begin, end) of the computed intervals of all rows; the cells outside are dry in all time steps
+  std::vector<t_idx> m_wetIntervals;
+
+  //! offsets of the rows' intervals in m_wetIntervals; row i uses the entries offsets[i], ..., offsets[i + 1] - 1
+  std::vector<t_idx> m_wetIntervalsOffsets;
+
+  //! number of tiles in x-direction
+  t_idx m_nTilesX = 0;
+
+  //! number of tiles in y-direction
+  t_idx m_nTilesY = 0;
+
+  //! number of tiles computed in the last time step
+  t_idx m_nTilesComputed = 0;
+
+  //! flags of the tiles computed in the current time step
+  unsigned char *m_tilesActive = nullptr;
+
+  //! flags of the tiles which changed in the last time step
+  unsigned char *m_tilesChanged = nullptr;
+
+  //! flags of the chunks of every row which changed in the last time step
+  unsigned char *m_chunksChanged = nullptr;
+
+  //! number of rows of the tiles which are scheduled as tasks; 0 assigns a block of rows to every thread
+  t_idx m_taskRows = 0;
+
+  //! seconds which the threads spent in tasks and in the tasked time steps in total
+  std::vector<double> m_taskBusy;
+  std::vector<double> m_taskTotal;
+
+  //! number of time steps between the rebalancings of the threads' blocks of rows; 0 splits the rows evenly
+  t_idx m_balanceSteps = 0;
+
+  //! number of time steps since the last rebalancing
+  t_idx m_stepsSinceBalance = 0;
+
+  //! cost of a row which has no computed cells, in computed cells
+  static t_idx constexpr m_rowCostOverhead = 16;
+
+  //! first rows of the threads' blocks followed by the row after the last block; empty if the rows are split evenly
+  std::vector<t_idx> m_rowBlocks;
+
+  //! corrections of the modelled costs of the inner rows by the measured times of their blocks, 1 if not measured
+  std::vector<double> m_rowCostFactors;
+
+  //! seconds which the threads spent updating their blocks since the last rebalancing and in the last time step
+  std::vector<double> m_blockBusy;
+  std::vector<double> m_stepBusy;
+
+  //! number of levels L of the local time stepping; a time step consists of 2^L micro steps, a cell of class c advances 2^c of them at once
+  t_idx m_timeStepLevels = 0;
+
+  //! largest supported number of levels of the local time stepping
+  static t_idx constexpr m_maxTimeStepLevels = 8;
+
+  //! class of the dry cells, which are not updated
+  static unsigned char constexpr m_dryClass = 255;
+
+  //! classes of the cells in the current time step
+  std::vector<unsigned char> m_cellClasses;
+
+  //! net-updates which the cells accumulate until the end of their local time steps
+  Field2d m_accumulatedHStorage;
+  Field2d m_accumulatedHuXStorage;
+  Field2d m_accumulatedHuYStorage;
+
+  //! columns [begin, end) of the edges and cells of a row which belong to one class
+  struct ClassRuns
+  {
+    //! x-edges, identified by their right cells
+    std::vector<t_idx> edgesX;
+
+    //! y-edges above the row
+    std::vector<t_idx> edgesY;
+
+    //! wet inner cells
+    std::vector<t_idx> cells;
+  };
+
+  //! runs of all rows and classes; row i and class c use the entry i * (L + 1) + c
+  std::vector<ClassRuns> m_classRuns;
+
+  //! maximum wave speed of the wet cells at the beginning of the current time step, which the classes refer to
+  t_real m_classSpeedMax = 0;
+
+  //! number of cell updates in the last time step with local time steps and with the micro step for all cells
+  t_idx m_nCellUpdates = 0;
+  t_idx m_nCellUpdatesGlobal = 0;
+
+  //! quantities of the cells of a row which all edges of a cell share, computed once per time step
+  struct RowQuantities
+  {
+    //! square roots of the water heights
+    t_real *hSqrt = nullptr;
+
+    //! particle velocities in x- and y-direction; zero in dry cells
+    t_real *uX = nullptr;
+    t_real *uY = nullptr;
+
+    //! momentum fluxes hu * u + g/2 * h^2 in x- and y-direction
+    t_real *fluxX = nullptr;
+    t_real *fluxY = nullptr;
+  };
+
+  //! buffers of a thread's time steps, which are sized once per patch and reused by all time steps
+  struct Scratch
+  {
+    //! net-updates of m_nScratchRows rows of y-edges
+    std::vector<t_real> updates;
+
+    //! net-updates which the first cells of the strips receive from the x-edges left of them, two per row
+    std::vector<t_real> carry;
+
+    //! shared quantities of two rows, see RowQuantities
+    std::vector<t_real> quantities;
+
+    //! intermediate heights, x and y momenta of a tile and its halo in two of the blocked time steps
+    std::vector<t_real> window;
+  };
+
+  //! number of rows of net-updates of a thread, which the local time steps use all of
+  static t_idx constexpr m_nScratchRows = 12;
+
+  //! scratch buffers of the threads, indexed by the id of the thread in its team
+  std::vector<Scratch> m_scratch;
+
+  /**
+   * Loads the states of a batch of edges and applies the reflection effect.
+   * Edge i of the batch lies between the cells i_ceL + i and i_ceL + i + i_offsetR.
+   * The variant matching systeminfo::Isa::active() is used.
+   *
+   * @param i_h water heights.
+   * @param i_hu water momenta normal to the edges.
+   * @param i_ceL left (or bottom) cell of the first edge.
+   * @param i_offsetR offset from the left (or bottom) to the right (or top) cell of an edge.
+   * @param i_nEdges number of edges in the batch.
+   * @param o_hL will be set to the water heights on the left sides.
+   * @param o_hR will be set to the water heights on the right sides.
+   * @param o_huL will be set to the water momenta on the left sides.
+   * @param o_huR will be set to the water momenta on the right sides.
+   * @param o_bL will be set to the bathymetry on the left sides.
+   * @param o_bR will be set to the bathymetry on the right sides.
+   **/
+  void loadEdges(t_real const *i_h,
+                 t_real const *i_hu,
+                 t_idx i_ceL,
+                 t_idx i_offsetR,
+                 t_idx i_nEdges,
+                 t_real *o_hL,
+                 t_real *o_hR,
+                 t_real *o_huL,
+                 t_real *o_huR,
+                 t_real *o_bL,
+                 t_real *o_bR);
+
+  /**
+   * Loads the states and the shared cell quantities of a batch of edges and applies the reflection effect.
+   * A reflected side takes the square root and the flux of the other side and its negated velocity.
+   * Edge i of the batch lies between the cells i_ceL + i and i_ceL + i + i_offsetR.
+   * The variant matching systeminfo::Isa::active() is used.
+   *
+   * @param i_h water heights.
+   * @param i_hu water momenta normal to the edges.
+   * @param i_ceL left (or bottom) cell of the first edge.
+   * @param i_offsetR offset from the left (or bottom) to the right (or top) cell of an edge.
+   * @param i_nEdges number of edges in the batch.
+   * @param i_hSqrtL square roots of the heights of the left cells, starting at the first edge.
+   * @param i_hSqrtR square roots of the heights of the right cells, starting at the first edge.
+   * @param i_uL velocities normal to the edges of the left cells, starting at the first edge.
+   * @param i_uR velocities normal to the edges of the right cells, starting at the first edge.
+   * @param i_fluxL momentum fluxes normal to the edges of the left cells, starting at the first edge.
+   * @param i_fluxR momentum fluxes normal to the edges of the right cells, starting at the first edge.
+   * @param o_hL will be set to the water heights on the left sides.
+   * @param o_hR will be set to the water heights on the right sides.
+   * @param o_huL will be set to the water momenta on the left sides.
+   * @param o_huR will be set to the water momenta on the right sides.
+   * @param o_bL will be set to the bathymetry on the left sides.
+   * @param o_bR will be set to the bathymetry on the right sides.
+   * @param o_hSqrtL will be set to the square roots of the heights on the left sides.
+   * @param o_hSqrtR will be set to the square roots of the heights on the right sides.
+   * @param o_uL will be set to the velocities on the left sides.
+   * @param o_uR will be set to the velocities on the right sides.
+   * @param o_fluxL will be set to the momentum fluxes on the left sides.
+   * @param o_fluxR will be set to the momentum fluxes on the right sides.
+   **/
+  void loadEdges(t_real const *i_h,
+                 t_real const *i_hu,
+                 t_idx i_ceL,
+                 t_idx i_offsetR,
+                 t_idx i_nEdges,
+                 t_real const *i_hSqrtL,
+                 t_real const *i_hSqrtR,
+                 t_real const *i_uL,
+                 t_real const *i_uR,
+                 t_real const *i_fluxL,
+                 t_real const *i_fluxR,
+                 t_real *o_hL,
+                 t_real *o_hR,
+                 t_real *o_huL,
+                 t_real *o_huR,
+                 t_real *o_bL,
+                 t_real *o_bR,
+                 t_real *o_hSqrtL,
+                 t_real *o_hSqrtR,
+                 t_real *o_uL,
+                 t_real *o_uR,
+                 t_real *o_fluxL,
+                 t_real *o_fluxR);
+
+  /**
+   * Computes the net-updates of a batch of at most m_batchSize edges.
+   * Edge i of the batch lies between the cells i_ceL + i and i_ceL + i + i_offsetR.
+   *
+   * @param i_h water heights.
+   * @param i_hu water momenta normal to the edges.
+   * @param i_ceL left (or bottom) cell of the first edge.
+   * @param i_offsetR offset from the left (or bottom) to the right (or top) cell of an edge.
+   * @param i_nEdges number of edges in the batch.
+   * @param o_netUpdatesLH will be set to the height net-updates of the left (or bottom) cells.
+   * @param o_netUpdatesLHu will be set to the momentum net-updates of the left (or bottom) cells.
+   * @param o_netUpdatesRH will be set to the height net-updates of the right (or top) cells.
+   * @param o_netUpdatesRHu will be set to the momentum net-updates of the right (or top) cells.
+   **/
+  void solveEdges(t_real const *i_h,
+                  t_real const *i_hu,
+                  t_idx i_ceL,
+                  t_idx i_offsetR,
+                  t_idx i_nEdges,
+                  t_real *o_netUpdatesLH,
+                  t_real *o_netUpdatesLHu,
+                  t_real *o_netUpdatesRH,
+                  t_real *o_netUpdatesRHu);
+
+  /**
+   * Computes the net-updates of a batch of at most m_batchSize edges from the shared quantities of their cells.
+   * Edge i of the batch lies between the cells i_ceL + i and i_ceL + i + i_offsetR.
+   *
+   * @param i_h water heights.
+   * @param i_hu water momenta normal to the edges.
+   * @param i_ceL left (or bottom) cell of the first edge.
+   * @param i_offsetR offset from the left (or bottom) to the right (or top) cell of an edge.
+   * @param i_nEdges number of edges in the batch.
+   * @param i_hSqrtL square roots of the heights of the left cells, starting at the first edge.
+   * @param i_hSqrtR square roots of the heights of the right cells, starting at the first edge.
+   * @param i_uL velocities normal to the edges of the left cells, starting at the first edge.
+   * @param i_uR velocities normal to the edges of the right cells, starting at the first edge.
+   * @param i_fluxL momentum fluxes normal to the edges of the left cells, starting at the first edge.
+   * @param i_fluxR momentum fluxes normal to the edges of the right cells, starting at the first edge.
+   * @param o_netUpdatesLH will be set to the height net-updates of the left (or bottom) cells.
+   * @param o_netUpdatesLHu will be set to the momentum net-updates of the left (or bottom) cells.
+   * @param o_netUpdatesRH will be set to the height net-updates of the right (or top) cells.
+   * @param o_netUpdatesRHu will be set to the momentum net-updates of the right (or top) cells.
+   **/
+  void solveEdges(t_real const *i_h,
+                  t_real const *i_hu,
+                  t_idx i_ceL,
+                  t_idx i_offsetR,
+                  t_idx i_nEdges,
+                  t_real const *i_hSqrtL,
+                  t_real const *i_hSqrtR,
+                  t_real const *i_uL,
+                  t_real const *i_uR,
+                  t_real const *i_fluxL,
+                  t_real const *i_fluxR,
+                  t_real *o_netUpdatesLH,
+                  t_real *o_netUpdatesLHu,
+                  t_real *o_netUpdatesRH,
+                  t_real *o_netUpdatesRHu);
+
+  /**
+   * Computes the shared quantities of consecutive cells.
+   * The variant matching systeminfo::Isa::active() is used.
+   *
+   * @param i_nCells number of cells.
+   * @param i_h water heights.
+   * @param i_huX x momenta.
+   * @param i_huY y momenta.
+   * @param o_quantities will be set to the quantities of the cells.
+   **/
+  static void cellQuantities(t_idx i_nCells,
+                             t_real const *i_h,
+                             t_real const *i_huX,
+                             t_real const *i_huY,
+                             RowQuantities const &o_quantities);
+
+  /**
+   * Computes the shared quantities of the cells of a row which the edges of a strip read.
+   * These are the cells of the row's intervals, the cells right of them and the cells above the intervals of the row below.
+   *
+   * @param i_row row of cells, 1, ..., ny.
+   * @param i_colBegin first column of the strip.
+   * @param i_colEnd column after the strip.
+   * @param i_h water heights.
+   * @param i_huX x momenta.
+   * @param i_huY y momenta.
+   * @param o_quantities will be set to the quantities of the row's cells; indexed by the column.
+   **/
+  void computeRowQuantities(t_idx i_row,
+                            t_idx i_colBegin,
+                            t_idx i_colEnd,
+                            t_real const *i_h,
+                            t_real const *i_huX,
+                            t_real const *i_huY,
+                            RowQuantities const &o_quantities);
+
+  /**
+   * Gets the shared quantities of two rows in the scratch buffers of a thread.
+   *
+   * @param i_scratch scratch buffers of the thread.
+   * @param o_quantities will be set to the quantities of two rows with getStride() cells each.
+   **/
+  void getRowQuantities(Scratch &i_scratch,
+                        RowQuantities o_quantities[2]);
+
+  /**
+   * Writes the new states of consecutive cells in a single pass.
+   * A cell receives the net-updates in the order: left x-edge, right x-edge, bottom y-edge, top y-edge.
+   * Dry cells are reset to zero height and momenta.
+   * The variant matching systeminfo::Isa::active() is used.
+   *
+   * @param i_ce first cell.
+   * @param i_nCells number of cells.
+   * @param i_scalingX scaling of the time step in x-direction.
+   * @param i_scalingY scaling of the time step in y-direction.
+   * @param i_hOld water heights of the old time step.
+   * @param i_huXOld x momenta of the old time step.
+   * @param i_huYOld y momenta of the old time step.
+   * @param i_xLeftH height net-updates from the x-edges left of the cells.
+   * @param i_xLeftHu x momentum net-updates from the x-edges left of the cells.
+   * @param i_xRightH height net-updates from the x-edges right of the cells.
+   * @param i_xRightHu x momentum net-updates from the x-edges right of the cells.
+   * @param i_yBottomH height net-updates from the y-edges below the cells.
+   * @param i_yBottomHu y momentum net-updates from the y-edges below the cells.
+   * @param i_yTopH height net-updates from the y-edges above the cells.
+   * @param i_yTopHu y momentum net-updates from the y-edges above the cells.
+   * @param o_hNew will be set to the water heights of the new time step.
+   * @param o_huXNew will be set to the x momenta of the new time step.
+   * @param o_huYNew will be set to the y momenta of the new time step.
+   **/
+  static void updateCells(t_idx i_ce,
+                          t_idx i_nCells,
+                          t_real i_scalingX,
+                          t_real i_scalingY,
+                          t_real const *i_hOld,
+                          t_real const *i_huXOld,
+                          t_real const *i_huYOld,
+                          t_real const *i_xLeftH,
+                          t_real const *i_xLeftHu,
+                          t_real const *i_xRightH,
+                          t_real const *i_xRightHu,
+                          t_real const *i_yBottomH,
+                          t_real const *i_yBottomHu,
+                          t_real const *i_yTopH,
+                          t_real const *i_yTopHu,
+                          t_real *o_hNew,
+                          t_real *o_huXNew,
+                          t_real *o_huYNew);
+
+  /**
+   * Computes the maximum wave speed |u| + sqrt(g * h) of consecutive cells; dry cells are skipped.
+   * The variant matching systeminfo::Isa::active() is used.
+   *
+   * @param i_ce first cell.
+   * @param i_nCells number of cells.
+   * @param i_h water heights.
+   * @param i_huX x momenta.
+   * @param i_huY y momenta.
+   * @return maximum wave speed; 0 if all cells are dry.
+   **/
+  static t_real maxWaveSpeed(t_idx i_ce,
+                             t_idx i_nCells,
+                             t_real const *i_h,
+                             t_real const *i_huX,
+                             t_real const *i_huY);
+
+  /**
+   * Checks whether all edges of a batch lie in deep water with small amplitudes, i.e., whether the linearized solver may compute them.
+   * Both sides of an edge have to have a still water depth -b of at least m_linearDepth and a surface elevation |h + b| of at most m_linearAmplitudeRatio times that depth.
+   * The variant matching systeminfo::Isa::active() is used.
+   *
+   * @param i_nEdges number of edges in the batch.
+   * @param i_hL heights of the left sides.
+   * @param i_hR heights of the right sides.
+   * @param i_bL bathymetry of the left sides.
+   * @param i_bR bathymetry of the right sides.
+   * @return true if the linearized solver may compute all edges of the batch.
+   **/
+  bool linearEdges(t_idx i_nEdges,
+                   t_real const *i_hL,
+                   t_real const *i_hR,
+                   t_real const *i_bL,
+                   t_real const *i_bR) const;
+
+  /**
+   * Derives the intervals of the rows which are computed.
+   * Dry cells never become wet, thus the edges between two dry inner cells are skipped in all time steps.
+   * The dry inner cells are reset to zero height and momenta, which the time steps would do as well.
+   **/
+  void updateWetIntervals();
+
+  /**
+   * Derives the tiles computed in the next time step from the changes of the last one.
+   * Waves travel at most one cell per time step, thus a tile only changes if it or a neighbouring tile changed before.
+   **/
+  void updateActiveTiles();
+
+  /**
+   * Sets the bathymetry of the ghost cells to the one of the adjacent inner cells, the corners copy the ghost columns.
+   * The bathymetry is static, thus it is only set after cells were set.
+   **/
+  void setGhostBathymetry();
+
+  /**
+   * Quantizes the bathymetry of all cells to 16-bit integers m_bOffset + m_bScale * q and replaces m_b by the dequantized values.
+   * The water heights of the wet inner cells are adjusted, which keeps their surface elevation h + b.
+   **/
+  void quantizeBathymetry();
+
+  /**
+   * Computes the net-updates of a batch of y-edges above a row.
+   * The edges of the bottom and top boundaries derive the ghost cells from the inner cells, the ghost rows are never read.
+   *
+   * @param i_row row of cells below the edges, 0, ..., ny.
+   * @param i_col column of the first edge.
+   * @param i_nEdges number of edges in the batch.
+   * @param i_h water heights.
+   * @param i_huY y momenta.
+   * @param i_quantities shared quantities of the rows i_row and i_row + 1 at the indices row % 2; nullptr to derive them from the states.
+   * @param o_netUpdatesLH will be set to the height net-updates of the bottom cells.
+   * @param o_netUpdatesLHu will be set to the momentum net-updates of the bottom cells.
+   * @param o_netUpdatesRH will be set to the height net-updates of the top cells.
+   * @param o_netUpdatesRHu will be set to the momentum net-updates of the top cells.
+   **/
+  void solveEdgesY(t_idx i_row,
+                   t_idx i_col,
+                   t_idx i_nEdges,
+                   t_real const *i_h,
+                   t_real const *i_huY,
+                   RowQuantities const *i_quantities,
+                   t_real *o_netUpdatesLH,
+                   t_real *o_netUpdatesLHu,
+                   t_real *o_netUpdatesRH,
+                   t_real *o_netUpdatesRHu);
+
+  /**
+   * Computes the net-updates of a batch of edges between inner cells and their ghost cells.
+   *
+   * @tparam T_Boundary boundary policy which determines the water heights of the ghost cells.
+   * @param i_h water heights.
+   * @param i_hu water momenta normal to the edges.
+   * @param i_ce inner cell of the first edge.
+   * @param i_nEdges number of edges in the batch.
+   * @param i_ghostAbove true if the ghost cells are the right (or top) cells of the edges.
+   * @param o_netUpdatesLH will be set to the height net-updates of the left (or bottom) cells.
+   * @param o_netUpdatesLHu will be set to the momentum net-updates of the left (or bottom) cells.
+   * @param o_netUpdatesRH will be set to the height net-updates of the right (or top) cells.
+   * @param o_netUpdatesRHu will be set to the momentum net-updates of the right (or top) cells.
+   **/
+  template <typename T_Boundary>
+  void solveBoundaryEdges(t_real const *i_h,
+                          t_real const *i_hu,
+                          t_idx i_ce,
+                          t_idx i_nEdges,
+                          bool i_ghostAbove,
+                          t_real *o_netUpdatesLH,
+                          t_real *o_netUpdatesLHu,
+                          t_real *o_netUpdatesRH,
+                          t_real *o_netUpdatesRHu);
+
+  /**
+   * Computes the net-updates of a batch of boundary edges using the policy matching the boundary condition.
+   *
+   * @param i_boundary boundary condition.
+   * @param i_h water heights.
+   * @param i_hu water momenta normal to the edges.
+   * @param i_ce inner cell of the first edge.
+   * @param i_nEdges number of edges in the batch.
+   * @param i_ghostAbove true if the ghost cells are the right (or top) cells of the edges.
+   * @param o_netUpdatesLH will be set to the height net-updates of the left (or bottom) cells.
+   * @param o_netUpdatesLHu will be set to the momentum net-updates of the left (or bottom) cells.
+   * @param o_netUpdatesRH will be set to the height net-updates of the right (or top) cells.
+   * @param o_netUpdatesRHu will be set to the momentum net-updates of the right (or top) cells.
+   **/
+  void solveBoundaryEdges(Boundary i_boundary,
+                          t_real const *i_h,
+                          t_real const *i_hu,
+                          t_idx i_ce,
+                          t_idx i_nEdges,
+                          bool i_ghostAbove,
+                          t_real *o_netUpdatesLH,
+                          t_real *o_netUpdatesLHu,
+                          t_real *o_netUpdatesRH,
+                          t_real *o_netUpdatesRHu);
+
+  /**
+   * Computes the net-updates of the y-edges below a row.
+   *
+   * @param i_row row of cells above the edges.
+   * @param i_hOld water heights of the old time step.
+   * @param i_huYOld y momenta of the old time step.
+   * @param o_updatesLowerH will be set to the height net-updates of the cells below the edges.
+   * @param o_updatesLowerHu will be set to the y momentum net-updates of the cells below the edges.
+   * @param o_updatesUpperH will be set to the height net-updates of the cells in the row.
+   * @param o_updatesUpperHu will be set to the y momentum net-updates of the cells in the row.
+   **/
+  void solveEdgesBelow(t_idx i_row,
+                       t_real const *i_hOld,
+                       t_real const *i_huYOld,
+                       t_real *o_updatesLowerH,
+                       t_real *o_updatesLowerHu,
+                       t_real *o_updatesUpperH,
+                       t_real *o_updatesUpperHu);
+
+  /**
+   * Solves the x-edges of a strip of a row and the y-edges above it and writes the new states of the strip.
+   * The old states of the row and the one above are read before they are overwritten, which allows in-place updates.
+   * Only the row's wet intervals are computed, in chunks aligned to multiples of m_batchSize.
+   * Chunks in inactive tiles keep their states; only their edges towards computed chunks are solved.
+   *
+   * @param i_row row of cells.
+   * @param i_colBegin first column of the strip, a multiple of m_batchSize.
+   * @param i_colEnd column after the strip, a multiple of m_batchSize or the stride.
+   * @param i_scalingX scaling of the time step in x-direction.
+   * @param i_scalingY scaling of the time step in y-direction.
+   * @param i_hOld water heights of the old time step.
+   * @param i_huXOld x momenta of the old time step.
+   * @param i_huYOld y momenta of the old time step.
+   * @param i_quantities shared quantities of the row and the one above at the indices row % 2; nullptr to derive them from the states.
+   * @param io_updatesBottomH height net-updates from the y-edges below the row; will be set to the ones of the next row.
+   * @param io_updatesBottomHu y momentum net-updates from the y-edges below the row; will be set to the ones of the next row.
+   * @param i_updatesTopH precomputed height net-updates from the y-edges above the row; nullptr to solve the edges.
+   * @param i_updatesTopHu precomputed y momentum net-updates from the y-edges above the row; nullptr to solve the edges.
+   * @param io_carryH height net-update from the x-edge left of the strip; will be set to the one of the next strip.
+   * @param io_carryHu x momentum net-update from the x-edge left of the strip; will be set to the one of the next strip.
+   * @param o_hNew will be set to the water heights of the new time step.
+   * @param o_huXNew will be set to the x momenta of the new time step.
+   * @param o_huYNew will be set to the y momenta of the new time step.
+   * @param io_maxWaveSpeed maximum wave speed, raised to the one of the strip's new states if tracking is enabled.
+   **/
+  void updateRow(t_idx i_row,
+                 t_idx i_colBegin,
+                 t_idx i_colEnd,
+                 t_real i_scalingX,
+                 t_real i_scalingY,
+                 t_real const *i_hOld,
+                 t_real const *i_huXOld,
+                 t_real const *i_huYOld,
+                 RowQuantities const *i_quantities,
+                 t_real *io_updatesBottomH,
+                 t_real *io_updatesBottomHu,
+                 t_real const *i_updatesTopH,
+                 t_real const *i_updatesTopHu,
+                 t_real &io_carryH,
+                 t_real &io_carryHu,
+                 t_real *o_hNew,
+                 t_real *o_huXNew,
+                 t_real *o_huYNew,
+                 t_real &io_maxWaveSpeed);
+
+  /**
+   * Gets the block of consecutive inner rows which the calling thread of the current team updates.
+   * The constructor initializes the cells with the even partitioning, the ghost rows belong to the adjacent blocks.
+   * The rebalanced blocks replace it if they were derived for a team of the same size.
+   *
+   * @param o_first will be set to the first row of the block.
+   * @param o_last will be set to the row after the block.
+   **/
+  void getRowBlock(t_idx &o_first,
+                   t_idx &o_last);
+
+  /**
+   * Sizes the scratch buffers of the given number of threads; called by a single thread.
+   * The buffers of further threads are kept, the buffers of the blocked time steps fit the ghost width.
+   *
+   * @param i_nThreads number of threads.
+   **/
+  void allocateScratch(t_idx i_nThreads);
+
+  /**
+   * Gets the scratch buffers of the calling thread of the current team.
+   *
+   * @return scratch buffers.
+   **/
+  Scratch &getScratch();
+
+  /**
+   * Gets the number of rows of the tiles of the blocked time steps, whose halo fills the targeted cache with them.
+   *
+   * @param i_nSteps number of time steps which a tile advances at once.
+   * @return number of rows.
+   **/
+  t_idx getBlockedTileRows(t_idx i_nSteps);
+
+  /**
+   * Fits the times of the threads to the current team and rebalances the blocks of rows if due; called by a single thread.
+   * The cost of a row are its computed cells plus its wet ones and an overhead, corrected by the measured times of the blocks.
+   *
+   * @param i_nSteps number of time steps which the team performs with the blocks.
+   **/
+  void balanceRowBlocks(t_idx i_nSteps);
+
+  /**
+   * Performs a time step; every thread of the current team has to call it and updates a block of rows.
+   *
+   * @param i_scalingX scaling of the time step (dt / dx).
+   * @param i_scalingY scaling of the time step (dt / dy).
+   **/
+  void timeStepTeam(t_real i_scalingX,
+                    t_real i_scalingY);
+
+  /**
+   * Prepares a time step by deriving the intervals and tiles and toggling the buffers; called by a single thread.
+   **/
+  void prepareTimeStep();
+
+  /**
+   * Performs multiple time steps; every thread of the current team has to call it.
+   *
+   * @param i_nSteps number of time steps.
+   * @param i_scalingX scaling of the time steps (dt / dx).
+   * @param i_scalingY scaling of the time steps (dt / dy).
+   **/
+  void timeStepsTeam(t_idx i_nSteps,
+                     t_real i_scalingX,
+                     t_real i_scalingY);
+
+  /**
+   * Performs multiple time steps with temporal blocking; every thread of the current team has to call it.
+   * The block of rows of a thread is split into tiles, which advance all time steps out of the cache.
+   * The intermediate states of a tile are computed in a halo of i_nSteps - 1 rows on each side, which shrinks by one row per time step.
+   *
+   * @param i_nSteps number of time steps.
+   * @param i_scalingX scaling of the time steps (dt / dx).
+   * @param i_scalingY scaling of the time steps (dt / dy).
+   **/
+  void timeStepsBlocked(t_idx i_nSteps,
+                        t_real i_scalingX,
+                        t_real i_scalingY);
+
+  /**
+   * Performs multiple time steps as tasks of tiles of rows; every thread of the current team has to call it.
+   * A single thread creates the tasks of all time steps, the others start with the first tiles.
+   * The task of a tile depends on the tile and its two neighbours in the previous time step, which read and write the same rows.
+   * With the activity tracking, the tasks of a time step wait for the previous one, whose changes select the tiles.
+   *
+   * @param i_nSteps number of time steps.
+   * @param i_scalingX scaling of the time steps (dt / dx).
+   * @param i_scalingY scaling of the time steps (dt / dy).
+   **/
+  void timeStepsTasks(t_idx i_nSteps,
+                      t_real i_scalingX,
+                      t_real i_scalingY);
+
+  /**
+   * Updates the rows of a tile out of place; the tasks of timeStepsTasks call it.
+   *
+   * @param i_first first row of the tile.
+   * @param i_last row after the tile.
+   * @param i_scalingX scaling of the time step (dt / dx).
+   * @param i_scalingY scaling of the time step (dt / dy).
+   * @param i_hOld old water heights.
+   * @param i_huXOld old momenta in x-direction.
+   * @param i_huYOld old momenta in y-direction.
+   * @param o_hNew will be set to the new water heights of the rows.
+   * @param o_huXNew will be set to the new momenta in x-direction of the rows.
+   * @param o_huYNew will be set to the new momenta in y-direction of the rows.
+   * @param io_maxWaveSpeed maximum wave speed, updated by the new states if it is tracked.
+   **/
+  void updateTile(t_idx i_first,
+                  t_idx i_last,
+                  t_real i_scalingX,
+                  t_real i_scalingY,
+                  t_real const *i_hOld,
+                  t_real const *i_huXOld,
+                  t_real const *i_huYOld,
+                  t_real *o_hNew,
+                  t_real *o_huXNew,
+                  t_real *o_huYNew,
+                  t_real &io_maxWaveSpeed);
+
+  /**
+   * Derives the intervals after cells were set and sizes the scratch buffers of a larger team; called by a single thread.
+   **/
+  void prepareCells();
+
+  /**
+   * Derives the classes of the local time stepping and the runs of the edges and cells of every class; every thread of the current team has to call it.
+   * A wet cell gets the largest class c <= L with 2^c times its wave speed not exceeding the maximum one, an edge the smaller class of its wet cells.
+   *
+   * @param i_first first row of the calling thread's block.
+   * @param i_last row after the calling thread's block.
+   **/
+  void classifyCells(t_idx i_first,
+                     t_idx i_last);
+
+  /**
+   * Solves the x-edges of a row which belong to a class and accumulates their net-updates in the adjacent cells.
+   *
+   * @param i_row row of the edges.
+   * @param i_class class of the edges.
+   * @param i_scaling scaling of the class' local time step (dt / dx).
+   **/
+  void accumulateEdgesX(t_idx i_row,
+                        t_idx i_class,
+                        t_real i_scaling);
+
+  /**
+   * Solves the y-edges above a row which belong to a class.
+   *
+   * @param i_row row of cells below the edges, 0, ..., ny.
+   * @param i_class class of the edges.
+   * @param o_netUpdatesLH will be set to the net-updates of the heights of the bottom cells, indexed by the columns of the edges.
+   * @param o_netUpdatesLHu will be set to the net-updates of the y momenta of the bottom cells.
+   * @param o_netUpdatesRH will be set to the net-updates of the heights of the top cells.
+   * @param o_netUpdatesRHu will be set to the net-updates of the y momenta of the top cells.
+   **/
+  void solveClassEdgesY(t_idx i_row,
+                        t_idx i_class,
+                        t_real *o_netUpdatesLH,
+                        t_real *o_netUpdatesLHu,
+                        t_real *o_netUpdatesRH,
+                        t_real *o_netUpdatesRHu);
+
+  /**
+   * Accumulates the net-updates of the y-edges above a row which belong to a class in the adjacent inner cells.
+   *
+   * @param i_row row of cells below the edges, 0, ..., ny.
+   * @param i_class class of the edges.
+   * @param i_scaling scaling of the class' local time step (dt / dy).
+   * @param i_netUpdatesLH net-updates of the heights of the bottom cells, see solveClassEdgesY; nullptr to skip the bottom cells.
+   * @param i_netUpdatesLHu net-updates of the y momenta of the bottom cells.
+   * @param i_netUpdatesRH net-updates of the heights of the top cells; nullptr to skip the top cells.
+   * @param i_netUpdatesRHu net-updates of the y momenta of the top cells.
+   **/
+  void accumulateEdgesY(t_idx i_row,
+                        t_idx i_class,
+                        t_real i_scaling,
+                        t_real const *i_netUpdatesLH,
+                        t_real const *i_netUpdatesLHu,
+                        t_real const *i_netUpdatesRH,
+                        t_real const *i_netUpdatesRHu);
+
+  /**
+   * Adds the accumulated net-updates to the wet cells of a row which belong to a class and resets them; dry cells are reset to zero.
+   *
+   * @param i_row row of the cells.
+   * @param i_class class of the cells.
+   **/
+  void applyAccumulatedUpdates(t_idx i_row,
+                               t_idx i_class);
+
+  /**
+   * Performs a time step with local time steps; every thread of the current team has to call it and updates a block of rows.
+   * The cells are updated in place by 2^L micro steps: a class c advances in micro steps m with m % 2^c == 0 and applies its net-updates after those with (m + 1) % 2^c == 0.
+   * The y-edges between the blocks are solved by both blocks, which keeps the order of the accumulated net-updates independent of the number of threads.
+   *
+   * @param i_scalingX scaling of the time step (dt / dx).
+   * @param i_scalingY scaling of the time step (dt / dy).
+   **/
+  void timeStepLocalTeam(t_real i_scalingX,
+                         t_real i_scalingY);
 
 public:
   /**
@@ -88,13 +927,15 @@ public:
    * @param i_boundaryR boundary condition on the left side
    * @param i_boundaryT boundary condition on the top side
    * @param i_boundaryB boundary condition on the bottom side
+   * @param i_inPlace true to keep a single buffer per quantity which is updated in place, false for double buffering.
    **/
   WavePropagation2d(t_idx i_nCellsX,
                     t_idx i_nCellsY,
                     Boundary i_boundaryL,
                     Boundary i_boundaryR,
                     Boundary i_boundaryT,
-                    Boundary i_boundaryB);
+                    Boundary i_boundaryB,
+                    bool i_inPlace);
 
   /**
    * Destructor which frees all allocated memory.
@@ -103,6 +944,8 @@ public:
 
   /**
    * Performs a time step.
+   * The rows are updated one after another; every new cell state is written exactly once.
+   * Inside an active parallel region, the threads of the team share the rows, otherwise a parallel region is opened.
    *
    * @param i_scalingX scaling of the time step (dt / dx).
    * @param i_scalingY scaling of the time step (dt / dy).
@@ -111,9 +954,36 @@ public:
                 t_real i_scalingY);
 
   /**
-   * Sets the values of the ghost cells according to outflow boundary conditions.
+   * The time steps apply the boundary conditions when solving the edges of the bottom and top rows; the ghost cells are not set.
    **/
-  void setGhostOutflow();
+  void setGhostOutflow()
+  {
+  }
+
+  /**
+   * Performs multiple time steps.
+   * Up to the ghost width many time steps are blocked in tiles, unless the updates are in place or the activity is tracked.
+   * With task tiles, the tiles of all time steps are scheduled as tasks instead.
+   * Inside an active parallel region, the threads of the team share the rows, otherwise a parallel region is opened.
+   *
+   * @param i_nSteps number of time steps.
+   * @param i_scalingX scaling of the time steps (dt / dx).
+   * @param i_scalingY scaling of the time steps (dt / dy).
+   **/
+  void timeSteps(t_idx i_nSteps,
+                 t_real i_scalingX,
+                 t_real i_scalingY);
+
+  /**
+   * Sets the number of time steps which a tile advances at once.
+   *
+   * @param i_nSteps number of time steps; 1 disables the temporal blocking.
+   **/
+  void setGhostWidth(t_idx i_nSteps)
+  {
+    m_ghostWidth = std::max(i_nSteps, t_idx(1));
+    allocateScratch(m_scratch.size());
+  }
 
   /**
    * Gets the stride in y-direction. x-direction is stride-1.
@@ -122,7 +992,7 @@ public:
    **/
   t_idx getStride()
   {
-    return m_nCellsX + 2;
+    return m_stride;
   }
 
   /**
@@ -175,6 +1045,7 @@ public:
                  t_real i_h)
   {
     m_h[m_step][i_ix + 1 + (i_iy+1) * getStride()] = i_h;
+    m_cellsSet = true;
   }
 
   /**
@@ -189,6 +1060,7 @@ public:
                     t_real i_huX)
   {
     m_huX[m_step][i_ix + 1 + (i_iy+1) * getStride()] = i_huX;
+    m_cellsSet = true;
   }
 
   /**
@@ -202,6 +1074,7 @@ public:
                     t_real i_huY)
   {
     m_huY[m_step][i_ix + 1 + (i_iy+1) * getStride()] = i_huY;
+    m_cellsSet = true;
   };
 
   /**
@@ -216,6 +1089,36 @@ public:
                      t_real i_b)
   {
     m_b[i_ix + 1 + (i_iy+1) * getStride()] = i_b;
+    m_cellsSet = true;
+  }
+
+  /**
+   * Overwrites the state of a cell between two time steps without deriving the dry cells and the computed intervals again.
+   * The active-region tracking computes the tiles around a changed cell again, the other tiles stay at rest.
+   *
+   * @param i_ix id of the cell in x-direction.
+   * @param i_iy id of the cell in y-direction.
+   * @param i_h water height.
+   * @param i_huX momentum in x-direction.
+   * @param i_huY momentum in y-direction.
+   **/
+  void setCellState(t_idx i_ix,
+                    t_idx i_iy,
+                    t_real i_h,
+                    t_real i_huX,
+                    t_real i_huY)
+  {
+    t_idx l_ce = i_ix + 1 + (i_iy + 1) * getStride();
+
+    // a change of the cell wakes its tile and the neighbouring ones like a change of the time step, the other tiles stay at rest
+    if (std::abs(i_h - m_h[m_step][l_ce]) > m_activityThreshold ||
+        std::abs(i_huX - m_huX[m_step][l_ce]) > m_activityThreshold ||
+        std::abs(i_huY - m_huY[m_step][l_ce]) > m_activityThreshold)
+      m_chunksChanged[(i_iy + 1) * m_nTilesX + (i_ix + 1) / m_batchSize] = 1;
+
+    m_h[m_step][l_ce] = i_h;
+    m_huX[m_step][l_ce] = i_huX;
+    m_huY[m_step][l_ce] = i_huY;
   }
 
   /**
@@ -223,6 +1126,171 @@ public:
    *
    **/
   void adjustWaterHeight();
+
+  /**
+   * Enables or disables the computation of the maximum wave speed in the following time steps.
+   *
+   * @param i_track true to compute the maximum wave speed.
+   **/
+  void setMaxWaveSpeedTracking(bool i_track)
+  {
+    m_trackMaxWaveSpeed = i_track;
+  }
+
+  /**
+   * Gets the maximum wave speed |u| + sqrt(g * h) of the cells after the last time step which computed it.
+   *
+   * @return maximum wave speed.
+   **/
+  t_real getMaxWaveSpeed()
+  {
+    return m_maxWaveSpeed;
+  }
+
+  /**
+   * Computes the maximum wave speed |u| + sqrt(g * h) of the current states of a rectangle of cells, as the time steps track it.
+   * Outside of a parallel region, the threads share the rows.
+   *
+   * @param i_ix first cell in x-direction.
+   * @param i_iy first cell in y-direction.
+   * @param i_nx number of cells in x-direction.
+   * @param i_ny number of cells in y-direction.
+   * @return maximum wave speed; 0 for an empty rectangle.
+   **/
+  t_real computeMaxWaveSpeed(t_idx i_ix,
+                             t_idx i_iy,
+                             t_idx i_nx,
+                             t_idx i_ny);
+
+  /**
+   * Sets the threshold of the active-region tracking.
+   * A tile is skipped in a time step if neither it nor a neighbouring tile changed by more than the threshold in the previous one.
+   *
+   * @param i_threshold maximum change of the heights and momenta of a tile at rest; negative values compute all tiles.
+   **/
+  void setActivityThreshold(t_real i_threshold)
+  {
+    m_activityThreshold = i_threshold;
+    m_resetActivity = true;
+  }
+
+  /**
+   * Sets the width of the column strips in which the time steps sweep the rows.
+   * Narrow strips keep the rows of a strip in the cache for the solution of the edges between them.
+   *
+   * @param i_nCells number of columns of a strip, rounded up to a multiple of the chunk size; 0 sweeps whole rows.
+   **/
+  void setStripWidth(t_idx i_nCells)
+  {
+    m_stripWidth = (i_nCells + m_batchSize - 1) / m_batchSize * m_batchSize;
+  }
+
+  /**
+   * Sets whether the time steps precompute the square roots, velocities and momentum fluxes of the cells once per row and share them between the edges.
+   * Only used by solvers with T_Solver::m_sharesCellQuantities and without the activity tracking.
+   *
+   * @param i_share true if the cell quantities are precomputed, false if every edge derives them from the states.
+   **/
+  void setCellQuantitySharing(bool i_share)
+  {
+    m_shareCellQuantities = i_share;
+  }
+
+  /**
+   * Sets whether the sweeps read the bathymetry quantized to 16-bit integers.
+   * The bathymetry is quantized before the next time step; getBathymetry() returns the quantized values afterwards, also if the quantization is disabled again.
+   *
+   * @param i_quantize true to quantize the bathymetry, false to read it as float.
+   **/
+  void setBathymetryQuantization(bool i_quantize)
+  {
+    m_quantizeBathymetry = i_quantize;
+    m_cellsSet = true;
+  }
+
+  /**
+   * Sets the deep water in which the linearized solver replaces T_Solver.
+   * The classification is done per batch of edges in every time step: a batch is linearized if all of its edges are deep and their amplitudes small, see linearEdges.
+   * Batches on the shelf, near the coast or in large waves are solved by T_Solver.
+   *
+   * @param i_minDepth minimum still water depth of the linearized edges; 0 or less solves all edges with T_Solver.
+   * @param i_maxAmplitudeRatio maximum ratio of the surface elevation to the still water depth of the linearized edges, less than 1.
+   **/
+  void setLinearization(t_real i_minDepth,
+                        t_real i_maxAmplitudeRatio)
+  {
+    m_linearDepth = i_minDepth > 0 ? i_minDepth : 0;
+    m_linearAmplitudeRatio = i_maxAmplitudeRatio;
+  }
+
+  /**
+   * Sets the number of levels of the local time stepping.
+   * A time step of the given scaling is split into 2^L micro steps, which the fastest cells advance one after another.
+   * The time stepping replaces the activity tracking, the strips, the shared cell quantities and the temporal blocking.
+   *
+   * @param i_nLevels number of levels L, at most m_maxTimeStepLevels; 0 advances all cells with the time step.
+   **/
+  void setLocalTimeStepping(t_idx i_nLevels);
+
+  /**
+   * Sets the number of rows of the tiles which the time steps schedule as tasks, and resets the times of the threads.
+   * The tasks replace the temporal blocking; in-place updates and the local time stepping keep the blocks of rows.
+   *
+   * @param i_nRows number of rows of a tile; 0 assigns a fixed block of rows to every thread.
+   **/
+  void setTaskTiles(t_idx i_nRows);
+
+  /**
+   * Gets the time which the threads spent in the tasks of the tiles and waiting for them, since the tiles were set.
+   *
+   * @param o_busy will be set to the seconds in tasks per thread.
+   * @param o_idle will be set to the seconds without a task per thread.
+   **/
+  void getTaskTimes(std::vector<double> &o_busy,
+                    std::vector<double> &o_idle);
+
+  /**
+   * Sets the number of time steps after which the threads' blocks of rows are rebalanced by the cost of the rows.
+   * The rows of a block keep consecutive, thus the results do not depend on the blocks.
+   *
+   * @param i_nSteps number of time steps between the rebalancings; 0 splits the rows evenly.
+   **/
+  void setLoadBalancing(t_idx i_nSteps);
+
+  /**
+   * Gets the blocks of rows of the threads of the last time step.
+   *
+   * @param o_blocks will be set to the first rows of the blocks followed by the row after the last block.
+   **/
+  void getRowBlocks(std::vector<t_idx> &o_blocks);
+
+  /**
+   * Gets the statistics of the last time step.
+   *
+   * @return statistics.
+   **/
+  StepStatistics getStepStatistics()
+  {
+    StepStatistics l_statistics;
+    l_statistics.nTilesX = m_nTilesX;
+    l_statistics.nTilesY = m_nTilesY;
+    l_statistics.nTilesComputed = m_nTilesComputed;
+    l_statistics.tilesComputed = m_activityThreshold < 0 || m_timeStepLevels > 0 ? nullptr : m_tilesActive;
+    l_statistics.nCellUpdates = m_nCellUpdates;
+    l_statistics.nCellUpdatesGlobal = m_nCellUpdatesGlobal;
+
+    // the busy times of the blocks, the tasks balance the threads on their own
+    double l_busyMax = 0;
+    double l_busySum = 0;
+    for (double l_busy : m_stepBusy)
+    {
+      l_busyMax = std::max(l_busyMax, l_busy);
+      l_busySum += l_busy;
+    }
+    if (l_busySum > 0)
+      l_statistics.threadImbalance = l_busyMax * m_stepBusy.size() / l_busySum;
+    return l_statistics;
+  }
   
 };
 
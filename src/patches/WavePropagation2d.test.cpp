@@ -7,10 +7,125 @@
  **/
 #include <catch2/catch.hpp>
 #include "WavePropagation2d.h"
+#include "../solvers/Fwave.h"
+#include <cmath>
+#include <numeric>
 
 using Boundary = tsunami_lab::patches::WavePropagation::Boundary;
+using WavePropagation = tsunami_lab::patches::WavePropagation;
+using WavePropagationFwave = tsunami_lab::patches::WavePropagation2d<tsunami_lab::solvers::Fwave>;
 
-TEST_CASE("Test the 2d wave propagation solver using fwave.", "[WaveProp2d]")
+/**
+ * Requires two patches of the same size to hold the same states in all cells.
+ *
+ * @param i_expected patch of the expected states.
+ * @param i_wave compared patch.
+ * @param i_nx number of cells in x-direction.
+ * @param i_ny number of cells in y-direction.
+ * @param i_margin allowed absolute difference of the states; 0 requires identical ones.
+ **/
+static void requireSameCells(WavePropagation &i_expected,
+                             WavePropagation &i_wave,
+                             tsunami_lab::t_idx i_nx,
+                             tsunami_lab::t_idx i_ny,
+                             tsunami_lab::t_real i_margin = 0)
+{
+  tsunami_lab::t_idx l_stride = i_expected.getStride();
+  for (tsunami_lab::t_idx l_cy = 0; l_cy < i_ny; l_cy++)
+  {
+    for (tsunami_lab::t_idx l_cx = 0; l_cx < i_nx; l_cx++)
+    {
+      tsunami_lab::t_idx l_ce = l_cx + l_cy * l_stride;
+      if (i_margin > 0)
+      {
+        REQUIRE(i_wave.getHeight()[l_ce] == Approx(i_expected.getHeight()[l_ce]).margin(i_margin));
+        REQUIRE(i_wave.getMomentumX()[l_ce] == Approx(i_expected.getMomentumX()[l_ce]).margin(i_margin));
+        REQUIRE(i_wave.getMomentumY()[l_ce] == Approx(i_expected.getMomentumY()[l_ce]).margin(i_margin));
+      }
+      else
+      {
+        REQUIRE(i_wave.getHeight()[l_ce] == i_expected.getHeight()[l_ce]);
+        REQUIRE(i_wave.getMomentumX()[l_ce] == i_expected.getMomentumX()[l_ce]);
+        REQUIRE(i_wave.getMomentumY()[l_ce] == i_expected.getMomentumY()[l_ce]);
+      }
+    }
+  }
+}
+
+/**
+ * Advances two patches which differ in a setting and requires them to compute identical states and maximum wave speeds.
+ * The expected patch performs the time steps one by one, the other one in a single call.
+ *
+ * @param io_expected patch of the expected states.
+ * @param io_wave compared patch.
+ * @param i_nx number of cells in x-direction.
+ * @param i_ny number of cells in y-direction.
+ * @param i_nSteps number of time steps.
+ * @param i_scaling scaling of the time steps in x- and y-direction.
+ **/
+static void requireSameSolution(WavePropagation &io_expected,
+                                WavePropagation &io_wave,
+                                tsunami_lab::t_idx i_nx,
+                                tsunami_lab::t_idx i_ny,
+                                tsunami_lab::t_idx i_nSteps,
+                                tsunami_lab::t_real i_scaling)
+{
+  for (tsunami_lab::t_idx l_ts = 0; l_ts < i_nSteps; l_ts++)
+    io_expected.timeStep(i_scaling, i_scaling);
+  io_wave.timeSteps(i_nSteps, i_scaling, i_scaling);
+
+  REQUIRE(io_wave.getMaxWaveSpeed() == io_expected.getMaxWaveSpeed());
+  requireSameCells(io_expected, io_wave, i_nx, i_ny);
+}
+
+/**
+ * Sets a circular dam break of radius 20 next to an island of 30x20 cells on a 300 cells wide grid.
+ *
+ * @param io_wave patch.
+ * @param i_ny number of cells in y-direction.
+ * @param i_cyDam row of the center of the dam break; the island spans the rows 10 to 29 above it.
+ * @param i_hv momentum in y-direction of the wet cells.
+ **/
+static void setIslandDamBreak(WavePropagation &io_wave,
+                              tsunami_lab::t_idx i_ny,
+                              tsunami_lab::t_idx i_cyDam,
+                              tsunami_lab::t_real i_hv)
+{
+  for (tsunami_lab::t_idx l_cy = 0; l_cy < i_ny; l_cy++)
+  {
+    for (tsunami_lab::t_idx l_cx = 0; l_cx < 300; l_cx++)
+    {
+      int l_dx = int(l_cx) - 150;
+      int l_dy = int(l_cy) - int(i_cyDam);
+      bool l_island = l_cx >= 100 && l_cx < 130 && l_cy >= i_cyDam + 10 && l_cy < i_cyDam + 30;
+      io_wave.setHeight(l_cx, l_cy, l_island ? 0 : (l_dx * l_dx + l_dy * l_dy < 400 ? 10 : 5));
+      io_wave.setMomentumY(l_cx, l_cy, l_island ? 0 : i_hv);
+      io_wave.setBathymetry(l_cx, l_cy, l_island ? 5 : -5);
+    }
+  }
+}
+
+/**
+ * Sets a circular dam break of radius 20 off a coast on a 300x200 grid, the land covers most of the upper rows.
+ *
+ * @param io_wave patch.
+ **/
+static void setCoastDamBreak(WavePropagation &io_wave)
+{
+  for (tsunami_lab::t_idx l_cy = 0; l_cy < 200; l_cy++)
+  {
+    for (tsunami_lab::t_idx l_cx = 0; l_cx < 300; l_cx++)
+    {
+      int l_dx = int(l_cx) - 150;
+      int l_dy = int(l_cy) - 40;
+      bool l_land = l_cy > 60 + l_cx / 10;
+      io_wave.setHeight(l_cx, l_cy, l_land ? 0 : (l_dx * l_dx + l_dy * l_dy < 400 ? 10 : 5));
+      io_wave.setBathymetry(l_cx, l_cy, l_land ? 5 : -5);
+    }
+  }
+}
+
+TEST_CASE("Test the 2d wave propagation solver using fwave and roe.", "[WaveProp2d]")
 {
   /*
    * Test case:
@@ -29,83 +144,773 @@ TEST_CASE("Test the 2d wave propagation solver using fwave.", "[WaveProp2d]")
    *    -88.25985     | -88.25985
    */
 
-  // construct solver and setup a dambreak problem
-  tsunami_lab::patches::WavePropagation2d m_waveProp(100,
-                                                     100,
-                                                     Boundary::OUTFLOW,
-                                                     Boundary::OUTFLOW,
-                                                     Boundary::OUTFLOW,
-                                                     Boundary::OUTFLOW);
+  // both solvers agree on flat bathymetry; double-buffered and in-place updates yield the same results
+  for (std::string l_solver : {"fwave", "roe"})
+  {
+    for (bool l_inPlace : {false, true})
+    {
+      // construct solver and setup a dambreak problem
+      tsunami_lab::patches::WavePropagation *l_patch = tsunami_lab::patches::createWavePropagation2d(100,
+                                                                                                   100,
+                                                                                                   l_solver,
+                                                                                                   Boundary::OUTFLOW,
+                                                                                                   Boundary::OUTFLOW,
+                                                                                                   Boundary::OUTFLOW,
+                                                                                                   Boundary::OUTFLOW,
+                                                                                                   l_inPlace);
+      tsunami_lab::patches::WavePropagation &m_waveProp = *l_patch;
+
+      std::size_t stride = m_waveProp.getStride();
+
+      for (std::size_t l_ce = 0; l_ce < 50; l_ce++)
+      {
+        for (std::size_t l_de = 0; l_de < 100; l_de++)
+        {
+          m_waveProp.setHeight(l_ce,
+                               l_de,
+                               10);
+          m_waveProp.setMomentumX(l_ce,
+                                  l_de,
+                                  0);
+          m_waveProp.setMomentumY(l_ce,
+                                  l_de,
+                                  0);
+        }
+      }
+      for (std::size_t l_ce = 50; l_ce < 100; l_ce++)
+      {
+        for (std::size_t l_de = 0; l_de < 100; l_de++)
+        {
+          m_waveProp.setHeight(l_ce,
+                               l_de,
+                               8);
+          m_waveProp.setMomentumX(l_ce,
+                                  l_de,
+                                  0);
+          m_waveProp.setMomentumY(l_ce,
+                                  l_de,
+                                  0);
+        }
+      }
+
+      // set outflow boundary condition
+      m_waveProp.setGhostOutflow();
 
-  std::size_t stride = 100 + 2;
+      // perform a time step
+      m_waveProp.timeStep(0.1, 0.1);
 
-  for (std::size_t l_ce = 0; l_ce < 50; l_ce++)
+      // steady state
+      for (std::size_t l_ce = 0; l_ce < 49; l_ce++)
+      {
+        for (std::size_t l_de = 0; l_de < 100; l_de++)
+        {
+          REQUIRE(m_waveProp.getHeight()[l_ce + l_de * stride] == Approx(10));
+          REQUIRE(m_waveProp.getMomentumX()[l_ce + l_de * stride] == Approx(0));
+          REQUIRE(m_waveProp.getMomentumY()[l_ce + l_de * stride] == Approx(0));
+        }
+      }
+
+      // dam-break
+      for (std::size_t l_de = 0; l_de < 100; l_de++)
+      {
+        REQUIRE(m_waveProp.getHeight()[49 + l_de * stride] == Approx(10 - 0.1 * 9.394671362));
+        REQUIRE(m_waveProp.getMomentumX()[49 + l_de * stride] == Approx(0 + 0.1 * 88.25985));
+        REQUIRE(m_waveProp.getMomentumY()[49 + l_de * stride] == Approx(0));
+
+        REQUIRE(m_waveProp.getHeight()[50 + l_de * stride] == Approx(8 + 0.1 * 9.394671362));
+        REQUIRE(m_waveProp.getMomentumX()[50 + l_de * stride] == Approx(0 + 0.1 * 88.25985));
+        REQUIRE(m_waveProp.getMomentumY()[50 + l_de * stride] == Approx(0));
+      }
+      // steady state
+      for (std::size_t l_ce = 51; l_ce < 100; l_ce++)
+      {
+        for (std::size_t l_de = 0; l_de < 100; l_de++)
+        {
+          REQUIRE(m_waveProp.getHeight()[l_ce + l_de * stride] == Approx(8));
+          REQUIRE(m_waveProp.getMomentumX()[l_ce + l_de * stride] == Approx(0));
+          REQUIRE(m_waveProp.getMomentumY()[l_ce + l_de * stride] == Approx(0));
+        }
+      }
+
+      delete l_patch;
+    }
+  }
+}
+
+TEST_CASE("Test in-place updates of the 2d wave propagation solver.", "[WaveProp2dInPlace]")
+{
+  /*
+   * Test case:
+   *
+   *   Circular dam break on a 37x29 grid with varying bathymetry and a wall on the right.
+   *   The in-place updates have to match the double-buffered ones after several time steps.
+   */
+  WavePropagationFwave l_waveProp(37, 29, Boundary::OUTFLOW, Boundary::WALL, Boundary::OUTFLOW, Boundary::OUTFLOW, false);
+  WavePropagationFwave l_waveInPlace(37, 29, Boundary::OUTFLOW, Boundary::WALL, Boundary::OUTFLOW, Boundary::OUTFLOW, true);
+  for (WavePropagation *l_wave : {&l_waveProp, &l_waveInPlace})
   {
-    for (std::size_t l_de = 0; l_de < 100; l_de++)
+    for (std::size_t l_cy = 0; l_cy < 29; l_cy++)
     {
-      m_waveProp.setHeight(l_ce,
-                           l_de,
-                           10);
-      m_waveProp.setMomentumX(l_ce,
-                              l_de,
-                              0);
-      m_waveProp.setMomentumY(l_ce,
-                              l_de,
-                              0);
+      for (std::size_t l_cx = 0; l_cx < 37; l_cx++)
+      {
+        std::size_t l_dx = l_cx > 18 ? l_cx - 18 : 18 - l_cx;
+        std::size_t l_dy = l_cy > 14 ? l_cy - 14 : 14 - l_cy;
+        l_wave->setHeight(l_cx, l_cy, l_dx * l_dx + l_dy * l_dy < 25 ? 10 : 5);
+        l_wave->setBathymetry(l_cx, l_cy, -20 + 0.1 * l_cx);
+      }
     }
   }
-  for (std::size_t l_ce = 50; l_ce < 100; l_ce++)
+
+  requireSameSolution(l_waveProp, l_waveInPlace, 37, 29, 10, 0.05);
+}
+
+TEST_CASE("Test the maximum wave speed of the 2d wave propagation solver.", "[WaveProp2dWaveSpeed]")
+{
+  /*
+   * Test case:
+   *
+   *   Uniform flow on a 300x20 grid which spans several batches of a row:
+   *     h = 4, hu = 8, hv = -2
+   *
+   *   The flow is steady, thus the maximum wave speed is
+   *     |hu| / h + sqrt(g * h) = 2 + sqrt(9.80665 * 4)
+   */
+  for (bool l_inPlace : {false, true})
   {
-    for (std::size_t l_de = 0; l_de < 100; l_de++)
+    tsunami_lab::patches::WavePropagation *l_waveProp = tsunami_lab::patches::createWavePropagation2d(300,
+                                                                                                      20,
+                                                                                                      "fwave",
+                                                                                                      Boundary::OUTFLOW,
+                                                                                                      Boundary::OUTFLOW,
+                                                                                                      Boundary::OUTFLOW,
+                                                                                                      Boundary::OUTFLOW,
+                                                                                                      l_inPlace);
+
+    for (std::size_t l_cy = 0; l_cy < 20; l_cy++)
     {
-      m_waveProp.setHeight(l_ce,
-                           l_de,
-                           8);
-      m_waveProp.setMomentumX(l_ce,
-                              l_de,
-                              0);
-      m_waveProp.setMomentumY(l_ce,
-                              l_de,
-                              0);
+      for (std::size_t l_cx = 0; l_cx < 300; l_cx++)
+      {
+        l_waveProp->setHeight(l_cx, l_cy, 4);
+        l_waveProp->setMomentumX(l_cx, l_cy, 8);
+        l_waveProp->setMomentumY(l_cx, l_cy, -2);
+      }
     }
+
+    // the wave speed is only computed on request
+    l_waveProp->setGhostOutflow();
+    l_waveProp->timeStep(0.1, 0.1);
+    REQUIRE(l_waveProp->getMaxWaveSpeed() == Approx(0));
+
+    l_waveProp->setMaxWaveSpeedTracking(true);
+    l_waveProp->setGhostOutflow();
+    l_waveProp->timeStep(0.1, 0.1);
+    REQUIRE(l_waveProp->getMaxWaveSpeed() == Approx(2 + std::sqrt(9.80665 * 4)));
+
+    // the speeds of rectangles of the current cells are the tracked ones, a faster cell raises the ones which contain it
+    REQUIRE(l_waveProp->computeMaxWaveSpeed(0, 0, 300, 20) == l_waveProp->getMaxWaveSpeed());
+    l_waveProp->setCellState(280, 15, 4, 20, 0);
+    REQUIRE(l_waveProp->computeMaxWaveSpeed(0, 0, 280, 20) == l_waveProp->getMaxWaveSpeed());
+    REQUIRE(l_waveProp->computeMaxWaveSpeed(270, 10, 20, 10) == Approx(5 + std::sqrt(9.80665 * 4)));
+    REQUIRE(l_waveProp->computeMaxWaveSpeed(0, 0, 0, 20) == 0);
+
+    delete l_waveProp;
   }
+}
 
-  // set outflow boundary condition
-  m_waveProp.setGhostOutflow();
+TEST_CASE("Test the active-region tracking of the 2d wave propagation solver.", "[WaveProp2dActiveTiles]")
+{
+  /*
+   * Test case:
+   *
+   *   Small dam break in the lower left corner of a 700x60 grid, elsewhere the water is at rest.
+   *   Skipping the tiles at rest with a zero threshold does not change the results, also after single cells were overwritten.
+   */
+  for (bool l_inPlace : {false, true})
+  {
+    WavePropagationFwave l_waveProp(700, 60, Boundary::OUTFLOW, Boundary::WALL, Boundary::OUTFLOW, Boundary::OUTFLOW, l_inPlace);
+    WavePropagationFwave l_waveActive(700, 60, Boundary::OUTFLOW, Boundary::WALL, Boundary::OUTFLOW, Boundary::OUTFLOW, l_inPlace);
+    l_waveActive.setActivityThreshold(0);
+    for (WavePropagation *l_wave : {&l_waveProp, &l_waveActive})
+    {
+      for (std::size_t l_cy = 0; l_cy < 60; l_cy++)
+      {
+        for (std::size_t l_cx = 0; l_cx < 700; l_cx++)
+        {
+          l_wave->setHeight(l_cx, l_cy, l_cx < 10 && l_cy < 10 ? 10 : 5);
+          l_wave->setBathymetry(l_cx, l_cy, -5);
+        }
+      }
+    }
+
+    // all tiles are computed after the cells were set
+    requireSameSolution(l_waveProp, l_waveActive, 700, 60, 1, 0.05);
+    WavePropagation::StepStatistics l_statistics = l_waveActive.getStepStatistics();
+    REQUIRE(l_statistics.nTilesX == 3);
+    REQUIRE(l_statistics.nTilesY == 8);
+    REQUIRE(l_statistics.nTilesComputed == 24);
 
-  // perform a time step
-  m_waveProp.timeStep(0.1, 0.1);
+    // afterwards only the tiles around the dam break
+    requireSameSolution(l_waveProp, l_waveActive, 700, 60, 20, 0.05);
+    l_statistics = l_waveActive.getStepStatistics();
+    REQUIRE(l_statistics.nTilesComputed < 24);
+    REQUIRE(l_statistics.tilesComputed[0] == 1);
+    REQUIRE(l_statistics.tilesComputed[2] == 0);
+    REQUIRE(l_statistics.tilesComputed[7 * 3 + 2] == 0);
+
+    // overwritten cells wake the tiles around them if their states change
+    for (WavePropagation *l_wave : {&l_waveProp, &l_waveActive})
+    {
+      l_wave->setCellState(650, 55, 6, 1, 0);
+      l_wave->setCellState(100, 55, 5, 0, 0);
+    }
+    requireSameSolution(l_waveProp, l_waveActive, 700, 60, 1, 0.05);
+    l_statistics = l_waveActive.getStepStatistics();
+    REQUIRE(l_statistics.nTilesComputed < 24);
+    REQUIRE(l_statistics.tilesComputed[7 * 3 + 2] == 1);
+    REQUIRE(l_statistics.tilesComputed[6 * 3 + 1] == 1);
+    REQUIRE(l_statistics.tilesComputed[7 * 3] == 0);
+  }
+}
 
-  // steady state
-  for (std::size_t l_ce = 0; l_ce < 49; l_ce++)
+TEST_CASE("Test the wet intervals of the 2d wave propagation solver.", "[WaveProp2dWetIntervals]")
+{
+  /*
+   * Test case:
+   *
+   *   Dam break on a 300x30 grid next to a bottom wall, and the same dam break on a 300x40 grid above ten rows of land.
+   *   The land has to reflect the waves like the wall, although its edges are not solved.
+   */
+  for (bool l_inPlace : {false, true})
   {
-    for (std::size_t l_de = 0; l_de < 100; l_de++)
+    WavePropagationFwave l_waveWall(300, 30, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::WALL, l_inPlace);
+    WavePropagationFwave l_waveLand(300, 40, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::OUTFLOW, l_inPlace);
+
+    for (std::size_t l_cy = 0; l_cy < 40; l_cy++)
     {
-      REQUIRE(m_waveProp.getHeight()[l_ce + l_de * stride] == Approx(10));
-      REQUIRE(m_waveProp.getMomentumX()[l_ce + l_de * stride] == Approx(0));
-      REQUIRE(m_waveProp.getMomentumY()[l_ce + l_de * stride] == Approx(0));
+      for (std::size_t l_cx = 0; l_cx < 300; l_cx++)
+      {
+        // land
+        if (l_cy < 10)
+        {
+          l_waveLand.setHeight(l_cx, l_cy, 0);
+          l_waveLand.setMomentumX(l_cx, l_cy, 0.5);
+          l_waveLand.setBathymetry(l_cx, l_cy, 5);
+          continue;
+        }
+
+        tsunami_lab::t_real l_h = l_cx > 100 && l_cx < 120 && l_cy < 20 ? 10 : 5;
+        tsunami_lab::t_real l_b = -5 - 0.01 * l_cx;
+        l_waveLand.setHeight(l_cx, l_cy, l_h);
+        l_waveLand.setBathymetry(l_cx, l_cy, l_b);
+        l_waveWall.setHeight(l_cx, l_cy - 10, l_h);
+        l_waveWall.setBathymetry(l_cx, l_cy - 10, l_b);
+      }
+    }
+
+    for (unsigned short l_ts = 0; l_ts < 30; l_ts++)
+    {
+      l_waveWall.setGhostOutflow();
+      l_waveWall.timeStep(0.05, 0.05);
+      l_waveLand.setGhostOutflow();
+      l_waveLand.timeStep(0.05, 0.05);
+    }
+
+    std::size_t l_stride = l_waveLand.getStride();
+    for (std::size_t l_cy = 0; l_cy < 40; l_cy++)
+    {
+      for (std::size_t l_cx = 0; l_cx < 300; l_cx++)
+      {
+        std::size_t l_ce = l_cx + l_cy * l_stride;
+        if (l_cy < 10)
+        {
+          REQUIRE(l_waveLand.getHeight()[l_ce] == 0);
+          REQUIRE(l_waveLand.getMomentumX()[l_ce] == 0);
+          REQUIRE(l_waveLand.getMomentumY()[l_ce] == 0);
+        }
+        else
+        {
+          std::size_t l_ceWall = l_cx + (l_cy - 10) * l_stride;
+          REQUIRE(l_waveLand.getHeight()[l_ce] == l_waveWall.getHeight()[l_ceWall]);
+          REQUIRE(l_waveLand.getMomentumX()[l_ce] == l_waveWall.getMomentumX()[l_ceWall]);
+          REQUIRE(l_waveLand.getMomentumY()[l_ce] == l_waveWall.getMomentumY()[l_ceWall]);
+        }
+      }
     }
   }
+}
 
-  // dam-break
-  for (std::size_t l_de = 0; l_de < 100; l_de++)
+TEST_CASE("Test the 2d wave propagation solver inside a persistent parallel region.", "[WaveProp2dPersistentRegion]")
+{
+  /*
+   * Test case:
+   *
+   *   Dam break in a basin with walls, once with a parallel region per call and once inside a single parallel region.
+   *   Both patches have to compute identical states and maximum wave speeds.
+   */
+  for (bool l_inPlace : {false, true})
   {
-    REQUIRE(m_waveProp.getHeight()[49 + l_de * stride] == Approx(10 - 0.1 * 9.394671362));
-    REQUIRE(m_waveProp.getMomentumX()[49 + l_de * stride] == Approx(0 + 0.1 * 88.25985));
-    REQUIRE(m_waveProp.getMomentumY()[49 + l_de * stride] == Approx(0));
+    WavePropagationFwave l_waveCalls(150, 70, Boundary::WALL, Boundary::OUTFLOW, Boundary::WALL, Boundary::OUTFLOW, l_inPlace);
+    WavePropagationFwave l_waveRegion(150, 70, Boundary::WALL, Boundary::OUTFLOW, Boundary::WALL, Boundary::OUTFLOW, l_inPlace);
+    for (WavePropagation *l_wave : {&l_waveCalls, &l_waveRegion})
+    {
+      l_wave->setMaxWaveSpeedTracking(true);
+      for (std::size_t l_cy = 0; l_cy < 70; l_cy++)
+      {
+        for (std::size_t l_cx = 0; l_cx < 150; l_cx++)
+        {
+          int l_dx = int(l_cx) - 40;
+          int l_dy = int(l_cy) - 30;
+          l_wave->setHeight(l_cx, l_cy, l_dx * l_dx + l_dy * l_dy < 200 ? 10 : 5);
+          l_wave->setBathymetry(l_cx, l_cy, -5);
+        }
+      }
+    }
+
+    for (unsigned short l_ts = 0; l_ts < 40; l_ts++)
+      l_waveCalls.timeStep(0.05, 0.05);
+
+#ifdef USEOMP
+#pragma omp parallel
+#endif
+    for (unsigned short l_ts = 0; l_ts < 40; l_ts++)
+      l_waveRegion.timeStep(0.05, 0.05);
 
-    REQUIRE(m_waveProp.getHeight()[50 + l_de * stride] == Approx(8 + 0.1 * 9.394671362));
-    REQUIRE(m_waveProp.getMomentumX()[50 + l_de * stride] == Approx(0 + 0.1 * 88.25985));
-    REQUIRE(m_waveProp.getMomentumY()[50 + l_de * stride] == Approx(0));
+    REQUIRE(l_waveRegion.getMaxWaveSpeed() == l_waveCalls.getMaxWaveSpeed());
+    requireSameCells(l_waveCalls, l_waveRegion, 150, 70);
   }
-  // steady state
-  for (std::size_t l_ce = 51; l_ce < 100; l_ce++)
+}
+
+TEST_CASE("Test the column strips of the 2d wave propagation solver.", "[WaveProp2dStrips]")
+{
+  /*
+   * Test case:
+   *
+   *   Two identical dam breaks on a 6000x20 grid, the first one across the border of the first two strips at column 4096.
+   *   The second one is shifted by 1024 columns and lies inside a strip; both have to compute identical states.
+   */
+  for (bool l_inPlace : {false, true})
   {
-    for (std::size_t l_de = 0; l_de < 100; l_de++)
+    WavePropagationFwave l_waveProp(6000, 20, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::OUTFLOW, l_inPlace);
+    l_waveProp.setActivityThreshold(0);
+    l_waveProp.setStripWidth(4000);
+
+    for (std::size_t l_cy = 0; l_cy < 20; l_cy++)
     {
-      REQUIRE(m_waveProp.getHeight()[l_ce + l_de * stride] == Approx(8));
-      REQUIRE(m_waveProp.getMomentumX()[l_ce + l_de * stride] == Approx(0));
-      REQUIRE(m_waveProp.getMomentumY()[l_ce + l_de * stride] == Approx(0));
+      for (std::size_t l_cx = 0; l_cx < 6000; l_cx++)
+      {
+        std::size_t l_cxDam = l_cx < 4600 ? l_cx : l_cx - 1024;
+        bool l_dam = l_cxDam > 4050 && l_cxDam < 4090 && l_cy > 5 && l_cy < 15;
+        l_waveProp.setHeight(l_cx, l_cy, l_dam ? 10 : 5);
+        l_waveProp.setMomentumX(l_cx, l_cy, l_dam ? 3 : 0);
+        l_waveProp.setBathymetry(l_cx, l_cy, -5);
+      }
     }
+
+    for (unsigned short l_ts = 0; l_ts < 40; l_ts++)
+    {
+      l_waveProp.setGhostOutflow();
+      l_waveProp.timeStep(0.04, 0.04);
+    }
+
+    std::size_t l_stride = l_waveProp.getStride();
+    for (std::size_t l_cy = 0; l_cy < 20; l_cy++)
+    {
+      for (std::size_t l_cx = 3900; l_cx < 4300; l_cx++)
+      {
+        std::size_t l_ce = l_cx + l_cy * l_stride;
+        REQUIRE(l_waveProp.getHeight()[l_ce] == l_waveProp.getHeight()[l_ce + 1024]);
+        REQUIRE(l_waveProp.getMomentumX()[l_ce] == l_waveProp.getMomentumX()[l_ce + 1024]);
+        REQUIRE(l_waveProp.getMomentumY()[l_ce] == l_waveProp.getMomentumY()[l_ce + 1024]);
+      }
+    }
+
+    // the waves crossed the border of the strips
+    REQUIRE(l_waveProp.getHeight()[4100 + 10 * l_stride] > 5);
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test the temporal blocking of the 2d wave propagation solver.", "[WaveProp2dTemporalBlocking]")
+{
+  /*
+   * Test case:
+   *
+   *   Dam break next to an island on a 300x400 grid with walls and outflow boundaries.
+   *   The patch is advanced by blocks of multiple time steps of different ghost widths and by single time steps.
+   *   The tiles split the rows in y-direction, all patches have to compute identical states and maximum wave speeds.
+   */
+  for (tsunami_lab::t_idx l_ghostWidth : {2, 3, 5})
+  {
+    WavePropagationFwave l_waveSteps(300, 400, Boundary::WALL, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::WALL, false);
+    WavePropagationFwave l_waveBlocked(300, 400, Boundary::WALL, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::WALL, false);
+    l_waveBlocked.setGhostWidth(l_ghostWidth);
+    for (WavePropagation *l_wave : {&l_waveSteps, &l_waveBlocked})
+    {
+      l_wave->setMaxWaveSpeedTracking(true);
+      setIslandDamBreak(*l_wave, 400, 140, 0);
+    }
+
+    requireSameSolution(l_waveSteps, l_waveBlocked, 300, 400, 23, 0.05);
+  }
+}
+
+TEST_CASE("Test the task tiles of the 2d wave propagation solver.", "[WaveProp2dTaskTiles]")
+{
+  /*
+   * Test case:
+   *
+   *   Dam break off a coast on a 300x200 grid with walls and outflow boundaries, the land covers most of the upper rows.
+   *   One patch schedules tiles of different heights as tasks and overlaps 23 time steps, the other one advances the time steps one after another.
+   *   Both have to compute identical states and maximum wave speeds, also if the activity is tracked.
+   */
+  for (tsunami_lab::t_idx l_taskRows : {1, 7, 64})
+  {
+    for (tsunami_lab::t_real l_threshold : {-1, 0})
+    {
+      WavePropagationFwave l_waveSteps(300, 200, Boundary::WALL, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::WALL, false);
+      WavePropagationFwave l_waveTasks(300, 200, Boundary::WALL, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::WALL, false);
+      l_waveTasks.setTaskTiles(l_taskRows);
+      for (WavePropagation *l_wave : {&l_waveSteps, &l_waveTasks})
+      {
+        l_wave->setActivityThreshold(l_threshold);
+        l_wave->setMaxWaveSpeedTracking(true);
+        setCoastDamBreak(*l_wave);
+      }
+
+      requireSameSolution(l_waveSteps, l_waveTasks, 300, 200, 23, 0.05);
+
+      // the threads spent time in the tasks
+      std::vector<double> l_busy, l_idle;
+      l_waveTasks.getTaskTimes(l_busy, l_idle);
+      REQUIRE(l_busy.size() == l_idle.size());
+      REQUIRE(std::accumulate(l_busy.begin(), l_busy.end(), 0.0) > 0);
+    }
+  }
+}
+
+TEST_CASE("Test the load balancing of the 2d wave propagation solver.", "[WaveProp2dLoadBalancing]")
+{
+  /*
+   * Test case:
+   *
+   *   Dam break off a coast on a 300x200 grid with walls and outflow boundaries, the land covers most of the upper rows.
+   *   One patch splits the rows evenly, the other one rebalances the blocks every 4 time steps.
+   *   Both have to compute identical states with temporal blocking, in-place updates and local time steps.
+   */
+  for (int l_variant = 0; l_variant < 3; l_variant++)
+  {
+    bool l_inPlace = l_variant == 1;
+    WavePropagationFwave l_waveEven(300, 200, Boundary::WALL, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::WALL, l_inPlace);
+    WavePropagationFwave l_waveBalanced(300, 200, Boundary::WALL, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::WALL, l_inPlace);
+    l_waveBalanced.setLoadBalancing(4);
+    for (WavePropagation *l_wave : {&l_waveEven, &l_waveBalanced})
+    {
+      l_wave->setGhostWidth(3);
+      l_wave->setLocalTimeStepping(l_variant == 2 ? 2 : 0);
+      l_wave->setMaxWaveSpeedTracking(true);
+      setCoastDamBreak(*l_wave);
+    }
+
+    requireSameSolution(l_waveEven, l_waveBalanced, 300, 200, 24, 0.05);
+
+    // the blocks cover the inner rows in order
+    std::vector<tsunami_lab::t_idx> l_blocks;
+    l_waveBalanced.getRowBlocks(l_blocks);
+    REQUIRE(l_blocks.size() >= 2);
+    REQUIRE(l_blocks.front() == 1);
+    REQUIRE(l_blocks.back() == 201);
+    for (std::size_t l_bl = 1; l_bl < l_blocks.size(); l_bl++)
+      REQUIRE(l_blocks[l_bl - 1] <= l_blocks[l_bl]);
+    REQUIRE(l_waveBalanced.getStepStatistics().threadImbalance >= 1);
+  }
+
+  // before any times are measured, the blocks follow the wet cells, thus the last block covers the rows of the land
+  WavePropagationFwave l_wave(300, 200, Boundary::WALL, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::WALL, false);
+  l_wave.setLoadBalancing(1000);
+  for (std::size_t l_cy = 0; l_cy < 200; l_cy++)
+  {
+    for (std::size_t l_cx = 0; l_cx < 300; l_cx++)
+    {
+      bool l_land = l_cy > 60 + l_cx / 10;
+      l_wave.setHeight(l_cx, l_cy, l_land ? 0 : 5);
+      l_wave.setBathymetry(l_cx, l_cy, l_land ? 5 : -5);
+    }
+  }
+  l_wave.timeStep(0.05, 0.05);
+
+  std::vector<tsunami_lab::t_idx> l_blocks;
+  l_wave.getRowBlocks(l_blocks);
+  tsunami_lab::t_idx l_nThreads = l_blocks.size() - 1;
+  if (l_nThreads > 1)
+    REQUIRE(l_blocks[l_nThreads] - l_blocks[l_nThreads - 1] > 200 / l_nThreads);
+}
+
+TEST_CASE("Test the shared cell quantities of the 2d wave propagation solver.", "[WaveProp2dSharedQuantities]")
+{
+  /*
+   * Test case:
+   *
+   *   Dam break next to an island on a 300x200 grid with walls and outflow boundaries.
+   *   One patch precomputes the cell quantities per row, the other one derives them at every edge.
+   *   Both have to compute the same states; the kernels may round differently.
+   */
+  for (bool l_inPlace : {false, true})
+  {
+    WavePropagationFwave l_waveEdges(300, 200, Boundary::WALL, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::WALL, l_inPlace);
+    WavePropagationFwave l_waveShared(300, 200, Boundary::WALL, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::WALL, l_inPlace);
+    l_waveShared.setCellQuantitySharing(true);
+    for (WavePropagation *l_wave : {&l_waveEdges, &l_waveShared})
+      setIslandDamBreak(*l_wave, 200, 100, 1);
+
+    for (unsigned short l_ts = 0; l_ts < 30; l_ts++)
+    {
+      l_waveEdges.timeStep(0.05, 0.05);
+      l_waveShared.timeStep(0.05, 0.05);
+    }
+    requireSameCells(l_waveEdges, l_waveShared, 300, 200, 1E-4);
+
+    // the island stays dry
+    REQUIRE(l_waveShared.getHeight()[115 + 120 * l_waveShared.getStride()] == 0);
+  }
+}
+
+TEST_CASE("Test the quantized bathymetry of the 2d wave propagation solver.", "[WaveProp2dQuantizedBathymetry]")
+{
+  /*
+   * Test case:
+   *
+   *   Ocean at rest on a 200x150 grid with a rough bathymetry between -4000 and -10 and an island.
+   *   The bathymetry spans 3990 meters, which gives the quantization step 0.0625.
+   *   The quantization changes the bathymetry by at most half a step, keeps the surface and the ocean at rest.
+   *   A bump of the surface propagates as in the float patch, up to the changed bathymetry.
+   */
+  WavePropagationFwave l_waveFloat(200, 150, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::OUTFLOW, false);
+  WavePropagationFwave l_waveQuantized(200, 150, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::OUTFLOW, Boundary::OUTFLOW, false);
+  l_waveQuantized.setBathymetryQuantization(true);
+  for (WavePropagation *l_wave : {&l_waveFloat, &l_waveQuantized})
+  {
+    for (std::size_t l_cy = 0; l_cy < 150; l_cy++)
+    {
+      for (std::size_t l_cx = 0; l_cx < 200; l_cx++)
+      {
+        bool l_island = l_cx >= 20 && l_cx < 30 && l_cy >= 40 && l_cy < 50;
+        tsunami_lab::t_real l_b = -4000 + 3990 * tsunami_lab::t_real((l_cx * 37 + l_cy * 91) % 101) / 100;
+        l_wave->setBathymetry(l_cx, l_cy, l_island ? 10 : l_b);
+        l_wave->setHeight(l_cx, l_cy, l_island ? 0 : -l_b);
+        l_wave->setMomentumX(l_cx, l_cy, 0);
+        l_wave->setMomentumY(l_cx, l_cy, 0);
+      }
+    }
+  }
+
+  // ocean at rest
+  for (unsigned short l_ts = 0; l_ts < 20; l_ts++)
+  {
+    l_waveQuantized.setGhostOutflow();
+    l_waveQuantized.timeStep(0.001, 0.001);
+  }
+
+  std::size_t l_stride = l_waveQuantized.getStride();
+  for (std::size_t l_cy = 0; l_cy < 150; l_cy++)
+  {
+    for (std::size_t l_cx = 0; l_cx < 200; l_cx++)
+    {
+      std::size_t l_ce = l_cx + l_cy * l_stride;
+      tsunami_lab::t_real l_b = l_waveFloat.getBathymetry()[l_ce];
+      tsunami_lab::t_real l_bQuantized = l_waveQuantized.getBathymetry()[l_ce];
+      REQUIRE(std::abs(l_bQuantized - l_b) <= tsunami_lab::t_real(0.03125));
+      REQUIRE(std::fmod(l_bQuantized - l_waveQuantized.getBathymetry()[0], tsunami_lab::t_real(0.0625)) == 0);
+
+      if (l_b > 0)
+      {
+        REQUIRE(l_waveQuantized.getHeight()[l_ce] == 0);
+      }
+      else
+      {
+        REQUIRE(l_waveQuantized.getHeight()[l_ce] + l_bQuantized == Approx(0).margin(1E-3));
+      }
+      // rounding noise of the deep ocean; a surface off by one quantization step gives momenta above 1 per step
+      REQUIRE(l_waveQuantized.getMomentumX()[l_ce] == Approx(0).margin(0.1));
+      REQUIRE(l_waveQuantized.getMomentumY()[l_ce] == Approx(0).margin(0.1));
+    }
+  }
+
+  // bump of the surface
+  for (WavePropagation *l_wave : {&l_waveFloat, &l_waveQuantized})
+  {
+    for (std::size_t l_cy = 0; l_cy < 150; l_cy++)
+    {
+      for (std::size_t l_cx = 0; l_cx < 200; l_cx++)
+      {
+        int l_dx = int(l_cx) - 120;
+        int l_dy = int(l_cy) - 75;
+        tsunami_lab::t_real l_b = l_wave->getBathymetry()[l_cx + l_cy * l_stride];
+        if (l_b < 0)
+          l_wave->setHeight(l_cx, l_cy, -l_b + (l_dx * l_dx + l_dy * l_dy < 100 ? 5 : 0));
+        l_wave->setMomentumX(l_cx, l_cy, 0);
+        l_wave->setMomentumY(l_cx, l_cy, 0);
+      }
+    }
+  }
+
+  for (unsigned short l_ts = 0; l_ts < 20; l_ts++)
+  {
+    l_waveFloat.setGhostOutflow();
+    l_waveFloat.timeStep(0.001, 0.001);
+    l_waveQuantized.setGhostOutflow();
+    l_waveQuantized.timeStep(0.001, 0.001);
+  }
+
+  for (std::size_t l_cy = 0; l_cy < 150; l_cy++)
+  {
+    for (std::size_t l_cx = 0; l_cx < 200; l_cx++)
+    {
+      std::size_t l_ce = l_cx + l_cy * l_stride;
+      tsunami_lab::t_real l_surface = l_waveFloat.getHeight()[l_ce] + l_waveFloat.getBathymetry()[l_ce];
+      tsunami_lab::t_real l_surfaceQuantized = l_waveQuantized.getHeight()[l_ce] + l_waveQuantized.getBathymetry()[l_ce];
+      if (l_waveFloat.getBathymetry()[l_ce] > 0)
+        l_surface = l_surfaceQuantized = 0;
+      REQUIRE(l_surfaceQuantized == Approx(l_surface).margin(0.05));
+      REQUIRE(l_waveQuantized.getMomentumX()[l_ce] == Approx(l_waveFloat.getMomentumX()[l_ce]).margin(0.5));
+      REQUIRE(l_waveQuantized.getMomentumY()[l_ce] == Approx(l_waveFloat.getMomentumY()[l_ce]).margin(0.5));
+    }
+  }
+}
+
+TEST_CASE("Test the linearized deep water of the 2d wave propagation solver.", "[WaveProp2dLinearization]")
+{
+  /*
+   * Test case:
+   *
+   *   Ocean of 4000 meters depth on a 300x200 grid, rising to a coast with 50 meters depth at the right boundary.
+   *   A bump of 1 meter in the deep water propagates onto the shelf.
+   *   One patch solves all edges with the F-wave solver, the other one the edges deeper than 1000 meters with the linearized solver.
+   *   Both have to compute the same waves, on the shelf as well as in the deep water.
+   */
+  WavePropagationFwave l_waveNonlinear(300, 200, Boundary::OUTFLOW, Boundary::WALL, Boundary::OUTFLOW, Boundary::OUTFLOW, false);
+  WavePropagationFwave l_waveHybrid(300, 200, Boundary::OUTFLOW, Boundary::WALL, Boundary::OUTFLOW, Boundary::OUTFLOW, false);
+  l_waveHybrid.setLinearization(1000, 0.01);
+  for (WavePropagation *l_wave : {&l_waveNonlinear, &l_waveHybrid})
+  {
+    for (std::size_t l_cy = 0; l_cy < 200; l_cy++)
+    {
+      for (std::size_t l_cx = 0; l_cx < 300; l_cx++)
+      {
+        int l_dx = int(l_cx) - 190;
+        int l_dy = int(l_cy) - 100;
+        tsunami_lab::t_real l_b = l_cx < 200 ? -4000 : -4000 + tsunami_lab::t_real(l_cx - 199) * 39.5;
+        tsunami_lab::t_real l_eta = l_dx * l_dx + l_dy * l_dy < 100 ? 1 : 0;
+        l_wave->setBathymetry(l_cx, l_cy, l_b);
+        l_wave->setHeight(l_cx, l_cy, -l_b + l_eta);
+        l_wave->setMomentumX(l_cx, l_cy, 0);
+        l_wave->setMomentumY(l_cx, l_cy, 0);
+      }
+    }
+  }
+
+  for (unsigned short l_ts = 0; l_ts < 200; l_ts++)
+  {
+    l_waveNonlinear.setGhostOutflow();
+    l_waveNonlinear.timeStep(0.002, 0.002);
+    l_waveHybrid.setGhostOutflow();
+    l_waveHybrid.timeStep(0.002, 0.002);
+  }
+
+  std::size_t l_stride = l_waveNonlinear.getStride();
+  bool l_identical = true;
+  for (std::size_t l_cy = 0; l_cy < 200; l_cy++)
+  {
+    for (std::size_t l_cx = 0; l_cx < 300; l_cx++)
+    {
+      std::size_t l_ce = l_cx + l_cy * l_stride;
+      REQUIRE(l_waveHybrid.getHeight()[l_ce] == Approx(l_waveNonlinear.getHeight()[l_ce]).margin(0.01));
+      REQUIRE(l_waveHybrid.getMomentumX()[l_ce] == Approx(l_waveNonlinear.getMomentumX()[l_ce]).margin(1.5));
+      REQUIRE(l_waveHybrid.getMomentumY()[l_ce] == Approx(l_waveNonlinear.getMomentumY()[l_ce]).margin(1.5));
+      l_identical = l_identical && l_waveHybrid.getHeight()[l_ce] == l_waveNonlinear.getHeight()[l_ce];
+    }
+  }
+
+  // the deep water was linearized
+  REQUIRE(!l_identical);
+
+  // the wave reached the shelf
+  REQUIRE(l_waveHybrid.getHeight()[260 + 100 * l_stride] + l_waveHybrid.getBathymetry()[260 + 100 * l_stride] > 0.01);
+}
+
+TEST_CASE("Test the local time stepping of the 2d wave propagation solver.", "[WaveProp2dLocalTimeStepping]")
+{
+  /*
+   * Test case:
+   *
+   *   Basin with walls on a 200x100 grid: ocean of 4000 meters depth, rising to a shelf of 40 meters depth and dry land at the right side.
+   *   A bump of 1 meter in the deep water propagates onto the shelf.
+   *   One patch advances all cells with the global time step, two with three levels of local time steps, which take eight times larger time steps.
+   *   The local time steps have to conserve the water volume and compute the same waves as the global ones with fewer cell updates.
+   *   The local time steps of a single thread and of the default team have to compute identical states.
+   */
+  WavePropagationFwave l_waveGlobal(200, 100, Boundary::WALL, Boundary::WALL, Boundary::WALL, Boundary::WALL, false);
+  WavePropagationFwave l_waveLocal(200, 100, Boundary::WALL, Boundary::WALL, Boundary::WALL, Boundary::WALL, false);
+  WavePropagationFwave l_waveSerial(200, 100, Boundary::WALL, Boundary::WALL, Boundary::WALL, Boundary::WALL, true);
+  l_waveLocal.setLocalTimeStepping(3);
+  l_waveSerial.setLocalTimeStepping(3);
+  for (WavePropagation *l_wave : {&l_waveGlobal, &l_waveLocal, &l_waveSerial})
+  {
+    l_wave->setMaxWaveSpeedTracking(true);
+    for (std::size_t l_cy = 0; l_cy < 100; l_cy++)
+    {
+      for (std::size_t l_cx = 0; l_cx < 200; l_cx++)
+      {
+        int l_dx = int(l_cx) - 60;
+        int l_dy = int(l_cy) - 50;
+        tsunami_lab::t_real l_b = l_cx < 100 ? -4000 : -4000 + tsunami_lab::t_real(l_cx - 99) * 99;
+        l_b = std::min(l_b, tsunami_lab::t_real(-40));
+        if (l_cx >= 190)
+          l_b = 10;
+        tsunami_lab::t_real l_eta = l_dx * l_dx + l_dy * l_dy < 100 ? 1 : 0;
+        l_wave->setBathymetry(l_cx, l_cy, l_b);
+        l_wave->setHeight(l_cx, l_cy, l_b < 0 ? -l_b + l_eta : 0);
+        l_wave->setMomentumX(l_cx, l_cy, 0);
+        l_wave->setMomentumY(l_cx, l_cy, 0);
+      }
+    }
+  }
+
+  std::size_t l_stride = l_waveGlobal.getStride();
+  double l_volume = 0;
+  for (std::size_t l_cy = 0; l_cy < 100; l_cy++)
+    for (std::size_t l_cx = 0; l_cx < 200; l_cx++)
+      l_volume += l_waveGlobal.getHeight()[l_cx + l_cy * l_stride];
+
+  for (unsigned short l_ts = 0; l_ts < 400; l_ts++)
+    l_waveGlobal.timeStep(0.002, 0.002);
+  for (unsigned short l_ts = 0; l_ts < 50; l_ts++)
+    l_waveLocal.timeStep(0.016, 0.016);
+#ifdef USEOMP
+#pragma omp parallel num_threads(1)
+#endif
+  for (unsigned short l_ts = 0; l_ts < 50; l_ts++)
+    l_waveSerial.timeStep(0.016, 0.016);
+
+  double l_volumeLocal = 0;
+  for (std::size_t l_cy = 0; l_cy < 100; l_cy++)
+  {
+    for (std::size_t l_cx = 0; l_cx < 200; l_cx++)
+    {
+      std::size_t l_ce = l_cx + l_cy * l_stride;
+      REQUIRE(l_waveLocal.getHeight()[l_ce] == Approx(l_waveGlobal.getHeight()[l_ce]).margin(0.05));
+      REQUIRE(l_waveLocal.getMomentumX()[l_ce] == Approx(l_waveGlobal.getMomentumX()[l_ce]).margin(2));
+      REQUIRE(l_waveLocal.getMomentumY()[l_ce] == Approx(l_waveGlobal.getMomentumY()[l_ce]).margin(2));
+      l_volumeLocal += l_waveLocal.getHeight()[l_ce];
+    }
+  }
+  requireSameCells(l_waveLocal, l_waveSerial, 200, 100);
+
+  // the heights of 4000 meters are rounded to 2.4e-4 meters in every update, which changes the volume of the global time steps by about 175 m^3 as well
+  REQUIRE(l_volumeLocal == Approx(l_volume).epsilon(1e-5));
+  REQUIRE(l_waveLocal.getMaxWaveSpeed() == Approx(l_waveGlobal.getMaxWaveSpeed()).epsilon(0.01));
+
+  // the wave reached the shelf, whose cells advance eight micro steps at once
+  REQUIRE(l_waveLocal.getHeight()[140 + 50 * l_stride] + l_waveLocal.getBathymetry()[140 + 50 * l_stride] > 0.01);
+  tsunami_lab::patches::WavePropagation::StepStatistics l_statistics = l_waveLocal.getStepStatistics();
+  REQUIRE(l_statistics.nCellUpdatesGlobal == 8 * 190 * 100);
+  REQUIRE(l_statistics.nCellUpdates < l_statistics.nCellUpdatesGlobal * 3 / 4);
+}
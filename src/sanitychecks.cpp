@@ -96,10 +96,10 @@ TEST_CASE("Middle states sanity check using middle_states.csv", "[MiddleStates]"
                                                                 l_xdis);
       // construct solver
       tsunami_lab::patches::WavePropagation *l_waveProp;
-      l_waveProp = new tsunami_lab::patches::WavePropagation1d(l_nx, 
-                                                               l_solver,
-                                                               Boundary::OUTFLOW,
-                                                               Boundary::OUTFLOW);
+      l_waveProp = tsunami_lab::patches::createWavePropagation1d(l_nx,
+                                                                 l_solver,
+                                                                 Boundary::OUTFLOW,
+                                                                 Boundary::OUTFLOW);
 
       // maximum observed height in the setup
       tsunami_lab::t_real l_hMax = std::numeric_limits<tsunami_lab::t_real>::lowest();
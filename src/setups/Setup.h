@@ -68,6 +68,24 @@ public:
    **/
   virtual t_real getBathymetry(t_real i_x,
                                t_real i_y) const = 0;
+
+  /**
+   * Gets the mean bathymetry of a cell, e.g., of a refined patch with a smaller cell size than the data.
+   * The default samples the bathymetry at the cell's center.
+   *
+   * @param i_x x-coordinate of the cell's center.
+   * @param i_y y-coordinate of the cell's center.
+   * @param i_dx extent of the cell in x-direction.
+   * @param i_dy extent of the cell in y-direction.
+   * @return mean bathymetry of the cell.
+   **/
+  virtual t_real getCellBathymetry(t_real i_x,
+                                   t_real i_y,
+                                   t_real,
+                                   t_real) const
+  {
+    return getBathymetry(i_x, i_y);
+  }
 };
 
 #endif
\ No newline at end of file
@@ -31,10 +31,12 @@ tsunami_lab::setups::TsunamiEvent2d::TsunamiEvent2d(const char *i_bathymetryPath
 {
     m_bathymetryPath = i_bathymetryPath;
     m_displacementPath = i_displacementPath;
+    m_bathymetryExists = exists(i_bathymetryPath);
+    m_displacementExists = exists(i_displacementPath);
 
-    std::cout <<i_bathymetryPath <<" : "<<exists(i_bathymetryPath) << std::endl;
+    std::cout <<i_bathymetryPath <<" : "<<m_bathymetryExists << std::endl;
 
-    if (exists(i_bathymetryPath))
+    if (m_bathymetryExists)
     {
         netcdf::getDimensionSize(i_bathymetryPath,
                                  "x",
@@ -43,7 +45,7 @@ tsunami_lab::setups::TsunamiEvent2d::TsunamiEvent2d(const char *i_bathymetryPath
                                  "y",
                                  m_nyB);
     }
-    if (exists(i_displacementPath))
+    if (m_displacementExists)
     {
         netcdf::getDimensionSize(i_displacementPath,
                                  "x",
@@ -56,7 +58,7 @@ tsunami_lab::setups::TsunamiEvent2d::TsunamiEvent2d(const char *i_bathymetryPath
     m_xDataB = new t_real[m_nxB];
     m_yDataB = new t_real[m_nyB];
     m_b = new t_real[m_nxB * m_nyB];
-    if (exists(i_bathymetryPath))
+    if (m_bathymetryExists)
     {
         netcdf::read(i_bathymetryPath,
                      "z",
@@ -79,7 +81,7 @@ tsunami_lab::setups::TsunamiEvent2d::TsunamiEvent2d(const char *i_bathymetryPath
     m_xDataD = new t_real[m_nxD];
     m_yDataD = new t_real[m_nyD];
     m_d = new t_real[m_nxD * m_nyD];
-    if (exists(i_displacementPath))
+    if (m_displacementExists)
     {
         netcdf::read(i_displacementPath,
                      "z",
@@ -110,7 +112,7 @@ tsunami_lab::setups::TsunamiEvent2d::~TsunamiEvent2d()
 tsunami_lab::t_real tsunami_lab::setups::TsunamiEvent2d::getBathymetryFromArray(t_real i_x,
                                                                                 t_real i_y) const
 {
-    if (!exists(m_bathymetryPath))
+    if (!m_bathymetryExists)
         return 0;
 
     t_real l_x = (i_x - m_bathymetryOffsetX) * m_bathymetrySampleDistanceXInverse;
@@ -129,7 +131,7 @@ tsunami_lab::t_real tsunami_lab::setups::TsunamiEvent2d::getBathymetryFromArray(
 tsunami_lab::t_real tsunami_lab::setups::TsunamiEvent2d::getDisplacementFromArray(t_real i_x,
                                                                                   t_real i_y) const
 {
-    if (!exists(m_displacementPath))
+    if (!m_displacementExists)
         return 0;
 
     t_real l_x = (i_x - m_displacementOffsetX) * m_displacementSampleDistanceXInverse;
@@ -186,4 +188,37 @@ tsunami_lab::t_real tsunami_lab::setups::TsunamiEvent2d::getBathymetry(t_real i_
     {
         return std::max(l_bath, m_delta) + l_displ;
     }
-}
\ No newline at end of file
+}
+
+tsunami_lab::t_real tsunami_lab::setups::TsunamiEvent2d::getCellBathymetry(t_real i_x,
+                                                                           t_real i_y,
+                                                                           t_real i_dx,
+                                                                           t_real i_dy) const
+{
+    if (!m_bathymetryExists)
+        return getBathymetry(i_x, i_y);
+
+    // samples [begin, end) inside the cell
+    t_idx l_xBegin = std::clamp(std::ceil((i_x - 0.5 * i_dx - m_bathymetryOffsetX) * m_bathymetrySampleDistanceXInverse), 0.0, double(m_nxB));
+    t_idx l_xEnd = std::clamp(std::ceil((i_x + 0.5 * i_dx - m_bathymetryOffsetX) * m_bathymetrySampleDistanceXInverse), 0.0, double(m_nxB));
+    t_idx l_yBegin = std::clamp(std::ceil((i_y - 0.5 * i_dy - m_bathymetryOffsetY) * m_bathymetrySampleDistanceYInverse), 0.0, double(m_nyB));
+    t_idx l_yEnd = std::clamp(std::ceil((i_y + 0.5 * i_dy - m_bathymetryOffsetY) * m_bathymetrySampleDistanceYInverse), 0.0, double(m_nyB));
+
+    // the cell is smaller than the sample distance or outside of the data
+    if (l_xBegin >= l_xEnd || l_yBegin >= l_yEnd)
+        return getBathymetry(i_x, i_y);
+
+    // the samples are clamped like in getBathymetry, the displacement is smooth and taken at the center
+    double l_sum = 0;
+    for (t_idx l_iy = l_yBegin; l_iy < l_yEnd; l_iy++)
+    {
+        for (t_idx l_ix = l_xBegin; l_ix < l_xEnd; l_ix++)
+        {
+            t_real l_bath = m_b[l_ix + m_nxB * l_iy];
+            l_sum += l_bath < 0 ? std::min(l_bath, -m_delta) : std::max(l_bath, m_delta);
+        }
+    }
+    t_real l_mean = l_sum / double((l_xEnd - l_xBegin) * (l_yEnd - l_yBegin));
+
+    return l_mean + getDisplacementFromArray(i_x, i_y);
+}
@@ -32,6 +32,10 @@ private:
   const char *m_bathymetryPath;
   //! displacement file path
   const char *m_displacementPath;
+  //! true if the bathymetry file exists, checked once by the constructor
+  bool m_bathymetryExists = false;
+  //! true if the displacement file exists, checked once by the constructor
+  bool m_displacementExists = false;
   //! offset of the bathymetry domain in x-direction
   t_real m_bathymetryOffsetX = 0;
   //! offset of the displacement domain in y-direction
@@ -149,6 +153,20 @@ public:
    **/
   t_real getBathymetry(t_real i_x,
                        t_real i_y) const;
+
+  /**
+   * Gets the mean bathymetry of a cell.
+   * The bathymetry samples inside the cell are averaged, a cell smaller than the sample distance takes the nearest sample.
+   * @param i_x x-coordinate of the cell's center
+   * @param i_y y-coordinate of the cell's center
+   * @param i_dx extent of the cell in x-direction
+   * @param i_dy extent of the cell in y-direction
+   * @return mean bathymetry of the cell.
+   **/
+  t_real getCellBathymetry(t_real i_x,
+                           t_real i_y,
+                           t_real i_dx,
+                           t_real i_dy) const;
 };
 
 #endif
\ No newline at end of file
@@ -8,6 +8,10 @@
 #include "Fwave.h"
 #include <cmath>
 
+#ifdef TSUNAMI_LAB_ISA_X86
+#include <immintrin.h>
+#endif
+
 void tsunami_lab::solvers::Fwave::computeEigenvalues(t_real i_hL,
                                                      t_real i_hR,
                                                      t_real i_uL,
@@ -121,3 +125,743 @@ void tsunami_lab::solvers::Fwave::netUpdates(t_real i_hL,
       o_netUpdateR[l_qt] += z2[l_qt];
   }
 }
+
+void tsunami_lab::solvers::Fwave::netUpdatesBatchScalar(t_idx i_first,
+                                                        t_idx i_last,
+                                                        t_real const *i_hL,
+                                                        t_real const *i_hR,
+                                                        t_real const *i_huL,
+                                                        t_real const *i_huR,
+                                                        t_real const *i_bL,
+                                                        t_real const *i_bR,
+                                                        t_real *o_netUpdateLH,
+                                                        t_real *o_netUpdateLHu,
+                                                        t_real *o_netUpdateRH,
+                                                        t_real *o_netUpdateRHu)
+{
+  for (t_idx l_ed = i_first; l_ed < i_last; l_ed++)
+  {
+    t_real l_hL = i_hL[l_ed];
+    t_real l_hR = i_hR[l_ed];
+    t_real l_huL = i_huL[l_ed];
+    t_real l_huR = i_huR[l_ed];
+
+    // dry edges have no net-updates
+    if (l_hL == 0 && l_hR == 0)
+    {
+      o_netUpdateLH[l_ed] = 0;
+      o_netUpdateLHu[l_ed] = 0;
+      o_netUpdateRH[l_ed] = 0;
+      o_netUpdateRHu[l_ed] = 0;
+      continue;
+    }
+
+    // compute particle velocities
+    t_real l_uL = l_hL != 0 ? (l_huL / l_hL) : 0;
+    t_real l_uR = l_hR != 0 ? (l_huR / l_hR) : 0;
+
+    // compute eigenvalues
+    t_real l_hSqrtL = std::sqrt(l_hL);
+    t_real l_hSqrtR = std::sqrt(l_hR);
+    t_real l_hRoe = t_real(0.5) * (l_hL + l_hR);
+    t_real l_uRoe = (l_hSqrtL * l_uL + l_hSqrtR * l_uR) / (l_hSqrtL + l_hSqrtR);
+    t_real l_ghSqrtRoe = m_gSqrt * std::sqrt(l_hRoe);
+    t_real l_s1 = l_uRoe - l_ghSqrtRoe;
+    t_real l_s2 = l_uRoe + l_ghSqrtRoe;
+
+    // compute eigencoefficients
+    t_real l_detInv = 1 / (l_s2 - l_s1);
+    t_real l_fDelta0 = l_huR - l_huL;
+    t_real l_fDelta1 = (l_huR * l_uR + l_gHalf * l_hR * l_hR) - (l_huL * l_uL + l_gHalf * l_hL * l_hL);
+    l_fDelta1 += l_gHalf * (i_bR[l_ed] - i_bL[l_ed]) * (l_hL + l_hR);
+    t_real l_a1 = l_detInv * l_s2 * l_fDelta0 - l_detInv * l_fDelta1;
+    t_real l_a2 = l_detInv * l_fDelta1 - l_detInv * l_s1 * l_fDelta0;
+
+    // assign the waves to the sides depending on the wave speeds
+    t_real l_z1[2] = {l_a1, l_a1 * l_s1};
+    t_real l_z2[2] = {l_a2, l_a2 * l_s2};
+
+    o_netUpdateLH[l_ed] = (l_s1 < 0 ? l_z1[0] : 0) + (l_s2 < 0 ? l_z2[0] : 0);
+    o_netUpdateLHu[l_ed] = (l_s1 < 0 ? l_z1[1] : 0) + (l_s2 < 0 ? l_z2[1] : 0);
+    o_netUpdateRH[l_ed] = (l_s1 < 0 ? 0 : l_z1[0]) + (l_s2 < 0 ? 0 : l_z2[0]);
+    o_netUpdateRHu[l_ed] = (l_s1 < 0 ? 0 : l_z1[1]) + (l_s2 < 0 ? 0 : l_z2[1]);
+  }
+}
+
+void tsunami_lab::solvers::Fwave::netUpdatesBatchScalar(t_idx i_first,
+                                                        t_idx i_last,
+                                                        t_real const *i_hL,
+                                                        t_real const *i_hR,
+                                                        t_real const *i_huL,
+                                                        t_real const *i_huR,
+                                                        t_real const *i_bL,
+                                                        t_real const *i_bR,
+                                                        t_real const *i_hSqrtL,
+                                                        t_real const *i_hSqrtR,
+                                                        t_real const *i_uL,
+                                                        t_real const *i_uR,
+                                                        t_real const *i_fluxL,
+                                                        t_real const *i_fluxR,
+                                                        t_real *o_netUpdateLH,
+                                                        t_real *o_netUpdateLHu,
+                                                        t_real *o_netUpdateRH,
+                                                        t_real *o_netUpdateRHu)
+{
+  for (t_idx l_ed = i_first; l_ed < i_last; l_ed++)
+  {
+    t_real l_hL = i_hL[l_ed];
+    t_real l_hR = i_hR[l_ed];
+    t_real l_huL = i_huL[l_ed];
+    t_real l_huR = i_huR[l_ed];
+
+    // dry edges have no net-updates
+    if (l_hL == 0 && l_hR == 0)
+    {
+      o_netUpdateLH[l_ed] = 0;
+      o_netUpdateLHu[l_ed] = 0;
+      o_netUpdateRH[l_ed] = 0;
+      o_netUpdateRHu[l_ed] = 0;
+      continue;
+    }
+
+    // compute eigenvalues
+    t_real l_hSqrtL = i_hSqrtL[l_ed];
+    t_real l_hSqrtR = i_hSqrtR[l_ed];
+    t_real l_hRoe = t_real(0.5) * (l_hL + l_hR);
+    t_real l_uRoe = (l_hSqrtL * i_uL[l_ed] + l_hSqrtR * i_uR[l_ed]) / (l_hSqrtL + l_hSqrtR);
+    t_real l_ghSqrtRoe = m_gSqrt * std::sqrt(l_hRoe);
+    t_real l_s1 = l_uRoe - l_ghSqrtRoe;
+    t_real l_s2 = l_uRoe + l_ghSqrtRoe;
+
+    // compute eigencoefficients
+    t_real l_detInv = 1 / (l_s2 - l_s1);
+    t_real l_fDelta0 = l_huR - l_huL;
+    t_real l_fDelta1 = i_fluxR[l_ed] - i_fluxL[l_ed];
+    l_fDelta1 += l_gHalf * (i_bR[l_ed] - i_bL[l_ed]) * (l_hL + l_hR);
+    t_real l_a1 = l_detInv * l_s2 * l_fDelta0 - l_detInv * l_fDelta1;
+    t_real l_a2 = l_detInv * l_fDelta1 - l_detInv * l_s1 * l_fDelta0;
+
+    // assign the waves to the sides depending on the wave speeds
+    t_real l_z1[2] = {l_a1, l_a1 * l_s1};
+    t_real l_z2[2] = {l_a2, l_a2 * l_s2};
+
+    o_netUpdateLH[l_ed] = (l_s1 < 0 ? l_z1[0] : 0) + (l_s2 < 0 ? l_z2[0] : 0);
+    o_netUpdateLHu[l_ed] = (l_s1 < 0 ? l_z1[1] : 0) + (l_s2 < 0 ? l_z2[1] : 0);
+    o_netUpdateRH[l_ed] = (l_s1 < 0 ? 0 : l_z1[0]) + (l_s2 < 0 ? 0 : l_z2[0]);
+    o_netUpdateRHu[l_ed] = (l_s1 < 0 ? 0 : l_z1[1]) + (l_s2 < 0 ? 0 : l_z2[1]);
+  }
+}
+
+#ifdef TSUNAMI_LAB_ISA_X86
+TSUNAMI_LAB_TARGET_SSE2 tsunami_lab::t_idx tsunami_lab::solvers::Fwave::netUpdatesBatchSse2(t_idx i_nEdges,
+                                                                                            t_real const *i_hL,
+                                                                                            t_real const *i_hR,
+                                                                                            t_real const *i_huL,
+                                                                                            t_real const *i_huR,
+                                                                                            t_real const *i_bL,
+                                                                                            t_real const *i_bR,
+                                                                                            t_real *o_netUpdateLH,
+                                                                                            t_real *o_netUpdateLHu,
+                                                                                            t_real *o_netUpdateRH,
+                                                                                            t_real *o_netUpdateRHu)
+{
+  static_assert(sizeof(t_real) == sizeof(float), "the SSE2 kernel requires single precision");
+
+  __m128 const l_zero = _mm_setzero_ps();
+  __m128 const l_one = _mm_set1_ps(1);
+  __m128 const l_half = _mm_set1_ps(0.5);
+  __m128 const l_gSqrtV = _mm_set1_ps(m_gSqrt);
+  __m128 const l_gHalfV = _mm_set1_ps(l_gHalf);
+
+  t_idx l_ed = 0;
+  for (; l_ed + 4 <= i_nEdges; l_ed += 4)
+  {
+    __m128 l_hL = _mm_loadu_ps(i_hL + l_ed);
+    __m128 l_hR = _mm_loadu_ps(i_hR + l_ed);
+    __m128 l_huL = _mm_loadu_ps(i_huL + l_ed);
+    __m128 l_huR = _mm_loadu_ps(i_huR + l_ed);
+    __m128 l_bL = _mm_loadu_ps(i_bL + l_ed);
+    __m128 l_bR = _mm_loadu_ps(i_bR + l_ed);
+
+    // masks of wet sides; lanes with two dry sides are zeroed at the end
+    __m128 l_wetL = _mm_cmpneq_ps(l_hL, l_zero);
+    __m128 l_wetR = _mm_cmpneq_ps(l_hR, l_zero);
+    __m128 l_wet = _mm_or_ps(l_wetL, l_wetR);
+
+    // compute particle velocities; dry sides divide by one
+    __m128 l_hDivL = _mm_or_ps(_mm_and_ps(l_wetL, l_hL), _mm_andnot_ps(l_wetL, l_one));
+    __m128 l_hDivR = _mm_or_ps(_mm_and_ps(l_wetR, l_hR), _mm_andnot_ps(l_wetR, l_one));
+    __m128 l_uL = _mm_and_ps(_mm_div_ps(l_huL, l_hDivL), l_wetL);
+    __m128 l_uR = _mm_and_ps(_mm_div_ps(l_huR, l_hDivR), l_wetR);
+
+    // compute eigenvalues
+    __m128 l_hSqrtL = _mm_sqrt_ps(l_hL);
+    __m128 l_hSqrtR = _mm_sqrt_ps(l_hR);
+    __m128 l_hRoe = _mm_mul_ps(l_half, _mm_add_ps(l_hL, l_hR));
+    __m128 l_uRoe = _mm_add_ps(_mm_mul_ps(l_hSqrtL, l_uL), _mm_mul_ps(l_hSqrtR, l_uR));
+    __m128 l_hSqrtSum = _mm_add_ps(l_hSqrtL, l_hSqrtR);
+    l_uRoe = _mm_div_ps(l_uRoe, _mm_or_ps(_mm_and_ps(l_wet, l_hSqrtSum), _mm_andnot_ps(l_wet, l_one)));
+    __m128 l_ghSqrtRoe = _mm_mul_ps(l_gSqrtV, _mm_sqrt_ps(l_hRoe));
+    __m128 l_s1 = _mm_sub_ps(l_uRoe, l_ghSqrtRoe);
+    __m128 l_s2 = _mm_add_ps(l_uRoe, l_ghSqrtRoe);
+
+    // compute eigencoefficients
+    __m128 l_sDiff = _mm_sub_ps(l_s2, l_s1);
+    __m128 l_detInv = _mm_div_ps(l_one, _mm_or_ps(_mm_and_ps(l_wet, l_sDiff), _mm_andnot_ps(l_wet, l_one)));
+    __m128 l_fDelta0 = _mm_sub_ps(l_huR, l_huL);
+    __m128 l_fluxR = _mm_add_ps(_mm_mul_ps(l_huR, l_uR), _mm_mul_ps(_mm_mul_ps(l_gHalfV, l_hR), l_hR));
+    __m128 l_fluxL = _mm_add_ps(_mm_mul_ps(l_huL, l_uL), _mm_mul_ps(_mm_mul_ps(l_gHalfV, l_hL), l_hL));
+    __m128 l_fDelta1 = _mm_sub_ps(l_fluxR, l_fluxL);
+    l_fDelta1 = _mm_add_ps(l_fDelta1,
+                           _mm_mul_ps(_mm_mul_ps(l_gHalfV, _mm_sub_ps(l_bR, l_bL)), _mm_add_ps(l_hL, l_hR)));
+    __m128 l_a1 = _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(l_detInv, l_s2), l_fDelta0), _mm_mul_ps(l_detInv, l_fDelta1));
+    __m128 l_a2 = _mm_sub_ps(_mm_mul_ps(l_detInv, l_fDelta1), _mm_mul_ps(_mm_mul_ps(l_detInv, l_s1), l_fDelta0));
+    l_a1 = _mm_and_ps(l_a1, l_wet);
+    l_a2 = _mm_and_ps(l_a2, l_wet);
+
+    // assign the waves to the sides depending on the wave speeds
+    __m128 l_leftGoing1 = _mm_cmplt_ps(l_s1, l_zero);
+    __m128 l_leftGoing2 = _mm_cmplt_ps(l_s2, l_zero);
+    __m128 l_z1Hu = _mm_mul_ps(l_a1, l_s1);
+    __m128 l_z2Hu = _mm_mul_ps(l_a2, l_s2);
+
+    _mm_storeu_ps(o_netUpdateLH + l_ed, _mm_add_ps(_mm_and_ps(l_a1, l_leftGoing1),
+                                                   _mm_and_ps(l_a2, l_leftGoing2)));
+    _mm_storeu_ps(o_netUpdateLHu + l_ed, _mm_add_ps(_mm_and_ps(l_z1Hu, l_leftGoing1),
+                                                    _mm_and_ps(l_z2Hu, l_leftGoing2)));
+    _mm_storeu_ps(o_netUpdateRH + l_ed, _mm_add_ps(_mm_andnot_ps(l_leftGoing1, l_a1),
+                                                   _mm_andnot_ps(l_leftGoing2, l_a2)));
+    _mm_storeu_ps(o_netUpdateRHu + l_ed, _mm_add_ps(_mm_andnot_ps(l_leftGoing1, l_z1Hu),
+                                                    _mm_andnot_ps(l_leftGoing2, l_z2Hu)));
+  }
+
+  return l_ed;
+}
+
+TSUNAMI_LAB_TARGET_AVX2 tsunami_lab::t_idx tsunami_lab::solvers::Fwave::netUpdatesBatchAvx2(t_idx i_nEdges,
+                                                                                            t_real const *i_hL,
+                                                                                            t_real const *i_hR,
+                                                                                            t_real const *i_huL,
+                                                                                            t_real const *i_huR,
+                                                                                            t_real const *i_bL,
+                                                                                            t_real const *i_bR,
+                                                                                            t_real *o_netUpdateLH,
+                                                                                            t_real *o_netUpdateLHu,
+                                                                                            t_real *o_netUpdateRH,
+                                                                                            t_real *o_netUpdateRHu)
+{
+  static_assert(sizeof(t_real) == sizeof(float), "the AVX2 kernel requires single precision");
+
+  __m256 const l_zero = _mm256_setzero_ps();
+  __m256 const l_one = _mm256_set1_ps(1);
+  __m256 const l_half = _mm256_set1_ps(0.5);
+  __m256 const l_gSqrtV = _mm256_set1_ps(m_gSqrt);
+  __m256 const l_gHalfV = _mm256_set1_ps(l_gHalf);
+
+  t_idx l_ed = 0;
+  for (; l_ed + 8 <= i_nEdges; l_ed += 8)
+  {
+    __m256 l_hL = _mm256_loadu_ps(i_hL + l_ed);
+    __m256 l_hR = _mm256_loadu_ps(i_hR + l_ed);
+    __m256 l_huL = _mm256_loadu_ps(i_huL + l_ed);
+    __m256 l_huR = _mm256_loadu_ps(i_huR + l_ed);
+    __m256 l_bL = _mm256_loadu_ps(i_bL + l_ed);
+    __m256 l_bR = _mm256_loadu_ps(i_bR + l_ed);
+
+    // masks of wet sides; lanes with two dry sides are zeroed at the end
+    __m256 l_wetL = _mm256_cmp_ps(l_hL, l_zero, _CMP_NEQ_OQ);
+    __m256 l_wetR = _mm256_cmp_ps(l_hR, l_zero, _CMP_NEQ_OQ);
+    __m256 l_wet = _mm256_or_ps(l_wetL, l_wetR);
+
+    // compute particle velocities
+    __m256 l_uL = _mm256_and_ps(_mm256_div_ps(l_huL, _mm256_blendv_ps(l_one, l_hL, l_wetL)), l_wetL);
+    __m256 l_uR = _mm256_and_ps(_mm256_div_ps(l_huR, _mm256_blendv_ps(l_one, l_hR, l_wetR)), l_wetR);
+
+    // compute eigenvalues
+    __m256 l_hSqrtL = _mm256_sqrt_ps(l_hL);
+    __m256 l_hSqrtR = _mm256_sqrt_ps(l_hR);
+    __m256 l_hRoe = _mm256_mul_ps(l_half, _mm256_add_ps(l_hL, l_hR));
+    __m256 l_uRoe = _mm256_add_ps(_mm256_mul_ps(l_hSqrtL, l_uL), _mm256_mul_ps(l_hSqrtR, l_uR));
+    l_uRoe = _mm256_div_ps(l_uRoe, _mm256_blendv_ps(l_one, _mm256_add_ps(l_hSqrtL, l_hSqrtR), l_wet));
+    __m256 l_ghSqrtRoe = _mm256_mul_ps(l_gSqrtV, _mm256_sqrt_ps(l_hRoe));
+    __m256 l_s1 = _mm256_sub_ps(l_uRoe, l_ghSqrtRoe);
+    __m256 l_s2 = _mm256_add_ps(l_uRoe, l_ghSqrtRoe);
+
+    // compute eigencoefficients
+    __m256 l_detInv = _mm256_div_ps(l_one, _mm256_blendv_ps(l_one, _mm256_sub_ps(l_s2, l_s1), l_wet));
+    __m256 l_fDelta0 = _mm256_sub_ps(l_huR, l_huL);
+    __m256 l_fluxR = _mm256_add_ps(_mm256_mul_ps(l_huR, l_uR), _mm256_mul_ps(_mm256_mul_ps(l_gHalfV, l_hR), l_hR));
+    __m256 l_fluxL = _mm256_add_ps(_mm256_mul_ps(l_huL, l_uL), _mm256_mul_ps(_mm256_mul_ps(l_gHalfV, l_hL), l_hL));
+    __m256 l_fDelta1 = _mm256_sub_ps(l_fluxR, l_fluxL);
+    l_fDelta1 = _mm256_add_ps(l_fDelta1,
+                              _mm256_mul_ps(_mm256_mul_ps(l_gHalfV, _mm256_sub_ps(l_bR, l_bL)), _mm256_add_ps(l_hL, l_hR)));
+    __m256 l_a1 = _mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(l_detInv, l_s2), l_fDelta0), _mm256_mul_ps(l_detInv, l_fDelta1));
+    __m256 l_a2 = _mm256_sub_ps(_mm256_mul_ps(l_detInv, l_fDelta1), _mm256_mul_ps(_mm256_mul_ps(l_detInv, l_s1), l_fDelta0));
+    l_a1 = _mm256_and_ps(l_a1, l_wet);
+    l_a2 = _mm256_and_ps(l_a2, l_wet);
+
+    // assign the waves to the sides depending on the wave speeds
+    __m256 l_leftGoing1 = _mm256_cmp_ps(l_s1, l_zero, _CMP_LT_OQ);
+    __m256 l_leftGoing2 = _mm256_cmp_ps(l_s2, l_zero, _CMP_LT_OQ);
+    __m256 l_z1Hu = _mm256_mul_ps(l_a1, l_s1);
+    __m256 l_z2Hu = _mm256_mul_ps(l_a2, l_s2);
+
+    _mm256_storeu_ps(o_netUpdateLH + l_ed, _mm256_add_ps(_mm256_and_ps(l_a1, l_leftGoing1),
+                                                         _mm256_and_ps(l_a2, l_leftGoing2)));
+    _mm256_storeu_ps(o_netUpdateLHu + l_ed, _mm256_add_ps(_mm256_and_ps(l_z1Hu, l_leftGoing1),
+                                                          _mm256_and_ps(l_z2Hu, l_leftGoing2)));
+    _mm256_storeu_ps(o_netUpdateRH + l_ed, _mm256_add_ps(_mm256_andnot_ps(l_leftGoing1, l_a1),
+                                                         _mm256_andnot_ps(l_leftGoing2, l_a2)));
+    _mm256_storeu_ps(o_netUpdateRHu + l_ed, _mm256_add_ps(_mm256_andnot_ps(l_leftGoing1, l_z1Hu),
+                                                          _mm256_andnot_ps(l_leftGoing2, l_z2Hu)));
+  }
+
+  return l_ed;
+}
+
+TSUNAMI_LAB_TARGET_AVX512 tsunami_lab::t_idx tsunami_lab::solvers::Fwave::netUpdatesBatchAvx512(t_idx i_nEdges,
+                                                                                                t_real const *i_hL,
+                                                                                                t_real const *i_hR,
+                                                                                                t_real const *i_huL,
+                                                                                                t_real const *i_huR,
+                                                                                                t_real const *i_bL,
+                                                                                                t_real const *i_bR,
+                                                                                                t_real *o_netUpdateLH,
+                                                                                                t_real *o_netUpdateLHu,
+                                                                                                t_real *o_netUpdateRH,
+                                                                                                t_real *o_netUpdateRHu)
+{
+  static_assert(sizeof(t_real) == sizeof(float), "the AVX-512 kernel requires single precision");
+
+  __m512 const l_zero = _mm512_setzero_ps();
+  // all lanes; the unmasked square root triggers false positives of -Wmaybe-uninitialized in GCC 12
+  __mmask16 const l_all = 0xFFFF;
+  __m512 const l_one = _mm512_set1_ps(1);
+  __m512 const l_half = _mm512_set1_ps(0.5);
+  __m512 const l_gSqrtV = _mm512_set1_ps(m_gSqrt);
+  __m512 const l_gHalfV = _mm512_set1_ps(l_gHalf);
+
+  t_idx l_ed = 0;
+  for (; l_ed + 16 <= i_nEdges; l_ed += 16)
+  {
+    __m512 l_hL = _mm512_loadu_ps(i_hL + l_ed);
+    __m512 l_hR = _mm512_loadu_ps(i_hR + l_ed);
+    __m512 l_huL = _mm512_loadu_ps(i_huL + l_ed);
+    __m512 l_huR = _mm512_loadu_ps(i_huR + l_ed);
+    __m512 l_bL = _mm512_loadu_ps(i_bL + l_ed);
+    __m512 l_bR = _mm512_loadu_ps(i_bR + l_ed);
+
+    // masks of wet sides; lanes with two dry sides are zeroed at the end
+    __mmask16 l_wetL = _mm512_cmp_ps_mask(l_hL, l_zero, _CMP_NEQ_OQ);
+    __mmask16 l_wetR = _mm512_cmp_ps_mask(l_hR, l_zero, _CMP_NEQ_OQ);
+    __mmask16 l_wet = l_wetL | l_wetR;
+
+    // compute particle velocities
+    __m512 l_uL = _mm512_maskz_div_ps(l_wetL, l_huL, l_hL);
+    __m512 l_uR = _mm512_maskz_div_ps(l_wetR, l_huR, l_hR);
+
+    // compute eigenvalues
+    __m512 l_hSqrtL = _mm512_maskz_sqrt_ps(l_all, l_hL);
+    __m512 l_hSqrtR = _mm512_maskz_sqrt_ps(l_all, l_hR);
+    __m512 l_hRoe = _mm512_mul_ps(l_half, _mm512_add_ps(l_hL, l_hR));
+    __m512 l_uRoe = _mm512_add_ps(_mm512_mul_ps(l_hSqrtL, l_uL), _mm512_mul_ps(l_hSqrtR, l_uR));
+    l_uRoe = _mm512_maskz_div_ps(l_wet, l_uRoe, _mm512_add_ps(l_hSqrtL, l_hSqrtR));
+    __m512 l_ghSqrtRoe = _mm512_mul_ps(l_gSqrtV, _mm512_maskz_sqrt_ps(l_all, l_hRoe));
+    __m512 l_s1 = _mm512_sub_ps(l_uRoe, l_ghSqrtRoe);
+    __m512 l_s2 = _mm512_add_ps(l_uRoe, l_ghSqrtRoe);
+
+    // compute eigencoefficients
+    __m512 l_detInv = _mm512_maskz_div_ps(l_wet, l_one, _mm512_sub_ps(l_s2, l_s1));
+    __m512 l_fDelta0 = _mm512_sub_ps(l_huR, l_huL);
+    __m512 l_fluxR = _mm512_add_ps(_mm512_mul_ps(l_huR, l_uR), _mm512_mul_ps(_mm512_mul_ps(l_gHalfV, l_hR), l_hR));
+    __m512 l_fluxL = _mm512_add_ps(_mm512_mul_ps(l_huL, l_uL), _mm512_mul_ps(_mm512_mul_ps(l_gHalfV, l_hL), l_hL));
+    __m512 l_fDelta1 = _mm512_sub_ps(l_fluxR, l_fluxL);
+    l_fDelta1 = _mm512_add_ps(l_fDelta1,
+                              _mm512_mul_ps(_mm512_mul_ps(l_gHalfV, _mm512_sub_ps(l_bR, l_bL)), _mm512_add_ps(l_hL, l_hR)));
+    __m512 l_a1 = _mm512_sub_ps(_mm512_mul_ps(_mm512_mul_ps(l_detInv, l_s2), l_fDelta0), _mm512_mul_ps(l_detInv, l_fDelta1));
+    __m512 l_a2 = _mm512_sub_ps(_mm512_mul_ps(l_detInv, l_fDelta1), _mm512_mul_ps(_mm512_mul_ps(l_detInv, l_s1), l_fDelta0));
+    l_a1 = _mm512_maskz_mov_ps(l_wet, l_a1);
+    l_a2 = _mm512_maskz_mov_ps(l_wet, l_a2);
+
+    // assign the waves to the sides depending on the wave speeds
+    __mmask16 l_leftGoing1 = _mm512_cmp_ps_mask(l_s1, l_zero, _CMP_LT_OQ);
+    __mmask16 l_leftGoing2 = _mm512_cmp_ps_mask(l_s2, l_zero, _CMP_LT_OQ);
+    __m512 l_z1Hu = _mm512_mul_ps(l_a1, l_s1);
+    __m512 l_z2Hu = _mm512_mul_ps(l_a2, l_s2);
+
+    _mm512_storeu_ps(o_netUpdateLH + l_ed, _mm512_add_ps(_mm512_maskz_mov_ps(l_leftGoing1, l_a1),
+                                                         _mm512_maskz_mov_ps(l_leftGoing2, l_a2)));
+    _mm512_storeu_ps(o_netUpdateLHu + l_ed, _mm512_add_ps(_mm512_maskz_mov_ps(l_leftGoing1, l_z1Hu),
+                                                          _mm512_maskz_mov_ps(l_leftGoing2, l_z2Hu)));
+    _mm512_storeu_ps(o_netUpdateRH + l_ed, _mm512_add_ps(_mm512_maskz_mov_ps(~l_leftGoing1, l_a1),
+                                                         _mm512_maskz_mov_ps(~l_leftGoing2, l_a2)));
+    _mm512_storeu_ps(o_netUpdateRHu + l_ed, _mm512_add_ps(_mm512_maskz_mov_ps(~l_leftGoing1, l_z1Hu),
+                                                          _mm512_maskz_mov_ps(~l_leftGoing2, l_z2Hu)));
+  }
+
+  return l_ed;
+}
+
+TSUNAMI_LAB_TARGET_SSE2 tsunami_lab::t_idx tsunami_lab::solvers::Fwave::netUpdatesBatchSse2(t_idx i_nEdges,
+                                                                                            t_real const *i_hL,
+                                                                                            t_real const *i_hR,
+                                                                                            t_real const *i_huL,
+                                                                                            t_real const *i_huR,
+                                                                                            t_real const *i_bL,
+                                                                                            t_real const *i_bR,
+                                                                                            t_real const *i_hSqrtL,
+                                                                                            t_real const *i_hSqrtR,
+                                                                                            t_real const *i_uL,
+                                                                                            t_real const *i_uR,
+                                                                                            t_real const *i_fluxL,
+                                                                                            t_real const *i_fluxR,
+                                                                                            t_real *o_netUpdateLH,
+                                                                                            t_real *o_netUpdateLHu,
+                                                                                            t_real *o_netUpdateRH,
+                                                                                            t_real *o_netUpdateRHu)
+{
+  __m128 const l_zero = _mm_setzero_ps();
+  __m128 const l_one = _mm_set1_ps(1);
+  __m128 const l_half = _mm_set1_ps(0.5);
+  __m128 const l_gSqrtV = _mm_set1_ps(m_gSqrt);
+  __m128 const l_gHalfV = _mm_set1_ps(l_gHalf);
+
+  t_idx l_ed = 0;
+  for (; l_ed + 4 <= i_nEdges; l_ed += 4)
+  {
+    __m128 l_hL = _mm_loadu_ps(i_hL + l_ed);
+    __m128 l_hR = _mm_loadu_ps(i_hR + l_ed);
+    __m128 l_huL = _mm_loadu_ps(i_huL + l_ed);
+    __m128 l_huR = _mm_loadu_ps(i_huR + l_ed);
+    __m128 l_bL = _mm_loadu_ps(i_bL + l_ed);
+    __m128 l_bR = _mm_loadu_ps(i_bR + l_ed);
+    __m128 l_hSqrtL = _mm_loadu_ps(i_hSqrtL + l_ed);
+    __m128 l_hSqrtR = _mm_loadu_ps(i_hSqrtR + l_ed);
+
+    // lanes with two dry sides are zeroed at the end
+    __m128 l_wet = _mm_or_ps(_mm_cmpneq_ps(l_hL, l_zero), _mm_cmpneq_ps(l_hR, l_zero));
+
+    // compute eigenvalues
+    __m128 l_hRoe = _mm_mul_ps(l_half, _mm_add_ps(l_hL, l_hR));
+    __m128 l_uRoe = _mm_add_ps(_mm_mul_ps(l_hSqrtL, _mm_loadu_ps(i_uL + l_ed)), _mm_mul_ps(l_hSqrtR, _mm_loadu_ps(i_uR + l_ed)));
+    __m128 l_hSqrtSum = _mm_add_ps(l_hSqrtL, l_hSqrtR);
+    l_uRoe = _mm_div_ps(l_uRoe, _mm_or_ps(_mm_and_ps(l_wet, l_hSqrtSum), _mm_andnot_ps(l_wet, l_one)));
+    __m128 l_ghSqrtRoe = _mm_mul_ps(l_gSqrtV, _mm_sqrt_ps(l_hRoe));
+    __m128 l_s1 = _mm_sub_ps(l_uRoe, l_ghSqrtRoe);
+    __m128 l_s2 = _mm_add_ps(l_uRoe, l_ghSqrtRoe);
+
+    // compute eigencoefficients
+    __m128 l_sDiff = _mm_sub_ps(l_s2, l_s1);
+    __m128 l_detInv = _mm_div_ps(l_one, _mm_or_ps(_mm_and_ps(l_wet, l_sDiff), _mm_andnot_ps(l_wet, l_one)));
+    __m128 l_fDelta0 = _mm_sub_ps(l_huR, l_huL);
+    __m128 l_fDelta1 = _mm_sub_ps(_mm_loadu_ps(i_fluxR + l_ed), _mm_loadu_ps(i_fluxL + l_ed));
+    l_fDelta1 = _mm_add_ps(l_fDelta1,
+                           _mm_mul_ps(_mm_mul_ps(l_gHalfV, _mm_sub_ps(l_bR, l_bL)), _mm_add_ps(l_hL, l_hR)));
+    __m128 l_a1 = _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(l_detInv, l_s2), l_fDelta0), _mm_mul_ps(l_detInv, l_fDelta1));
+    __m128 l_a2 = _mm_sub_ps(_mm_mul_ps(l_detInv, l_fDelta1), _mm_mul_ps(_mm_mul_ps(l_detInv, l_s1), l_fDelta0));
+    l_a1 = _mm_and_ps(l_a1, l_wet);
+    l_a2 = _mm_and_ps(l_a2, l_wet);
+
+    // assign the waves to the sides depending on the wave speeds
+    __m128 l_leftGoing1 = _mm_cmplt_ps(l_s1, l_zero);
+    __m128 l_leftGoing2 = _mm_cmplt_ps(l_s2, l_zero);
+    __m128 l_z1Hu = _mm_mul_ps(l_a1, l_s1);
+    __m128 l_z2Hu = _mm_mul_ps(l_a2, l_s2);
+
+    _mm_storeu_ps(o_netUpdateLH + l_ed, _mm_add_ps(_mm_and_ps(l_a1, l_leftGoing1),
+                                                   _mm_and_ps(l_a2, l_leftGoing2)));
+    _mm_storeu_ps(o_netUpdateLHu + l_ed, _mm_add_ps(_mm_and_ps(l_z1Hu, l_leftGoing1),
+                                                    _mm_and_ps(l_z2Hu, l_leftGoing2)));
+    _mm_storeu_ps(o_netUpdateRH + l_ed, _mm_add_ps(_mm_andnot_ps(l_leftGoing1, l_a1),
+                                                   _mm_andnot_ps(l_leftGoing2, l_a2)));
+    _mm_storeu_ps(o_netUpdateRHu + l_ed, _mm_add_ps(_mm_andnot_ps(l_leftGoing1, l_z1Hu),
+                                                    _mm_andnot_ps(l_leftGoing2, l_z2Hu)));
+  }
+
+  return l_ed;
+}
+
+TSUNAMI_LAB_TARGET_AVX2 tsunami_lab::t_idx tsunami_lab::solvers::Fwave::netUpdatesBatchAvx2(t_idx i_nEdges,
+                                                                                            t_real const *i_hL,
+                                                                                            t_real const *i_hR,
+                                                                                            t_real const *i_huL,
+                                                                                            t_real const *i_huR,
+                                                                                            t_real const *i_bL,
+                                                                                            t_real const *i_bR,
+                                                                                            t_real const *i_hSqrtL,
+                                                                                            t_real const *i_hSqrtR,
+                                                                                            t_real const *i_uL,
+                                                                                            t_real const *i_uR,
+                                                                                            t_real const *i_fluxL,
+                                                                                            t_real const *i_fluxR,
+                                                                                            t_real *o_netUpdateLH,
+                                                                                            t_real *o_netUpdateLHu,
+                                                                                            t_real *o_netUpdateRH,
+                                                                                            t_real *o_netUpdateRHu)
+{
+  __m256 const l_zero = _mm256_setzero_ps();
+  __m256 const l_one = _mm256_set1_ps(1);
+  __m256 const l_half = _mm256_set1_ps(0.5);
+  __m256 const l_gSqrtV = _mm256_set1_ps(m_gSqrt);
+  __m256 const l_gHalfV = _mm256_set1_ps(l_gHalf);
+
+  t_idx l_ed = 0;
+  for (; l_ed + 8 <= i_nEdges; l_ed += 8)
+  {
+    __m256 l_hL = _mm256_loadu_ps(i_hL + l_ed);
+    __m256 l_hR = _mm256_loadu_ps(i_hR + l_ed);
+    __m256 l_huL = _mm256_loadu_ps(i_huL + l_ed);
+    __m256 l_huR = _mm256_loadu_ps(i_huR + l_ed);
+    __m256 l_bL = _mm256_loadu_ps(i_bL + l_ed);
+    __m256 l_bR = _mm256_loadu_ps(i_bR + l_ed);
+    __m256 l_hSqrtL = _mm256_loadu_ps(i_hSqrtL + l_ed);
+    __m256 l_hSqrtR = _mm256_loadu_ps(i_hSqrtR + l_ed);
+
+    // lanes with two dry sides are zeroed at the end
+    __m256 l_wet = _mm256_or_ps(_mm256_cmp_ps(l_hL, l_zero, _CMP_NEQ_OQ), _mm256_cmp_ps(l_hR, l_zero, _CMP_NEQ_OQ));
+
+    // compute eigenvalues
+    __m256 l_hRoe = _mm256_mul_ps(l_half, _mm256_add_ps(l_hL, l_hR));
+    __m256 l_uRoe = _mm256_add_ps(_mm256_mul_ps(l_hSqrtL, _mm256_loadu_ps(i_uL + l_ed)), _mm256_mul_ps(l_hSqrtR, _mm256_loadu_ps(i_uR + l_ed)));
+    l_uRoe = _mm256_div_ps(l_uRoe, _mm256_blendv_ps(l_one, _mm256_add_ps(l_hSqrtL, l_hSqrtR), l_wet));
+    __m256 l_ghSqrtRoe = _mm256_mul_ps(l_gSqrtV, _mm256_sqrt_ps(l_hRoe));
+    __m256 l_s1 = _mm256_sub_ps(l_uRoe, l_ghSqrtRoe);
+    __m256 l_s2 = _mm256_add_ps(l_uRoe, l_ghSqrtRoe);
+
+    // compute eigencoefficients
+    __m256 l_detInv = _mm256_div_ps(l_one, _mm256_blendv_ps(l_one, _mm256_sub_ps(l_s2, l_s1), l_wet));
+    __m256 l_fDelta0 = _mm256_sub_ps(l_huR, l_huL);
+    __m256 l_fDelta1 = _mm256_sub_ps(_mm256_loadu_ps(i_fluxR + l_ed), _mm256_loadu_ps(i_fluxL + l_ed));
+    l_fDelta1 = _mm256_add_ps(l_fDelta1,
+                              _mm256_mul_ps(_mm256_mul_ps(l_gHalfV, _mm256_sub_ps(l_bR, l_bL)), _mm256_add_ps(l_hL, l_hR)));
+    __m256 l_a1 = _mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(l_detInv, l_s2), l_fDelta0), _mm256_mul_ps(l_detInv, l_fDelta1));
+    __m256 l_a2 = _mm256_sub_ps(_mm256_mul_ps(l_detInv, l_fDelta1), _mm256_mul_ps(_mm256_mul_ps(l_detInv, l_s1), l_fDelta0));
+    l_a1 = _mm256_and_ps(l_a1, l_wet);
+    l_a2 = _mm256_and_ps(l_a2, l_wet);
+
+    // assign the waves to the sides depending on the wave speeds
+    __m256 l_leftGoing1 = _mm256_cmp_ps(l_s1, l_zero, _CMP_LT_OQ);
+    __m256 l_leftGoing2 = _mm256_cmp_ps(l_s2, l_zero, _CMP_LT_OQ);
+    __m256 l_z1Hu = _mm256_mul_ps(l_a1, l_s1);
+    __m256 l_z2Hu = _mm256_mul_ps(l_a2, l_s2);
+
+    _mm256_storeu_ps(o_netUpdateLH + l_ed, _mm256_add_ps(_mm256_and_ps(l_a1, l_leftGoing1),
+                                                         _mm256_and_ps(l_a2, l_leftGoing2)));
+    _mm256_storeu_ps(o_netUpdateLHu + l_ed, _mm256_add_ps(_mm256_and_ps(l_z1Hu, l_leftGoing1),
+                                                          _mm256_and_ps(l_z2Hu, l_leftGoing2)));
+    _mm256_storeu_ps(o_netUpdateRH + l_ed, _mm256_add_ps(_mm256_andnot_ps(l_leftGoing1, l_a1),
+                                                         _mm256_andnot_ps(l_leftGoing2, l_a2)));
+    _mm256_storeu_ps(o_netUpdateRHu + l_ed, _mm256_add_ps(_mm256_andnot_ps(l_leftGoing1, l_z1Hu),
+                                                          _mm256_andnot_ps(l_leftGoing2, l_z2Hu)));
+  }
+
+  return l_ed;
+}
+
+TSUNAMI_LAB_TARGET_AVX512 tsunami_lab::t_idx tsunami_lab::solvers::Fwave::netUpdatesBatchAvx512(t_idx i_nEdges,
+                                                                                                t_real const *i_hL,
+                                                                                                t_real const *i_hR,
+                                                                                                t_real const *i_huL,
+                                                                                                t_real const *i_huR,
+                                                                                                t_real const *i_bL,
+                                                                                                t_real const *i_bR,
+                                                                                                t_real const *i_hSqrtL,
+                                                                                                t_real const *i_hSqrtR,
+                                                                                                t_real const *i_uL,
+                                                                                                t_real const *i_uR,
+                                                                                                t_real const *i_fluxL,
+                                                                                                t_real const *i_fluxR,
+                                                                                                t_real *o_netUpdateLH,
+                                                                                                t_real *o_netUpdateLHu,
+                                                                                                t_real *o_netUpdateRH,
+                                                                                                t_real *o_netUpdateRHu)
+{
+  __m512 const l_zero = _mm512_setzero_ps();
+  // all lanes; the unmasked square root triggers false positives of -Wmaybe-uninitialized in GCC 12
+  __mmask16 const l_all = 0xFFFF;
+  __m512 const l_one = _mm512_set1_ps(1);
+  __m512 const l_half = _mm512_set1_ps(0.5);
+  __m512 const l_gSqrtV = _mm512_set1_ps(m_gSqrt);
+  __m512 const l_gHalfV = _mm512_set1_ps(l_gHalf);
+
+  t_idx l_ed = 0;
+  for (; l_ed + 16 <= i_nEdges; l_ed += 16)
+  {
+    __m512 l_hL = _mm512_loadu_ps(i_hL + l_ed);
+    __m512 l_hR = _mm512_loadu_ps(i_hR + l_ed);
+    __m512 l_huL = _mm512_loadu_ps(i_huL + l_ed);
+    __m512 l_huR = _mm512_loadu_ps(i_huR + l_ed);
+    __m512 l_bL = _mm512_loadu_ps(i_bL + l_ed);
+    __m512 l_bR = _mm512_loadu_ps(i_bR + l_ed);
+    __m512 l_hSqrtL = _mm512_loadu_ps(i_hSqrtL + l_ed);
+    __m512 l_hSqrtR = _mm512_loadu_ps(i_hSqrtR + l_ed);
+
+    // lanes with two dry sides are zeroed at the end
+    __mmask16 l_wet = _mm512_cmp_ps_mask(l_hL, l_zero, _CMP_NEQ_OQ) | _mm512_cmp_ps_mask(l_hR, l_zero, _CMP_NEQ_OQ);
+
+    // compute eigenvalues
+    __m512 l_hRoe = _mm512_mul_ps(l_half, _mm512_add_ps(l_hL, l_hR));
+    __m512 l_uRoe = _mm512_add_ps(_mm512_mul_ps(l_hSqrtL, _mm512_loadu_ps(i_uL + l_ed)), _mm512_mul_ps(l_hSqrtR, _mm512_loadu_ps(i_uR + l_ed)));
+    l_uRoe = _mm512_maskz_div_ps(l_wet, l_uRoe, _mm512_add_ps(l_hSqrtL, l_hSqrtR));
+    __m512 l_ghSqrtRoe = _mm512_mul_ps(l_gSqrtV, _mm512_maskz_sqrt_ps(l_all, l_hRoe));
+    __m512 l_s1 = _mm512_sub_ps(l_uRoe, l_ghSqrtRoe);
+    __m512 l_s2 = _mm512_add_ps(l_uRoe, l_ghSqrtRoe);
+
+    // compute eigencoefficients
+    __m512 l_detInv = _mm512_maskz_div_ps(l_wet, l_one, _mm512_sub_ps(l_s2, l_s1));
+    __m512 l_fDelta0 = _mm512_sub_ps(l_huR, l_huL);
+    __m512 l_fDelta1 = _mm512_sub_ps(_mm512_loadu_ps(i_fluxR + l_ed), _mm512_loadu_ps(i_fluxL + l_ed));
+    l_fDelta1 = _mm512_add_ps(l_fDelta1,
+                              _mm512_mul_ps(_mm512_mul_ps(l_gHalfV, _mm512_sub_ps(l_bR, l_bL)), _mm512_add_ps(l_hL, l_hR)));
+    __m512 l_a1 = _mm512_sub_ps(_mm512_mul_ps(_mm512_mul_ps(l_detInv, l_s2), l_fDelta0), _mm512_mul_ps(l_detInv, l_fDelta1));
+    __m512 l_a2 = _mm512_sub_ps(_mm512_mul_ps(l_detInv, l_fDelta1), _mm512_mul_ps(_mm512_mul_ps(l_detInv, l_s1), l_fDelta0));
+    l_a1 = _mm512_maskz_mov_ps(l_wet, l_a1);
+    l_a2 = _mm512_maskz_mov_ps(l_wet, l_a2);
+
+    // assign the waves to the sides depending on the wave speeds
+    __mmask16 l_leftGoing1 = _mm512_cmp_ps_mask(l_s1, l_zero, _CMP_LT_OQ);
+    __mmask16 l_leftGoing2 = _mm512_cmp_ps_mask(l_s2, l_zero, _CMP_LT_OQ);
+    __m512 l_z1Hu = _mm512_mul_ps(l_a1, l_s1);
+    __m512 l_z2Hu = _mm512_mul_ps(l_a2, l_s2);
+
+    _mm512_storeu_ps(o_netUpdateLH + l_ed, _mm512_add_ps(_mm512_maskz_mov_ps(l_leftGoing1, l_a1),
+                                                         _mm512_maskz_mov_ps(l_leftGoing2, l_a2)));
+    _mm512_storeu_ps(o_netUpdateLHu + l_ed, _mm512_add_ps(_mm512_maskz_mov_ps(l_leftGoing1, l_z1Hu),
+                                                          _mm512_maskz_mov_ps(l_leftGoing2, l_z2Hu)));
+    _mm512_storeu_ps(o_netUpdateRH + l_ed, _mm512_add_ps(_mm512_maskz_mov_ps(~l_leftGoing1, l_a1),
+                                                         _mm512_maskz_mov_ps(~l_leftGoing2, l_a2)));
+    _mm512_storeu_ps(o_netUpdateRHu + l_ed, _mm512_add_ps(_mm512_maskz_mov_ps(~l_leftGoing1, l_z1Hu),
+                                                          _mm512_maskz_mov_ps(~l_leftGoing2, l_z2Hu)));
+  }
+
+  return l_ed;
+}
+#endif
+
+void tsunami_lab::solvers::Fwave::netUpdatesBatch(t_idx i_nEdges,
+                                                  t_real const *i_hL,
+                                                  t_real const *i_hR,
+                                                  t_real const *i_huL,
+                                                  t_real const *i_huR,
+                                                  t_real const *i_bL,
+                                                  t_real const *i_bR,
+                                                  t_real *o_netUpdateLH,
+                                                  t_real *o_netUpdateLHu,
+                                                  t_real *o_netUpdateRH,
+                                                  t_real *o_netUpdateRHu)
+{
+  t_idx l_nVectorized = 0;
+#ifdef TSUNAMI_LAB_ISA_X86
+  switch (systeminfo::Isa::active())
+  {
+  case systeminfo::Isa::AVX512:
+    l_nVectorized = netUpdatesBatchAvx512(i_nEdges,
+                                          i_hL, i_hR,
+                                          i_huL, i_huR,
+                                          i_bL, i_bR,
+                                          o_netUpdateLH, o_netUpdateLHu,
+                                          o_netUpdateRH, o_netUpdateRHu);
+    break;
+  case systeminfo::Isa::AVX2:
+    l_nVectorized = netUpdatesBatchAvx2(i_nEdges,
+                                        i_hL, i_hR,
+                                        i_huL, i_huR,
+                                        i_bL, i_bR,
+                                        o_netUpdateLH, o_netUpdateLHu,
+                                        o_netUpdateRH, o_netUpdateRHu);
+    break;
+  case systeminfo::Isa::SSE2:
+    l_nVectorized = netUpdatesBatchSse2(i_nEdges,
+                                        i_hL, i_hR,
+                                        i_huL, i_huR,
+                                        i_bL, i_bR,
+                                        o_netUpdateLH, o_netUpdateLHu,
+                                        o_netUpdateRH, o_netUpdateRHu);
+    break;
+  default:
+    break;
+  }
+#endif
+
+  // remainder of the batch
+  netUpdatesBatchScalar(l_nVectorized,
+                        i_nEdges,
+                        i_hL, i_hR,
+                        i_huL, i_huR,
+                        i_bL, i_bR,
+                        o_netUpdateLH, o_netUpdateLHu,
+                        o_netUpdateRH, o_netUpdateRHu);
+}
+
+void tsunami_lab::solvers::Fwave::netUpdatesBatch(t_idx i_nEdges,
+                                                  t_real const *i_hL,
+                                                  t_real const *i_hR,
+                                                  t_real const *i_huL,
+                                                  t_real const *i_huR,
+                                                  t_real const *i_bL,
+                                                  t_real const *i_bR,
+                                                  t_real const *i_hSqrtL,
+                                                  t_real const *i_hSqrtR,
+                                                  t_real const *i_uL,
+                                                  t_real const *i_uR,
+                                                  t_real const *i_fluxL,
+                                                  t_real const *i_fluxR,
+                                                  t_real *o_netUpdateLH,
+                                                  t_real *o_netUpdateLHu,
+                                                  t_real *o_netUpdateRH,
+                                                  t_real *o_netUpdateRHu)
+{
+  t_idx l_nVectorized = 0;
+#ifdef TSUNAMI_LAB_ISA_X86
+  switch (systeminfo::Isa::active())
+  {
+  case systeminfo::Isa::AVX512:
+    l_nVectorized = netUpdatesBatchAvx512(i_nEdges,
+                                          i_hL, i_hR,
+                                          i_huL, i_huR,
+                                          i_bL, i_bR,
+                                          i_hSqrtL, i_hSqrtR,
+                                          i_uL, i_uR,
+                                          i_fluxL, i_fluxR,
+                                          o_netUpdateLH, o_netUpdateLHu,
+                                          o_netUpdateRH, o_netUpdateRHu);
+    break;
+  case systeminfo::Isa::AVX2:
+    l_nVectorized = netUpdatesBatchAvx2(i_nEdges,
+                                        i_hL, i_hR,
+                                        i_huL, i_huR,
+                                        i_bL, i_bR,
+                                        i_hSqrtL, i_hSqrtR,
+                                        i_uL, i_uR,
+                                        i_fluxL, i_fluxR,
+                                        o_netUpdateLH, o_netUpdateLHu,
+                                        o_netUpdateRH, o_netUpdateRHu);
+    break;
+  case systeminfo::Isa::SSE2:
+    l_nVectorized = netUpdatesBatchSse2(i_nEdges,
+                                        i_hL, i_hR,
+                                        i_huL, i_huR,
+                                        i_bL, i_bR,
+                                        i_hSqrtL, i_hSqrtR,
+                                        i_uL, i_uR,
+                                        i_fluxL, i_fluxR,
+                                        o_netUpdateLH, o_netUpdateLHu,
+                                        o_netUpdateRH, o_netUpdateRHu);
+    break;
+  default:
+    break;
+  }
+#endif
+
+  // remainder of the batch
+  netUpdatesBatchScalar(l_nVectorized,
+                        i_nEdges,
+                        i_hL, i_hR,
+                        i_huL, i_huR,
+                        i_bL, i_bR,
+                        i_hSqrtL, i_hSqrtR,
+                        i_uL, i_uR,
+                        i_fluxL, i_fluxR,
+                        o_netUpdateLH, o_netUpdateLHu,
+                        o_netUpdateRH, o_netUpdateRHu);
+}
@@ -9,6 +9,7 @@
 #define TSUNAMI_LAB_SOLVERS_FWAVE
 
 #include "../constants.h"
+#include "../systeminfo/Isa.h"
 
 namespace tsunami_lab
 {
@@ -21,8 +22,6 @@ namespace tsunami_lab
 class tsunami_lab::solvers::Fwave
 {
 private:
-  //! gravity constant
-  static t_real constexpr m_g = 9.80665;
   static t_real constexpr l_gHalf = 4.903325;
 
   //! square root of gravity
@@ -69,7 +68,181 @@ private:
                                        t_real &o_strengthL,
                                        t_real &o_strengthR);
 
+  /**
+   * Computes the net-updates for the edges [i_first, i_last) of a batch without SIMD intrinsics.
+   * The parameters are the ones of netUpdatesBatch.
+   **/
+  static void netUpdatesBatchScalar(t_idx i_first,
+                                    t_idx i_last,
+                                    t_real const *i_hL,
+                                    t_real const *i_hR,
+                                    t_real const *i_huL,
+                                    t_real const *i_huR,
+                                    t_real const *i_bL,
+                                    t_real const *i_bR,
+                                    t_real *o_netUpdateLH,
+                                    t_real *o_netUpdateLHu,
+                                    t_real *o_netUpdateRH,
+                                    t_real *o_netUpdateRHu);
+
+  /**
+   * Computes the net-updates for the edges [i_first, i_last) of a batch from shared cell quantities without SIMD intrinsics.
+   * The parameters are the ones of netUpdatesBatch.
+   **/
+  static void netUpdatesBatchScalar(t_idx i_first,
+                                    t_idx i_last,
+                                    t_real const *i_hL,
+                                    t_real const *i_hR,
+                                    t_real const *i_huL,
+                                    t_real const *i_huR,
+                                    t_real const *i_bL,
+                                    t_real const *i_bR,
+                                    t_real const *i_hSqrtL,
+                                    t_real const *i_hSqrtR,
+                                    t_real const *i_uL,
+                                    t_real const *i_uR,
+                                    t_real const *i_fluxL,
+                                    t_real const *i_fluxR,
+                                    t_real *o_netUpdateLH,
+                                    t_real *o_netUpdateLHu,
+                                    t_real *o_netUpdateRH,
+                                    t_real *o_netUpdateRHu);
+
+#ifdef TSUNAMI_LAB_ISA_X86
+  /**
+   * Computes the net-updates for the leading edges of a batch using SSE2 (4 edges per instruction).
+   * The parameters are the ones of netUpdatesBatch.
+   *
+   * @return number of processed edges; the remaining ones have to be handled by netUpdatesBatchScalar.
+   **/
+  TSUNAMI_LAB_TARGET_SSE2 static t_idx netUpdatesBatchSse2(t_idx i_nEdges,
+                                                           t_real const *i_hL,
+                                                           t_real const *i_hR,
+                                                           t_real const *i_huL,
+                                                           t_real const *i_huR,
+                                                           t_real const *i_bL,
+                                                           t_real const *i_bR,
+                                                           t_real *o_netUpdateLH,
+                                                           t_real *o_netUpdateLHu,
+                                                           t_real *o_netUpdateRH,
+                                                           t_real *o_netUpdateRHu);
+
+  /**
+   * Computes the net-updates for the leading edges of a batch using AVX2 (8 edges per instruction).
+   * The parameters are the ones of netUpdatesBatch.
+   *
+   * @return number of processed edges; the remaining ones have to be handled by netUpdatesBatchScalar.
+   **/
+  TSUNAMI_LAB_TARGET_AVX2 static t_idx netUpdatesBatchAvx2(t_idx i_nEdges,
+                                                           t_real const *i_hL,
+                                                           t_real const *i_hR,
+                                                           t_real const *i_huL,
+                                                           t_real const *i_huR,
+                                                           t_real const *i_bL,
+                                                           t_real const *i_bR,
+                                                           t_real *o_netUpdateLH,
+                                                           t_real *o_netUpdateLHu,
+                                                           t_real *o_netUpdateRH,
+                                                           t_real *o_netUpdateRHu);
+
+  /**
+   * Computes the net-updates for the leading edges of a batch using AVX-512 (16 edges per instruction).
+   * The parameters are the ones of netUpdatesBatch.
+   *
+   * @return number of processed edges; the remaining ones have to be handled by netUpdatesBatchScalar.
+   **/
+  TSUNAMI_LAB_TARGET_AVX512 static t_idx netUpdatesBatchAvx512(t_idx i_nEdges,
+                                                               t_real const *i_hL,
+                                                               t_real const *i_hR,
+                                                               t_real const *i_huL,
+                                                               t_real const *i_huR,
+                                                               t_real const *i_bL,
+                                                               t_real const *i_bR,
+                                                               t_real *o_netUpdateLH,
+                                                               t_real *o_netUpdateLHu,
+                                                               t_real *o_netUpdateRH,
+                                                               t_real *o_netUpdateRHu);
+
+  /**
+   * Computes the net-updates for the leading edges of a batch from shared cell quantities using SSE2.
+   * The parameters are the ones of netUpdatesBatch.
+   *
+   * @return number of processed edges; the remaining ones have to be handled by netUpdatesBatchScalar.
+   **/
+  TSUNAMI_LAB_TARGET_SSE2 static t_idx netUpdatesBatchSse2(t_idx i_nEdges,
+                                                           t_real const *i_hL,
+                                                           t_real const *i_hR,
+                                                           t_real const *i_huL,
+                                                           t_real const *i_huR,
+                                                           t_real const *i_bL,
+                                                           t_real const *i_bR,
+                                                           t_real const *i_hSqrtL,
+                                                           t_real const *i_hSqrtR,
+                                                           t_real const *i_uL,
+                                                           t_real const *i_uR,
+                                                           t_real const *i_fluxL,
+                                                           t_real const *i_fluxR,
+                                                           t_real *o_netUpdateLH,
+                                                           t_real *o_netUpdateLHu,
+                                                           t_real *o_netUpdateRH,
+                                                           t_real *o_netUpdateRHu);
+
+  /**
+   * Computes the net-updates for the leading edges of a batch from shared cell quantities using AVX2.
+   * The parameters are the ones of netUpdatesBatch.
+   *
+   * @return number of processed edges; the remaining ones have to be handled by netUpdatesBatchScalar.
+   **/
+  TSUNAMI_LAB_TARGET_AVX2 static t_idx netUpdatesBatchAvx2(t_idx i_nEdges,
+                                                           t_real const *i_hL,
+                                                           t_real const *i_hR,
+                                                           t_real const *i_huL,
+                                                           t_real const *i_huR,
+                                                           t_real const *i_bL,
+                                                           t_real const *i_bR,
+                                                           t_real const *i_hSqrtL,
+                                                           t_real const *i_hSqrtR,
+                                                           t_real const *i_uL,
+                                                           t_real const *i_uR,
+                                                           t_real const *i_fluxL,
+                                                           t_real const *i_fluxR,
+                                                           t_real *o_netUpdateLH,
+                                                           t_real *o_netUpdateLHu,
+                                                           t_real *o_netUpdateRH,
+                                                           t_real *o_netUpdateRHu);
+
+  /**
+   * Computes the net-updates for the leading edges of a batch from shared cell quantities using AVX-512.
+   * The parameters are the ones of netUpdatesBatch.
+   *
+   * @return number of processed edges; the remaining ones have to be handled by netUpdatesBatchScalar.
+   **/
+  TSUNAMI_LAB_TARGET_AVX512 static t_idx netUpdatesBatchAvx512(t_idx i_nEdges,
+                                                               t_real const *i_hL,
+                                                               t_real const *i_hR,
+                                                               t_real const *i_huL,
+                                                               t_real const *i_huR,
+                                                               t_real const *i_bL,
+                                                               t_real const *i_bR,
+                                                               t_real const *i_hSqrtL,
+                                                               t_real const *i_hSqrtR,
+                                                               t_real const *i_uL,
+                                                               t_real const *i_uR,
+                                                               t_real const *i_fluxL,
+                                                               t_real const *i_fluxR,
+                                                               t_real *o_netUpdateLH,
+                                                               t_real *o_netUpdateLHu,
+                                                               t_real *o_netUpdateRH,
+                                                               t_real *o_netUpdateRHu);
+#endif
+
 public:
+  //! gravity constant, also of the wave speeds of the patches
+  static t_real constexpr m_g = 9.80665;
+
+  //! netUpdatesBatch accepts the quantities which an edge shares with the other edges of its cells
+  static bool constexpr m_sharesCellQuantities = true;
+
   /**
    * Computes the net-updates.
    *
@@ -90,6 +263,78 @@ public:
                          t_real i_bR,
                          t_real o_netUpdateL[2],
                          t_real o_netUpdateR[2]);
+
+  /**
+   * Computes the net-updates for a batch of edges.
+   * Edge i lies between the states (i_hL[i], i_huL[i], i_bL[i]) and (i_hR[i], i_huR[i], i_bR[i]).
+   * Edges which are dry on both sides get zero net-updates.
+   * The kernel matching systeminfo::Isa::active() is used, the portable one on non-x86 machines.
+   *
+   * @param i_nEdges number of edges in the batch.
+   * @param i_hL heights of the left sides.
+   * @param i_hR heights of the right sides.
+   * @param i_huL momenta of the left sides.
+   * @param i_huR momenta of the right sides.
+   * @param i_bL bathymetry of the left sides.
+   * @param i_bR bathymetry of the right sides.
+   * @param o_netUpdateLH will be set to the height net-updates for the left sides.
+   * @param o_netUpdateLHu will be set to the momentum net-updates for the left sides.
+   * @param o_netUpdateRH will be set to the height net-updates for the right sides.
+   * @param o_netUpdateRHu will be set to the momentum net-updates for the right sides.
+   **/
+  static void netUpdatesBatch(t_idx i_nEdges,
+                              t_real const *i_hL,
+                              t_real const *i_hR,
+                              t_real const *i_huL,
+                              t_real const *i_huR,
+                              t_real const *i_bL,
+                              t_real const *i_bR,
+                              t_real *o_netUpdateLH,
+                              t_real *o_netUpdateLHu,
+                              t_real *o_netUpdateRH,
+                              t_real *o_netUpdateRHu);
+
+  /**
+   * Computes the net-updates for a batch of edges from quantities which the edges of a cell share.
+   * The caller computes them once per cell and time step, which spares the square roots of the heights,
+   * the divisions for the particle velocities and the fluxes of the edges.
+   * Dry sides (height 0) have to be given zero velocities; the net-updates match the ones of the overload without the quantities.
+   *
+   * @param i_nEdges number of edges in the batch.
+   * @param i_hL heights of the left sides.
+   * @param i_hR heights of the right sides.
+   * @param i_huL momenta of the left sides.
+   * @param i_huR momenta of the right sides.
+   * @param i_bL bathymetry of the left sides.
+   * @param i_bR bathymetry of the right sides.
+   * @param i_hSqrtL square roots of the heights of the left sides.
+   * @param i_hSqrtR square roots of the heights of the right sides.
+   * @param i_uL particle velocities hu / h of the left sides.
+   * @param i_uR particle velocities hu / h of the right sides.
+   * @param i_fluxL momentum fluxes hu * u + g/2 * h^2 of the left sides.
+   * @param i_fluxR momentum fluxes hu * u + g/2 * h^2 of the right sides.
+   * @param o_netUpdateLH will be set to the height net-updates for the left sides.
+   * @param o_netUpdateLHu will be set to the momentum net-updates for the left sides.
+   * @param o_netUpdateRH will be set to the height net-updates for the right sides.
+   * @param o_netUpdateRHu will be set to the momentum net-updates for the right sides.
+   **/
+  static void netUpdatesBatch(t_idx i_nEdges,
+                              t_real const *i_hL,
+                              t_real const *i_hR,
+                              t_real const *i_huL,
+                              t_real const *i_huR,
+                              t_real const *i_bL,
+                              t_real const *i_bR,
+                              t_real const *i_hSqrtL,
+                              t_real const *i_hSqrtR,
+                              t_real const *i_uL,
+                              t_real const *i_uR,
+                              t_real const *i_fluxL,
+                              t_real const *i_fluxR,
+                              t_real *o_netUpdateLH,
+                              t_real *o_netUpdateLHu,
+                              t_real *o_netUpdateRH,
+                              t_real *o_netUpdateRHu);
 };
 
 #endif
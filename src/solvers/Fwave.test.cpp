@@ -6,6 +6,7 @@
  * Unit tests of the Fwave solver.
  **/
 #include <catch2/catch.hpp>
+#include <cmath>
 #define private public
 #include "Fwave.h"
 #undef public
@@ -201,3 +202,190 @@ TEST_CASE("Test the computation of the F-wave net-updates.", "[FWaveUpdates]")
   REQUIRE(l_netUpdatesR[0] == Approx(0));
   REQUIRE(l_netUpdatesR[1] == Approx(0));
 }
+
+TEST_CASE("Test the batched computation of the F-wave net-updates.", "[FwaveNetUpdatesBatch]")
+{
+  /*
+   * Test case:
+   *   37 edges with varying states, including a steady state,
+   *   supercritical flow, bathymetry jumps and a dry edge.
+   *   The number of edges is no multiple of the vector width
+   *   to cover the scalar remainder.
+   *
+   *   The batched net-updates have to match the ones of the
+   *   single edge solver.
+   */
+  tsunami_lab::t_idx const l_nEdges = 37;
+  tsunami_lab::t_real l_hL[l_nEdges], l_hR[l_nEdges];
+  tsunami_lab::t_real l_huL[l_nEdges], l_huR[l_nEdges];
+  tsunami_lab::t_real l_bL[l_nEdges], l_bR[l_nEdges];
+
+  for (tsunami_lab::t_idx l_ed = 0; l_ed < l_nEdges; l_ed++)
+  {
+    l_hL[l_ed] = 5 + (l_ed % 7);
+    l_hR[l_ed] = 3 + (l_ed % 5);
+    l_huL[l_ed] = (tsunami_lab::t_real(l_ed) - 18) * 1.5;
+    l_huR[l_ed] = (tsunami_lab::t_real(l_ed % 11) - 5) * 2.5;
+    l_bL[l_ed] = -20 + (l_ed % 3);
+    l_bR[l_ed] = -19 - (l_ed % 4);
+  }
+
+  // steady state
+  l_hL[3] = l_hR[3] = 10;
+  l_huL[3] = l_huR[3] = 0;
+  l_bL[3] = l_bR[3] = -10;
+
+  // dry edge
+  l_hL[20] = l_hR[20] = 0;
+  l_huL[20] = l_huR[20] = 0;
+
+  tsunami_lab::t_real l_netUpdatesLH[l_nEdges], l_netUpdatesLHu[l_nEdges];
+  tsunami_lab::t_real l_netUpdatesRH[l_nEdges], l_netUpdatesRHu[l_nEdges];
+
+  // test all kernels supported by the CPU
+  tsunami_lab::systeminfo::Isa::Level l_detected = tsunami_lab::systeminfo::Isa::detect();
+  for (int l_level = tsunami_lab::systeminfo::Isa::SCALAR; l_level <= l_detected; l_level++)
+  {
+    tsunami_lab::systeminfo::Isa::select(tsunami_lab::systeminfo::Isa::Level(l_level));
+
+    tsunami_lab::solvers::Fwave::netUpdatesBatch(l_nEdges,
+                                                 l_hL,
+                                                 l_hR,
+                                                 l_huL,
+                                                 l_huR,
+                                                 l_bL,
+                                                 l_bR,
+                                                 l_netUpdatesLH,
+                                                 l_netUpdatesLHu,
+                                                 l_netUpdatesRH,
+                                                 l_netUpdatesRHu);
+
+    for (tsunami_lab::t_idx l_ed = 0; l_ed < l_nEdges; l_ed++)
+    {
+      if (l_ed == 20)
+        continue;
+
+      tsunami_lab::t_real l_netUpdatesL[2] = {-5, 3};
+      tsunami_lab::t_real l_netUpdatesR[2] = {4, 7};
+      tsunami_lab::solvers::Fwave::netUpdates(l_hL[l_ed],
+                                              l_hR[l_ed],
+                                              l_huL[l_ed],
+                                              l_huR[l_ed],
+                                              l_bL[l_ed],
+                                              l_bR[l_ed],
+                                              l_netUpdatesL,
+                                              l_netUpdatesR);
+
+      REQUIRE(l_netUpdatesLH[l_ed] == Approx(l_netUpdatesL[0]).margin(1E-4));
+      REQUIRE(l_netUpdatesLHu[l_ed] == Approx(l_netUpdatesL[1]).margin(1E-4));
+      REQUIRE(l_netUpdatesRH[l_ed] == Approx(l_netUpdatesR[0]).margin(1E-4));
+      REQUIRE(l_netUpdatesRHu[l_ed] == Approx(l_netUpdatesR[1]).margin(1E-4));
+    }
+
+    REQUIRE(l_netUpdatesLH[20] == 0);
+    REQUIRE(l_netUpdatesLHu[20] == 0);
+    REQUIRE(l_netUpdatesRH[20] == 0);
+    REQUIRE(l_netUpdatesRHu[20] == 0);
+  }
+  tsunami_lab::systeminfo::Isa::select(l_detected);
+}
+
+TEST_CASE("Test the batched computation of the F-wave net-updates from shared cell quantities.", "[FwaveNetUpdatesBatchShared]")
+{
+  /*
+   * Test case:
+   *   37 edges with varying states and a dry edge, see above.
+   *   The square roots, velocities and fluxes of the sides
+   *   are computed in advance as the patches do per cell.
+   *
+   *   The net-updates have to match the ones of the batch
+   *   computation from the states only.
+   */
+  tsunami_lab::t_idx const l_nEdges = 37;
+  tsunami_lab::t_real l_hL[l_nEdges], l_hR[l_nEdges];
+  tsunami_lab::t_real l_huL[l_nEdges], l_huR[l_nEdges];
+  tsunami_lab::t_real l_bL[l_nEdges], l_bR[l_nEdges];
+  tsunami_lab::t_real l_hSqrtL[l_nEdges], l_hSqrtR[l_nEdges];
+  tsunami_lab::t_real l_uL[l_nEdges], l_uR[l_nEdges];
+  tsunami_lab::t_real l_fluxL[l_nEdges], l_fluxR[l_nEdges];
+
+  for (tsunami_lab::t_idx l_ed = 0; l_ed < l_nEdges; l_ed++)
+  {
+    l_hL[l_ed] = 5 + (l_ed % 7);
+    l_hR[l_ed] = 3 + (l_ed % 5);
+    l_huL[l_ed] = (tsunami_lab::t_real(l_ed) - 18) * 1.5;
+    l_huR[l_ed] = (tsunami_lab::t_real(l_ed % 11) - 5) * 2.5;
+    l_bL[l_ed] = -20 + (l_ed % 3);
+    l_bR[l_ed] = -19 - (l_ed % 4);
+  }
+
+  // dry edge
+  l_hL[20] = l_hR[20] = 0;
+  l_huL[20] = l_huR[20] = 0;
+
+  for (tsunami_lab::t_idx l_ed = 0; l_ed < l_nEdges; l_ed++)
+  {
+    l_hSqrtL[l_ed] = std::sqrt(l_hL[l_ed]);
+    l_hSqrtR[l_ed] = std::sqrt(l_hR[l_ed]);
+    l_uL[l_ed] = l_hL[l_ed] > 0 ? l_huL[l_ed] / l_hL[l_ed] : 0;
+    l_uR[l_ed] = l_hR[l_ed] > 0 ? l_huR[l_ed] / l_hR[l_ed] : 0;
+    l_fluxL[l_ed] = l_huL[l_ed] * l_uL[l_ed] + tsunami_lab::t_real(0.5) * tsunami_lab::t_real(9.80665) * l_hL[l_ed] * l_hL[l_ed];
+    l_fluxR[l_ed] = l_huR[l_ed] * l_uR[l_ed] + tsunami_lab::t_real(0.5) * tsunami_lab::t_real(9.80665) * l_hR[l_ed] * l_hR[l_ed];
+  }
+
+  tsunami_lab::t_real l_netUpdatesLH[l_nEdges], l_netUpdatesLHu[l_nEdges];
+  tsunami_lab::t_real l_netUpdatesRH[l_nEdges], l_netUpdatesRHu[l_nEdges];
+  tsunami_lab::t_real l_refLH[l_nEdges], l_refLHu[l_nEdges];
+  tsunami_lab::t_real l_refRH[l_nEdges], l_refRHu[l_nEdges];
+
+  // test all kernels supported by the CPU
+  tsunami_lab::systeminfo::Isa::Level l_detected = tsunami_lab::systeminfo::Isa::detect();
+  for (int l_level = tsunami_lab::systeminfo::Isa::SCALAR; l_level <= l_detected; l_level++)
+  {
+    tsunami_lab::systeminfo::Isa::select(tsunami_lab::systeminfo::Isa::Level(l_level));
+
+    tsunami_lab::solvers::Fwave::netUpdatesBatch(l_nEdges,
+                                                 l_hL,
+                                                 l_hR,
+                                                 l_huL,
+                                                 l_huR,
+                                                 l_bL,
+                                                 l_bR,
+                                                 l_refLH,
+                                                 l_refLHu,
+                                                 l_refRH,
+                                                 l_refRHu);
+
+    tsunami_lab::solvers::Fwave::netUpdatesBatch(l_nEdges,
+                                                 l_hL,
+                                                 l_hR,
+                                                 l_huL,
+                                                 l_huR,
+                                                 l_bL,
+                                                 l_bR,
+                                                 l_hSqrtL,
+                                                 l_hSqrtR,
+                                                 l_uL,
+                                                 l_uR,
+                                                 l_fluxL,
+                                                 l_fluxR,
+                                                 l_netUpdatesLH,
+                                                 l_netUpdatesLHu,
+                                                 l_netUpdatesRH,
+                                                 l_netUpdatesRHu);
+
+    for (tsunami_lab::t_idx l_ed = 0; l_ed < l_nEdges; l_ed++)
+    {
+      REQUIRE(l_netUpdatesLH[l_ed] == Approx(l_refLH[l_ed]).margin(1E-4));
+      REQUIRE(l_netUpdatesLHu[l_ed] == Approx(l_refLHu[l_ed]).margin(1E-4));
+      REQUIRE(l_netUpdatesRH[l_ed] == Approx(l_refRH[l_ed]).margin(1E-4));
+      REQUIRE(l_netUpdatesRHu[l_ed] == Approx(l_refRHu[l_ed]).margin(1E-4));
+    }
+
+    REQUIRE(l_netUpdatesLH[20] == 0);
+    REQUIRE(l_netUpdatesLHu[20] == 0);
+    REQUIRE(l_netUpdatesRH[20] == 0);
+    REQUIRE(l_netUpdatesRHu[20] == 0);
+  }
+  tsunami_lab::systeminfo::Isa::select(l_detected);
+}
@@ -0,0 +1,182 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Linearized F-wave solver for the one-dimensional shallow water equations.
+ **/
+#include "Linear.h"
+#include <cmath>
+
+/**
+ * Computes the net-updates of the edges [i_first, i_last).
+ * The loop is compiled for every instruction set by the variants below.
+ **/
+static TSUNAMI_LAB_INLINE void netUpdatesKernel(tsunami_lab::t_idx i_first,
+                                                tsunami_lab::t_idx i_last,
+                                                tsunami_lab::t_real i_g,
+                                                tsunami_lab::t_real const *i_hL,
+                                                tsunami_lab::t_real const *i_hR,
+                                                tsunami_lab::t_real const *i_huL,
+                                                tsunami_lab::t_real const *i_huR,
+                                                tsunami_lab::t_real const *i_bL,
+                                                tsunami_lab::t_real const *i_bR,
+                                                tsunami_lab::t_real *o_netUpdateLH,
+                                                tsunami_lab::t_real *o_netUpdateLHu,
+                                                tsunami_lab::t_real *o_netUpdateRH,
+                                                tsunami_lab::t_real *o_netUpdateRHu)
+{
+#pragma omp simd
+  for (tsunami_lab::t_idx l_ed = i_first; l_ed < i_last; l_ed++)
+  {
+    // wave speeds of the mean height
+    tsunami_lab::t_real l_hMean = tsunami_lab::t_real(0.5) * (i_hL[l_ed] + i_hR[l_ed]);
+    tsunami_lab::t_real l_c = std::sqrt(i_g * l_hMean);
+
+    // flux difference; the surface difference combines the pressure and the bathymetry source term
+    tsunami_lab::t_real l_fDelta0 = i_huR[l_ed] - i_huL[l_ed];
+    tsunami_lab::t_real l_etaDelta = (i_hR[l_ed] - i_hL[l_ed]) + (i_bR[l_ed] - i_bL[l_ed]);
+
+    // eigencoefficients of the eigenvectors (1, -c) and (1, c), with g * h / c = c
+    tsunami_lab::t_real l_a1 = tsunami_lab::t_real(0.5) * (l_fDelta0 - l_c * l_etaDelta);
+    tsunami_lab::t_real l_a2 = tsunami_lab::t_real(0.5) * (l_fDelta0 + l_c * l_etaDelta);
+
+    o_netUpdateLH[l_ed] = l_a1;
+    o_netUpdateLHu[l_ed] = -l_c * l_a1;
+    o_netUpdateRH[l_ed] = l_a2;
+    o_netUpdateRHu[l_ed] = l_c * l_a2;
+  }
+}
+
+void tsunami_lab::solvers::Linear::netUpdates(t_real i_hL,
+                                              t_real i_hR,
+                                              t_real i_huL,
+                                              t_real i_huR,
+                                              t_real i_bL,
+                                              t_real i_bR,
+                                              t_real o_netUpdateL[2],
+                                              t_real o_netUpdateR[2])
+{
+  netUpdatesKernel(0,
+                   1,
+                   m_g,
+                   &i_hL, &i_hR,
+                   &i_huL, &i_huR,
+                   &i_bL, &i_bR,
+                   o_netUpdateL, o_netUpdateL + 1,
+                   o_netUpdateR, o_netUpdateR + 1);
+}
+
+void tsunami_lab::solvers::Linear::netUpdatesBatchScalar(t_idx i_first,
+                                                         t_idx i_last,
+                                                         t_real const *i_hL,
+                                                         t_real const *i_hR,
+                                                         t_real const *i_huL,
+                                                         t_real const *i_huR,
+                                                         t_real const *i_bL,
+                                                         t_real const *i_bR,
+                                                         t_real *o_netUpdateLH,
+                                                         t_real *o_netUpdateLHu,
+                                                         t_real *o_netUpdateRH,
+                                                         t_real *o_netUpdateRHu)
+{
+  netUpdatesKernel(i_first,
+                   i_last,
+                   m_g,
+                   i_hL, i_hR,
+                   i_huL, i_huR,
+                   i_bL, i_bR,
+                   o_netUpdateLH, o_netUpdateLHu,
+                   o_netUpdateRH, o_netUpdateRHu);
+}
+
+#ifdef TSUNAMI_LAB_ISA_X86
+TSUNAMI_LAB_TARGET_AVX2 void tsunami_lab::solvers::Linear::netUpdatesBatchAvx2(t_idx i_nEdges,
+                                                                               t_real const *i_hL,
+                                                                               t_real const *i_hR,
+                                                                               t_real const *i_huL,
+                                                                               t_real const *i_huR,
+                                                                               t_real const *i_bL,
+                                                                               t_real const *i_bR,
+                                                                               t_real *o_netUpdateLH,
+                                                                               t_real *o_netUpdateLHu,
+                                                                               t_real *o_netUpdateRH,
+                                                                               t_real *o_netUpdateRHu)
+{
+  netUpdatesKernel(0,
+                   i_nEdges,
+                   m_g,
+                   i_hL, i_hR,
+                   i_huL, i_huR,
+                   i_bL, i_bR,
+                   o_netUpdateLH, o_netUpdateLHu,
+                   o_netUpdateRH, o_netUpdateRHu);
+}
+
+TSUNAMI_LAB_TARGET_AVX512 void tsunami_lab::solvers::Linear::netUpdatesBatchAvx512(t_idx i_nEdges,
+                                                                                   t_real const *i_hL,
+                                                                                   t_real const *i_hR,
+                                                                                   t_real const *i_huL,
+                                                                                   t_real const *i_huR,
+                                                                                   t_real const *i_bL,
+                                                                                   t_real const *i_bR,
+                                                                                   t_real *o_netUpdateLH,
+                                                                                   t_real *o_netUpdateLHu,
+                                                                                   t_real *o_netUpdateRH,
+                                                                                   t_real *o_netUpdateRHu)
+{
+  netUpdatesKernel(0,
+                   i_nEdges,
+                   m_g,
+                   i_hL, i_hR,
+                   i_huL, i_huR,
+                   i_bL, i_bR,
+                   o_netUpdateLH, o_netUpdateLHu,
+                   o_netUpdateRH, o_netUpdateRHu);
+}
+#endif
+
+void tsunami_lab::solvers::Linear::netUpdatesBatch(t_idx i_nEdges,
+                                                   t_real const *i_hL,
+                                                   t_real const *i_hR,
+                                                   t_real const *i_huL,
+                                                   t_real const *i_huR,
+                                                   t_real const *i_bL,
+                                                   t_real const *i_bR,
+                                                   t_real *o_netUpdateLH,
+                                                   t_real *o_netUpdateLHu,
+                                                   t_real *o_netUpdateRH,
+                                                   t_real *o_netUpdateRHu)
+{
+#ifdef TSUNAMI_LAB_ISA_X86
+  switch (systeminfo::Isa::active())
+  {
+  case systeminfo::Isa::AVX512:
+    netUpdatesBatchAvx512(i_nEdges,
+                          i_hL, i_hR,
+                          i_huL, i_huR,
+                          i_bL, i_bR,
+                          o_netUpdateLH, o_netUpdateLHu,
+                          o_netUpdateRH, o_netUpdateRHu);
+    return;
+  case systeminfo::Isa::AVX2:
+    netUpdatesBatchAvx2(i_nEdges,
+                        i_hL, i_hR,
+                        i_huL, i_huR,
+                        i_bL, i_bR,
+                        o_netUpdateLH, o_netUpdateLHu,
+                        o_netUpdateRH, o_netUpdateRHu);
+    return;
+  default:
+    break;
+  }
+#endif
+
+  netUpdatesBatchScalar(0,
+                        i_nEdges,
+                        i_hL, i_hR,
+                        i_huL, i_huR,
+                        i_bL, i_bR,
+                        o_netUpdateLH, o_netUpdateLHu,
+                        o_netUpdateRH, o_netUpdateRHu);
+}
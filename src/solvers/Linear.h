@@ -0,0 +1,140 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Linearized F-wave solver for the one-dimensional shallow water equations.
+ **/
+#ifndef TSUNAMI_LAB_SOLVERS_LINEAR
+#define TSUNAMI_LAB_SOLVERS_LINEAR
+
+#include "../constants.h"
+#include "../systeminfo/Isa.h"
+#include "Fwave.h"
+
+namespace tsunami_lab
+{
+  namespace solvers
+  {
+    class Linear;
+  }
+}
+
+/**
+ * F-wave solver for the shallow water equations linearized about the ocean at rest.
+ * The advection of the momentum is neglected, which leaves the hydrostatic pressure and the bathymetry source term:
+ * the flux difference of an edge is (huR - huL, g * h * (etaR - etaL)) with the mean height h = (hL + hR) / 2 and the surfaces eta = h + b.
+ * The waves travel at -sqrt(g * h) and +sqrt(g * h), which costs one square root and no divisions per edge.
+ * For resting water the net-updates match the ones of the F-wave solver, the ocean at rest stays at rest.
+ * The approximation holds in deep water with small amplitudes only; both sides of an edge have to be wet.
+ **/
+class tsunami_lab::solvers::Linear
+{
+private:
+  //! gravity constant of the F-wave solver, which solves the other edges of the patches
+  static t_real constexpr m_g = Fwave::m_g;
+
+  /**
+   * Computes the net-updates for the edges [i_first, i_last) of a batch for the instruction set the caller is compiled for.
+   * The parameters are the ones of netUpdatesBatch.
+   **/
+  static void netUpdatesBatchScalar(t_idx i_first,
+                                    t_idx i_last,
+                                    t_real const *i_hL,
+                                    t_real const *i_hR,
+                                    t_real const *i_huL,
+                                    t_real const *i_huR,
+                                    t_real const *i_bL,
+                                    t_real const *i_bR,
+                                    t_real *o_netUpdateLH,
+                                    t_real *o_netUpdateLHu,
+                                    t_real *o_netUpdateRH,
+                                    t_real *o_netUpdateRHu);
+
+#ifdef TSUNAMI_LAB_ISA_X86
+  /**
+   * Computes the net-updates for a batch using AVX2 (8 edges per instruction).
+   * The parameters are the ones of netUpdatesBatch.
+   **/
+  TSUNAMI_LAB_TARGET_AVX2 static void netUpdatesBatchAvx2(t_idx i_nEdges,
+                                                          t_real const *i_hL,
+                                                          t_real const *i_hR,
+                                                          t_real const *i_huL,
+                                                          t_real const *i_huR,
+                                                          t_real const *i_bL,
+                                                          t_real const *i_bR,
+                                                          t_real *o_netUpdateLH,
+                                                          t_real *o_netUpdateLHu,
+                                                          t_real *o_netUpdateRH,
+                                                          t_real *o_netUpdateRHu);
+
+  /**
+   * Computes the net-updates for a batch using AVX-512 (16 edges per instruction).
+   * The parameters are the ones of netUpdatesBatch.
+   **/
+  TSUNAMI_LAB_TARGET_AVX512 static void netUpdatesBatchAvx512(t_idx i_nEdges,
+                                                              t_real const *i_hL,
+                                                              t_real const *i_hR,
+                                                              t_real const *i_huL,
+                                                              t_real const *i_huR,
+                                                              t_real const *i_bL,
+                                                              t_real const *i_bR,
+                                                              t_real *o_netUpdateLH,
+                                                              t_real *o_netUpdateLHu,
+                                                              t_real *o_netUpdateRH,
+                                                              t_real *o_netUpdateRHu);
+#endif
+
+public:
+  /**
+   * Computes the net-updates.
+   *
+   * @param i_hL height of the left side.
+   * @param i_hR height of the right side.
+   * @param i_huL momentum of the left side.
+   * @param i_huR momentum of the right side.
+   * @param i_bL left bathymetry
+   * @param i_bR right bathymetry
+   * @param o_netUpdateL will be set to the net-updates for the left side; 0: height, 1: momentum.
+   * @param o_netUpdateR will be set to the net-updates for the right side; 0: height, 1: momentum.
+   **/
+  static void netUpdates(t_real i_hL,
+                         t_real i_hR,
+                         t_real i_huL,
+                         t_real i_huR,
+                         t_real i_bL,
+                         t_real i_bR,
+                         t_real o_netUpdateL[2],
+                         t_real o_netUpdateR[2]);
+
+  /**
+   * Computes the net-updates for a batch of edges.
+   * Edge i lies between the states (i_hL[i], i_huL[i], i_bL[i]) and (i_hR[i], i_huR[i], i_bR[i]).
+   * The kernel matching systeminfo::Isa::active() is used, the portable one on non-x86 machines.
+   *
+   * @param i_nEdges number of edges in the batch.
+   * @param i_hL heights of the left sides.
+   * @param i_hR heights of the right sides.
+   * @param i_huL momenta of the left sides.
+   * @param i_huR momenta of the right sides.
+   * @param i_bL bathymetry of the left sides.
+   * @param i_bR bathymetry of the right sides.
+   * @param o_netUpdateLH will be set to the height net-updates for the left sides.
+   * @param o_netUpdateLHu will be set to the momentum net-updates for the left sides.
+   * @param o_netUpdateRH will be set to the height net-updates for the right sides.
+   * @param o_netUpdateRHu will be set to the momentum net-updates for the right sides.
+   **/
+  static void netUpdatesBatch(t_idx i_nEdges,
+                              t_real const *i_hL,
+                              t_real const *i_hR,
+                              t_real const *i_huL,
+                              t_real const *i_huR,
+                              t_real const *i_bL,
+                              t_real const *i_bR,
+                              t_real *o_netUpdateLH,
+                              t_real *o_netUpdateLHu,
+                              t_real *o_netUpdateRH,
+                              t_real *o_netUpdateRHu);
+};
+
+#endif
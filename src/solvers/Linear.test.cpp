@@ -0,0 +1,159 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Unit tests of the linearized F-wave solver.
+ **/
+#include <catch2/catch.hpp>
+#include "Linear.h"
+#include "Fwave.h"
+
+TEST_CASE("Test the computation of the linearized net-updates.", "[LinearUpdates]")
+{
+  /*
+   * Test case:
+   *
+   *      left | right
+   *  h:    10 | 12
+   *  hu:    5 | -3
+   *  b:   -10 | -11
+   *
+   * mean height: 11
+   * wave speeds: -c, c with c = sqrt(9.80665 * 11) = 10.386199978818047
+   * flux difference: (-3 - 5, g * 11 * ((12 - 11) - (10 - 10))) = (-8, c^2)
+   *
+   * eigencoefficients: a1 = (-8 - c) / 2 = -9.193099989409024
+   *                    a2 = (-8 + c) / 2 =  1.1930999894090233
+   *
+   * net-updates: left:  a1 * (1, -c) = (-9.193099989409024, 95.48137491527218)
+   *              right: a2 * (1,  c) = ( 1.1930999894090233, 12.39177508472781)
+   */
+  tsunami_lab::t_real l_netUpdatesL[2] = {-5, 3};
+  tsunami_lab::t_real l_netUpdatesR[2] = {4, 7};
+
+  tsunami_lab::solvers::Linear::netUpdates(10,
+                                           12,
+                                           5,
+                                           -3,
+                                           -10,
+                                           -11,
+                                           l_netUpdatesL,
+                                           l_netUpdatesR);
+
+  REQUIRE(l_netUpdatesL[0] == Approx(-9.193099989409024));
+  REQUIRE(l_netUpdatesL[1] == Approx(95.48137491527218));
+  REQUIRE(l_netUpdatesR[0] == Approx(1.1930999894090233));
+  REQUIRE(l_netUpdatesR[1] == Approx(12.39177508472781));
+
+  /*
+   * Test case (ocean at rest with a bathymetry step):
+   *
+   *      left | right
+   *  h:  4000 | 3500
+   *  hu:    0 | 0
+   *  b: -4000 | -3500
+   *
+   * The surfaces match, there are no net-updates.
+   */
+  tsunami_lab::solvers::Linear::netUpdates(4000,
+                                           3500,
+                                           0,
+                                           0,
+                                           -4000,
+                                           -3500,
+                                           l_netUpdatesL,
+                                           l_netUpdatesR);
+
+  REQUIRE(l_netUpdatesL[0] == Approx(0));
+  REQUIRE(l_netUpdatesL[1] == Approx(0));
+  REQUIRE(l_netUpdatesR[0] == Approx(0));
+  REQUIRE(l_netUpdatesR[1] == Approx(0));
+}
+
+TEST_CASE("Test the batched computation of the linearized net-updates.", "[LinearNetUpdatesBatch]")
+{
+  /*
+   * Test case:
+   *   37 deep water edges with small amplitudes and varying momenta.
+   *   The number of edges is no multiple of the vector width.
+   *
+   *   The batched net-updates have to match the ones of the single edge solver.
+   *   The edges without momenta have to match the F-wave solver,
+   *   whose flux difference is the linearized one for resting water.
+   */
+  tsunami_lab::t_idx const l_nEdges = 37;
+  tsunami_lab::t_real l_hL[l_nEdges], l_hR[l_nEdges];
+  tsunami_lab::t_real l_huL[l_nEdges], l_huR[l_nEdges];
+  tsunami_lab::t_real l_bL[l_nEdges], l_bR[l_nEdges];
+
+  for (tsunami_lab::t_idx l_ed = 0; l_ed < l_nEdges; l_ed++)
+  {
+    l_bL[l_ed] = -3000 - 100 * tsunami_lab::t_real(l_ed % 7);
+    l_bR[l_ed] = -3000 - 100 * tsunami_lab::t_real(l_ed % 5);
+    l_hL[l_ed] = -l_bL[l_ed] + tsunami_lab::t_real(l_ed % 3) - 1;
+    l_hR[l_ed] = -l_bR[l_ed] + tsunami_lab::t_real(l_ed % 4) * 0.5;
+    l_huL[l_ed] = l_ed % 2 == 0 ? 0 : (tsunami_lab::t_real(l_ed) - 18) * 10;
+    l_huR[l_ed] = l_ed % 2 == 0 ? 0 : (tsunami_lab::t_real(l_ed % 11) - 5) * 20;
+  }
+
+  tsunami_lab::t_real l_netUpdatesLH[l_nEdges], l_netUpdatesLHu[l_nEdges];
+  tsunami_lab::t_real l_netUpdatesRH[l_nEdges], l_netUpdatesRHu[l_nEdges];
+
+  // test all kernels supported by the CPU
+  tsunami_lab::systeminfo::Isa::Level l_detected = tsunami_lab::systeminfo::Isa::detect();
+  for (int l_level = tsunami_lab::systeminfo::Isa::SCALAR; l_level <= l_detected; l_level++)
+  {
+    tsunami_lab::systeminfo::Isa::select(tsunami_lab::systeminfo::Isa::Level(l_level));
+
+    tsunami_lab::solvers::Linear::netUpdatesBatch(l_nEdges,
+                                                  l_hL,
+                                                  l_hR,
+                                                  l_huL,
+                                                  l_huR,
+                                                  l_bL,
+                                                  l_bR,
+                                                  l_netUpdatesLH,
+                                                  l_netUpdatesLHu,
+                                                  l_netUpdatesRH,
+                                                  l_netUpdatesRHu);
+
+    for (tsunami_lab::t_idx l_ed = 0; l_ed < l_nEdges; l_ed++)
+    {
+      tsunami_lab::t_real l_netUpdatesL[2] = {-5, 3};
+      tsunami_lab::t_real l_netUpdatesR[2] = {4, 7};
+      tsunami_lab::solvers::Linear::netUpdates(l_hL[l_ed],
+                                               l_hR[l_ed],
+                                               l_huL[l_ed],
+                                               l_huR[l_ed],
+                                               l_bL[l_ed],
+                                               l_bR[l_ed],
+                                               l_netUpdatesL,
+                                               l_netUpdatesR);
+
+      REQUIRE(l_netUpdatesLH[l_ed] == Approx(l_netUpdatesL[0]).margin(1E-3));
+      REQUIRE(l_netUpdatesLHu[l_ed] == Approx(l_netUpdatesL[1]).margin(1E-3));
+      REQUIRE(l_netUpdatesRH[l_ed] == Approx(l_netUpdatesR[0]).margin(1E-3));
+      REQUIRE(l_netUpdatesRHu[l_ed] == Approx(l_netUpdatesR[1]).margin(1E-3));
+
+      if (l_ed % 2 == 0)
+      {
+        tsunami_lab::solvers::Fwave::netUpdates(l_hL[l_ed],
+                                                l_hR[l_ed],
+                                                l_huL[l_ed],
+                                                l_huR[l_ed],
+                                                l_bL[l_ed],
+                                                l_bR[l_ed],
+                                                l_netUpdatesL,
+                                                l_netUpdatesR);
+
+        // the F-wave solver subtracts the large pressure terms of the deep water, which costs digits
+        REQUIRE(l_netUpdatesLH[l_ed] == Approx(l_netUpdatesL[0]).epsilon(1E-3).margin(0.05));
+        REQUIRE(l_netUpdatesLHu[l_ed] == Approx(l_netUpdatesL[1]).epsilon(1E-3).margin(5));
+        REQUIRE(l_netUpdatesRH[l_ed] == Approx(l_netUpdatesR[0]).epsilon(1E-3).margin(0.05));
+        REQUIRE(l_netUpdatesRHu[l_ed] == Approx(l_netUpdatesR[1]).epsilon(1E-3).margin(5));
+      }
+    }
+  }
+  tsunami_lab::systeminfo::Isa::select(l_detected);
+}
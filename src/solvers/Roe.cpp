@@ -7,6 +7,10 @@
 #include "Roe.h"
 #include <cmath>
 
+#ifdef TSUNAMI_LAB_ISA_X86
+#include <immintrin.h>
+#endif
+
 void tsunami_lab::solvers::Roe::waveSpeeds(t_real i_hL,
                                            t_real i_hR,
                                            t_real i_uL,
@@ -131,4 +135,373 @@ void tsunami_lab::solvers::Roe::netUpdates(t_real i_hL,
       o_netUpdateL[l_qt] = l_waveR[l_qt];
     }
   }
-}
\ No newline at end of file
+}
+
+void tsunami_lab::solvers::Roe::netUpdatesBatchScalar(t_idx i_first,
+                                                      t_idx i_last,
+                                                      t_real const *i_hL,
+                                                      t_real const *i_hR,
+                                                      t_real const *i_huL,
+                                                      t_real const *i_huR,
+                                                      t_real *o_netUpdateLH,
+                                                      t_real *o_netUpdateLHu,
+                                                      t_real *o_netUpdateRH,
+                                                      t_real *o_netUpdateRHu)
+{
+  for (t_idx l_ed = i_first; l_ed < i_last; l_ed++)
+  {
+    // compute particle velocities
+    t_real l_uL = i_huL[l_ed] / i_hL[l_ed];
+    t_real l_uR = i_huR[l_ed] / i_hR[l_ed];
+
+    // compute wave speeds
+    t_real l_sL = 0;
+    t_real l_sR = 0;
+    waveSpeeds(i_hL[l_ed], i_hR[l_ed], l_uL, l_uR, l_sL, l_sR);
+
+    // compute wave strengths
+    t_real l_aL = 0;
+    t_real l_aR = 0;
+    waveStrengths(i_hL[l_ed], i_hR[l_ed], i_huL[l_ed], i_huR[l_ed], l_sL, l_sR, l_aL, l_aR);
+
+    // compute scaled waves
+    t_real l_waveL[2] = {l_sL * l_aL, l_sL * l_aL * l_sL};
+    t_real l_waveR[2] = {l_sR * l_aR, l_sR * l_aR * l_sR};
+
+    // the 2nd wave overwrites the 1st one if both propagate to the same side
+    o_netUpdateLH[l_ed] = l_sR > 0 ? (l_sL < 0 ? l_waveL[0] : 0) : l_waveR[0];
+    o_netUpdateLHu[l_ed] = l_sR > 0 ? (l_sL < 0 ? l_waveL[1] : 0) : l_waveR[1];
+    o_netUpdateRH[l_ed] = l_sR > 0 ? l_waveR[0] : (l_sL < 0 ? 0 : l_waveL[0]);
+    o_netUpdateRHu[l_ed] = l_sR > 0 ? l_waveR[1] : (l_sL < 0 ? 0 : l_waveL[1]);
+  }
+}
+
+#ifdef TSUNAMI_LAB_ISA_X86
+TSUNAMI_LAB_TARGET_SSE2 tsunami_lab::t_idx tsunami_lab::solvers::Roe::netUpdatesBatchSse2(t_idx i_nEdges,
+                                                                                          t_real const *i_hL,
+                                                                                          t_real const *i_hR,
+                                                                                          t_real const *i_huL,
+                                                                                          t_real const *i_huR,
+                                                                                          t_real *o_netUpdateLH,
+                                                                                          t_real *o_netUpdateLHu,
+                                                                                          t_real *o_netUpdateRH,
+                                                                                          t_real *o_netUpdateRHu)
+{
+  static_assert(sizeof(t_real) == sizeof(float), "the SSE2 kernel requires single precision");
+
+  __m128 const l_zero = _mm_setzero_ps();
+  __m128 const l_one = _mm_set1_ps(1);
+  __m128 const l_half = _mm_set1_ps(0.5);
+  __m128 const l_gSqrtV = _mm_set1_ps(m_gSqrt);
+
+  t_idx l_ed = 0;
+  for (; l_ed + 4 <= i_nEdges; l_ed += 4)
+  {
+    __m128 l_hL = _mm_loadu_ps(i_hL + l_ed);
+    __m128 l_hR = _mm_loadu_ps(i_hR + l_ed);
+    __m128 l_huL = _mm_loadu_ps(i_huL + l_ed);
+    __m128 l_huR = _mm_loadu_ps(i_huR + l_ed);
+
+    // compute particle velocities
+    __m128 l_uL = _mm_div_ps(l_huL, l_hL);
+    __m128 l_uR = _mm_div_ps(l_huR, l_hR);
+
+    // compute wave speeds
+    __m128 l_hSqrtL = _mm_sqrt_ps(l_hL);
+    __m128 l_hSqrtR = _mm_sqrt_ps(l_hR);
+    __m128 l_hRoe = _mm_mul_ps(l_half, _mm_add_ps(l_hL, l_hR));
+    __m128 l_uRoe = _mm_add_ps(_mm_mul_ps(l_hSqrtL, l_uL), _mm_mul_ps(l_hSqrtR, l_uR));
+    l_uRoe = _mm_div_ps(l_uRoe, _mm_add_ps(l_hSqrtL, l_hSqrtR));
+    __m128 l_ghSqrtRoe = _mm_mul_ps(l_gSqrtV, _mm_sqrt_ps(l_hRoe));
+    __m128 l_sL = _mm_sub_ps(l_uRoe, l_ghSqrtRoe);
+    __m128 l_sR = _mm_add_ps(l_uRoe, l_ghSqrtRoe);
+
+    // compute wave strengths
+    __m128 l_detInv = _mm_div_ps(l_one, _mm_sub_ps(l_sR, l_sL));
+    __m128 l_hJump = _mm_sub_ps(l_hR, l_hL);
+    __m128 l_huJump = _mm_sub_ps(l_huR, l_huL);
+    __m128 l_aL = _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(l_detInv, l_sR), l_hJump), _mm_mul_ps(l_detInv, l_huJump));
+    __m128 l_aR = _mm_sub_ps(_mm_mul_ps(l_detInv, l_huJump), _mm_mul_ps(_mm_mul_ps(l_detInv, l_sL), l_hJump));
+
+    // compute scaled waves
+    __m128 l_waveLH = _mm_mul_ps(l_sL, l_aL);
+    __m128 l_waveLHu = _mm_mul_ps(l_waveLH, l_sL);
+    __m128 l_waveRH = _mm_mul_ps(l_sR, l_aR);
+    __m128 l_waveRHu = _mm_mul_ps(l_waveRH, l_sR);
+
+    // assign the 1st wave
+    __m128 l_leftGoingL = _mm_cmplt_ps(l_sL, l_zero);
+    __m128 l_netUpdateLH = _mm_and_ps(l_leftGoingL, l_waveLH);
+    __m128 l_netUpdateLHu = _mm_and_ps(l_leftGoingL, l_waveLHu);
+    __m128 l_netUpdateRH = _mm_andnot_ps(l_leftGoingL, l_waveLH);
+    __m128 l_netUpdateRHu = _mm_andnot_ps(l_leftGoingL, l_waveLHu);
+
+    // the 2nd wave overwrites the 1st one if both propagate to the same side
+    __m128 l_rightGoingR = _mm_cmpgt_ps(l_sR, l_zero);
+    l_netUpdateLH = _mm_or_ps(_mm_and_ps(l_rightGoingR, l_netUpdateLH), _mm_andnot_ps(l_rightGoingR, l_waveRH));
+    l_netUpdateLHu = _mm_or_ps(_mm_and_ps(l_rightGoingR, l_netUpdateLHu), _mm_andnot_ps(l_rightGoingR, l_waveRHu));
+    l_netUpdateRH = _mm_or_ps(_mm_and_ps(l_rightGoingR, l_waveRH), _mm_andnot_ps(l_rightGoingR, l_netUpdateRH));
+    l_netUpdateRHu = _mm_or_ps(_mm_and_ps(l_rightGoingR, l_waveRHu), _mm_andnot_ps(l_rightGoingR, l_netUpdateRHu));
+
+    _mm_storeu_ps(o_netUpdateLH + l_ed, l_netUpdateLH);
+    _mm_storeu_ps(o_netUpdateLHu + l_ed, l_netUpdateLHu);
+    _mm_storeu_ps(o_netUpdateRH + l_ed, l_netUpdateRH);
+    _mm_storeu_ps(o_netUpdateRHu + l_ed, l_netUpdateRHu);
+  }
+
+  return l_ed;
+}
+
+TSUNAMI_LAB_TARGET_AVX2 tsunami_lab::t_idx tsunami_lab::solvers::Roe::netUpdatesBatchAvx2(t_idx i_nEdges,
+                                                                                          t_real const *i_hL,
+                                                                                          t_real const *i_hR,
+                                                                                          t_real const *i_huL,
+                                                                                          t_real const *i_huR,
+                                                                                          t_real *o_netUpdateLH,
+                                                                                          t_real *o_netUpdateLHu,
+                                                                                          t_real *o_netUpdateRH,
+                                                                                          t_real *o_netUpdateRHu)
+{
+  static_assert(sizeof(t_real) == sizeof(float), "the AVX2 kernel requires single precision");
+
+  __m256 const l_zero = _mm256_setzero_ps();
+  __m256 const l_one = _mm256_set1_ps(1);
+  __m256 const l_half = _mm256_set1_ps(0.5);
+  __m256 const l_gSqrtV = _mm256_set1_ps(m_gSqrt);
+
+  t_idx l_ed = 0;
+  for (; l_ed + 8 <= i_nEdges; l_ed += 8)
+  {
+    __m256 l_hL = _mm256_loadu_ps(i_hL + l_ed);
+    __m256 l_hR = _mm256_loadu_ps(i_hR + l_ed);
+    __m256 l_huL = _mm256_loadu_ps(i_huL + l_ed);
+    __m256 l_huR = _mm256_loadu_ps(i_huR + l_ed);
+
+    // compute particle velocities
+    __m256 l_uL = _mm256_div_ps(l_huL, l_hL);
+    __m256 l_uR = _mm256_div_ps(l_huR, l_hR);
+
+    // compute wave speeds
+    __m256 l_hSqrtL = _mm256_sqrt_ps(l_hL);
+    __m256 l_hSqrtR = _mm256_sqrt_ps(l_hR);
+    __m256 l_hRoe = _mm256_mul_ps(l_half, _mm256_add_ps(l_hL, l_hR));
+    __m256 l_uRoe = _mm256_add_ps(_mm256_mul_ps(l_hSqrtL, l_uL), _mm256_mul_ps(l_hSqrtR, l_uR));
+    l_uRoe = _mm256_div_ps(l_uRoe, _mm256_add_ps(l_hSqrtL, l_hSqrtR));
+    __m256 l_ghSqrtRoe = _mm256_mul_ps(l_gSqrtV, _mm256_sqrt_ps(l_hRoe));
+    __m256 l_sL = _mm256_sub_ps(l_uRoe, l_ghSqrtRoe);
+    __m256 l_sR = _mm256_add_ps(l_uRoe, l_ghSqrtRoe);
+
+    // compute wave strengths
+    __m256 l_detInv = _mm256_div_ps(l_one, _mm256_sub_ps(l_sR, l_sL));
+    __m256 l_hJump = _mm256_sub_ps(l_hR, l_hL);
+    __m256 l_huJump = _mm256_sub_ps(l_huR, l_huL);
+    __m256 l_aL = _mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(l_detInv, l_sR), l_hJump), _mm256_mul_ps(l_detInv, l_huJump));
+    __m256 l_aR = _mm256_sub_ps(_mm256_mul_ps(l_detInv, l_huJump), _mm256_mul_ps(_mm256_mul_ps(l_detInv, l_sL), l_hJump));
+
+    // compute scaled waves
+    __m256 l_waveLH = _mm256_mul_ps(l_sL, l_aL);
+    __m256 l_waveLHu = _mm256_mul_ps(l_waveLH, l_sL);
+    __m256 l_waveRH = _mm256_mul_ps(l_sR, l_aR);
+    __m256 l_waveRHu = _mm256_mul_ps(l_waveRH, l_sR);
+
+    // assign the 1st wave
+    __m256 l_leftGoingL = _mm256_cmp_ps(l_sL, l_zero, _CMP_LT_OQ);
+    __m256 l_netUpdateLH = _mm256_and_ps(l_leftGoingL, l_waveLH);
+    __m256 l_netUpdateLHu = _mm256_and_ps(l_leftGoingL, l_waveLHu);
+    __m256 l_netUpdateRH = _mm256_andnot_ps(l_leftGoingL, l_waveLH);
+    __m256 l_netUpdateRHu = _mm256_andnot_ps(l_leftGoingL, l_waveLHu);
+
+    // the 2nd wave overwrites the 1st one if both propagate to the same side
+    __m256 l_rightGoingR = _mm256_cmp_ps(l_sR, l_zero, _CMP_GT_OQ);
+    l_netUpdateLH = _mm256_blendv_ps(l_waveRH, l_netUpdateLH, l_rightGoingR);
+    l_netUpdateLHu = _mm256_blendv_ps(l_waveRHu, l_netUpdateLHu, l_rightGoingR);
+    l_netUpdateRH = _mm256_blendv_ps(l_netUpdateRH, l_waveRH, l_rightGoingR);
+    l_netUpdateRHu = _mm256_blendv_ps(l_netUpdateRHu, l_waveRHu, l_rightGoingR);
+
+    _mm256_storeu_ps(o_netUpdateLH + l_ed, l_netUpdateLH);
+    _mm256_storeu_ps(o_netUpdateLHu + l_ed, l_netUpdateLHu);
+    _mm256_storeu_ps(o_netUpdateRH + l_ed, l_netUpdateRH);
+    _mm256_storeu_ps(o_netUpdateRHu + l_ed, l_netUpdateRHu);
+  }
+
+  return l_ed;
+}
+
+TSUNAMI_LAB_TARGET_AVX512 tsunami_lab::t_idx tsunami_lab::solvers::Roe::netUpdatesBatchAvx512(t_idx i_nEdges,
+                                                                                              t_real const *i_hL,
+                                                                                              t_real const *i_hR,
+                                                                                              t_real const *i_huL,
+                                                                                              t_real const *i_huR,
+                                                                                              t_real *o_netUpdateLH,
+                                                                                              t_real *o_netUpdateLHu,
+                                                                                              t_real *o_netUpdateRH,
+                                                                                              t_real *o_netUpdateRHu)
+{
+  static_assert(sizeof(t_real) == sizeof(float), "the AVX-512 kernel requires single precision");
+
+  __m512 const l_zero = _mm512_setzero_ps();
+  // all lanes; the unmasked square root triggers false positives of -Wmaybe-uninitialized in GCC 12
+  __mmask16 const l_all = 0xFFFF;
+  __m512 const l_one = _mm512_set1_ps(1);
+  __m512 const l_half = _mm512_set1_ps(0.5);
+  __m512 const l_gSqrtV = _mm512_set1_ps(m_gSqrt);
+
+  t_idx l_ed = 0;
+  for (; l_ed + 16 <= i_nEdges; l_ed += 16)
+  {
+    __m512 l_hL = _mm512_loadu_ps(i_hL + l_ed);
+    __m512 l_hR = _mm512_loadu_ps(i_hR + l_ed);
+    __m512 l_huL = _mm512_loadu_ps(i_huL + l_ed);
+    __m512 l_huR = _mm512_loadu_ps(i_huR + l_ed);
+
+    // compute particle velocities
+    __m512 l_uL = _mm512_div_ps(l_huL, l_hL);
+    __m512 l_uR = _mm512_div_ps(l_huR, l_hR);
+
+    // compute wave speeds
+    __m512 l_hSqrtL = _mm512_maskz_sqrt_ps(l_all, l_hL);
+    __m512 l_hSqrtR = _mm512_maskz_sqrt_ps(l_all, l_hR);
+    __m512 l_hRoe = _mm512_mul_ps(l_half, _mm512_add_ps(l_hL, l_hR));
+    __m512 l_uRoe = _mm512_add_ps(_mm512_mul_ps(l_hSqrtL, l_uL), _mm512_mul_ps(l_hSqrtR, l_uR));
+    l_uRoe = _mm512_div_ps(l_uRoe, _mm512_add_ps(l_hSqrtL, l_hSqrtR));
+    __m512 l_ghSqrtRoe = _mm512_mul_ps(l_gSqrtV, _mm512_maskz_sqrt_ps(l_all, l_hRoe));
+    __m512 l_sL = _mm512_sub_ps(l_uRoe, l_ghSqrtRoe);
+    __m512 l_sR = _mm512_add_ps(l_uRoe, l_ghSqrtRoe);
+
+    // compute wave strengths
+    __m512 l_detInv = _mm512_div_ps(l_one, _mm512_sub_ps(l_sR, l_sL));
+    __m512 l_hJump = _mm512_sub_ps(l_hR, l_hL);
+    __m512 l_huJump = _mm512_sub_ps(l_huR, l_huL);
+    __m512 l_aL = _mm512_sub_ps(_mm512_mul_ps(_mm512_mul_ps(l_detInv, l_sR), l_hJump), _mm512_mul_ps(l_detInv, l_huJump));
+    __m512 l_aR = _mm512_sub_ps(_mm512_mul_ps(l_detInv, l_huJump), _mm512_mul_ps(_mm512_mul_ps(l_detInv, l_sL), l_hJump));
+
+    // compute scaled waves
+    __m512 l_waveLH = _mm512_mul_ps(l_sL, l_aL);
+    __m512 l_waveLHu = _mm512_mul_ps(l_waveLH, l_sL);
+    __m512 l_waveRH = _mm512_mul_ps(l_sR, l_aR);
+    __m512 l_waveRHu = _mm512_mul_ps(l_waveRH, l_sR);
+
+    // assign the 1st wave
+    __mmask16 l_leftGoingL = _mm512_cmp_ps_mask(l_sL, l_zero, _CMP_LT_OQ);
+    __m512 l_netUpdateLH = _mm512_maskz_mov_ps(l_leftGoingL, l_waveLH);
+    __m512 l_netUpdateLHu = _mm512_maskz_mov_ps(l_leftGoingL, l_waveLHu);
+    __m512 l_netUpdateRH = _mm512_maskz_mov_ps(~l_leftGoingL, l_waveLH);
+    __m512 l_netUpdateRHu = _mm512_maskz_mov_ps(~l_leftGoingL, l_waveLHu);
+
+    // the 2nd wave overwrites the 1st one if both propagate to the same side
+    __mmask16 l_rightGoingR = _mm512_cmp_ps_mask(l_sR, l_zero, _CMP_GT_OQ);
+    l_netUpdateLH = _mm512_mask_blend_ps(l_rightGoingR, l_waveRH, l_netUpdateLH);
+    l_netUpdateLHu = _mm512_mask_blend_ps(l_rightGoingR, l_waveRHu, l_netUpdateLHu);
+    l_netUpdateRH = _mm512_mask_blend_ps(l_rightGoingR, l_netUpdateRH, l_waveRH);
+    l_netUpdateRHu = _mm512_mask_blend_ps(l_rightGoingR, l_netUpdateRHu, l_waveRHu);
+
+    _mm512_storeu_ps(o_netUpdateLH + l_ed, l_netUpdateLH);
+    _mm512_storeu_ps(o_netUpdateLHu + l_ed, l_netUpdateLHu);
+    _mm512_storeu_ps(o_netUpdateRH + l_ed, l_netUpdateRH);
+    _mm512_storeu_ps(o_netUpdateRHu + l_ed, l_netUpdateRHu);
+  }
+
+  return l_ed;
+}
+#endif
+
+void tsunami_lab::solvers::Roe::netUpdatesBatch(t_idx i_nEdges,
+                                                t_real const *i_hL,
+                                                t_real const *i_hR,
+                                                t_real const *i_huL,
+                                                t_real const *i_huR,
+                                                t_real *o_netUpdateLH,
+                                                t_real *o_netUpdateLHu,
+                                                t_real *o_netUpdateRH,
+                                                t_real *o_netUpdateRHu)
+{
+  t_idx l_nVectorized = 0;
+#ifdef TSUNAMI_LAB_ISA_X86
+  switch (systeminfo::Isa::active())
+  {
+  case systeminfo::Isa::AVX512:
+    l_nVectorized = netUpdatesBatchAvx512(i_nEdges,
+                                          i_hL, i_hR,
+                                          i_huL, i_huR,
+                                          o_netUpdateLH, o_netUpdateLHu,
+                                          o_netUpdateRH, o_netUpdateRHu);
+    break;
+  case systeminfo::Isa::AVX2:
+    l_nVectorized = netUpdatesBatchAvx2(i_nEdges,
+                                        i_hL, i_hR,
+                                        i_huL, i_huR,
+                                        o_netUpdateLH, o_netUpdateLHu,
+                                        o_netUpdateRH, o_netUpdateRHu);
+    break;
+  case systeminfo::Isa::SSE2:
+    l_nVectorized = netUpdatesBatchSse2(i_nEdges,
+                                        i_hL, i_hR,
+                                        i_huL, i_huR,
+                                        o_netUpdateLH, o_netUpdateLHu,
+                                        o_netUpdateRH, o_netUpdateRHu);
+    break;
+  default:
+    break;
+  }
+#endif
+
+  // remainder of the batch
+  netUpdatesBatchScalar(l_nVectorized,
+                        i_nEdges,
+                        i_hL, i_hR,
+                        i_huL, i_huR,
+                        o_netUpdateLH, o_netUpdateLHu,
+                        o_netUpdateRH, o_netUpdateRHu);
+}
+
+void tsunami_lab::solvers::Roe::netUpdatesBatch(t_idx i_nEdges,
+                                                t_real const *i_hL,
+                                                t_real const *i_hR,
+                                                t_real const *i_huL,
+                                                t_real const *i_huR,
+                                                t_real const *,
+                                                t_real const *,
+                                                t_real *o_netUpdateLH,
+                                                t_real *o_netUpdateLHu,
+                                                t_real *o_netUpdateRH,
+                                                t_real *o_netUpdateRHu)
+{
+  netUpdatesBatch(i_nEdges,
+                  i_hL,
+                  i_hR,
+                  i_huL,
+                  i_huR,
+                  o_netUpdateLH,
+                  o_netUpdateLHu,
+                  o_netUpdateRH,
+                  o_netUpdateRHu);
+}
+
+void tsunami_lab::solvers::Roe::netUpdatesBatch(t_idx i_nEdges,
+                                                t_real const *i_hL,
+                                                t_real const *i_hR,
+                                                t_real const *i_huL,
+                                                t_real const *i_huR,
+                                                t_real const *,
+                                                t_real const *,
+                                                t_real const *,
+                                                t_real const *,
+                                                t_real const *,
+                                                t_real const *,
+                                                t_real const *,
+                                                t_real const *,
+                                                t_real *o_netUpdateLH,
+                                                t_real *o_netUpdateLHu,
+                                                t_real *o_netUpdateRH,
+                                                t_real *o_netUpdateRHu)
+{
+  netUpdatesBatch(i_nEdges,
+                  i_hL,
+                  i_hR,
+                  i_huL,
+                  i_huR,
+                  o_netUpdateLH,
+                  o_netUpdateLHu,
+                  o_netUpdateRH,
+                  o_netUpdateRHu);
+}
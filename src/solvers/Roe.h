@@ -8,6 +8,7 @@
 #define TSUNAMI_LAB_SOLVERS_ROE
 
 #include "../constants.h"
+#include "../systeminfo/Isa.h"
 
 namespace tsunami_lab
 {
@@ -61,7 +62,78 @@ private:
                             t_real &o_strengthL,
                             t_real &o_strengthR);
 
+  /**
+   * Computes the net-updates for the edges [i_first, i_last) of a batch without SIMD intrinsics.
+   * The parameters are the ones of netUpdatesBatch.
+   **/
+  static void netUpdatesBatchScalar(t_idx i_first,
+                                    t_idx i_last,
+                                    t_real const *i_hL,
+                                    t_real const *i_hR,
+                                    t_real const *i_huL,
+                                    t_real const *i_huR,
+                                    t_real *o_netUpdateLH,
+                                    t_real *o_netUpdateLHu,
+                                    t_real *o_netUpdateRH,
+                                    t_real *o_netUpdateRHu);
+
+#ifdef TSUNAMI_LAB_ISA_X86
+  /**
+   * Computes the net-updates for the leading edges of a batch using SSE2 (4 edges per instruction).
+   * The parameters are the ones of netUpdatesBatch.
+   *
+   * @return number of processed edges; the remaining ones have to be handled by netUpdatesBatchScalar.
+   **/
+  TSUNAMI_LAB_TARGET_SSE2 static t_idx netUpdatesBatchSse2(t_idx i_nEdges,
+                                                           t_real const *i_hL,
+                                                           t_real const *i_hR,
+                                                           t_real const *i_huL,
+                                                           t_real const *i_huR,
+                                                           t_real *o_netUpdateLH,
+                                                           t_real *o_netUpdateLHu,
+                                                           t_real *o_netUpdateRH,
+                                                           t_real *o_netUpdateRHu);
+
+  /**
+   * Computes the net-updates for the leading edges of a batch using AVX2 (8 edges per instruction).
+   * The parameters are the ones of netUpdatesBatch.
+   *
+   * @return number of processed edges; the remaining ones have to be handled by netUpdatesBatchScalar.
+   **/
+  TSUNAMI_LAB_TARGET_AVX2 static t_idx netUpdatesBatchAvx2(t_idx i_nEdges,
+                                                           t_real const *i_hL,
+                                                           t_real const *i_hR,
+                                                           t_real const *i_huL,
+                                                           t_real const *i_huR,
+                                                           t_real *o_netUpdateLH,
+                                                           t_real *o_netUpdateLHu,
+                                                           t_real *o_netUpdateRH,
+                                                           t_real *o_netUpdateRHu);
+
+  /**
+   * Computes the net-updates for the leading edges of a batch using AVX-512 (16 edges per instruction).
+   * The parameters are the ones of netUpdatesBatch.
+   *
+   * @return number of processed edges; the remaining ones have to be handled by netUpdatesBatchScalar.
+   **/
+  TSUNAMI_LAB_TARGET_AVX512 static t_idx netUpdatesBatchAvx512(t_idx i_nEdges,
+                                                               t_real const *i_hL,
+                                                               t_real const *i_hR,
+                                                               t_real const *i_huL,
+                                                               t_real const *i_huR,
+                                                               t_real *o_netUpdateLH,
+                                                               t_real *o_netUpdateLHu,
+                                                               t_real *o_netUpdateRH,
+                                                               t_real *o_netUpdateRHu);
+#endif
+
 public:
+  //! gravity constant, also of the wave speeds of the patches
+  static t_real constexpr m_g = 9.80665;
+
+  //! the patches do not compute the cell quantities of netUpdatesBatch for this solver
+  static bool constexpr m_sharesCellQuantities = false;
+
   /**
    * Computes the net-updates.
    *
@@ -78,6 +150,99 @@ public:
                          t_real i_huR,
                          t_real o_netUpdateL[2],
                          t_real o_netUpdateR[2]);
+
+  /**
+   * Computes the net-updates for a batch of edges.
+   * Edge i lies between the states (i_hL[i], i_huL[i]) and (i_hR[i], i_huR[i]).
+   * The kernel matching systeminfo::Isa::active() is used, the portable one on non-x86 machines.
+   *
+   * @param i_nEdges number of edges in the batch.
+   * @param i_hL heights of the left sides.
+   * @param i_hR heights of the right sides.
+   * @param i_huL momenta of the left sides.
+   * @param i_huR momenta of the right sides.
+   * @param o_netUpdateLH will be set to the height net-updates for the left sides.
+   * @param o_netUpdateLHu will be set to the momentum net-updates for the left sides.
+   * @param o_netUpdateRH will be set to the height net-updates for the right sides.
+   * @param o_netUpdateRHu will be set to the momentum net-updates for the right sides.
+   **/
+  static void netUpdatesBatch(t_idx i_nEdges,
+                              t_real const *i_hL,
+                              t_real const *i_hR,
+                              t_real const *i_huL,
+                              t_real const *i_huR,
+                              t_real *o_netUpdateLH,
+                              t_real *o_netUpdateLHu,
+                              t_real *o_netUpdateRH,
+                              t_real *o_netUpdateRHu);
+
+  /**
+   * Computes the net-updates for a batch of edges, ignoring the bathymetry.
+   * Matches the signature of Fwave::netUpdatesBatch, which allows the patches to use both solvers as policy.
+   *
+   * @param i_nEdges number of edges in the batch.
+   * @param i_hL heights of the left sides.
+   * @param i_hR heights of the right sides.
+   * @param i_huL momenta of the left sides.
+   * @param i_huR momenta of the right sides.
+   * @param i_bL bathymetry of the left sides (unused).
+   * @param i_bR bathymetry of the right sides (unused).
+   * @param o_netUpdateLH will be set to the height net-updates for the left sides.
+   * @param o_netUpdateLHu will be set to the momentum net-updates for the left sides.
+   * @param o_netUpdateRH will be set to the height net-updates for the right sides.
+   * @param o_netUpdateRHu will be set to the momentum net-updates for the right sides.
+   **/
+  static void netUpdatesBatch(t_idx i_nEdges,
+                              t_real const *i_hL,
+                              t_real const *i_hR,
+                              t_real const *i_huL,
+                              t_real const *i_huR,
+                              t_real const *i_bL,
+                              t_real const *i_bR,
+                              t_real *o_netUpdateLH,
+                              t_real *o_netUpdateLHu,
+                              t_real *o_netUpdateRH,
+                              t_real *o_netUpdateRHu);
+
+  /**
+   * Computes the net-updates for a batch of edges, ignoring the bathymetry and the shared cell quantities.
+   * Matches the signature of Fwave::netUpdatesBatch, which allows the patches to use both solvers as policy.
+   *
+   * @param i_nEdges number of edges in the batch.
+   * @param i_hL heights of the left sides.
+   * @param i_hR heights of the right sides.
+   * @param i_huL momenta of the left sides.
+   * @param i_huR momenta of the right sides.
+   * @param i_bL bathymetry of the left sides (unused).
+   * @param i_bR bathymetry of the right sides (unused).
+   * @param i_hSqrtL square roots of the heights of the left sides (unused).
+   * @param i_hSqrtR square roots of the heights of the right sides (unused).
+   * @param i_uL particle velocities of the left sides (unused).
+   * @param i_uR particle velocities of the right sides (unused).
+   * @param i_fluxL momentum fluxes of the left sides (unused).
+   * @param i_fluxR momentum fluxes of the right sides (unused).
+   * @param o_netUpdateLH will be set to the height net-updates for the left sides.
+   * @param o_netUpdateLHu will be set to the momentum net-updates for the left sides.
+   * @param o_netUpdateRH will be set to the height net-updates for the right sides.
+   * @param o_netUpdateRHu will be set to the momentum net-updates for the right sides.
+   **/
+  static void netUpdatesBatch(t_idx i_nEdges,
+                              t_real const *i_hL,
+                              t_real const *i_hR,
+                              t_real const *i_huL,
+                              t_real const *i_huR,
+                              t_real const *i_bL,
+                              t_real const *i_bR,
+                              t_real const *i_hSqrtL,
+                              t_real const *i_hSqrtR,
+                              t_real const *i_uL,
+                              t_real const *i_uR,
+                              t_real const *i_fluxL,
+                              t_real const *i_fluxR,
+                              t_real *o_netUpdateLH,
+                              t_real *o_netUpdateLHu,
+                              t_real *o_netUpdateRH,
+                              t_real *o_netUpdateRHu);
 };
 
 #endif
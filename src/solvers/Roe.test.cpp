@@ -190,4 +190,77 @@ TEST_CASE("Test the derivation of the Roe net-updates.", "[RoeUpdates]")
 
   REQUIRE(l_netUpdatesR[0] == Approx(0));
   REQUIRE(l_netUpdatesR[1] == Approx(0));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test the batched computation of the Roe net-updates.", "[RoeNetUpdatesBatch]")
+{
+  /*
+   * Test case:
+   *   37 edges with varying states, including a steady state and
+   *   supercritical flow to both sides.
+   *   The number of edges is no multiple of the vector width
+   *   to cover the scalar remainder.
+   *
+   *   The batched net-updates of all kernels supported by the CPU
+   *   have to match the ones of the single edge solver.
+   */
+  tsunami_lab::t_idx const l_nEdges = 37;
+  tsunami_lab::t_real l_hL[l_nEdges], l_hR[l_nEdges];
+  tsunami_lab::t_real l_huL[l_nEdges], l_huR[l_nEdges];
+
+  for (tsunami_lab::t_idx l_ed = 0; l_ed < l_nEdges; l_ed++)
+  {
+    l_hL[l_ed] = 5 + (l_ed % 7);
+    l_hR[l_ed] = 3 + (l_ed % 5);
+    l_huL[l_ed] = (tsunami_lab::t_real(l_ed) - 18) * 1.5;
+    l_huR[l_ed] = (tsunami_lab::t_real(l_ed % 11) - 5) * 2.5;
+  }
+
+  // steady state
+  l_hL[3] = l_hR[3] = 10;
+  l_huL[3] = l_huR[3] = 0;
+
+  // supercritical flow to the right and to the left
+  l_hL[10] = l_hR[10] = 1;
+  l_huL[10] = l_huR[10] = 20;
+  l_hL[30] = l_hR[30] = 1;
+  l_huL[30] = -20;
+  l_huR[30] = -25;
+
+  tsunami_lab::t_real l_netUpdatesLH[l_nEdges], l_netUpdatesLHu[l_nEdges];
+  tsunami_lab::t_real l_netUpdatesRH[l_nEdges], l_netUpdatesRHu[l_nEdges];
+
+  tsunami_lab::systeminfo::Isa::Level l_detected = tsunami_lab::systeminfo::Isa::detect();
+  for (int l_level = tsunami_lab::systeminfo::Isa::SCALAR; l_level <= l_detected; l_level++)
+  {
+    tsunami_lab::systeminfo::Isa::select(tsunami_lab::systeminfo::Isa::Level(l_level));
+
+    tsunami_lab::solvers::Roe::netUpdatesBatch(l_nEdges,
+                                               l_hL,
+                                               l_hR,
+                                               l_huL,
+                                               l_huR,
+                                               l_netUpdatesLH,
+                                               l_netUpdatesLHu,
+                                               l_netUpdatesRH,
+                                               l_netUpdatesRHu);
+
+    for (tsunami_lab::t_idx l_ed = 0; l_ed < l_nEdges; l_ed++)
+    {
+      tsunami_lab::t_real l_netUpdatesL[2] = {-5, 3};
+      tsunami_lab::t_real l_netUpdatesR[2] = {4, 7};
+      tsunami_lab::solvers::Roe::netUpdates(l_hL[l_ed],
+                                            l_hR[l_ed],
+                                            l_huL[l_ed],
+                                            l_huR[l_ed],
+                                            l_netUpdatesL,
+                                            l_netUpdatesR);
+
+      REQUIRE(l_netUpdatesLH[l_ed] == Approx(l_netUpdatesL[0]).margin(1E-4));
+      REQUIRE(l_netUpdatesLHu[l_ed] == Approx(l_netUpdatesL[1]).margin(1E-4));
+      REQUIRE(l_netUpdatesRH[l_ed] == Approx(l_netUpdatesR[0]).margin(1E-4));
+      REQUIRE(l_netUpdatesRHu[l_ed] == Approx(l_netUpdatesR[1]).margin(1E-4));
+    }
+  }
+  tsunami_lab::systeminfo::Isa::select(l_detected);
+}
@@ -0,0 +1,105 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Placement of the threads and memory pages on the cores and NUMA nodes.
+ **/
+#include "Affinity.h"
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+#ifdef USEOMP
+#include <omp.h>
+#endif
+
+#include <vector>
+
+bool tsunami_lab::systeminfo::Affinity::pinThreads()
+{
+#ifdef __linux__
+  cpu_set_t l_allowed;
+  CPU_ZERO(&l_allowed);
+  if (sched_getaffinity(0, sizeof(l_allowed), &l_allowed) != 0)
+    return false;
+
+  std::vector<int> l_cpus;
+  for (int l_cpu = 0; l_cpu < CPU_SETSIZE; l_cpu++)
+  {
+    if (CPU_ISSET(l_cpu, &l_allowed))
+      l_cpus.push_back(l_cpu);
+  }
+  if (l_cpus.empty())
+    return false;
+
+  bool l_pinned = true;
+#ifdef USEOMP
+#pragma omp parallel reduction(&& : l_pinned)
+#endif
+  {
+    std::size_t l_thread = 0;
+#ifdef USEOMP
+    l_thread = omp_get_thread_num();
+#endif
+    // neighbouring threads update neighbouring blocks of rows, thus they share a socket
+    cpu_set_t l_set;
+    CPU_ZERO(&l_set);
+    CPU_SET(l_cpus[l_thread % l_cpus.size()], &l_set);
+    l_pinned = sched_setaffinity(0, sizeof(l_set), &l_set) == 0;
+  }
+  return l_pinned;
+#else
+  return false;
+#endif
+}
+
+bool tsunami_lab::systeminfo::Affinity::setMemoryPolicy(MemoryPolicy i_policy)
+{
+#ifdef __linux__
+  // the policy applies to the allocations of a thread, thus every thread sets it
+  bool l_set = true;
+#ifdef USEOMP
+#pragma omp parallel reduction(&& : l_set)
+#endif
+  {
+    if (i_policy == INTERLEAVE)
+    {
+      // interleave over all nodes which the process may use; the kernel reads maxnode - 1 bits of the mask
+      unsigned long l_nodes[16] = {0};
+      unsigned long l_maxNode = sizeof(l_nodes) * 8 + 1;
+      l_set = syscall(SYS_get_mempolicy, nullptr, l_nodes, l_maxNode, nullptr, MPOL_F_MEMS_ALLOWED) == 0 &&
+              syscall(SYS_set_mempolicy, MPOL_INTERLEAVE, l_nodes, l_maxNode) == 0;
+    }
+    else
+    {
+      l_set = syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0) == 0;
+    }
+  }
+  return l_set;
+#else
+  return i_policy == FIRST_TOUCH;
+#endif
+}
+
+bool tsunami_lab::systeminfo::Affinity::parse(std::string const &i_name,
+                                              MemoryPolicy &o_policy)
+{
+  if (i_name == "firsttouch" || i_name == "FIRSTTOUCH")
+    o_policy = FIRST_TOUCH;
+  else if (i_name == "interleave" || i_name == "INTERLEAVE")
+    o_policy = INTERLEAVE;
+  else
+    return false;
+  return true;
+}
+
+std::string tsunami_lab::systeminfo::Affinity::name(MemoryPolicy i_policy)
+{
+  if (i_policy == INTERLEAVE)
+    return "interleave";
+  return "firsttouch";
+}
@@ -0,0 +1,70 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Placement of the threads and memory pages on the cores and NUMA nodes.
+ **/
+#ifndef TSUNAMI_LAB_SYSTEMINFO_AFFINITY_H
+#define TSUNAMI_LAB_SYSTEMINFO_AFFINITY_H
+
+#include <string>
+
+namespace tsunami_lab
+{
+  namespace systeminfo
+  {
+    class Affinity;
+  }
+}
+
+class tsunami_lab::systeminfo::Affinity
+{
+public:
+  //! placement policies of the memory pages
+  enum MemoryPolicy
+  {
+    //! a page is placed on the NUMA node of the thread which touches it first
+    FIRST_TOUCH = 0,
+    //! the pages are distributed round robin over all NUMA nodes
+    INTERLEAVE = 1
+  };
+
+  /**
+   * Pins the threads of the next parallel regions to the cores which the process may use.
+   * Consecutive threads use consecutive cores; the threads are distributed round robin if there are more threads than cores.
+   * Has to be called outside of parallel regions and at most once, since the initial thread is pinned as well.
+   *
+   * @return true if all threads were pinned; false on failure or on other systems than Linux.
+   **/
+  static bool pinThreads();
+
+  /**
+   * Sets the placement policy of the memory pages which the threads of the next parallel regions allocate.
+   * Has to be called outside of parallel regions and before the memory is touched.
+   *
+   * @param i_policy placement policy.
+   * @return true if the policy was set in all threads; false on failure or on other systems than Linux.
+   **/
+  static bool setMemoryPolicy(MemoryPolicy i_policy);
+
+  /**
+   * Parses the name of a memory policy.
+   *
+   * @param i_name name of the policy.
+   * @param o_policy will be set to the parsed policy.
+   * @return true if the name is known, false otherwise.
+   **/
+  static bool parse(std::string const &i_name,
+                    MemoryPolicy &o_policy);
+
+  /**
+   * Gets the name of a memory policy.
+   *
+   * @param i_policy policy.
+   * @return name of the policy.
+   **/
+  static std::string name(MemoryPolicy i_policy);
+};
+
+#endif
@@ -0,0 +1,26 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Unit tests of the thread and memory placement.
+ **/
+#include <catch2/catch.hpp>
+#include "Affinity.h"
+
+TEST_CASE("Test the parsing of memory policy names.", "[Affinity]")
+{
+  tsunami_lab::systeminfo::Affinity::MemoryPolicy l_policy = tsunami_lab::systeminfo::Affinity::FIRST_TOUCH;
+
+  REQUIRE(tsunami_lab::systeminfo::Affinity::parse("interleave", l_policy));
+  REQUIRE(l_policy == tsunami_lab::systeminfo::Affinity::INTERLEAVE);
+  REQUIRE(tsunami_lab::systeminfo::Affinity::parse("FIRSTTOUCH", l_policy));
+  REQUIRE(l_policy == tsunami_lab::systeminfo::Affinity::FIRST_TOUCH);
+
+  // unknown names keep the policy
+  REQUIRE_FALSE(tsunami_lab::systeminfo::Affinity::parse("bind", l_policy));
+  REQUIRE(l_policy == tsunami_lab::systeminfo::Affinity::FIRST_TOUCH);
+
+  REQUIRE(tsunami_lab::systeminfo::Affinity::name(tsunami_lab::systeminfo::Affinity::INTERLEAVE) == "interleave");
+  REQUIRE(tsunami_lab::systeminfo::Affinity::name(tsunami_lab::systeminfo::Affinity::FIRST_TOUCH) == "firsttouch");
+}
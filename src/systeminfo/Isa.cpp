@@ -0,0 +1,88 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Runtime selection of the instruction set used by the vectorized kernels.
+ **/
+#include "Isa.h"
+
+#include <cstdlib>
+#include <iostream>
+
+tsunami_lab::systeminfo::Isa::Level tsunami_lab::systeminfo::Isa::m_active = tsunami_lab::systeminfo::Isa::detect();
+
+tsunami_lab::systeminfo::Isa::Level tsunami_lab::systeminfo::Isa::detect()
+{
+#ifdef TSUNAMI_LAB_ISA_X86
+  // also checks that the OS saves the extended registers
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return AVX512;
+  if (__builtin_cpu_supports("avx2"))
+    return AVX2;
+  if (__builtin_cpu_supports("sse2"))
+    return SSE2;
+#endif
+  return SCALAR;
+}
+
+tsunami_lab::systeminfo::Isa::Level tsunami_lab::systeminfo::Isa::select(Level i_level)
+{
+  Level l_detected = detect();
+  if (i_level > l_detected)
+  {
+    std::cerr << "Warning: " << name(i_level) << " is not supported by this CPU, using "
+              << name(l_detected) << " instead" << std::endl;
+    i_level = l_detected;
+  }
+  m_active = i_level;
+  return m_active;
+}
+
+tsunami_lab::systeminfo::Isa::Level tsunami_lab::systeminfo::Isa::select(std::string const &i_name)
+{
+  std::string l_name = i_name;
+  char const *l_env = std::getenv("TSUNAMI_LAB_ISA");
+  if (l_env != nullptr && l_env[0] != '\0')
+    l_name = l_env;
+
+  Level l_level = detect();
+  if (!l_name.empty() && l_name != "auto" && !parse(l_name, l_level))
+  {
+    std::cerr << "Warning: unknown instruction set " << l_name << ", using "
+              << name(l_level) << " instead" << std::endl;
+  }
+  return select(l_level);
+}
+
+bool tsunami_lab::systeminfo::Isa::parse(std::string const &i_name,
+                                         Level &o_level)
+{
+  if (i_name == "scalar" || i_name == "SCALAR")
+    o_level = SCALAR;
+  else if (i_name == "sse2" || i_name == "SSE2")
+    o_level = SSE2;
+  else if (i_name == "avx2" || i_name == "AVX2")
+    o_level = AVX2;
+  else if (i_name == "avx512" || i_name == "AVX512")
+    o_level = AVX512;
+  else
+    return false;
+  return true;
+}
+
+std::string tsunami_lab::systeminfo::Isa::name(Level i_level)
+{
+  switch (i_level)
+  {
+  case SSE2:
+    return "sse2";
+  case AVX2:
+    return "avx2";
+  case AVX512:
+    return "avx512";
+  default:
+    return "scalar";
+  }
+}
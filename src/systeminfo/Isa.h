@@ -0,0 +1,108 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Runtime selection of the instruction set used by the vectorized kernels.
+ **/
+#ifndef TSUNAMI_LAB_SYSTEMINFO_ISA_H
+#define TSUNAMI_LAB_SYSTEMINFO_ISA_H
+
+#include <string>
+
+// kernel variants for x86 are compiled independently of the build flags
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define TSUNAMI_LAB_ISA_X86
+#define TSUNAMI_LAB_TARGET_SSE2 __attribute__((target("sse2")))
+#define TSUNAMI_LAB_TARGET_AVX2 __attribute__((target("avx2")))
+#define TSUNAMI_LAB_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+// kernels which are inlined into the variants of every instruction set
+#ifdef __GNUC__
+#define TSUNAMI_LAB_INLINE inline __attribute__((always_inline))
+#else
+#define TSUNAMI_LAB_INLINE inline
+#endif
+
+namespace tsunami_lab
+{
+  namespace systeminfo
+  {
+    class Isa;
+  }
+}
+
+class tsunami_lab::systeminfo::Isa
+{
+public:
+  //! instruction set levels, ordered by capability
+  enum Level
+  {
+    SCALAR = 0,
+    SSE2 = 1,
+    AVX2 = 2,
+    AVX512 = 3
+  };
+
+private:
+  //! level used by the kernels
+  static Level m_active;
+
+public:
+  /**
+   * Detects the best level supported by the CPU and the OS.
+   *
+   * @return detected level; SCALAR on non-x86 machines.
+   **/
+  static Level detect();
+
+  /**
+   * Gets the level used by the kernels.
+   *
+   * @return active level.
+   **/
+  static Level active()
+  {
+    return m_active;
+  }
+
+  /**
+   * Selects the level used by the kernels.
+   * Requests above the detected level fall back to the detected one.
+   *
+   * @param i_level requested level.
+   * @return selected level.
+   **/
+  static Level select(Level i_level);
+
+  /**
+   * Selects the level from a name, e.g. from the configuration.
+   * The environment variable TSUNAMI_LAB_ISA takes precedence over the given name.
+   * "auto" or an empty name select the detected level.
+   *
+   * @param i_name name of the requested level (auto, scalar, sse2, avx2 or avx512).
+   * @return selected level.
+   **/
+  static Level select(std::string const &i_name);
+
+  /**
+   * Parses the name of a level.
+   *
+   * @param i_name name of the level.
+   * @param o_level will be set to the parsed level.
+   * @return true if the name is known, false otherwise.
+   **/
+  static bool parse(std::string const &i_name,
+                    Level &o_level);
+
+  /**
+   * Gets the name of a level.
+   *
+   * @param i_level level.
+   * @return name of the level.
+   **/
+  static std::string name(Level i_level);
+};
+
+#endif
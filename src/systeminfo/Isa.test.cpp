@@ -0,0 +1,43 @@
+/**
+ * @author Luca-Philipp Grumbach
+ * @author Richard Hofmann
+ *
+ * # Description
+ * Unit tests of the instruction set selection.
+ **/
+#include <catch2/catch.hpp>
+#include "Isa.h"
+
+TEST_CASE("Test the parsing of instruction set names.", "[Isa]")
+{
+  tsunami_lab::systeminfo::Isa::Level l_level = tsunami_lab::systeminfo::Isa::SCALAR;
+
+  REQUIRE(tsunami_lab::systeminfo::Isa::parse("avx2", l_level));
+  REQUIRE(l_level == tsunami_lab::systeminfo::Isa::AVX2);
+  REQUIRE(tsunami_lab::systeminfo::Isa::parse("AVX512", l_level));
+  REQUIRE(l_level == tsunami_lab::systeminfo::Isa::AVX512);
+  REQUIRE(tsunami_lab::systeminfo::Isa::parse("sse2", l_level));
+  REQUIRE(l_level == tsunami_lab::systeminfo::Isa::SSE2);
+  REQUIRE(tsunami_lab::systeminfo::Isa::parse("scalar", l_level));
+  REQUIRE(l_level == tsunami_lab::systeminfo::Isa::SCALAR);
+
+  // unknown names keep the level
+  REQUIRE_FALSE(tsunami_lab::systeminfo::Isa::parse("neon", l_level));
+  REQUIRE(l_level == tsunami_lab::systeminfo::Isa::SCALAR);
+
+  REQUIRE(tsunami_lab::systeminfo::Isa::name(tsunami_lab::systeminfo::Isa::AVX2) == "avx2");
+}
+
+TEST_CASE("Test the selection of instruction sets.", "[Isa]")
+{
+  tsunami_lab::systeminfo::Isa::Level l_detected = tsunami_lab::systeminfo::Isa::detect();
+
+  // requests are limited to the detected level
+  REQUIRE(tsunami_lab::systeminfo::Isa::select(tsunami_lab::systeminfo::Isa::AVX512) == l_detected);
+  REQUIRE(tsunami_lab::systeminfo::Isa::active() == l_detected);
+
+  REQUIRE(tsunami_lab::systeminfo::Isa::select(tsunami_lab::systeminfo::Isa::SCALAR) == tsunami_lab::systeminfo::Isa::SCALAR);
+  REQUIRE(tsunami_lab::systeminfo::Isa::active() == tsunami_lab::systeminfo::Isa::SCALAR);
+
+  tsunami_lab::systeminfo::Isa::select(l_detected);
+}
@@ -8,11 +8,33 @@
 #define CATCH_CONFIG_RUNNER
 #include <catch2/catch.hpp>
 #undef CATCH_CONFIG_RUNNER
+#ifdef USEMPI
+#include <mpi.h>
+#endif
 
 int main(int i_argc,
          char *i_argv[])
 {
-  int l_result = Catch::Session().run(i_argc, i_argv);
+#ifdef USEMPI
+  // the tests of the decomposition run on all processes of mpirun
+  MPI_Init(&i_argc, &i_argv);
+#endif
+  Catch::Session l_session;
+  int l_result = l_session.applyCommandLine(i_argc, i_argv);
+  if (l_result == 0)
+  {
+#ifdef USEMPI
+    // the other tests write the same files on all processes, several processes run the ones of the decomposition unless tests are given
+    int l_nRanks = 1;
+    MPI_Comm_size(MPI_COMM_WORLD, &l_nRanks);
+    if (l_nRanks > 1 && l_session.configData().testsOrTags.empty())
+      l_session.configData().testsOrTags.push_back("[Decomposition2d]");
+#endif
+    l_result = l_session.run();
+  }
+#ifdef USEMPI
+  MPI_Finalize();
+#endif
 
   return (l_result < 0xff ? l_result : 0xff);
 }
\ No newline at end of file